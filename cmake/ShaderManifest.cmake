@@ -0,0 +1,39 @@
+# Write the manifest of the compiled shaders, run in script mode by the
+# Shaders target:
+#
+#   cmake -DSHADER_DIR=<dir> -DSHADER_VARIANTS=<source>:<name>[:<define>],...
+#         -DSHADER_OPTIMIZED=<ON|OFF> -DMANIFEST=<file> -P ShaderManifest.cmake
+#
+# Every variant is listed with its source, its stage, the file the renderer
+# loads, the sizes before and after spirv-opt and the SHA-256 of the file.
+# The renderer derives the key of its pipeline cache from the hashes.
+
+if(SHADER_OPTIMIZED)
+	set(BUILD_TYPE "release")
+	set(OPTIMIZED "true")
+else()
+	set(BUILD_TYPE "debug")
+	set(OPTIMIZED "false")
+endif()
+
+set(ENTRIES "")
+string(REPLACE "," ";" SHADER_VARIANTS "${SHADER_VARIANTS}")
+
+foreach(VARIANT ${SHADER_VARIANTS})
+	string(REPLACE ":" ";" VARIANT_FIELDS ${VARIANT})
+	list(GET VARIANT_FIELDS 0 SOURCE)
+	list(GET VARIANT_FIELDS 1 NAME)
+	get_filename_component(STAGE ${SOURCE} LAST_EXT)
+	string(SUBSTRING ${STAGE} 1 -1 STAGE)
+
+	set(FILE "${SHADER_DIR}/${NAME}.spv")
+	file(SIZE ${FILE} SIZE)
+	file(SIZE "${SHADER_DIR}/${NAME}.unoptimized.spv" UNOPTIMIZED_SIZE)
+	file(SHA256 ${FILE} HASH)
+
+	list(APPEND ENTRIES "    {\"name\": \"${NAME}\", \"source\": \"${SOURCE}\", \"stage\": \"${STAGE}\", \"file\": \"${NAME}.spv\", \"size\": ${SIZE}, \"unoptimized_size\": ${UNOPTIMIZED_SIZE}, \"sha256\": \"${HASH}\"}")
+endforeach()
+
+list(JOIN ENTRIES ",\n" ENTRIES)
+
+file(WRITE ${MANIFEST} "{\n  \"build\": \"${BUILD_TYPE}\",\n  \"optimized\": ${OPTIMIZED},\n  \"shaders\": [\n${ENTRIES}\n  ]\n}\n")
@@ -0,0 +1,241 @@
+/* Local header files */
+#include "application_options.hpp"
+
+/* Standard libraries */
+#include <stdexcept>
+
+namespace {
+
+uint32_t ParseUnsigned(const std::string& option, const std::string& value) {
+    /* Parse a positive integer value of an option */
+    size_t parsed_length = 0;
+    unsigned long parsed_value = 0;
+
+    try {
+        parsed_value = std::stoul(value, &parsed_length);
+    } catch (const std::exception&) {
+        parsed_length = 0;
+    }
+
+    if (parsed_length != value.size() || parsed_value == 0 ||
+        parsed_value > UINT32_MAX) {
+        throw std::invalid_argument("invalid value for " + option + ": " +
+                                    value);
+    }
+
+    return static_cast<uint32_t>(parsed_value);
+}
+
+double ParseFrameRate(const std::string& option, const std::string& value) {
+    /* Parse a positive frame rate */
+    size_t parsed_length = 0;
+    double parsed_value = 0.0;
+
+    try {
+        parsed_value = std::stod(value, &parsed_length);
+    } catch (const std::exception&) {
+        parsed_length = 0;
+    }
+
+    if (parsed_length != value.size() || !(parsed_value > 0.0)) {
+        throw std::invalid_argument("invalid value for " + option + ": " +
+                                    value);
+    }
+
+    return parsed_value;
+}
+
+bool ParseSwitch(const std::string& option, const std::string& value) {
+    /* Parse an on or off value */
+    if (value == "on") {
+        return true;
+    }
+
+    if (value == "off") {
+        return false;
+    }
+
+    throw std::invalid_argument("invalid value for " + option + ": " + value);
+}
+
+VkSampleCountFlagBits ParseSampleCount(const std::string& option,
+                                       const std::string& value) {
+    /* Parse a sample count, a power of two from 1 to 64 */
+    uint32_t sample_count = ParseUnsigned(option, value);
+
+    if (sample_count > VK_SAMPLE_COUNT_64_BIT ||
+        (sample_count & (sample_count - 1)) != 0) {
+        throw std::invalid_argument("invalid value for " + option + ": " +
+                                    value);
+    }
+
+    // The sample count flag bits have the value of the sample count
+    return static_cast<VkSampleCountFlagBits>(sample_count);
+}
+
+VkExtent2D ParseExtent(const std::string& option, const std::string& value) {
+    /* Parse an extent in the WIDTHxHEIGHT form */
+    size_t separator = value.find('x');
+
+    if (separator == std::string::npos) {
+        throw std::invalid_argument("invalid value for " + option + ": " +
+                                    value);
+    }
+
+    VkExtent2D extent{};
+    extent.width = ParseUnsigned(option, value.substr(0, separator));
+    extent.height = ParseUnsigned(option, value.substr(separator + 1));
+
+    return extent;
+}
+
+std::vector<PostStage> ParsePostStages(const std::string& option,
+                                       const std::string& value) {
+    /* Parse a comma separated list of post-processing stages */
+    if (value.empty()) {
+        throw std::invalid_argument("missing stages for " + option);
+    }
+
+    std::vector<PostStage> stages;
+    size_t begin = 0;
+    while (true) {
+        size_t separator = value.find(',', begin);
+        stages.push_back(
+            ParsePostStage(value.substr(begin, separator - begin)));
+        if (separator == std::string::npos) {
+            break;
+        }
+        begin = separator + 1;
+    }
+
+    return stages;
+}
+
+}  // namespace
+
+ApplicationOptions ParseApplicationOptions(int argc, char** argv) {
+    /* Options are given in the --name or --name=value form */
+    ApplicationOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        std::string name = argument;
+        std::string value;
+
+        size_t separator = argument.find('=');
+        if (separator != std::string::npos) {
+            name = argument.substr(0, separator);
+            value = argument.substr(separator + 1);
+        }
+
+        if (name == "--present-mode") {
+            options.present_mode = ParsePresentMode(value);
+        } else if (name == "--frames-in-flight") {
+            options.frames_in_flight = ParseUnsigned(name, value);
+        } else if (name == "--measure-latency") {
+            options.measure_latency = true;
+        } else if (name == "--latency-frames") {
+            options.latency_frames = ParseUnsigned(name, value);
+        } else if (name == "--fps-cap") {
+            if (value == "display") {
+                options.fps_cap_display = true;
+            } else {
+                options.fps_cap = ParseFrameRate(name, value);
+            }
+        } else if (name == "--low-latency") {
+            options.low_latency = true;
+        } else if (name == "--pacing-depth") {
+            options.pacing_depth = ParseUnsigned(name, value);
+        } else if (name == "--headless") {
+            options.headless = true;
+        } else if (name == "--headless-extent") {
+            options.headless_extent = ParseExtent(name, value);
+        } else if (name == "--headless-resize-interval") {
+            options.headless_resize_interval = ParseUnsigned(name, value);
+        } else if (name == "--frames") {
+            options.frame_limit = ParseUnsigned(name, value);
+        } else if (name == "--validation") {
+            options.validation = ParseSwitch(name, value);
+        } else if (name == "--samples") {
+            options.sample_count = ParseSampleCount(name, value);
+        } else if (name == "--draw-count") {
+            options.draw_count = ParseUnsigned(name, value);
+        } else if (name == "--depth-prepass") {
+            options.depth_prepass = true;
+        } else if (name == "--resize-storm") {
+            options.resize_storm = true;
+        } else if (name == "--resize-storm-burst") {
+            options.resize_storm_burst = ParseUnsigned(name, value);
+        } else if (name == "--texture") {
+            if (value.empty()) {
+                throw std::invalid_argument("missing file name for " + name);
+            }
+            options.textures.push_back(value);
+        } else if (name == "--texture-budget") {
+            options.texture_budget = ParseUnsigned(name, value);
+        } else if (name == "--mesh") {
+            if (value.empty()) {
+                throw std::invalid_argument("missing file name for " + name);
+            }
+            options.meshes.push_back(value);
+        } else if (name == "--gltf") {
+            if (value.empty()) {
+                throw std::invalid_argument("missing file name for " + name);
+            }
+            options.gltf_files.push_back(value);
+        } else if (name == "--load-threads") {
+            options.load_threads = ParseUnsigned(name, value);
+        } else if (name == "--instances") {
+            options.instances = ParseUnsigned(name, value);
+        } else if (name == "--particles") {
+            options.particles = ParseUnsigned(name, value);
+        } else if (name == "--hud") {
+            options.hud = true;
+        } else if (name == "--metrics-port") {
+            options.metrics_port = ParseUnsigned(name, value);
+            if (options.metrics_port > 65535) {
+                throw std::invalid_argument("invalid port for " + name + ": " +
+                                            value);
+            }
+        } else if (name == "--lights") {
+            options.lights = ParseUnsigned(name, value);
+        } else if (name == "--deferred") {
+            options.deferred = true;
+        } else if (name == "--post") {
+            options.post_stages = ParsePostStages(name, value);
+        } else if (name == "--occlusion-culling") {
+            options.occlusion_culling = true;
+        } else {
+            throw std::invalid_argument("unknown option: " + argument);
+        }
+    }
+
+    return options;
+}
+
+std::string PresentModeName(VkPresentModeKHR present_mode) {
+    switch (present_mode) {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:
+            return "immediate";
+        case VK_PRESENT_MODE_MAILBOX_KHR:
+            return "mailbox";
+        case VK_PRESENT_MODE_FIFO_KHR:
+            return "fifo";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+            return "fifo_relaxed";
+        default:
+            return "unknown";
+    }
+}
+
+VkPresentModeKHR ParsePresentMode(const std::string& name) {
+    for (VkPresentModeKHR present_mode :
+         {VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR,
+          VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR}) {
+        if (PresentModeName(present_mode) == name) {
+            return present_mode;
+        }
+    }
+
+    throw std::invalid_argument("unknown present mode: " + name);
+}
@@ -0,0 +1,120 @@
+#ifndef APPLICATION_OPTIONS_H
+#define APPLICATION_OPTIONS_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Local header files */
+#include "post_process.hpp"
+
+/* Standard libraries */
+#include <cstdint>  // Required for uint32_t
+#include <optional>
+#include <string>
+#include <vector>
+
+struct ApplicationOptions {
+    // Present mode to prefer when creating the swap chain. Without a value
+    // the application prefers MAILBOX and falls back to FIFO.
+    std::optional<VkPresentModeKHR> present_mode;
+
+    // Number of frames the CPU may record ahead of the GPU. Without a value
+    // the application uses DEFAULT_FRAMES_IN_FLIGHT.
+    std::optional<uint32_t> frames_in_flight;
+
+    // Input-to-present latency measurement mode
+    bool measure_latency = false;
+    uint32_t latency_frames = 300;
+
+    // Frame rate cap in frames per second, or the refresh rate of the
+    // display if fps_cap_display is set
+    std::optional<double> fps_cap;
+    bool fps_cap_display = false;
+
+    // Low latency pacing: wait for the present of frame N - pacing_depth to
+    // complete, then start frame N as late as possible
+    bool low_latency = false;
+    uint32_t pacing_depth = 1;
+
+    // Render to a VK_EXT_headless_surface instead of a GLFW window, so the
+    // swap chain path runs without a display server
+    bool headless = false;
+    std::optional<VkExtent2D> headless_extent;
+
+    // Simulate a resize of the headless surface every n frames, 0 disables
+    uint32_t headless_resize_interval = 0;
+
+    // Stop after this many frames, 0 runs until the window is closed
+    uint32_t frame_limit = 0;
+
+    // Enable the validation layers. Without a value the default of the
+    // renderer configuration is used.
+    std::optional<bool> validation;
+
+    // Number of samples per pixel for multisample anti-aliasing, limited to
+    // what the device supports
+    std::optional<VkSampleCountFlagBits> sample_count;
+
+    // Number of draw commands recorded per frame
+    uint32_t draw_count = 1;
+
+    // Record the draws depth only first, then shade only the nearest
+    // fragments
+    bool depth_prepass = false;
+
+    // Resize storm stress test: issue resize_storm_burst resizes every frame
+    // and report the swap chain recreations
+    bool resize_storm = false;
+    uint32_t resize_storm_burst = 4;
+
+    // KTX2 textures to stream to the GPU, and the most bytes copied to the
+    // GPU per frame in KiB
+    std::vector<std::string> textures;
+    uint32_t texture_budget = 4096;
+
+    // Binary meshes (.vmesh) to load
+    std::vector<std::string> meshes;
+
+    // glTF 2.0 scenes (.gltf, .glb) to load, decoded on load_threads threads
+    // (0 for one per hardware thread)
+    std::vector<std::string> gltf_files;
+    uint32_t load_threads = 0;
+
+    // Instances of the loaded meshes placed on a grid, with a camera that
+    // flies over them so the levels of detail change (0 for none)
+    uint32_t instances = 0;
+
+    // Capacity of the GPU particle fountain (0 for none)
+    uint32_t particles = 0;
+
+    // Draw the performance overlay
+    bool hud = false;
+
+    // Serve the renderer metrics on http://127.0.0.1:<port>/metrics (0 for
+    // none)
+    uint32_t metrics_port = 0;
+
+    // Point lights the scene is shaded with (0 for an unlit scene), and
+    // deferred shading with a G-buffer instead of shading every fragment
+    uint32_t lights = 0;
+    bool deferred = false;
+
+    // Compute post-processing stages run on the rendered scene in this order
+    // (empty for none)
+    std::vector<PostStage> post_stages;
+
+    // Cull the scene draws against a depth pyramid of the previous frame in
+    // two phases, and against occlusion queries where the device has
+    // conditional rendering
+    bool occlusion_culling = false;
+};
+
+// Parse the command line arguments into the application options.
+// Throws std::invalid_argument for unknown options or malformed values.
+ApplicationOptions ParseApplicationOptions(int argc, char** argv);
+
+// Convert a present mode to and from its command line spelling
+std::string PresentModeName(VkPresentModeKHR present_mode);
+VkPresentModeKHR ParsePresentMode(const std::string& name);
+
+#endif  // APPLICATION_OPTIONS_H
@@ -0,0 +1,120 @@
+/* Local header files */
+#include "application_options.hpp"
+#include "benchmark_suite.hpp"
+#include "renderer.hpp"
+
+/* Standard libraries */
+#include <fstream>
+
+namespace {
+
+uint32_t ParseCount(const std::string& option, const std::string& value) {
+    size_t parsed_length = 0;
+    unsigned long parsed_value = 0;
+
+    try {
+        parsed_value = std::stoul(value, &parsed_length);
+    } catch (const std::exception&) {
+        parsed_length = 0;
+    }
+
+    if (parsed_length != value.size() || parsed_value > UINT32_MAX) {
+        throw std::invalid_argument("invalid value for " + option + ": " +
+                                    value);
+    }
+
+    return static_cast<uint32_t>(parsed_value);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        /* The benchmark options are handled here, all other arguments are
+        application options, e.g. --headless-extent or --frames-in-flight */
+        BenchmarkOptions benchmark_options;
+        std::vector<char*> application_arguments = {argv[0]};
+
+        for (int i = 1; i < argc; i++) {
+            std::string argument = argv[i];
+            size_t separator = argument.find('=');
+            std::string name = argument.substr(0, separator);
+            std::string value = separator == std::string::npos
+                                    ? std::string()
+                                    : argument.substr(separator + 1);
+
+            if (name == "--iterations") {
+                benchmark_options.iterations = ParseCount(name, value);
+            } else if (name == "--warmup") {
+                benchmark_options.warmup_iterations = ParseCount(name, value);
+            } else if (name == "--filter") {
+                benchmark_options.filter = value;
+            } else if (name == "--output") {
+                benchmark_options.output = value;
+            } else {
+                application_arguments.push_back(argv[i]);
+            }
+        }
+
+        if (benchmark_options.iterations == 0) {
+            throw std::invalid_argument("--iterations must be at least 1");
+        }
+
+        ApplicationOptions options = ParseApplicationOptions(
+            static_cast<int>(application_arguments.size()),
+            application_arguments.data());
+
+        // The benchmarks always render headless, so they run on a software
+        // ICD in CI
+        benchmark_options.surface_extent =
+            options.headless_extent.value_or(benchmark_options.surface_extent);
+
+        BenchmarkReport report;
+
+        /* Production build: the settings are fixed at compile time, only the
+        options that are not part of the configuration are passed on */
+        ApplicationOptions production_options = options;
+        production_options.frames_in_flight.reset();
+        production_options.present_mode.reset();
+        production_options.validation.reset();
+        production_options.sample_count.reset();
+        production_options.draw_count = 1;
+        production_options.measure_latency = false;
+        production_options.resize_storm = false;
+
+        Renderer<ProductionConfig> production_renderer(production_options);
+        BenchmarkSuite<ProductionConfig>(production_renderer,
+                                         benchmark_options, "production")
+            .Run(report);
+
+        /* Diagnostic build: configured at runtime with the settings of the
+        production build, so the results only differ by the runtime checks */
+        ApplicationOptions diagnostic_options = production_options;
+        diagnostic_options.frames_in_flight =
+            ProductionConfig::FRAMES_IN_FLIGHT;
+        diagnostic_options.present_mode = ProductionConfig::PRESENT_MODE;
+        diagnostic_options.validation = ProductionConfig::ENABLE_VALIDATION;
+        diagnostic_options.sample_count = ProductionConfig::SAMPLE_COUNT;
+
+        Renderer<DiagnosticConfig> diagnostic_renderer(diagnostic_options);
+        BenchmarkSuite<DiagnosticConfig>(diagnostic_renderer,
+                                         benchmark_options, "diagnostic")
+            .Run(report);
+
+        if (benchmark_options.output.empty()) {
+            report.WriteJson(std::cout);
+        } else {
+            std::ofstream output(benchmark_options.output);
+            if (!output.is_open()) {
+                throw std::runtime_error("failed to open file: " +
+                                         benchmark_options.output + "!");
+            }
+            report.WriteJson(output);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,1290 @@
+/* Local header files */
+#include "benchmark_suite.hpp"
+
+#include "frustum_culling.hpp"
+#include "gltf_loader.hpp"
+#include "lod_generator.hpp"
+#include "lod_selection.hpp"
+#include "mesh_builder.hpp"
+#include "obj_loader.hpp"
+#include "occlusion_culling.hpp"
+#include "thread_pool.hpp"
+#include "vertex_conversion.hpp"
+
+/* Standard libraries */
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double MicrosecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start)
+        .count();
+}
+
+std::string EscapeJson(const std::string& text) {
+    /* Escape a string for a JSON string literal */
+    std::ostringstream escaped;
+
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                    << static_cast<int>(c);
+        } else {
+            escaped << c;
+        }
+    }
+
+    return escaped.str();
+}
+
+// Triangles drawn over the same pixels by the overdraw benchmark
+constexpr uint32_t BENCHMARK_OVERDRAW_LAYERS = 256;
+
+// Light counts of the lighting benchmark, each drawn forward and deferred
+constexpr std::array<uint32_t, 2> BENCHMARK_LIGHT_COUNTS = {64, 1024};
+
+// Layers of the occlusion benchmark, each a grid of triangles over the whole
+// view, see MakeOcclusionTestScene
+constexpr std::array<uint32_t, 2> BENCHMARK_OCCLUSION_LAYERS = {16, 64};
+
+// Capacities of the particle benchmark, and the frame rate its report
+// scales the particle counts to
+constexpr std::array<uint32_t, 3> BENCHMARK_PARTICLE_CAPACITIES = {
+    262144, 1048576, 4194304};
+constexpr double BENCHMARK_PARTICLE_TARGET_FPS = 60.0;
+
+// CPU time the performance overlay may add to a frame, in microseconds
+constexpr double BENCHMARK_HUD_BUDGET_US = 50.0;
+
+// Descriptor sets a frame of the descriptor benchmarks allocates
+constexpr uint32_t BENCHMARK_DESCRIPTOR_SETS = 1000;
+
+// Objects of the culling benchmarks, about a sixteenth of them is in the view
+constexpr uint32_t BENCHMARK_CULLING_OBJECTS = 100000;
+
+// Objects of the level of detail benchmark, on a square grid in front of
+// the camera
+constexpr uint32_t BENCHMARK_LOD_OBJECTS = 10000;
+
+// Vertices per side of the grid mesh of the load benchmarks, 65536
+// vertices and about 130000 triangles
+constexpr uint32_t BENCHMARK_GRID_SIZE = 256;
+
+void WriteGridObj(const std::string& filename, uint32_t size) {
+    /* A wavy grid with positions, texture coordinates and normals */
+    std::ofstream file(filename);
+
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            float u = static_cast<float>(x) / static_cast<float>(size - 1);
+            float v = static_cast<float>(y) / static_cast<float>(size - 1);
+            file << "v " << u << " " << 0.1F * std::sin(u * 20.0F) << " " << v
+                 << "\n";
+            file << "vt " << u << " " << v << "\n";
+            file << "vn 0 1 0\n";
+        }
+    }
+
+    for (uint32_t y = 0; y + 1 < size; y++) {
+        for (uint32_t x = 0; x + 1 < size; x++) {
+            uint32_t corner = y * size + x + 1;
+            for (uint32_t index :
+                 {corner, corner + 1, corner + size + 1, corner + size}) {
+                file << (index == corner ? "f" : "") << " " << index << "/"
+                     << index << "/" << index;
+            }
+            file << "\n";
+        }
+    }
+}
+
+void WriteGridGltf(const std::string& filename, const std::string& bin_name,
+                   uint32_t size) {
+    /* The grid of WriteGridObj as a glTF file with float attributes and 32
+    bit indices in an external buffer */
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> uvs;
+    std::vector<uint32_t> indices;
+
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            float u = static_cast<float>(x) / static_cast<float>(size - 1);
+            float v = static_cast<float>(y) / static_cast<float>(size - 1);
+            positions.insert(positions.end(),
+                             {u, 0.1F * std::sin(u * 20.0F), v});
+            normals.insert(normals.end(), {0.0F, 1.0F, 0.0F});
+            uvs.insert(uvs.end(), {u, v});
+        }
+    }
+
+    for (uint32_t y = 0; y + 1 < size; y++) {
+        for (uint32_t x = 0; x + 1 < size; x++) {
+            uint32_t corner = y * size + x;
+            indices.insert(indices.end(),
+                           {corner, corner + 1, corner + size + 1, corner,
+                            corner + size + 1, corner + size});
+        }
+    }
+
+    std::filesystem::path bin_path =
+        std::filesystem::path(filename).parent_path() / bin_name;
+    std::ofstream bin(bin_path, std::ios::binary | std::ios::trunc);
+    std::ostringstream views;
+    size_t offset = 0;
+
+    auto write_view = [&](const void* data, size_t length) {
+        bin.write(static_cast<const char*>(data),
+                  static_cast<std::streamsize>(length));
+        views << (offset == 0 ? "" : ",") << "{\"buffer\":0,\"byteOffset\":"
+              << offset << ",\"byteLength\":" << length << "}";
+        offset += length;
+    };
+
+    write_view(positions.data(), positions.size() * sizeof(float));
+    write_view(normals.data(), normals.size() * sizeof(float));
+    write_view(uvs.data(), uvs.size() * sizeof(float));
+    write_view(indices.data(), indices.size() * sizeof(uint32_t));
+
+    size_t vertex_count = size_t{size} * size;
+    std::ofstream file(filename, std::ios::trunc);
+    file << "{\"asset\":{\"version\":\"2.0\"},"
+         << "\"buffers\":[{\"uri\":\"" << bin_name
+         << "\",\"byteLength\":" << offset << "}],"
+         << "\"bufferViews\":[" << views.str() << "],"
+         << "\"accessors\":["
+         << "{\"bufferView\":0,\"componentType\":5126,\"count\":"
+         << vertex_count << ",\"type\":\"VEC3\","
+         << "\"min\":[0,-0.1,0],\"max\":[1,0.1,1]},"
+         << "{\"bufferView\":1,\"componentType\":5126,\"count\":"
+         << vertex_count << ",\"type\":\"VEC3\"},"
+         << "{\"bufferView\":2,\"componentType\":5126,\"count\":"
+         << vertex_count << ",\"type\":\"VEC2\"},"
+         << "{\"bufferView\":3,\"componentType\":5125,\"count\":"
+         << indices.size() << ",\"type\":\"SCALAR\"}],"
+         << "\"meshes\":[{\"primitives\":[{\"attributes\":{"
+         << "\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},"
+         << "\"indices\":3}]}]}";
+}
+
+}  // namespace
+
+void BenchmarkReport::WriteJson(std::ostream& out) const {
+    out << "{\n";
+    out << "  \"device\": \"" << EscapeJson(device_name) << "\",\n";
+    out << "  \"driver_version\": \"" << driver_version << "\",\n";
+    out << "  \"unit\": \"us\",\n";
+    out << "  \"benchmarks\": [";
+
+    out << std::fixed << std::setprecision(3);
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const SampleSummary& summary = results[i].summary;
+
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"name\": \"" << EscapeJson(results[i].name)
+            << "\", \"iterations\": " << summary.count
+            << ", \"mean\": " << summary.mean
+            << ", \"stddev\": " << summary.stddev
+            << ", \"min\": " << summary.min << ", \"p50\": " << summary.p50
+            << ", \"p90\": " << summary.p90 << ", \"p99\": " << summary.p99
+            << ", \"max\": " << summary.max << "}";
+    }
+
+    out << "\n  ]\n";
+    out << "}\n";
+}
+
+template <typename Config>
+BenchmarkSuite<Config>::BenchmarkSuite(Renderer<Config>& renderer,
+                                       const BenchmarkOptions& options,
+                                       std::string configuration_name)
+    : renderer(renderer),
+      options(options),
+      configuration_name(std::move(configuration_name)) {}
+
+template <typename Config>
+void BenchmarkSuite<Config>::Run(BenchmarkReport& report) {
+    renderer.Initialize(MakeHeadlessSurface(options.surface_extent));
+
+    // Identify the device in the report, results are only comparable between
+    // runs on the same driver
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(renderer.physical_device, &properties);
+    report.device_name = properties.deviceName;
+    report.driver_version = std::to_string(properties.driverVersion);
+
+    CreateFenceObjects();
+
+    BenchmarkRecordCommandBuffer(1);
+
+    // The compile time configuration always records a single draw
+    if constexpr (Config::RUNTIME_CONFIGURED) {
+        BenchmarkRecordCommandBuffer(100);
+        BenchmarkRecordCommandBuffer(10000);
+    }
+
+    for (uint32_t command_buffer_count : {1U, 8U}) {
+        BenchmarkCommandReset(false, command_buffer_count);
+        BenchmarkCommandReset(true, command_buffer_count);
+    }
+
+    BenchmarkDrawFrame();
+    BenchmarkHudUpdate();
+    BenchmarkRecreateSwapChain();
+    BenchmarkCreateShaderModule();
+    BenchmarkCreatePipeline(false);
+    BenchmarkCreatePipeline(true);
+    BenchmarkAsyncPipeline();
+    BenchmarkDescriptorAllocation(false);
+    BenchmarkDescriptorAllocation(true);
+    BenchmarkFenceRoundTrip();
+    BenchmarkMeshLoad();
+    BenchmarkGltfLoad();
+
+    // The scene benchmarks draw many layers, the compile time configuration
+    // always records a single draw
+    if constexpr (Config::RUNTIME_CONFIGURED) {
+        BenchmarkOverdraw();
+        BenchmarkLighting();
+        BenchmarkOcclusion();
+    }
+
+    // The particles and the culling do not depend on the configuration, they
+    // are measured once
+    if constexpr (Config::RUNTIME_CONFIGURED) {
+        BenchmarkParticles();
+        BenchmarkFrustumCulling();
+        BenchmarkLodSelection();
+    }
+
+    vkDeviceWaitIdle(renderer.device);
+
+    DestroyFenceObjects();
+    renderer.Shutdown();
+
+    report.results.insert(report.results.end(), results.begin(),
+                          results.end());
+}
+
+template <typename Config>
+bool BenchmarkSuite<Config>::IsSelected(const std::string& name) const {
+    return options.filter.empty() ||
+           name.find(options.filter) != std::string::npos;
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::Measure(
+    const std::string& benchmark, const std::function<double()>& iteration) {
+    std::string name = configuration_name + "/" + benchmark;
+
+    if (!IsSelected(name)) {
+        return;
+    }
+
+    // Warm up the caches of the driver and the CPU before timing
+    for (uint32_t i = 0; i < options.warmup_iterations; i++) {
+        iteration();
+    }
+
+    std::vector<double> samples;
+    samples.reserve(options.iterations);
+
+    for (uint32_t i = 0; i < options.iterations; i++) {
+        samples.push_back(iteration());
+    }
+
+    results.push_back({name, Summarize(samples)});
+
+    // Progress goes to the error stream, the standard output is reserved for
+    // the JSON report
+    std::cerr << name << ": p50 " << results.back().summary.p50 << " us"
+              << std::endl;
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkRecordCommandBuffer(
+    uint32_t draw_count) {
+    /* Record the command buffer of the current frame without submitting it */
+    uint32_t frame = renderer.current_frame;
+
+    // The command buffer may still be in use by the last submitted frame
+    vkWaitForFences(renderer.device, 1, &renderer.in_flight_fences[frame],
+                    VK_TRUE, UINT64_MAX);
+
+    uint32_t configured_draw_count = renderer.draw_count;
+    renderer.draw_count = draw_count;
+
+    Measure("record_command_buffer/" + std::to_string(draw_count), [&]() {
+        // Like a frame, every recording starts with the command buffers and
+        // the descriptor sets of the frame slot released
+        renderer.ResetFrameCommandPool(frame);
+        VkCommandBuffer command_buffer = renderer.AcquireCommandBuffer(frame);
+        renderer.frame_descriptors->ResetFrame(frame);
+
+        auto start = Clock::now();
+        renderer.RecordCommandBuffer(command_buffer, 0);
+        return MicrosecondsSince(start);
+    });
+
+    renderer.draw_count = configured_draw_count;
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkCommandReset(
+    bool pool_reset, uint32_t command_buffer_count) {
+    /* Reset and rerecord the command buffers of a frame, either each command
+    buffer with vkResetCommandBuffer from a pool created with
+    VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, or all of them with a
+    single vkResetCommandPool of a transient pool like the renderer does */
+    VkCommandPool pool = CreateCommandPool(
+        pool_reset ? VK_COMMAND_POOL_CREATE_TRANSIENT_BIT
+                   : VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+
+    VkCommandBufferAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    alloc_info.commandPool = pool;
+    alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    alloc_info.commandBufferCount = command_buffer_count;
+
+    std::vector<VkCommandBuffer> command_buffers(command_buffer_count);
+    if (vkAllocateCommandBuffers(renderer.device, &alloc_info,
+                                 command_buffers.data()) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkAllocateCommandBuffers Error: failed to allocate command "
+            "buffers!");
+    }
+
+    std::string name = std::string("command_reset/") +
+                       (pool_reset ? "pool/" : "buffer/") +
+                       std::to_string(command_buffer_count);
+
+    Measure(name, [&]() {
+        auto start = Clock::now();
+        if (pool_reset) {
+            vkResetCommandPool(renderer.device, pool, 0);
+        }
+
+        for (VkCommandBuffer command_buffer : command_buffers) {
+            if (!pool_reset) {
+                vkResetCommandBuffer(command_buffer, 0);
+            }
+            renderer.RecordCommandBuffer(command_buffer, 0);
+        }
+        return MicrosecondsSince(start);
+    });
+
+    // Destroying the pool frees its command buffers
+    vkDestroyCommandPool(renderer.device, pool, nullptr);
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkDrawFrame() {
+    /* CPU time of a whole frame: wait, acquire, record, submit and present */
+    Measure("draw_frame", [&]() {
+        auto start = Clock::now();
+        if (renderer.BeginFrame()) {
+            renderer.Submit();
+            renderer.EndFrame();
+        }
+        return MicrosecondsSince(start);
+    });
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkHudUpdate() {
+    /* CPU time the performance overlay adds to a frame: the timestamp
+    readback, the quads of the frame and, twice a second, the text. The draw
+    itself is a handful of commands. */
+    std::string name = "hud/update";
+    if (!IsSelected(configuration_name + "/" + name)) {
+        return;
+    }
+
+    // The quads of the frame slot are rewritten, it must be idle
+    vkDeviceWaitIdle(renderer.device);
+
+    bool created = renderer.hud == nullptr;
+    if (created) {
+        renderer.CreateHud();
+    }
+
+    bool created_queries = renderer.timestamp_query_pool == VK_NULL_HANDLE;
+    if (created_queries) {
+        renderer.CreateTimestampQueries();
+    }
+
+    Measure(name, [&]() {
+        auto start = Clock::now();
+        renderer.MeasureFrameTimings();
+        renderer.UpdateHud();
+        return MicrosecondsSince(start);
+    });
+
+    double p99 = results.back().summary.p99;
+    std::cerr << name << ": p99 " << p99 << " us of the "
+              << BENCHMARK_HUD_BUDGET_US << " us budget"
+              << (p99 <= BENCHMARK_HUD_BUDGET_US ? "" : ", over budget")
+              << std::endl;
+
+    if (created_queries) {
+        vkDestroyQueryPool(renderer.device, renderer.timestamp_query_pool,
+                           nullptr);
+        renderer.timestamp_query_pool = VK_NULL_HANDLE;
+    }
+
+    if (created) {
+        renderer.DestroyHud();
+    }
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkOverdraw() {
+    /* BENCHMARK_OVERDRAW_LAYERS triangles over the same pixels, drawn back
+    to front, the worst case of the depth test: drawn once every layer is
+    nearer than the last one and shaded, with the pre-pass only the nearest
+    layer is shaded. The frame is waited for, so the time includes the GPU
+    work. */
+    auto vert_shader_code = Renderer<Config>::ReadFile("shaders/vert.spv");
+    auto frag_shader_code = Renderer<Config>::ReadFile("shaders/frag.spv");
+
+    VkShaderModule vert_shader_module =
+        renderer.CreateShaderModule(vert_shader_code);
+    VkShaderModule frag_shader_module =
+        renderer.CreateShaderModule(frag_shader_code);
+
+    VkPipeline depth_prepass_pipeline = renderer.depth_prepass_pipeline;
+    VkPipeline depth_shading_pipeline = renderer.depth_shading_pipeline;
+    uint32_t draw_count = renderer.draw_count;
+    renderer.draw_count = BENCHMARK_OVERDRAW_LAYERS;
+
+    double single_p50 = 0.0;
+
+    // Without a pre-pass the graphics pipeline of the renderer is drawn
+    for (bool depth_prepass : {false, true}) {
+        renderer.depth_prepass_pipeline =
+            depth_prepass ? renderer.CreatePipeline(
+                                vert_shader_module, VK_NULL_HANDLE,
+                                renderer.pipeline_cache, DepthPass::PRE_PASS)
+                          : VK_NULL_HANDLE;
+        renderer.depth_shading_pipeline =
+            depth_prepass ? renderer.CreatePipeline(
+                                vert_shader_module, frag_shader_module,
+                                renderer.pipeline_cache, DepthPass::SHADING)
+                          : VK_NULL_HANDLE;
+
+        std::string name = "overdraw/" +
+                           std::to_string(BENCHMARK_OVERDRAW_LAYERS) +
+                           (depth_prepass ? "/prepass" : "/single");
+
+        Measure(name, [&]() {
+            auto start = Clock::now();
+            if (renderer.BeginFrame()) {
+                renderer.Submit();
+                renderer.EndFrame();
+            }
+            vkDeviceWaitIdle(renderer.device);
+            return MicrosecondsSince(start);
+        });
+
+        vkDeviceWaitIdle(renderer.device);
+        vkDestroyPipeline(renderer.device, renderer.depth_shading_pipeline,
+                          nullptr);
+        vkDestroyPipeline(renderer.device, renderer.depth_prepass_pipeline,
+                          nullptr);
+
+        if (!IsSelected(configuration_name + "/" + name)) {
+            continue;
+        }
+
+        double p50 = results.back().summary.p50;
+        if (!depth_prepass) {
+            single_p50 = p50;
+        } else if (single_p50 > 0.0) {
+            std::cerr << name << ": " << single_p50 / p50
+                      << "x the frame rate of drawing once" << std::endl;
+        }
+    }
+
+    renderer.depth_prepass_pipeline = depth_prepass_pipeline;
+    renderer.depth_shading_pipeline = depth_shading_pipeline;
+    renderer.draw_count = draw_count;
+
+    vkDestroyShaderModule(renderer.device, frag_shader_module, nullptr);
+    vkDestroyShaderModule(renderer.device, vert_shader_module, nullptr);
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkLighting() {
+    /* BENCHMARK_OVERDRAW_LAYERS lit triangles over the same pixels, drawn
+    back to front so every layer passes the depth test. The forward path
+    adds up all lights in every fragment of every layer, the deferred path
+    only writes the G-buffer per layer and lights each pixel once. The render
+    pass is rebuilt for every path, the frame is waited for. */
+
+    uint32_t lights = renderer.options.lights;
+    bool deferred = renderer.options.deferred;
+    uint32_t draw_count = renderer.draw_count;
+    renderer.draw_count = BENCHMARK_OVERDRAW_LAYERS;
+    bool rebuilt = false;
+
+    for (uint32_t light_count : BENCHMARK_LIGHT_COUNTS) {
+        double forward_p50 = 0.0;
+
+        for (bool deferred_path : {false, true}) {
+            std::string name = "lighting/" + std::to_string(light_count) +
+                               (deferred_path ? "/deferred" : "/forward");
+            if (!IsSelected(configuration_name + "/" + name)) {
+                continue;
+            }
+
+            vkDeviceWaitIdle(renderer.device);
+            renderer.options.lights = light_count;
+            renderer.options.deferred = deferred_path;
+            renderer.RebuildRenderPass();
+            rebuilt = true;
+
+            // The pre-pass pipelines are published at the first frame
+            renderer.pipeline_compiler->WaitAll();
+
+            Measure(name, [&]() {
+                auto start = Clock::now();
+                if (renderer.BeginFrame()) {
+                    renderer.Submit();
+                    renderer.EndFrame();
+                }
+                vkDeviceWaitIdle(renderer.device);
+                return MicrosecondsSince(start);
+            });
+
+            double p50 = results.back().summary.p50;
+            if (!deferred_path) {
+                forward_p50 = p50;
+            } else if (forward_p50 > 0.0) {
+                std::cerr << name << ": " << forward_p50 / p50
+                          << "x the frame rate of forward shading"
+                          << std::endl;
+            }
+        }
+    }
+
+    renderer.draw_count = draw_count;
+
+    if (rebuilt) {
+        vkDeviceWaitIdle(renderer.device);
+        renderer.options.lights = lights;
+        renderer.options.deferred = deferred;
+        renderer.RebuildRenderPass();
+    }
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkOcclusion() {
+    /* The layers of the dense test scene are drawn back to front, so
+    without culling every layer passes the depth test and is shaded. With
+    culling the pyramid of the previous frame hides all but the nearest
+    layer. The render pass is rebuilt with and without culling and the test
+    scene replaces the scene pipeline and the draws of the culler. The GPU
+    time of the frame command buffer is read from the timestamps of the
+    renderer after the frame was waited for. The culling has no pre-pass
+    and no deferred path, both are turned off for the runs. */
+
+    auto vert_shader_code =
+        Renderer<Config>::ReadFile("shaders/occlusion_test_vert.spv");
+    auto frag_shader_code = Renderer<Config>::ReadFile("shaders/frag.spv");
+
+    VkShaderModule vert_shader_module =
+        renderer.CreateShaderModule(vert_shader_code);
+    VkShaderModule frag_shader_module =
+        renderer.CreateShaderModule(frag_shader_code);
+
+    bool occlusion_culling = renderer.options.occlusion_culling;
+    bool depth_prepass = renderer.options.depth_prepass;
+    bool deferred = renderer.options.deferred;
+    uint32_t draw_count = renderer.draw_count;
+    bool rebuilt = false;
+
+    bool created_queries = renderer.timestamp_query_pool == VK_NULL_HANDLE;
+    if (created_queries) {
+        renderer.CreateTimestampQueries();
+    }
+
+    for (uint32_t layers : BENCHMARK_OCCLUSION_LAYERS) {
+        double off_ms = -1.0;
+
+        for (bool culled : {false, true}) {
+            std::string name = "occlusion/" + std::to_string(layers) +
+                               (culled ? "/on" : "/off");
+            if (!IsSelected(configuration_name + "/" + name)) {
+                continue;
+            }
+
+            vkDeviceWaitIdle(renderer.device);
+            renderer.options.occlusion_culling = culled;
+            renderer.options.depth_prepass = false;
+            renderer.options.deferred = false;
+            renderer.RebuildRenderPass();
+            rebuilt = true;
+
+            VkPipeline graphics_pipeline = renderer.graphics_pipeline;
+            VkPipeline proxy_pipeline = renderer.occlusion_proxy_pipeline;
+            renderer.graphics_pipeline = renderer.CreatePipeline(
+                vert_shader_module, frag_shader_module,
+                renderer.pipeline_cache, DepthPass::SINGLE);
+            if (culled) {
+                renderer.occlusion_proxy_pipeline = renderer.CreatePipeline(
+                    vert_shader_module, frag_shader_module,
+                    renderer.pipeline_cache, DepthPass::PROXY);
+                renderer.occlusion_culler->SetDraws(
+                    MakeOcclusionTestScene(layers));
+            }
+            renderer.draw_count =
+                layers * OCCLUSION_TEST_GRID * OCCLUSION_TEST_GRID;
+
+            // The warm-up frames build the first pyramid, they are left out
+            // of the culling statistics and the GPU times
+            uint32_t iteration_index = 0;
+            std::vector<double> gpu_samples;
+
+            Measure(name, [&]() {
+                bool warm = iteration_index >= options.warmup_iterations;
+                if (culled && iteration_index == options.warmup_iterations) {
+                    renderer.occlusion_culler->ResetStatistics();
+                }
+                iteration_index++;
+
+                uint32_t frame = renderer.current_frame;
+                auto start = Clock::now();
+                bool rendered = renderer.BeginFrame();
+                if (rendered) {
+                    renderer.Submit();
+                    renderer.EndFrame();
+                }
+                vkDeviceWaitIdle(renderer.device);
+                double elapsed = MicrosecondsSince(start);
+
+                double gpu_ms =
+                    rendered ? renderer.ReadGpuFrameTime(frame) : -1.0;
+                if (warm && gpu_ms >= 0.0) {
+                    gpu_samples.push_back(gpu_ms);
+                }
+                return elapsed;
+            });
+
+            vkDeviceWaitIdle(renderer.device);
+
+            // Without timestamps the frame time is compared instead
+            bool gpu_timed = !gpu_samples.empty();
+            double frame_ms = gpu_timed ? Summarize(gpu_samples).p50
+                                        : results.back().summary.p50 / 1000.0;
+
+            if (!culled) {
+                off_ms = frame_ms;
+            } else {
+                OcclusionStatistics statistics =
+                    renderer.occlusion_culler->GetStatistics();
+                std::cerr << name << ": " << 100.0 * statistics.culled
+                          << "% of " << statistics.draws << " draws culled ("
+                          << 100.0 * statistics.query_skipped
+                          << "% by the queries)";
+                if (off_ms >= 0.0) {
+                    std::cerr << ", " << off_ms - frame_ms
+                              << (gpu_timed ? " GPU" : " frame")
+                              << " ms saved (" << off_ms << " -> "
+                              << frame_ms << " ms)";
+                }
+                std::cerr << std::endl;
+            }
+
+            vkDestroyPipeline(renderer.device, renderer.graphics_pipeline,
+                              nullptr);
+            renderer.graphics_pipeline = graphics_pipeline;
+            if (culled) {
+                vkDestroyPipeline(renderer.device,
+                                  renderer.occlusion_proxy_pipeline, nullptr);
+                renderer.occlusion_proxy_pipeline = proxy_pipeline;
+            }
+        }
+    }
+
+    renderer.draw_count = draw_count;
+
+    if (rebuilt) {
+        vkDeviceWaitIdle(renderer.device);
+        renderer.options.occlusion_culling = occlusion_culling;
+        renderer.options.depth_prepass = depth_prepass;
+        renderer.options.deferred = deferred;
+        renderer.RebuildRenderPass();
+    }
+
+    if (created_queries) {
+        vkDestroyQueryPool(renderer.device, renderer.timestamp_query_pool,
+                           nullptr);
+        renderer.timestamp_query_pool = VK_NULL_HANDLE;
+    }
+
+    vkDestroyShaderModule(renderer.device, frag_shader_module, nullptr);
+    vkDestroyShaderModule(renderer.device, vert_shader_module, nullptr);
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkParticles() {
+    /* Whole frames with a full particle buffer of each capacity, waited for
+    so the time includes the simulation and the draw on the GPU. The report
+    scales the capacity to the particles a frame of the target frame rate
+    holds, assuming the time grows linearly with the particles. */
+    auto particle_system = std::move(renderer.particle_system);
+
+    for (uint32_t capacity : BENCHMARK_PARTICLE_CAPACITIES) {
+        std::string name = "particles/" + std::to_string(capacity);
+        if (!IsSelected(configuration_name + "/" + name)) {
+            continue;
+        }
+
+        renderer.CreateParticleSystem(capacity);
+
+        Measure(name, [&]() {
+            auto start = Clock::now();
+            if (renderer.BeginFrame()) {
+                renderer.Submit();
+                renderer.EndFrame();
+            }
+            vkDeviceWaitIdle(renderer.device);
+            return MicrosecondsSince(start);
+        });
+
+        vkDeviceWaitIdle(renderer.device);
+
+        double p50 = results.back().summary.p50;
+        double frame_budget = 1000000.0 / BENCHMARK_PARTICLE_TARGET_FPS;
+        // Count read back by the last frame, the slot before the current one
+        uint32_t frames_in_flight = renderer.FramesInFlight();
+        uint32_t alive_count = renderer.particle_system->GetAliveCount(
+            (renderer.current_frame + frames_in_flight - 1) %
+            frames_in_flight);
+
+        std::cerr << name << ": " << alive_count << " particles alive, about "
+                  << static_cast<uint64_t>(capacity * frame_budget / p50)
+                  << " particles per frame at " << BENCHMARK_PARTICLE_TARGET_FPS
+                  << " fps" << std::endl;
+
+        renderer.DestroyParticleSystem();
+    }
+
+    renderer.particle_system = std::move(particle_system);
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkRecreateSwapChain() {
+    Measure("recreate_swap_chain", [&]() {
+        auto start = Clock::now();
+        renderer.RecreateSwapChain();
+        return MicrosecondsSince(start);
+    });
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkCreateShaderModule() {
+    auto vert_shader_code = Renderer<Config>::ReadFile("shaders/vert.spv");
+
+    Measure("create_shader_module", [&]() {
+        auto start = Clock::now();
+        VkShaderModule shader_module =
+            renderer.CreateShaderModule(vert_shader_code);
+        double elapsed = MicrosecondsSince(start);
+
+        vkDestroyShaderModule(renderer.device, shader_module, nullptr);
+        return elapsed;
+    });
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkCreatePipeline(bool cached) {
+    /* A cold pipeline is created without a pipeline cache, a cached pipeline
+    with the cache that already holds the pipeline of the application. Drivers
+    may keep an internal cache as well, so cold is an upper bound of what the
+    application can save. */
+    auto vert_shader_code = Renderer<Config>::ReadFile("shaders/vert.spv");
+    auto frag_shader_code = Renderer<Config>::ReadFile("shaders/frag.spv");
+
+    VkShaderModule vert_shader_module =
+        renderer.CreateShaderModule(vert_shader_code);
+    VkShaderModule frag_shader_module =
+        renderer.CreateShaderModule(frag_shader_code);
+
+    VkPipelineCache cache = cached ? renderer.pipeline_cache : VK_NULL_HANDLE;
+
+    Measure(cached ? "create_pipeline/cached" : "create_pipeline/cold",
+            [&]() {
+                auto start = Clock::now();
+                VkPipeline pipeline = renderer.CreatePipeline(
+                    vert_shader_module, frag_shader_module, cache,
+                    DepthPass::SINGLE);
+                double elapsed = MicrosecondsSince(start);
+
+                vkDestroyPipeline(renderer.device, pipeline, nullptr);
+                return elapsed;
+            });
+
+    vkDestroyShaderModule(renderer.device, frag_shader_module, nullptr);
+    vkDestroyShaderModule(renderer.device, vert_shader_module, nullptr);
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkAsyncPipeline() {
+    /* The longest frame while a cold pipeline compiles on the pipeline
+    compiler, including the request, against the inline creation of
+    create_pipeline/cold. A compiler of its own keeps the pipelines of the
+    iterations apart from the renderer. */
+    auto vert_shader_code = Renderer<Config>::ReadFile("shaders/vert.spv");
+    auto frag_shader_code = Renderer<Config>::ReadFile("shaders/frag.spv");
+
+    VkShaderModule vert_shader_module =
+        renderer.CreateShaderModule(vert_shader_code);
+    VkShaderModule frag_shader_module =
+        renderer.CreateShaderModule(frag_shader_code);
+
+    PipelineCompiler compiler(renderer.device);
+
+    Measure("create_pipeline/async_frame", [&]() {
+        auto start = Clock::now();
+        PipelineCompiler::Handle handle = compiler.Request(
+            "benchmark",
+            [&]() {
+                return renderer.CreatePipeline(vert_shader_module,
+                                               frag_shader_module,
+                                               VK_NULL_HANDLE,
+                                               DepthPass::SINGLE);
+            },
+            renderer.graphics_pipeline);
+        double longest = MicrosecondsSince(start);
+
+        while (!compiler.IsReady(handle)) {
+            auto frame_start = Clock::now();
+            compiler.PublishReady();
+            if (renderer.BeginFrame()) {
+                renderer.Submit();
+                renderer.EndFrame();
+            }
+            longest = std::max(longest, MicrosecondsSince(frame_start));
+        }
+
+        return longest;
+    });
+
+    vkDeviceWaitIdle(renderer.device);
+    compiler.Destroy();
+
+    vkDestroyShaderModule(renderer.device, frag_shader_module, nullptr);
+    vkDestroyShaderModule(renderer.device, vert_shader_module, nullptr);
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkDescriptorAllocation(bool frame_pools) {
+    /* Allocate and release the descriptor sets of a frame, either linearly
+    from the pools of a DescriptorAllocator released with a single
+    vkResetDescriptorPool, or one by one from a pool created with
+    VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT and freed one by one.
+    The sets have the bindings of a material: a uniform buffer and two
+    textures. */
+    std::string name = std::string("descriptor_alloc/") +
+                       (frame_pools ? "frame_pool/" : "free/") +
+                       std::to_string(BENCHMARK_DESCRIPTOR_SETS);
+    if (!IsSelected(configuration_name + "/" + name)) {
+        return;
+    }
+
+    std::vector<VkDescriptorSetLayoutBinding> bindings(2);
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[1].descriptorCount = 2;
+    bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayout layout =
+        renderer.GetDescriptorLayoutCache().Get(bindings);
+
+    if (frame_pools) {
+        DescriptorAllocator allocator(renderer.device, 1);
+
+        Measure(name, [&]() {
+            auto start = Clock::now();
+            allocator.ResetFrame(0);
+            for (uint32_t i = 0; i < BENCHMARK_DESCRIPTOR_SETS; i++) {
+                allocator.Allocate(layout);
+            }
+            return MicrosecondsSince(start);
+        });
+
+        allocator.Destroy();
+        return;
+    }
+
+    std::array<VkDescriptorPoolSize, 2> pool_sizes = {{
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, BENCHMARK_DESCRIPTOR_SETS},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+         2 * BENCHMARK_DESCRIPTOR_SETS},
+    }};
+
+    VkDescriptorPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    pool_info.maxSets = BENCHMARK_DESCRIPTOR_SETS;
+    pool_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+    pool_info.pPoolSizes = pool_sizes.data();
+
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    if (vkCreateDescriptorPool(renderer.device, &pool_info, nullptr, &pool) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateDescriptorPool Error: failed to create descriptor pool!");
+    }
+
+    std::vector<VkDescriptorSet> sets(BENCHMARK_DESCRIPTOR_SETS);
+
+    VkDescriptorSetAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.descriptorPool = pool;
+    alloc_info.descriptorSetCount = 1;
+    alloc_info.pSetLayouts = &layout;
+
+    Measure(name, [&]() {
+        auto start = Clock::now();
+        for (VkDescriptorSet& set : sets) {
+            if (vkAllocateDescriptorSets(renderer.device, &alloc_info, &set) !=
+                VK_SUCCESS) {
+                throw std::runtime_error(
+                    "vkAllocateDescriptorSets Error: failed to allocate "
+                    "descriptor set!");
+            }
+        }
+        for (VkDescriptorSet set : sets) {
+            vkFreeDescriptorSets(renderer.device, pool, 1, &set);
+        }
+        return MicrosecondsSince(start);
+    });
+
+    vkDestroyDescriptorPool(renderer.device, pool, nullptr);
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkFenceRoundTrip() {
+    /* Submit an empty command buffer and wait for its fence, the latency of
+    the smallest possible piece of GPU work */
+    VkSubmitInfo submit_info{};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &empty_command_buffer;
+
+    // The frames of the earlier benchmarks must not be part of the first
+    // round trip
+    vkDeviceWaitIdle(renderer.device);
+
+    Measure("fence_round_trip", [&]() {
+        auto start = Clock::now();
+        if (vkQueueSubmit(renderer.graphics_queue, 1, &submit_info, fence) !=
+            VK_SUCCESS) {
+            throw std::runtime_error(
+                "vkQueueSubmit Error: failed to submit empty command buffer!");
+        }
+        vkWaitForFences(renderer.device, 1, &fence, VK_TRUE, UINT64_MAX);
+        double elapsed = MicrosecondsSince(start);
+
+        vkResetFences(renderer.device, 1, &fence);
+        return elapsed;
+    });
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkMeshLoad() {
+    /* Load the same mesh from a Wavefront OBJ and from the binary container,
+    each to device local memory. The OBJ is parsed and converted like the
+    converter tool does, the binary mesh is mapped and copied as it is. */
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    std::string obj_filename = (directory / "benchmark_mesh.obj").string();
+    std::string mesh_filename = (directory / "benchmark_mesh.vmesh").string();
+
+    WriteGridObj(obj_filename, BENCHMARK_GRID_SIZE);
+    WriteMeshFile(BuildMesh(LoadObjFile(obj_filename)), mesh_filename);
+
+    Measure("mesh_load/obj", [&]() {
+        auto start = Clock::now();
+        MeshData mesh = BuildMesh(LoadObjFile(obj_filename));
+
+        renderer.UploadMesh(mesh);
+        double elapsed = MicrosecondsSince(start);
+
+        renderer.DestroyMeshes();
+        return elapsed;
+    });
+
+    Measure("mesh_load/vmesh", [&]() {
+        auto start = Clock::now();
+        renderer.LoadMesh(mesh_filename);
+        double elapsed = MicrosecondsSince(start);
+
+        renderer.DestroyMeshes();
+        return elapsed;
+    });
+
+    std::filesystem::remove(obj_filename);
+    std::filesystem::remove(mesh_filename);
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkGltfLoad() {
+    /* The grid of the mesh load benchmarks from a glTF file, decoded on a
+    thread pool and uploaded like a binary mesh. The decode benchmarks report
+    microseconds per MB of source data, for 1 thread up to one thread per
+    hardware thread. */
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    std::string gltf_filename = (directory / "benchmark_mesh.gltf").string();
+    std::string bin_name = "benchmark_mesh.bin";
+
+    WriteGridGltf(gltf_filename, bin_name, BENCHMARK_GRID_SIZE);
+
+    ThreadPool hardware_pool;
+    double megabytes =
+        static_cast<double>(
+            LoadGltfFile(gltf_filename, hardware_pool).source_bytes) /
+        1.0e6;
+
+    Measure("mesh_load/gltf", [&]() {
+        auto start = Clock::now();
+        GltfScene scene = LoadGltfFile(gltf_filename, hardware_pool);
+
+        for (const auto& mesh : scene.meshes) {
+            renderer.UploadMesh(mesh);
+        }
+        double elapsed = MicrosecondsSince(start);
+
+        renderer.DestroyMeshes();
+        return elapsed;
+    });
+
+    std::vector<size_t> thread_counts = {1, 2, 4};
+    if (hardware_pool.GetThreadCount() > 4) {
+        thread_counts.push_back(hardware_pool.GetThreadCount());
+    }
+
+    for (size_t thread_count : thread_counts) {
+        ThreadPool thread_pool(thread_count);
+
+        Measure("gltf_decode_per_mb/threads/" + std::to_string(thread_count),
+                [&]() {
+                    auto start = Clock::now();
+                    LoadGltfFile(gltf_filename, thread_pool);
+                    return MicrosecondsSince(start) / megabytes;
+                });
+    }
+
+    std::cerr << "gltf_decode_per_mb: " << megabytes << " MB per load, "
+              << GetVertexConversionPath() << std::endl;
+
+    std::filesystem::remove(gltf_filename);
+    std::filesystem::remove(directory / bin_name);
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkFrustumCulling() {
+    /* Objects scattered in a cube around a perspective like frustum, culled
+    with every path the CPU supports. The throughput of each path is printed
+    as objects per microsecond together with the speedup over the scalar
+    path. */
+    CullingSet culling_set;
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> position(-2.0F, 2.0F);
+    std::uniform_real_distribution<float> size(0.01F, 0.1F);
+
+    for (uint32_t i = 0; i < BENCHMARK_CULLING_OBJECTS; i++) {
+        glm::vec3 center(position(random), position(random),
+                         position(random));
+        glm::vec3 half_extent(size(random), size(random), size(random));
+        float radius = std::sqrt(half_extent.x * half_extent.x +
+                                 half_extent.y * half_extent.y +
+                                 half_extent.z * half_extent.z);
+        culling_set.Add(center, radius, half_extent);
+    }
+
+    // Clip space is x and y in [-1, 1] and z in [0, 1], shifted by 0.5 in
+    // depth the visible box is a sixteenth of the cube
+    glm::mat4 view_projection(1.0F);
+    view_projection[3][2] = -0.5F;
+    Frustum frustum = ExtractFrustum(view_projection);
+
+    std::vector<uint32_t> visible(culling_set.GetPaddedSize());
+    double scalar_p50 = 0.0;
+
+    for (CullingPath path : GetSupportedCullingPaths()) {
+        std::string name = std::string("frustum_cull/") +
+                           CullingPathName(path) + "/" +
+                           std::to_string(BENCHMARK_CULLING_OBJECTS);
+        uint32_t visible_count = 0;
+
+        Measure(name, [&]() {
+            auto start = Clock::now();
+            visible_count = culling_set.Cull(frustum, visible.data(), path);
+            return MicrosecondsSince(start);
+        });
+
+        if (!IsSelected(configuration_name + "/" + name)) {
+            continue;
+        }
+
+        double p50 = results.back().summary.p50;
+        scalar_p50 = path == CullingPath::SCALAR ? p50 : scalar_p50;
+
+        std::cerr << name << ": " << BENCHMARK_CULLING_OBJECTS / p50
+                  << " objects/us, " << visible_count << " visible";
+        if (scalar_p50 > 0.0) {
+            std::cerr << ", " << scalar_p50 / p50 << "x scalar";
+        }
+        std::cerr << std::endl;
+    }
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::BenchmarkLodSelection() {
+    /* Instances of the grid mesh with generated levels of detail on a
+    square grid that starts at the camera, every object is visible. The
+    triangles of the selected levels are printed next to the triangles of
+    the full meshes. */
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    std::string obj_filename = (directory / "benchmark_lod.obj").string();
+
+    WriteGridObj(obj_filename, BENCHMARK_GRID_SIZE);
+    SourceMesh source = LoadObjFile(obj_filename);
+    MeshData mesh = BuildMesh(source, GenerateLods(source, 8));
+    std::filesystem::remove(obj_filename);
+
+    CullingSet culling_set;
+    LodSelector lod_selector;
+    lod_selector.SetChain(0, mesh.lods);
+
+    auto columns = static_cast<uint32_t>(
+        std::sqrt(static_cast<double>(BENCHMARK_LOD_OBJECTS)));
+    for (uint32_t i = 0; i < BENCHMARK_LOD_OBJECTS; i++) {
+        glm::vec3 center(
+            2.0F * (static_cast<float>(i % columns) -
+                    static_cast<float>(columns) / 2),
+            0.0F, -2.0F * static_cast<float>(i / columns) - 2.0F);
+        lod_selector.SetObjectChain(culling_set.Add(center, 0.75F), 0);
+    }
+
+    std::vector<uint32_t> visible(BENCHMARK_LOD_OBJECTS);
+    for (uint32_t i = 0; i < BENCHMARK_LOD_OBJECTS; i++) {
+        visible[i] = i;
+    }
+
+    // 1080 pixels high with a vertical field of view of 60 degrees
+    LodView view;
+    view.projection_scale = 1080.0F / 2.0F / std::tan(0.5236F);
+
+    std::string name =
+        "lod_select/" + std::to_string(BENCHMARK_LOD_OBJECTS);
+    Measure(name, [&]() {
+        auto start = Clock::now();
+        lod_selector.Select(view, culling_set, visible.data(),
+                            BENCHMARK_LOD_OBJECTS);
+        return MicrosecondsSince(start);
+    });
+
+    if (IsSelected(configuration_name + "/" + name)) {
+        auto selected = lod_selector.GetSelectedTriangles();
+        auto full = lod_selector.GetFullTriangles();
+
+        std::cerr << name << ": " << mesh.lods.size() << " levels, "
+                  << selected << " triangles selected, " << full
+                  << " without levels of detail ("
+                  << 100.0 * static_cast<double>(selected) /
+                         static_cast<double>(full)
+                  << "%)" << std::endl;
+    }
+}
+
+template <typename Config>
+VkCommandPool BenchmarkSuite<Config>::CreateCommandPool(
+    VkCommandPoolCreateFlags flags) {
+    /* Command pool of the suite, the pools of the renderer are reset by the
+    frames of the benchmarks */
+    typename Renderer<Config>::QueueFamilyIndices indices =
+        renderer.FindQueueFamilies(renderer.physical_device);
+
+    VkCommandPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    pool_info.flags = flags;
+    pool_info.queueFamilyIndex = indices.graphics_family.value();
+
+    VkCommandPool pool = VK_NULL_HANDLE;
+    if (vkCreateCommandPool(renderer.device, &pool_info, nullptr, &pool) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateCommandPool Error: failed to create command pool!");
+    }
+
+    return pool;
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::CreateFenceObjects() {
+    fence_command_pool = CreateCommandPool(0);
+
+    // Allocate a command buffer that is recorded once without commands
+    VkCommandBufferAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    alloc_info.commandPool = fence_command_pool;
+    alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    alloc_info.commandBufferCount = 1;
+
+    if (vkAllocateCommandBuffers(renderer.device, &alloc_info,
+                                 &empty_command_buffer) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkAllocateCommandBuffers Error: failed to allocate command "
+            "buffer!");
+    }
+
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+    if (vkBeginCommandBuffer(empty_command_buffer, &begin_info) !=
+            VK_SUCCESS ||
+        vkEndCommandBuffer(empty_command_buffer) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkBeginCommandBuffer Error: failed to record command buffer!");
+    }
+
+    // Unlike the frame fences this fence starts unsignaled
+    VkFenceCreateInfo fence_info{};
+    fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    if (vkCreateFence(renderer.device, &fence_info, nullptr, &fence) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateFence Error: failed to create fence!");
+    }
+}
+
+template <typename Config>
+void BenchmarkSuite<Config>::DestroyFenceObjects() {
+    vkDestroyFence(renderer.device, fence, nullptr);
+
+    // Destroying the pool frees the empty command buffer
+    vkDestroyCommandPool(renderer.device, fence_command_pool, nullptr);
+}
+
+template class BenchmarkSuite<ProductionConfig>;
+template class BenchmarkSuite<DiagnosticConfig>;
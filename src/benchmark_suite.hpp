@@ -0,0 +1,108 @@
+#ifndef BENCHMARK_SUITE_H
+#define BENCHMARK_SUITE_H
+
+/* Local header files */
+#include "frame_statistics.hpp"
+#include "renderer.hpp"
+
+/* Standard libraries */
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct BenchmarkOptions {
+    // Timed iterations per benchmark, preceded by untimed warm up iterations
+    uint32_t iterations = 200;
+    uint32_t warmup_iterations = 10;
+
+    // Only run the benchmarks whose name contains the filter
+    std::string filter;
+
+    // Write the JSON report to this file instead of the standard output
+    std::string output;
+
+    // Size of the headless surface the benchmarks render to
+    VkExtent2D surface_extent{800, 600};
+};
+
+struct BenchmarkResult {
+    std::string name;
+    SampleSummary summary;
+};
+
+// Results of the benchmark runs of all configurations
+struct BenchmarkReport {
+    std::string device_name;
+    std::string driver_version;
+    std::vector<BenchmarkResult> results;
+
+    void WriteJson(std::ostream& out) const;
+};
+
+/* Microbenchmarks of the frame hot path
+
+The suite initializes the renderer on a headless surface, so it runs on a
+software ICD such as lavapipe without a display server. Each benchmark times
+one step of the renderer per iteration and is reported in microseconds as a
+statistical summary, so the JSON report can be compared between runs.
+
+The suite runs for one renderer configuration, the benchmark names are
+prefixed with the name of the configuration.
+*/
+template <typename Config>
+class BenchmarkSuite {
+   public:
+    BenchmarkSuite(Renderer<Config>& renderer,
+                   const BenchmarkOptions& options,
+                   std::string configuration_name);
+
+    // Initialize the renderer, run the selected benchmarks, add their
+    // results to the report and clean up
+    void Run(BenchmarkReport& report);
+
+   private:
+    Renderer<Config>& renderer;
+    const BenchmarkOptions& options;
+    std::string configuration_name;
+    std::vector<BenchmarkResult> results;
+
+    // Empty command buffer and fence for the fence round trip
+    VkCommandPool fence_command_pool = VK_NULL_HANDLE;
+    VkCommandBuffer empty_command_buffer = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+
+    bool IsSelected(const std::string& name) const;
+
+    // Run an iteration function warmup_iterations + iterations times. The
+    // function returns the measured time of the iteration in microseconds,
+    // so setup and teardown within an iteration are not part of the sample.
+    void Measure(const std::string& name,
+                 const std::function<double()>& iteration);
+
+    void BenchmarkRecordCommandBuffer(uint32_t draw_count);
+    void BenchmarkCommandReset(bool pool_reset, uint32_t command_buffer_count);
+    void BenchmarkDrawFrame();
+    void BenchmarkHudUpdate();
+    void BenchmarkOverdraw();
+    void BenchmarkLighting();
+    void BenchmarkOcclusion();
+    void BenchmarkParticles();
+    void BenchmarkRecreateSwapChain();
+    void BenchmarkCreateShaderModule();
+    void BenchmarkCreatePipeline(bool cached);
+    void BenchmarkAsyncPipeline();
+    void BenchmarkDescriptorAllocation(bool frame_pools);
+    void BenchmarkFenceRoundTrip();
+    void BenchmarkMeshLoad();
+    void BenchmarkGltfLoad();
+    void BenchmarkFrustumCulling();
+    void BenchmarkLodSelection();
+
+    VkCommandPool CreateCommandPool(VkCommandPoolCreateFlags flags);
+    void CreateFenceObjects();
+    void DestroyFenceObjects();
+};
+
+#endif  // BENCHMARK_SUITE_H
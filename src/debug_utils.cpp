@@ -0,0 +1,51 @@
+/* Local header files */
+#include "debug_utils.hpp"
+
+void DebugUtils::Load(VkInstance instance, VkDevice device) {
+    this->device = device;
+
+    set_object_name = reinterpret_cast<PFN_vkSetDebugUtilsObjectNameEXT>(
+        vkGetInstanceProcAddr(instance, "vkSetDebugUtilsObjectNameEXT"));
+    begin_label = reinterpret_cast<PFN_vkCmdBeginDebugUtilsLabelEXT>(
+        vkGetInstanceProcAddr(instance, "vkCmdBeginDebugUtilsLabelEXT"));
+    end_label = reinterpret_cast<PFN_vkCmdEndDebugUtilsLabelEXT>(
+        vkGetInstanceProcAddr(instance, "vkCmdEndDebugUtilsLabelEXT"));
+}
+
+void DebugUtils::SetObjectName(VkObjectType type, uint64_t handle,
+                               const char* name) const {
+    if (set_object_name == nullptr || handle == 0) {
+        return;
+    }
+
+    VkDebugUtilsObjectNameInfoEXT name_info{};
+    name_info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
+    name_info.objectType = type;
+    name_info.objectHandle = handle;
+    name_info.pObjectName = name;
+
+    set_object_name(device, &name_info);
+}
+
+void DebugUtils::BeginLabel(VkCommandBuffer command_buffer, const char* name,
+                            const std::array<float, 4>& color) const {
+    if (begin_label == nullptr) {
+        return;
+    }
+
+    VkDebugUtilsLabelEXT label{};
+    label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+    label.pLabelName = name;
+    label.color[0] = color[0];
+    label.color[1] = color[1];
+    label.color[2] = color[2];
+    label.color[3] = color[3];
+
+    begin_label(command_buffer, &label);
+}
+
+void DebugUtils::EndLabel(VkCommandBuffer command_buffer) const {
+    if (end_label != nullptr) {
+        end_label(command_buffer);
+    }
+}
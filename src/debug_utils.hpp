@@ -0,0 +1,89 @@
+#ifndef DEBUG_UTILS_H
+#define DEBUG_UTILS_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Standard libraries */
+#include <array>
+#include <cstdint>  // Required for uint64_t
+#include <type_traits>
+
+// Colors of the command buffer regions in capture tools
+const std::array<float, 4> DEBUG_LABEL_COMPUTE = {0.9F, 0.5F, 0.1F, 1.0F};
+const std::array<float, 4> DEBUG_LABEL_DRAW = {0.2F, 0.6F, 0.9F, 1.0F};
+const std::array<float, 4> DEBUG_LABEL_TRANSFER = {0.4F, 0.8F, 0.3F, 1.0F};
+
+/* Object names and command buffer labels of VK_EXT_debug_utils
+
+Capture and profiling tools show the names instead of anonymous handles, and
+the labels as nested regions of a command buffer. The functions are loaded
+from the instance, without the extension they stay null and every call does
+nothing.
+*/
+class DebugUtils {
+   public:
+    // Load the functions, the extension must be enabled on the instance
+    void Load(VkInstance instance, VkDevice device);
+
+    bool IsEnabled() const { return set_object_name != nullptr; }
+
+    void SetObjectName(VkObjectType type, uint64_t handle,
+                       const char* name) const;
+
+    // Dispatchable handles are pointers, the others are pointers or 64 bit
+    // integers depending on the platform
+    template <typename Handle>
+    void SetObjectName(Handle handle, VkObjectType type,
+                       const char* name) const {
+        if constexpr (std::is_pointer_v<Handle>) {
+            SetObjectName(type, reinterpret_cast<uint64_t>(handle), name);
+        } else {
+            SetObjectName(type, static_cast<uint64_t>(handle), name);
+        }
+    }
+
+    void BeginLabel(VkCommandBuffer command_buffer, const char* name,
+                    const std::array<float, 4>& color) const;
+    void EndLabel(VkCommandBuffer command_buffer) const;
+
+   private:
+    VkDevice device = VK_NULL_HANDLE;
+    PFN_vkSetDebugUtilsObjectNameEXT set_object_name = nullptr;
+    PFN_vkCmdBeginDebugUtilsLabelEXT begin_label = nullptr;
+    PFN_vkCmdEndDebugUtilsLabelEXT end_label = nullptr;
+};
+
+/* Label region of a command buffer for the lifetime of the scope
+
+The disabled specialization is empty, so the labels compile to nothing in a
+configuration without them.
+*/
+template <bool Enabled>
+class DebugLabelScope {
+   public:
+    DebugLabelScope(const DebugUtils& debug_utils,
+                    VkCommandBuffer command_buffer, const char* name,
+                    const std::array<float, 4>& color)
+        : debug_utils(debug_utils), command_buffer(command_buffer) {
+        debug_utils.BeginLabel(command_buffer, name, color);
+    }
+    ~DebugLabelScope() { debug_utils.EndLabel(command_buffer); }
+
+    DebugLabelScope(const DebugLabelScope&) = delete;
+    DebugLabelScope& operator=(const DebugLabelScope&) = delete;
+
+   private:
+    const DebugUtils& debug_utils;
+    VkCommandBuffer command_buffer;
+};
+
+template <>
+class DebugLabelScope<false> {
+   public:
+    DebugLabelScope(const DebugUtils& /*debug_utils*/,
+                    VkCommandBuffer /*command_buffer*/, const char* /*name*/,
+                    const std::array<float, 4>& /*color*/) {}
+};
+
+#endif  // DEBUG_UTILS_H
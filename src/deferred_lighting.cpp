@@ -0,0 +1,201 @@
+/* Local header files */
+#include "deferred_lighting.hpp"
+
+/* Standard libraries */
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+DeferredLighting::DeferredLighting(VkDevice device) : device(device) {}
+
+void DeferredLighting::Destroy() {
+    // The set layout belongs to the layout cache
+    vkDestroyPipeline(device, pipeline, nullptr);
+    vkDestroyPipelineLayout(device, pipeline_layout, nullptr);
+    pipeline = VK_NULL_HANDLE;
+    pipeline_layout = VK_NULL_HANDLE;
+}
+
+void DeferredLighting::CreatePipeline(VkRenderPass render_pass,
+                                      VkPipelineCache cache,
+                                      DescriptorLayoutCache& layout_cache,
+                                      VkDescriptorSetLayout light_set_layout,
+                                      VkShaderModule vert_shader,
+                                      VkShaderModule frag_shader) {
+    /* The albedo, the normal and the depth at the bindings 0 to 2, in the
+    order of the input attachments of the subpass */
+    std::vector<VkDescriptorSetLayoutBinding> bindings(3);
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    }
+    input_set_layout = layout_cache.Get(bindings);
+
+    // The inverse extent turns the fragment coordinates into clip space
+    VkPushConstantRange push_constant_range{};
+    push_constant_range.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    push_constant_range.offset = 0;
+    push_constant_range.size = 2 * sizeof(float);
+
+    std::array<VkDescriptorSetLayout, 2> set_layouts = {input_set_layout,
+                                                        light_set_layout};
+
+    VkPipelineLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_info.setLayoutCount = static_cast<uint32_t>(set_layouts.size());
+    layout_info.pSetLayouts = set_layouts.data();
+    layout_info.pushConstantRangeCount = 1;
+    layout_info.pPushConstantRanges = &push_constant_range;
+
+    if (vkCreatePipelineLayout(device, &layout_info, nullptr,
+                               &pipeline_layout) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreatePipelineLayout Error: failed to create lighting pipeline "
+            "layout!");
+    }
+
+    std::array<VkPipelineShaderStageCreateInfo, 2> shader_stages{};
+    shader_stages[0].sType =
+        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shader_stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shader_stages[0].module = vert_shader;
+    shader_stages[0].pName = "main";
+    shader_stages[1].sType =
+        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shader_stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shader_stages[1].module = frag_shader;
+    shader_stages[1].pName = "main";
+
+    // The fullscreen triangle is built from the vertex index
+    VkPipelineVertexInputStateCreateInfo vertex_input_info{};
+    vertex_input_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+    VkPipelineInputAssemblyStateCreateInfo input_assembly{};
+    input_assembly.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkPipelineViewportStateCreateInfo viewport_state{};
+    viewport_state.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewport_state.viewportCount = 1;
+    viewport_state.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0F;
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+
+    // The G-buffer has one sample per pixel
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    multisampling.minSampleShading = 1.0F;
+
+    // The subpass has no depth attachment, the depth is an input
+    VkPipelineDepthStencilStateCreateInfo depth_stencil{};
+    depth_stencil.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depth_stencil.depthTestEnable = VK_FALSE;
+    depth_stencil.depthWriteEnable = VK_FALSE;
+
+    VkPipelineColorBlendAttachmentState color_blend_attachment{};
+    color_blend_attachment.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    color_blend_attachment.blendEnable = VK_FALSE;
+
+    VkPipelineColorBlendStateCreateInfo color_blending{};
+    color_blending.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    color_blending.attachmentCount = 1;
+    color_blending.pAttachments = &color_blend_attachment;
+
+    std::array<VkDynamicState, 2> dynamic_states = {VK_DYNAMIC_STATE_VIEWPORT,
+                                                    VK_DYNAMIC_STATE_SCISSOR};
+
+    VkPipelineDynamicStateCreateInfo dynamic_state{};
+    dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamic_state.dynamicStateCount =
+        static_cast<uint32_t>(dynamic_states.size());
+    dynamic_state.pDynamicStates = dynamic_states.data();
+
+    VkGraphicsPipelineCreateInfo pipeline_info{};
+    pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipeline_info.stageCount = static_cast<uint32_t>(shader_stages.size());
+    pipeline_info.pStages = shader_stages.data();
+    pipeline_info.pVertexInputState = &vertex_input_info;
+    pipeline_info.pInputAssemblyState = &input_assembly;
+    pipeline_info.pViewportState = &viewport_state;
+    pipeline_info.pRasterizationState = &rasterizer;
+    pipeline_info.pMultisampleState = &multisampling;
+    pipeline_info.pDepthStencilState = &depth_stencil;
+    pipeline_info.pColorBlendState = &color_blending;
+    pipeline_info.pDynamicState = &dynamic_state;
+    pipeline_info.layout = pipeline_layout;
+    pipeline_info.renderPass = render_pass;
+    pipeline_info.subpass = DEFERRED_LIGHTING_SUBPASS;
+
+    if (vkCreateGraphicsPipelines(device, cache, 1, &pipeline_info, nullptr,
+                                  &pipeline) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateGraphicsPipelines Error: failed to create lighting "
+            "pipeline!");
+    }
+}
+
+void DeferredLighting::RecordDraw(VkCommandBuffer command_buffer,
+                                  const GBufferViews& views,
+                                  VkDescriptorSet light_set, VkExtent2D extent,
+                                  DescriptorAllocator& allocator) const {
+    VkDescriptorSet input_set = allocator.Allocate(input_set_layout);
+
+    // The layouts the attachments have in the lighting subpass
+    std::array<VkDescriptorImageInfo, 3> image_infos = {{
+        {VK_NULL_HANDLE, views.albedo,
+         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+        {VK_NULL_HANDLE, views.normal,
+         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+        {VK_NULL_HANDLE, views.depth,
+         VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL},
+    }};
+
+    std::array<VkWriteDescriptorSet, 3> writes{};
+    for (uint32_t binding = 0; binding < writes.size(); binding++) {
+        writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[binding].dstSet = input_set;
+        writes[binding].dstBinding = binding;
+        writes[binding].descriptorCount = 1;
+        writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        writes[binding].pImageInfo = &image_infos[binding];
+    }
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()),
+                           writes.data(), 0, nullptr);
+
+    std::array<VkDescriptorSet, 2> sets = {input_set, light_set};
+    std::array<float, 2> inverse_extent = {
+        1.0F / static_cast<float>(extent.width),
+        1.0F / static_cast<float>(extent.height)};
+
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                      pipeline);
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            pipeline_layout, 0,
+                            static_cast<uint32_t>(sets.size()), sets.data(), 0,
+                            nullptr);
+    vkCmdPushConstants(command_buffer, pipeline_layout,
+                       VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(inverse_extent),
+                       inverse_extent.data());
+    vkCmdDraw(command_buffer, 3, 1, 0, 0);
+}
+
+void DeferredLighting::SetDebugNames(const DebugUtils& debug_utils) const {
+    debug_utils.SetObjectName(pipeline, VK_OBJECT_TYPE_PIPELINE, "Lighting");
+}
@@ -0,0 +1,74 @@
+#ifndef DEFERRED_LIGHTING_H
+#define DEFERRED_LIGHTING_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Local header files */
+#include "debug_utils.hpp"
+#include "descriptor_allocator.hpp"
+
+/* Standard libraries */
+#include <cstdint>  // Required for uint32_t
+
+// Formats of the G-buffer. Every device supports both as color attachments.
+const VkFormat GBUFFER_ALBEDO_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+const VkFormat GBUFFER_NORMAL_FORMAT = VK_FORMAT_A2B10G10R10_UNORM_PACK32;
+
+// Subpasses of the deferred render pass. The scene writes the G-buffer in
+// the first one, the lighting, the particles and the overlay write the
+// color attachment in the second one.
+const uint32_t DEFERRED_GBUFFER_SUBPASS = 0;
+const uint32_t DEFERRED_LIGHTING_SUBPASS = 1;
+
+// Views of the G-buffer attachments the lighting subpass reads
+struct GBufferViews {
+    VkImageView albedo = VK_NULL_HANDLE;
+    VkImageView normal = VK_NULL_HANDLE;
+    VkImageView depth = VK_NULL_HANDLE;
+};
+
+/* Lighting subpass of the deferred path
+
+A fullscreen triangle reads the albedo, the normal and the depth of its pixel
+through input attachments and adds up the scene lights, so every pixel is lit
+once however many triangles were drawn over it. Input attachments only read
+the pixel being shaded, which lets tiled GPUs keep the G-buffer in tile
+memory between the subpasses: it is never written to or read from video
+memory.
+
+The input attachment set is allocated from the frame allocator, the views
+change with the swap chain.
+*/
+class DeferredLighting {
+   public:
+    explicit DeferredLighting(VkDevice device);
+
+    // Destroy the pipeline, the device must be idle
+    void Destroy();
+
+    // The pipeline is created for DEFERRED_LIGHTING_SUBPASS, with the set of
+    // the lights as set 1
+    void CreatePipeline(VkRenderPass render_pass, VkPipelineCache cache,
+                        DescriptorLayoutCache& layout_cache,
+                        VkDescriptorSetLayout light_set_layout,
+                        VkShaderModule vert_shader,
+                        VkShaderModule frag_shader);
+
+    // Record the lighting, inside the lighting subpass
+    void RecordDraw(VkCommandBuffer command_buffer, const GBufferViews& views,
+                    VkDescriptorSet light_set, VkExtent2D extent,
+                    DescriptorAllocator& allocator) const;
+
+    // Name the pipeline for capture tools
+    void SetDebugNames(const DebugUtils& debug_utils) const;
+
+   private:
+    VkDevice device;
+
+    VkDescriptorSetLayout input_set_layout = VK_NULL_HANDLE;
+    VkPipelineLayout pipeline_layout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+};
+
+#endif  // DEFERRED_LIGHTING_H
@@ -0,0 +1,298 @@
+/* Local header files */
+#include "descriptor_allocator.hpp"
+
+/* Standard libraries */
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+uint64_t HashValue(uint64_t hash, uint64_t value) {
+    // FNV-1a over the 8 bytes of the value
+    for (uint32_t i = 0; i < 8; i++) {
+        hash = (hash ^ ((value >> (i * 8)) & 0xFF)) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint64_t HashSampler(uint64_t hash, VkSampler sampler) {
+    // A handle is a pointer or a 64 bit integer depending on the platform
+    uint64_t value = 0;
+    std::memcpy(&value, &sampler, sizeof(sampler));
+    return HashValue(hash, value);
+}
+
+// The immutable samplers of the binding, Vulkan ignores them for other
+// descriptor types than samplers
+const VkSampler* ImmutableSamplers(
+    const VkDescriptorSetLayoutBinding& binding) {
+    bool sampler_type =
+        binding.descriptorType == VK_DESCRIPTOR_TYPE_SAMPLER ||
+        binding.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    return sampler_type ? binding.pImmutableSamplers : nullptr;
+}
+
+bool BindingsEqual(const std::vector<VkDescriptorSetLayoutBinding>& a,
+                   const std::vector<VkDescriptorSetLayoutBinding>& b) {
+    return std::equal(
+        a.begin(), a.end(), b.begin(), b.end(),
+        [](const VkDescriptorSetLayoutBinding& x,
+           const VkDescriptorSetLayoutBinding& y) {
+            if (x.binding != y.binding ||
+                x.descriptorType != y.descriptorType ||
+                x.descriptorCount != y.descriptorCount ||
+                x.stageFlags != y.stageFlags) {
+                return false;
+            }
+
+            const VkSampler* x_samplers = ImmutableSamplers(x);
+            const VkSampler* y_samplers = ImmutableSamplers(y);
+            if (x_samplers == nullptr || y_samplers == nullptr) {
+                return x_samplers == y_samplers;
+            }
+            return std::equal(x_samplers, x_samplers + x.descriptorCount,
+                              y_samplers);
+        });
+}
+
+}  // namespace
+
+std::vector<DescriptorPoolRatio> DefaultDescriptorPoolRatios() {
+    return {
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1.0F},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.0F},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2.0F},
+        {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1.0F},
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 2.0F},
+        {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 3.0F},
+    };
+}
+
+DescriptorLayoutCache::DescriptorLayoutCache(VkDevice device)
+    : device(device) {}
+
+void DescriptorLayoutCache::Destroy() {
+    for (auto& [hash, cached] : layouts) {
+        vkDestroyDescriptorSetLayout(device, cached.layout, nullptr);
+    }
+    layouts.clear();
+    layout_count = 0;
+}
+
+VkDescriptorSetLayout DescriptorLayoutCache::Get(
+    std::vector<VkDescriptorSetLayoutBinding> bindings) {
+    std::sort(bindings.begin(), bindings.end(),
+              [](const VkDescriptorSetLayoutBinding& a,
+                 const VkDescriptorSetLayoutBinding& b) {
+                  return a.binding < b.binding;
+              });
+
+    uint64_t hash = HashBindings(bindings);
+
+    // Equal hashes of different bindings are told apart by comparing them
+    auto [first, last] = layouts.equal_range(hash);
+    for (auto cached = first; cached != last; ++cached) {
+        if (BindingsEqual(cached->second.bindings, bindings)) {
+            hit_count++;
+            return cached->second.layout;
+        }
+    }
+
+    // Copy the immutable samplers, the bindings of the entry point to the copy
+    std::vector<VkSampler> immutable_samplers;
+    for (const auto& binding : bindings) {
+        if (const VkSampler* samplers = ImmutableSamplers(binding)) {
+            immutable_samplers.insert(immutable_samplers.end(), samplers,
+                                      samplers + binding.descriptorCount);
+        }
+    }
+
+    size_t sampler_offset = 0;
+    for (auto& binding : bindings) {
+        if (ImmutableSamplers(binding) != nullptr) {
+            binding.pImmutableSamplers =
+                immutable_samplers.data() + sampler_offset;
+            sampler_offset += binding.descriptorCount;
+        } else {
+            binding.pImmutableSamplers = nullptr;
+        }
+    }
+
+    VkDescriptorSetLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_info.bindingCount = static_cast<uint32_t>(bindings.size());
+    layout_info.pBindings = bindings.data();
+
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    if (vkCreateDescriptorSetLayout(device, &layout_info, nullptr, &layout) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateDescriptorSetLayout Error: failed to create descriptor "
+            "set layout!");
+    }
+
+    // Moving the vectors keeps their storage, the pointers stay valid
+    layouts.emplace(hash, CachedLayout{std::move(bindings),
+                                       std::move(immutable_samplers), layout});
+    layout_count++;
+    return layout;
+}
+
+uint64_t DescriptorLayoutCache::HashBindings(
+    const std::vector<VkDescriptorSetLayoutBinding>& bindings) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const auto& binding : bindings) {
+        hash = HashValue(hash, binding.binding);
+        hash = HashValue(hash, binding.descriptorType);
+        hash = HashValue(hash, binding.descriptorCount);
+        hash = HashValue(hash, binding.stageFlags);
+
+        if (const VkSampler* samplers = ImmutableSamplers(binding)) {
+            for (uint32_t i = 0; i < binding.descriptorCount; i++) {
+                hash = HashSampler(hash, samplers[i]);
+            }
+        }
+    }
+    return hash;
+}
+
+DescriptorAllocator::DescriptorAllocator(
+    VkDevice device, uint32_t frame_slot_count,
+    std::vector<DescriptorPoolRatio> ratios)
+    : device(device),
+      ratios(std::move(ratios)),
+      frame_slots(frame_slot_count) {}
+
+void DescriptorAllocator::Destroy() {
+    // Destroying a pool frees its sets
+    for (auto& slot : frame_slots) {
+        for (VkDescriptorPool pool : slot.pools) {
+            vkDestroyDescriptorPool(device, pool, nullptr);
+        }
+        slot = {};
+    }
+}
+
+void DescriptorAllocator::ResetFrame(uint32_t frame_slot) {
+    this->frame_slot = frame_slot;
+    FrameSlot& slot = frame_slots[frame_slot];
+
+    // Only the pools that were allocated from have sets to release
+    for (size_t i = 0; i < slot.pools.size() && i <= slot.current_pool; i++) {
+        vkResetDescriptorPool(device, slot.pools[i], 0);
+    }
+
+    slot.current_pool = 0;
+    slot.frame_sets = 0;
+    reset_count++;
+}
+
+VkDescriptorSet DescriptorAllocator::Allocate(VkDescriptorSetLayout layout) {
+    FrameSlot& slot = frame_slots[frame_slot];
+    VkDescriptorSet set = VK_NULL_HANDLE;
+
+    while (true) {
+        bool new_pool = slot.current_pool == slot.pools.size();
+        if (new_pool) {
+            slot.pools.push_back(CreatePool());
+        }
+
+        VkResult result =
+            TryAllocate(slot.pools[slot.current_pool], layout, set);
+
+        if (result == VK_SUCCESS) {
+            break;
+        }
+
+        // Vulkan 1.0 drivers without VK_KHR_maintenance1 report an exhausted
+        // pool with VK_ERROR_FRAGMENTED_POOL
+        if (result != VK_ERROR_OUT_OF_POOL_MEMORY &&
+            result != VK_ERROR_FRAGMENTED_POOL) {
+            throw std::runtime_error(
+                "vkAllocateDescriptorSets Error: failed to allocate frame "
+                "descriptor set!");
+        }
+
+        // A set that does not fit an empty pool never fits
+        if (new_pool) {
+            throw std::runtime_error(
+                "vkAllocateDescriptorSets Error: the descriptor set is larger "
+                "than a descriptor pool!");
+        }
+
+        // The sets allocated from the full pool stay valid until the reset
+        slot.current_pool++;
+    }
+
+    slot.frame_sets++;
+    slot.peak_sets = std::max(slot.peak_sets, slot.frame_sets);
+    allocation_count++;
+    return set;
+}
+
+size_t DescriptorAllocator::GetPoolCount() const {
+    size_t pool_count = 0;
+    for (const auto& slot : frame_slots) {
+        pool_count += slot.pools.size();
+    }
+    return pool_count;
+}
+
+void DescriptorAllocator::Report(std::ostream& out) const {
+    out << "Frame descriptors: " << allocation_count << " sets in "
+        << reset_count << " frames, " << GetPoolCount() << " pools"
+        << std::endl;
+
+    for (size_t i = 0; i < frame_slots.size(); i++) {
+        out << "  Frame slot " << i << ": " << frame_slots[i].pools.size()
+            << " pools, at most " << frame_slots[i].peak_sets
+            << " sets in a frame" << std::endl;
+    }
+}
+
+VkDescriptorPool DescriptorAllocator::CreatePool() {
+    /* Every pool holds the sets of the ratios, each further pool twice as
+    many, so a frame that outgrows its pools needs few new ones */
+    uint32_t max_sets = next_pool_sets;
+    next_pool_sets = std::min(next_pool_sets * 2, DESCRIPTOR_POOL_MAX_SETS);
+
+    std::vector<VkDescriptorPoolSize> pool_sizes;
+    pool_sizes.reserve(ratios.size());
+    for (const auto& ratio : ratios) {
+        pool_sizes.push_back(
+            {ratio.type,
+             static_cast<uint32_t>(std::ceil(ratio.descriptors_per_set *
+                                             static_cast<float>(max_sets)))});
+    }
+
+    VkDescriptorPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.maxSets = max_sets;
+    pool_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+    pool_info.pPoolSizes = pool_sizes.data();
+
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    if (vkCreateDescriptorPool(device, &pool_info, nullptr, &pool) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateDescriptorPool Error: failed to create frame descriptor "
+            "pool!");
+    }
+
+    return pool;
+}
+
+VkResult DescriptorAllocator::TryAllocate(VkDescriptorPool pool,
+                                          VkDescriptorSetLayout layout,
+                                          VkDescriptorSet& set) const {
+    VkDescriptorSetAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.descriptorPool = pool;
+    alloc_info.descriptorSetCount = 1;
+    alloc_info.pSetLayouts = &layout;
+
+    return vkAllocateDescriptorSets(device, &alloc_info, &set);
+}
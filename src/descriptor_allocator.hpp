@@ -0,0 +1,132 @@
+#ifndef DESCRIPTOR_ALLOCATOR_H
+#define DESCRIPTOR_ALLOCATOR_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Standard libraries */
+#include <cstdint>  // Required for uint32_t
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+// Sets of the first pool of a frame slot. Every further pool is twice as
+// large, up to DESCRIPTOR_POOL_MAX_SETS.
+const uint32_t DESCRIPTOR_POOL_SETS = 64;
+const uint32_t DESCRIPTOR_POOL_MAX_SETS = 4096;
+
+// Descriptors of a type a pool holds per set
+struct DescriptorPoolRatio {
+    VkDescriptorType type;
+    float descriptors_per_set;
+};
+
+// Ratios of the sets the renderer allocates per frame
+std::vector<DescriptorPoolRatio> DefaultDescriptorPoolRatios();
+
+/* Deduplicated descriptor set layouts
+
+Get returns the layout of a list of bindings and only creates it the first
+time the bindings are requested, so modules that describe the same bindings
+share a layout and sets allocated for one fit the pipelines of the other.
+The layouts are looked up by a hash of the bindings and live until Destroy.
+
+Immutable samplers are compared by their handles, the cache keeps a copy of
+them, so the caller's array does not have to outlive the call. The cache is
+used from the render thread only.
+*/
+class DescriptorLayoutCache {
+   public:
+    explicit DescriptorLayoutCache(VkDevice device);
+
+    // Destroy the layouts, the pipeline layouts created with them may outlive
+    // them but no set may be allocated afterwards
+    void Destroy();
+
+    // Layout of the bindings, in any order of the bindings. Throws
+    // std::runtime_error if the layout can not be created.
+    VkDescriptorSetLayout Get(
+        std::vector<VkDescriptorSetLayoutBinding> bindings);
+
+    size_t GetLayoutCount() const { return layout_count; }
+    uint64_t GetHitCount() const { return hit_count; }
+
+    // Hash of the bindings sorted by binding number
+    static uint64_t HashBindings(
+        const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+
+   private:
+    // The immutable samplers of the bindings point into the samplers of the
+    // entry, so an entry is moved but never copied
+    struct CachedLayout {
+        std::vector<VkDescriptorSetLayoutBinding> bindings;
+        std::vector<VkSampler> immutable_samplers;
+        VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    };
+
+    VkDevice device;
+    std::unordered_multimap<uint64_t, CachedLayout> layouts;
+    size_t layout_count = 0;
+    uint64_t hit_count = 0;
+};
+
+/* Linear descriptor set allocator with a list of pools per frame slot
+
+Allocating and freeing descriptor sets one by one fragments a pool until an
+allocation fails although enough descriptors are free. The sets of a frame
+are instead allocated linearly from the pools of its frame slot: when the
+current pool is exhausted or fragmented the next one is used, and a new pool
+is created once all of them are full. ResetFrame resets every pool of the
+slot with vkResetDescriptorPool when the fence of the slot was signaled, so
+all sets of the frame are released at once and the pools are reused without
+creating or destroying anything.
+
+A set allocated in a frame is valid until the frame slot is reset again,
+sets that live longer belong in a pool of their own.
+*/
+class DescriptorAllocator {
+   public:
+    DescriptorAllocator(VkDevice device, uint32_t frame_slot_count,
+                        std::vector<DescriptorPoolRatio> ratios =
+                            DefaultDescriptorPoolRatios());
+
+    // Destroy the pools, the device must be idle
+    void Destroy();
+
+    // Release the sets of the frame slot and allocate from it until the next
+    // call, the last frame of the slot must be complete
+    void ResetFrame(uint32_t frame_slot);
+
+    // Allocate a set of the current frame slot. Throws std::runtime_error if
+    // the set does not fit a new pool.
+    VkDescriptorSet Allocate(VkDescriptorSetLayout layout);
+
+    size_t GetPoolCount() const;
+    uint64_t GetAllocationCount() const { return allocation_count; }
+
+    // Print the pools of every frame slot and the most sets a frame used
+    void Report(std::ostream& out) const;
+
+   private:
+    struct FrameSlot {
+        std::vector<VkDescriptorPool> pools;
+        size_t current_pool = 0;
+        uint32_t frame_sets = 0;
+        uint32_t peak_sets = 0;
+    };
+
+    VkDevice device;
+    std::vector<DescriptorPoolRatio> ratios;
+    std::vector<FrameSlot> frame_slots;
+    uint32_t frame_slot = 0;
+    uint32_t next_pool_sets = DESCRIPTOR_POOL_SETS;
+
+    uint64_t allocation_count = 0;
+    uint64_t reset_count = 0;
+
+    VkDescriptorPool CreatePool();
+    VkResult TryAllocate(VkDescriptorPool pool, VkDescriptorSetLayout layout,
+                         VkDescriptorSet& set) const;
+};
+
+#endif  // DESCRIPTOR_ALLOCATOR_H
@@ -0,0 +1,134 @@
+/* Local header files */
+#include "frame_pacer.hpp"
+
+/* Standard libraries */
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+// Adjustment of the safety margin after a missed and a made refresh
+constexpr std::chrono::microseconds MARGIN_INCREASE(1000);
+constexpr std::chrono::microseconds MARGIN_DECREASE(50);
+constexpr std::chrono::microseconds MIN_MARGIN(500);
+
+// Always spin at least this long before the deadline
+constexpr std::chrono::microseconds MIN_SPIN(200);
+
+// Weight of a new sample in the moving averages is 1 / AVERAGE_WEIGHT
+constexpr int AVERAGE_WEIGHT = 8;
+
+FramePacer::Clock::duration MovingAverage(FramePacer::Clock::duration average,
+                                          FramePacer::Clock::duration sample) {
+    return average + (sample - average) / AVERAGE_WEIGHT;
+}
+
+}  // namespace
+
+void FramePacer::SetTargetInterval(std::optional<Clock::duration> interval) {
+    target_interval = interval;
+}
+
+void FramePacer::SetRefreshInterval(Clock::duration interval) {
+    refresh_interval = interval;
+}
+
+void FramePacer::OnPresentCompleted(Clock::time_point time) {
+    if (previous_present_completed.has_value()) {
+        Clock::duration interval = time - previous_present_completed.value();
+
+        // A present that took more than half a refresh longer than expected
+        // missed its refresh, so frames have to start earlier
+        if (interval > ExpectedPresentInterval() + refresh_interval / 2) {
+            safety_margin =
+                std::min<Clock::duration>(safety_margin + MARGIN_INCREASE,
+                                          refresh_interval);
+        } else {
+            safety_margin = std::max<Clock::duration>(
+                safety_margin - MARGIN_DECREASE, MIN_MARGIN);
+        }
+    }
+
+    previous_present_completed = time;
+    present_completed = time;
+}
+
+FramePacer::Clock::time_point FramePacer::WaitForFrameStart() {
+    Clock::time_point now = Clock::now();
+    std::optional<Clock::time_point> start;
+
+    if (target_interval.has_value()) {
+        // Frames are scheduled one interval after the previous schedule, so
+        // the rate does not drift by the time spent waking up. After a long
+        // frame the schedule restarts instead of catching up with a burst.
+        Clock::time_point scheduled_start = now;
+        if (last_frame_start.has_value()) {
+            scheduled_start =
+                last_frame_start.value() + target_interval.value();
+            if (scheduled_start + target_interval.value() < now) {
+                scheduled_start = now;
+            }
+        }
+        start = scheduled_start;
+    }
+
+    if (present_completed.has_value()) {
+        // Latest start that is still ready for the next refresh
+        Clock::time_point latest_start = present_completed.value() +
+                                         ExpectedPresentInterval() -
+                                         predicted_work - safety_margin;
+        start = start.has_value() ? std::max(start.value(), latest_start)
+                                  : latest_start;
+        present_completed.reset();
+    }
+
+    if (start.has_value() && start.value() > now) {
+        SleepUntil(start.value());
+    }
+
+    // Remember the scheduled start rather than the wake up time
+    last_frame_start = start.has_value() ? std::max(start.value(), now) : now;
+
+    return Clock::now();
+}
+
+void FramePacer::OnFrameSubmitted(Clock::time_point time) {
+    if (last_frame_start.has_value() && time > last_frame_start.value()) {
+        predicted_work =
+            MovingAverage(predicted_work, time - last_frame_start.value());
+    }
+}
+
+void FramePacer::SleepUntil(Clock::time_point deadline) {
+    /* Sleep for the bulk of the wait, then spin until the deadline */
+    Clock::duration spin_time = sleep_overshoot + MIN_SPIN;
+
+    if (deadline - Clock::now() > spin_time) {
+        Clock::time_point wake_up = deadline - spin_time;
+        std::this_thread::sleep_until(wake_up);
+
+        // Track how late the thread wakes up to adjust the spin time
+        Clock::duration overshoot =
+            std::max<Clock::duration>(Clock::now() - wake_up,
+                                      Clock::duration::zero());
+        sleep_overshoot = MovingAverage(sleep_overshoot, overshoot);
+    }
+
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+FramePacer::Clock::duration FramePacer::ExpectedPresentInterval() const {
+    /* Presents complete on refreshes, a frame rate cap below the refresh rate
+    rounds up to a whole number of refreshes */
+    if (!target_interval.has_value() ||
+        target_interval.value() <= refresh_interval) {
+        return refresh_interval;
+    }
+
+    auto refreshes = (target_interval.value() + refresh_interval -
+                      Clock::duration(1)) /
+                     refresh_interval;
+    return refresh_interval * refreshes;
+}
@@ -0,0 +1,64 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+/* Standard libraries */
+#include <chrono>
+#include <optional>
+
+/* Decides when the next frame should start
+
+Two limits can delay the start of a frame:
+- A frame rate cap: frames start at least one target interval apart.
+- Low latency pacing: once the present of an earlier frame completed, the next
+frame only has to be ready by the following refresh. The frame starts at the
+predicted latest time that still makes it, so input is sampled as late as
+possible. The prediction is the CPU time of recent frames plus a safety margin
+that grows when a refresh is missed and slowly shrinks otherwise.
+
+Waiting uses a hybrid timer: sleep while the deadline is far away and spin for
+the last part, because sleeping can overshoot by the scheduler granularity.
+*/
+class FramePacer {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    // Frame rate cap, no value disables the cap
+    void SetTargetInterval(std::optional<Clock::duration> interval);
+
+    // Refresh interval of the display
+    void SetRefreshInterval(Clock::duration interval);
+
+    // The present of an earlier frame completed at the given time. Enables
+    // the low latency start prediction for the next frame.
+    void OnPresentCompleted(Clock::time_point time);
+
+    // Wait until the next frame should start and return the start time
+    Clock::time_point WaitForFrameStart();
+
+    // The CPU work of the frame that started last has been submitted
+    void OnFrameSubmitted(Clock::time_point time);
+
+    // Hybrid sleep and spin until the deadline
+    void SleepUntil(Clock::time_point deadline);
+
+   private:
+    std::optional<Clock::duration> target_interval;
+    Clock::duration refresh_interval = std::chrono::microseconds(16667);
+
+    std::optional<Clock::time_point> last_frame_start;
+    std::optional<Clock::time_point> present_completed;
+    std::optional<Clock::time_point> previous_present_completed;
+
+    // Exponential moving average of the CPU time of a frame
+    Clock::duration predicted_work = Clock::duration::zero();
+
+    // Extra time reserved for GPU work and presentation
+    Clock::duration safety_margin = std::chrono::milliseconds(2);
+
+    // Moving average of how much sleeping overshoots the requested time
+    Clock::duration sleep_overshoot = std::chrono::microseconds(500);
+
+    Clock::duration ExpectedPresentInterval() const;
+};
+
+#endif  // FRAME_PACER_H
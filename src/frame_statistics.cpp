@@ -0,0 +1,53 @@
+/* Local header files */
+#include "frame_statistics.hpp"
+
+/* Standard libraries */
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+double Percentile(const std::vector<double>& sorted_samples,
+                  double percentile) {
+    if (sorted_samples.empty()) {
+        return 0.0;
+    }
+
+    // Position of the percentile between the two closest ranks
+    double rank = percentile / 100.0 *
+                  static_cast<double>(sorted_samples.size() - 1);
+    auto lower = static_cast<size_t>(std::floor(rank));
+    size_t upper = std::min(lower + 1, sorted_samples.size() - 1);
+    double fraction = rank - static_cast<double>(lower);
+
+    return sorted_samples[lower] +
+           (sorted_samples[upper] - sorted_samples[lower]) * fraction;
+}
+
+SampleSummary Summarize(std::vector<double> samples) {
+    SampleSummary summary;
+
+    if (samples.empty()) {
+        return summary;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    summary.count = samples.size();
+    summary.mean = std::accumulate(samples.begin(), samples.end(), 0.0) /
+                   static_cast<double>(samples.size());
+
+    double squared_deviations = 0.0;
+    for (double sample : samples) {
+        squared_deviations += (sample - summary.mean) * (sample - summary.mean);
+    }
+    summary.stddev =
+        std::sqrt(squared_deviations / static_cast<double>(samples.size()));
+
+    summary.min = samples.front();
+    summary.p50 = Percentile(samples, 50.0);
+    summary.p90 = Percentile(samples, 90.0);
+    summary.p99 = Percentile(samples, 99.0);
+    summary.max = samples.back();
+
+    return summary;
+}
@@ -0,0 +1,27 @@
+#ifndef FRAME_STATISTICS_H
+#define FRAME_STATISTICS_H
+
+/* Standard libraries */
+#include <cstddef>
+#include <vector>
+
+// Statistical summary of a set of timing samples
+struct SampleSummary {
+    size_t count = 0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    double min = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+// Linearly interpolated percentile (0-100) of an ascending sorted sample set
+double Percentile(const std::vector<double>& sorted_samples, double percentile);
+
+// Summarize the samples. The samples are taken by value because they need
+// to be sorted.
+SampleSummary Summarize(std::vector<double> samples);
+
+#endif  // FRAME_STATISTICS_H
@@ -0,0 +1,425 @@
+/* Local header files */
+#include "frustum_culling.hpp"
+
+/* Standard libraries */
+#include <algorithm>  // Required for std::min
+#include <cmath>
+#include <limits>  // Required for std::numeric_limits
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FRUSTUM_CULLING_X86
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define FRUSTUM_CULLING_NEON
+#endif
+
+namespace {
+
+const size_t PLANE_COUNT = 6;
+
+// Planes split into components, with the absolute values of the normals for
+// the projected extent of the boxes
+struct FrustumPlanes {
+    std::array<float, PLANE_COUNT> x;
+    std::array<float, PLANE_COUNT> y;
+    std::array<float, PLANE_COUNT> z;
+    std::array<float, PLANE_COUNT> w;
+    std::array<float, PLANE_COUNT> abs_x;
+    std::array<float, PLANE_COUNT> abs_y;
+    std::array<float, PLANE_COUNT> abs_z;
+};
+
+FrustumPlanes SplitPlanes(const Frustum& frustum) {
+    FrustumPlanes planes{};
+
+    for (size_t i = 0; i < PLANE_COUNT; i++) {
+        const glm::vec4& plane = frustum.planes[i];
+        planes.x[i] = plane.x;
+        planes.y[i] = plane.y;
+        planes.z[i] = plane.z;
+        planes.w[i] = plane.w;
+        planes.abs_x[i] = std::fabs(plane.x);
+        planes.abs_y[i] = std::fabs(plane.y);
+        planes.abs_z[i] = std::fabs(plane.z);
+    }
+
+    return planes;
+}
+
+// Arrays of a CullingSet, padded to a multiple of 8 objects
+struct BoundsView {
+    const float* center_x;
+    const float* center_y;
+    const float* center_z;
+    const float* radius;
+    const float* extent_x;
+    const float* extent_y;
+    const float* extent_z;
+    uint32_t count;
+};
+
+// Lane indices of the visible lanes of a 4 lane mask, moved to the front
+using CompactionTable = std::array<std::array<uint32_t, 4>, 16>;
+
+constexpr CompactionTable MakeCompactionTable() {
+    CompactionTable table{};
+
+    for (uint32_t mask = 0; mask < 16; mask++) {
+        uint32_t count = 0;
+        for (uint32_t lane = 0; lane < 4; lane++) {
+            if ((mask & (1U << lane)) != 0) {
+                table[mask][count++] = lane;
+            }
+        }
+    }
+
+    return table;
+}
+
+// The same for 8 lanes, 4 bits per lane index
+constexpr std::array<uint32_t, 256> MakePackedCompactionTable() {
+    std::array<uint32_t, 256> table{};
+
+    for (uint32_t mask = 0; mask < 256; mask++) {
+        uint32_t count = 0;
+        for (uint32_t lane = 0; lane < 8; lane++) {
+            if ((mask & (1U << lane)) != 0) {
+                table[mask] |= lane << (4 * count++);
+            }
+        }
+    }
+
+    return table;
+}
+
+[[maybe_unused]] constexpr CompactionTable COMPACTION_TABLE =
+    MakeCompactionTable();
+[[maybe_unused]] constexpr std::array<uint32_t, 256>
+    PACKED_COMPACTION_TABLE = MakePackedCompactionTable();
+
+#ifdef FRUSTUM_CULLING_X86
+
+bool SupportsSse41() {
+    static const bool supported = __builtin_cpu_supports("sse4.1") != 0;
+    return supported;
+}
+
+bool SupportsAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2") != 0;
+    return supported;
+}
+
+#endif  // FRUSTUM_CULLING_X86
+
+uint32_t CullScalar(const BoundsView& bounds, const Frustum& frustum,
+                    uint32_t* visible) {
+    FrustumPlanes planes = SplitPlanes(frustum);
+    uint32_t visible_count = 0;
+
+    for (uint32_t i = 0; i < bounds.count; i++) {
+        bool inside = true;
+
+        for (size_t p = 0; p < PLANE_COUNT; p++) {
+            float distance = planes.x[p] * bounds.center_x[i] +
+                             planes.y[p] * bounds.center_y[i] +
+                             planes.z[p] * bounds.center_z[i] + planes.w[p];
+            float box_radius = planes.abs_x[p] * bounds.extent_x[i] +
+                               planes.abs_y[p] * bounds.extent_y[i] +
+                               planes.abs_z[p] * bounds.extent_z[i];
+            inside &= distance >= -std::min(bounds.radius[i], box_radius);
+        }
+
+        // Branchless compaction, the index is overwritten if not visible
+        visible[visible_count] = i;
+        visible_count += inside ? 1 : 0;
+    }
+
+    return visible_count;
+}
+
+#ifdef FRUSTUM_CULLING_X86
+
+__attribute__((target("sse4.1"))) uint32_t CullSse41(
+    const BoundsView& bounds, const Frustum& frustum, uint32_t* visible) {
+    FrustumPlanes planes = SplitPlanes(frustum);
+    const __m128 sign_bit = _mm_set1_ps(-0.0F);
+    uint32_t visible_count = 0;
+
+    for (uint32_t base = 0; base < bounds.count; base += 4) {
+        __m128 x = _mm_loadu_ps(bounds.center_x + base);
+        __m128 y = _mm_loadu_ps(bounds.center_y + base);
+        __m128 z = _mm_loadu_ps(bounds.center_z + base);
+        __m128 r = _mm_loadu_ps(bounds.radius + base);
+        __m128 ex = _mm_loadu_ps(bounds.extent_x + base);
+        __m128 ey = _mm_loadu_ps(bounds.extent_y + base);
+        __m128 ez = _mm_loadu_ps(bounds.extent_z + base);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        for (size_t p = 0; p < PLANE_COUNT; p++) {
+            __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.x[p]), x),
+                           _mm_mul_ps(_mm_set1_ps(planes.y[p]), y)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.z[p]), z),
+                           _mm_set1_ps(planes.w[p])));
+            __m128 box_radius = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.abs_x[p]), ex),
+                           _mm_mul_ps(_mm_set1_ps(planes.abs_y[p]), ey)),
+                _mm_mul_ps(_mm_set1_ps(planes.abs_z[p]), ez));
+            __m128 limit = _mm_xor_ps(_mm_min_ps(r, box_radius), sign_bit);
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, limit));
+        }
+
+        // Store the indices of the visible lanes at the end of the list
+        auto mask = static_cast<uint32_t>(_mm_movemask_ps(inside));
+        __m128i lanes = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(COMPACTION_TABLE[mask].data()));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(visible + visible_count),
+            _mm_add_epi32(lanes, _mm_set1_epi32(static_cast<int>(base))));
+        visible_count += static_cast<uint32_t>(__builtin_popcount(mask));
+    }
+
+    return visible_count;
+}
+
+__attribute__((target("avx2"))) uint32_t CullAvx2(
+    const BoundsView& bounds, const Frustum& frustum, uint32_t* visible) {
+    FrustumPlanes planes = SplitPlanes(frustum);
+    const __m256 sign_bit = _mm256_set1_ps(-0.0F);
+    const __m256i lane_shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+    uint32_t visible_count = 0;
+
+    for (uint32_t base = 0; base < bounds.count; base += 8) {
+        __m256 x = _mm256_loadu_ps(bounds.center_x + base);
+        __m256 y = _mm256_loadu_ps(bounds.center_y + base);
+        __m256 z = _mm256_loadu_ps(bounds.center_z + base);
+        __m256 r = _mm256_loadu_ps(bounds.radius + base);
+        __m256 ex = _mm256_loadu_ps(bounds.extent_x + base);
+        __m256 ey = _mm256_loadu_ps(bounds.extent_y + base);
+        __m256 ez = _mm256_loadu_ps(bounds.extent_z + base);
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        for (size_t p = 0; p < PLANE_COUNT; p++) {
+            __m256 distance = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.x[p]), x),
+                              _mm256_mul_ps(_mm256_set1_ps(planes.y[p]), y)),
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.z[p]), z),
+                              _mm256_set1_ps(planes.w[p])));
+            __m256 box_radius = _mm256_add_ps(
+                _mm256_add_ps(
+                    _mm256_mul_ps(_mm256_set1_ps(planes.abs_x[p]), ex),
+                    _mm256_mul_ps(_mm256_set1_ps(planes.abs_y[p]), ey)),
+                _mm256_mul_ps(_mm256_set1_ps(planes.abs_z[p]), ez));
+            __m256 limit =
+                _mm256_xor_ps(_mm256_min_ps(r, box_radius), sign_bit);
+            inside = _mm256_and_ps(
+                inside, _mm256_cmp_ps(distance, limit, _CMP_GE_OQ));
+        }
+
+        // Unpack the 4 bit lane indices of the mask and store them
+        auto mask = static_cast<uint32_t>(_mm256_movemask_ps(inside));
+        __m256i lanes = _mm256_and_si256(
+            _mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(
+                                  PACKED_COMPACTION_TABLE[mask])),
+                              lane_shifts),
+            _mm256_set1_epi32(0xF));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(visible + visible_count),
+            _mm256_add_epi32(lanes, _mm256_set1_epi32(static_cast<int>(base))));
+        visible_count += static_cast<uint32_t>(__builtin_popcount(mask));
+    }
+
+    return visible_count;
+}
+
+#endif  // FRUSTUM_CULLING_X86
+
+#ifdef FRUSTUM_CULLING_NEON
+
+uint32_t CullNeon(const BoundsView& bounds, const Frustum& frustum,
+                  uint32_t* visible) {
+    FrustumPlanes planes = SplitPlanes(frustum);
+    const uint32x4_t lane_bits = {1, 2, 4, 8};
+    uint32_t visible_count = 0;
+
+    for (uint32_t base = 0; base < bounds.count; base += 4) {
+        float32x4_t x = vld1q_f32(bounds.center_x + base);
+        float32x4_t y = vld1q_f32(bounds.center_y + base);
+        float32x4_t z = vld1q_f32(bounds.center_z + base);
+        float32x4_t r = vld1q_f32(bounds.radius + base);
+        float32x4_t ex = vld1q_f32(bounds.extent_x + base);
+        float32x4_t ey = vld1q_f32(bounds.extent_y + base);
+        float32x4_t ez = vld1q_f32(bounds.extent_z + base);
+        uint32x4_t inside = vdupq_n_u32(UINT32_MAX);
+
+        for (size_t p = 0; p < PLANE_COUNT; p++) {
+            float32x4_t distance = vaddq_f32(
+                vaddq_f32(vmulq_n_f32(x, planes.x[p]),
+                          vmulq_n_f32(y, planes.y[p])),
+                vaddq_f32(vmulq_n_f32(z, planes.z[p]),
+                          vdupq_n_f32(planes.w[p])));
+            float32x4_t box_radius = vaddq_f32(
+                vaddq_f32(vmulq_n_f32(ex, planes.abs_x[p]),
+                          vmulq_n_f32(ey, planes.abs_y[p])),
+                vmulq_n_f32(ez, planes.abs_z[p]));
+            float32x4_t limit = vnegq_f32(vminq_f32(r, box_radius));
+            inside = vandq_u32(inside, vcgeq_f32(distance, limit));
+        }
+
+        uint32_t mask = vaddvq_u32(vandq_u32(inside, lane_bits));
+        uint32x4_t lanes = vld1q_u32(COMPACTION_TABLE[mask].data());
+        vst1q_u32(visible + visible_count,
+                  vaddq_u32(lanes, vdupq_n_u32(base)));
+        visible_count += static_cast<uint32_t>(__builtin_popcount(mask));
+    }
+
+    return visible_count;
+}
+
+#endif  // FRUSTUM_CULLING_NEON
+
+}  // namespace
+
+Frustum ExtractFrustum(const glm::mat4& view_projection) {
+    /* Gribb and Hartmann: a clip space bound like -w <= x is the dot product
+    of a row combination of the matrix with the point. glm matrices are
+    column major, m[column][row]. */
+    auto row = [&](int index) {
+        return glm::vec4(view_projection[0][index], view_projection[1][index],
+                         view_projection[2][index], view_projection[3][index]);
+    };
+    auto add = [](const glm::vec4& a, const glm::vec4& b) {
+        return glm::vec4(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+    };
+    auto subtract = [](const glm::vec4& a, const glm::vec4& b) {
+        return glm::vec4(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
+    };
+
+    glm::vec4 x = row(0);
+    glm::vec4 y = row(1);
+    glm::vec4 z = row(2);
+    glm::vec4 w = row(3);
+
+    Frustum frustum{};
+    frustum.planes = {add(w, x),      subtract(w, x), add(w, y),
+                      subtract(w, y), z,              subtract(w, z)};
+
+    // Normalized planes give distances, which the radii are compared to
+    for (auto& plane : frustum.planes) {
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y +
+                                 plane.z * plane.z);
+        if (length > 0.0F) {
+            plane = glm::vec4(plane.x / length, plane.y / length,
+                              plane.z / length, plane.w / length);
+        }
+    }
+
+    return frustum;
+}
+
+const char* CullingPathName(CullingPath path) {
+    switch (path) {
+        case CullingPath::SCALAR:
+            return "scalar";
+        case CullingPath::SSE41:
+            return "sse4.1";
+        case CullingPath::AVX2:
+            return "avx2";
+        case CullingPath::NEON:
+            return "neon";
+    }
+
+    return "unknown";
+}
+
+CullingPath GetCullingPath() {
+    static const CullingPath path = GetSupportedCullingPaths().back();
+    return path;
+}
+
+std::vector<CullingPath> GetSupportedCullingPaths() {
+    // From the slowest to the fastest
+    std::vector<CullingPath> paths = {CullingPath::SCALAR};
+
+#ifdef FRUSTUM_CULLING_X86
+    if (SupportsSse41()) {
+        paths.push_back(CullingPath::SSE41);
+    }
+    if (SupportsAvx2()) {
+        paths.push_back(CullingPath::AVX2);
+    }
+#endif
+
+#ifdef FRUSTUM_CULLING_NEON
+    paths.push_back(CullingPath::NEON);
+#endif
+
+    return paths;
+}
+
+uint32_t CullingSet::Add(const glm::vec3& center, float object_radius,
+                         const glm::vec3& half_extent) {
+    /* Grow by a whole batch of padding objects: a negative radius that no
+    distance is below the negative of, so they are always culled */
+    if (count == radius.size()) {
+        size_t size = radius.size() + CULLING_BATCH_SIZE;
+        center_x.resize(size, 0.0F);
+        center_y.resize(size, 0.0F);
+        center_z.resize(size, 0.0F);
+        radius.resize(size, std::numeric_limits<float>::lowest());
+        extent_x.resize(size, 0.0F);
+        extent_y.resize(size, 0.0F);
+        extent_z.resize(size, 0.0F);
+    }
+
+    SetBounds(count, center, object_radius, half_extent);
+    return count++;
+}
+
+void CullingSet::SetBounds(uint32_t object, const glm::vec3& center,
+                           float object_radius, const glm::vec3& half_extent) {
+    center_x[object] = center.x;
+    center_y[object] = center.y;
+    center_z[object] = center.z;
+    radius[object] = object_radius;
+    extent_x[object] = half_extent.x;
+    extent_y[object] = half_extent.y;
+    extent_z[object] = half_extent.z;
+}
+
+void CullingSet::Clear() {
+    count = 0;
+    for (auto* values : {&center_x, &center_y, &center_z, &radius, &extent_x,
+                         &extent_y, &extent_z}) {
+        values->clear();
+    }
+}
+
+uint32_t CullingSet::Cull(const Frustum& frustum, uint32_t* visible,
+                          CullingPath path) const {
+    BoundsView bounds{center_x.data(), center_y.data(), center_z.data(),
+                      radius.data(),   extent_x.data(), extent_y.data(),
+                      extent_z.data(), count};
+
+    switch (path) {
+        case CullingPath::SCALAR:
+            return CullScalar(bounds, frustum, visible);
+#ifdef FRUSTUM_CULLING_X86
+        case CullingPath::SSE41:
+            return CullSse41(bounds, frustum, visible);
+        case CullingPath::AVX2:
+            return CullAvx2(bounds, frustum, visible);
+#endif
+#ifdef FRUSTUM_CULLING_NEON
+        case CullingPath::NEON:
+            return CullNeon(bounds, frustum, visible);
+#endif
+        default:
+            throw std::invalid_argument(std::string(CullingPathName(path)) +
+                                        " culling is not supported!");
+    }
+}
+
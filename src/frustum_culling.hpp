@@ -0,0 +1,88 @@
+#ifndef FRUSTUM_CULLING_H
+#define FRUSTUM_CULLING_H
+
+/* Third party libraries */
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+/* Standard libraries */
+#include <array>
+#include <cstddef>
+#include <cstdint>  // Required for uint32_t
+#include <vector>
+
+// Planes of a view frustum with normals that point inside, a point p is in
+// front of a plane if dot(plane.xyz, p) + plane.w >= 0
+struct Frustum {
+    std::array<glm::vec4, 6> planes;
+};
+
+// Frustum of a view projection matrix in the Vulkan clip space, x and y in
+// [-w, w] and z in [0, w]
+Frustum ExtractFrustum(const glm::mat4& view_projection);
+
+enum class CullingPath { SCALAR, SSE41, AVX2, NEON };
+
+const char* CullingPathName(CullingPath path);
+
+// Fastest path of this CPU, and every path it can run for the benchmarks
+CullingPath GetCullingPath();
+std::vector<CullingPath> GetSupportedCullingPaths();
+
+/* Bounds of the objects of a scene, stored as structure of arrays
+
+Every object has a bounding sphere and an axis aligned box around the same
+center. An object is culled if the sphere or the box is completely behind
+one of the planes of the frustum, the tighter of the two decides per plane.
+The arrays are padded to a multiple of CULLING_BATCH_SIZE with objects that
+are always culled, so the SIMD paths only process whole vectors.
+*/
+class CullingSet {
+   public:
+    // Objects tested at once by the widest path (AVX2)
+    static constexpr uint32_t CULLING_BATCH_SIZE = 8;
+
+    // An object with only a sphere gets the box around the sphere
+    uint32_t Add(const glm::vec3& center, float radius,
+                 const glm::vec3& half_extent);
+    uint32_t Add(const glm::vec3& center, float radius) {
+        return Add(center, radius, glm::vec3(radius, radius, radius));
+    }
+    void SetBounds(uint32_t object, const glm::vec3& center, float radius,
+                   const glm::vec3& half_extent);
+    void Clear();
+
+    uint32_t Size() const { return count; }
+
+    glm::vec3 GetCenter(uint32_t object) const {
+        return {center_x[object], center_y[object], center_z[object]};
+    }
+    float GetRadius(uint32_t object) const { return radius[object]; }
+
+    // Size of the visible index list Cull writes, the SIMD paths store whole
+    // vectors past the last visible object
+    size_t GetPaddedSize() const { return radius.size(); }
+
+    // Write the indices of the objects that intersect the frustum, in
+    // increasing order, to visible and return their number. The path must be
+    // supported by the CPU.
+    uint32_t Cull(const Frustum& frustum, uint32_t* visible,
+                  CullingPath path) const;
+    uint32_t Cull(const Frustum& frustum, uint32_t* visible) const {
+        return Cull(frustum, visible, GetCullingPath());
+    }
+
+   private:
+    uint32_t count = 0;
+
+    std::vector<float> center_x;
+    std::vector<float> center_y;
+    std::vector<float> center_z;
+    std::vector<float> radius;
+    std::vector<float> extent_x;
+    std::vector<float> extent_y;
+    std::vector<float> extent_z;
+};
+
+#endif  // FRUSTUM_CULLING_H
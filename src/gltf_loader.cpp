@@ -0,0 +1,706 @@
+/* Local header files */
+#include "gltf_loader.hpp"
+
+#include "json_value.hpp"
+#include "vertex_conversion.hpp"
+
+/* Standard libraries */
+#include <algorithm>  // Required for std::min
+#include <cstring>
+#include <exception>  // Required for std::exception_ptr
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <limits>  // Required for std::numeric_limits
+#include <stdexcept>
+
+namespace {
+
+// Header of a binary glTF file and its chunk types, see the specification
+const uint32_t GLB_MAGIC = 0x46546C67;       // "glTF"
+const uint32_t GLB_CHUNK_JSON = 0x4E4F534A;  // "JSON"
+const uint32_t GLB_CHUNK_BIN = 0x004E4942;   // "BIN\0"
+const size_t GLB_HEADER_SIZE = 12;
+const size_t GLB_CHUNK_HEADER_SIZE = 8;
+
+const size_t PRIMITIVE_MODE_TRIANGLES = 4;
+
+// Limits of the byteStride of a buffer view, it is also a multiple of 4
+const size_t GLTF_MIN_STRIDE = 4;
+const size_t GLTF_MAX_STRIDE = 252;
+
+// Elements converted by one task, large enough that a task takes longer than
+// its scheduling
+const size_t CONVERSION_CHUNK_VERTICES = 16384;
+const size_t CONVERSION_CHUNK_INDICES = 3 * CONVERSION_CHUNK_VERTICES;
+
+// Data of a buffer, either owned or a range of the binary chunk of a .glb
+struct BufferData {
+    std::vector<uint8_t> storage;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+struct ConversionTasks {
+    std::vector<std::future<void>> tasks;
+
+    /* Wait for every task before the first exception is rethrown, the tasks
+    reference the buffers and meshes of the loader */
+    void Wait() {
+        for (auto& task : tasks) {
+            task.wait();
+        }
+        for (auto& task : tasks) {
+            task.get();
+        }
+        tasks.clear();
+    }
+};
+
+std::vector<uint8_t> ReadFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::ate | std::ios::binary);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("failed to open file: " + filename + "!");
+    }
+
+    auto file_size = static_cast<size_t>(file.tellg());
+    std::vector<uint8_t> data(file_size);
+
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(data.data()),
+              static_cast<std::streamsize>(file_size));
+
+    return data;
+}
+
+uint32_t ReadUint32(const uint8_t* data) {
+    uint32_t value = 0;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+bool EndsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) ==
+               0;
+}
+
+int HexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// Relative URIs are percent encoded, e.g. "my%20model.bin"
+std::string DecodeUri(const std::string& uri) {
+    std::string path;
+    path.reserve(uri.size());
+
+    for (size_t i = 0; i < uri.size(); i++) {
+        if (uri[i] == '%' && i + 2 < uri.size() && HexValue(uri[i + 1]) >= 0 &&
+            HexValue(uri[i + 2]) >= 0) {
+            path += static_cast<char>(HexValue(uri[i + 1]) * 16 +
+                                      HexValue(uri[i + 2]));
+            i += 2;
+        } else {
+            path += uri[i];
+        }
+    }
+
+    return path;
+}
+
+int Base64Value(char c) {
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A';
+    }
+    if (c >= 'a' && c <= 'z') {
+        return c - 'a' + 26;
+    }
+    if (c >= '0' && c <= '9') {
+        return c - '0' + 52;
+    }
+    if (c == '+') {
+        return 62;
+    }
+    if (c == '/') {
+        return 63;
+    }
+    return -1;
+}
+
+std::vector<uint8_t> DecodeBase64(const std::string& text, size_t begin) {
+    std::vector<uint8_t> data;
+    data.reserve((text.size() - begin) / 4 * 3);
+
+    uint32_t bits = 0;
+    int bit_count = 0;
+
+    for (size_t i = begin; i < text.size() && text[i] != '='; i++) {
+        int value = Base64Value(text[i]);
+
+        if (value < 0) {
+            throw std::runtime_error("invalid base64 data URI!");
+        }
+
+        bits = (bits << 6) | static_cast<uint32_t>(value);
+        bit_count += 6;
+
+        if (bit_count >= 8) {
+            bit_count -= 8;
+            data.push_back(static_cast<uint8_t>(bits >> bit_count));
+        }
+    }
+
+    return data;
+}
+
+bool IsDataUri(const std::string& uri) {
+    return uri.compare(0, 5, "data:") == 0;
+}
+
+// Data of a data URI, or of a file relative to the glTF file
+std::vector<uint8_t> ReadUri(const std::string& uri,
+                             const std::filesystem::path& directory) {
+    if (IsDataUri(uri)) {
+        size_t base64 = uri.find(";base64,");
+
+        if (base64 == std::string::npos) {
+            throw std::runtime_error("data URIs must be base64 encoded!");
+        }
+
+        return DecodeBase64(uri, base64 + 8);
+    }
+
+    return ReadFile((directory / DecodeUri(uri)).string());
+}
+
+uint32_t GetComponentCount(const std::string& type) {
+    if (type == "SCALAR") {
+        return 1;
+    }
+    if (type == "VEC2") {
+        return 2;
+    }
+    if (type == "VEC3") {
+        return 3;
+    }
+    if (type == "VEC4") {
+        return 4;
+    }
+
+    throw std::runtime_error("unsupported accessor type " + type + "!");
+}
+
+// Bytes of a buffer view, validated against its buffer
+std::pair<const uint8_t*, size_t> GetBufferView(
+    const JsonValue& json, const std::vector<BufferData>& buffers,
+    size_t view_index) {
+    const JsonValue& view = json["bufferViews"][view_index];
+    size_t buffer_index = view["buffer"].AsUnsigned(buffers.size());
+    size_t offset = view["byteOffset"].AsUnsigned(0);
+    size_t length = view["byteLength"].AsUnsigned(0);
+
+    if (!view.IsObject() || buffer_index >= buffers.size() ||
+        offset > buffers[buffer_index].size ||
+        length > buffers[buffer_index].size - offset) {
+        throw std::runtime_error("invalid buffer view " +
+                                 std::to_string(view_index) + "!");
+    }
+
+    return {buffers[buffer_index].data + offset, length};
+}
+
+AccessorView GetAccessorView(const JsonValue& json,
+                             const std::vector<BufferData>& buffers,
+                             size_t accessor_index) {
+    const JsonValue& accessor = json["accessors"][accessor_index];
+    std::string name = "accessor " + std::to_string(accessor_index);
+
+    if (!accessor.IsObject()) {
+        throw std::runtime_error("invalid " + name + "!");
+    }
+    if (!accessor["sparse"].IsNull()) {
+        throw std::runtime_error(name +
+                                 ": sparse accessors are not supported!");
+    }
+    if (accessor["bufferView"].IsNull()) {
+        throw std::runtime_error(name + ": accessors without a buffer view "
+                                        "are not supported!");
+    }
+
+    AccessorView view;
+    view.count = accessor["count"].AsUnsigned(0);
+    view.component_type = static_cast<ComponentType>(
+        accessor["componentType"].AsUnsigned(0));
+    view.component_count = GetComponentCount(accessor["type"].AsString());
+    view.normalized = accessor["normalized"].AsBool(false);
+
+    size_t component_size = GetComponentSize(view.component_type);
+    if (component_size == 0) {
+        throw std::runtime_error(name + ": invalid component type!");
+    }
+
+    size_t view_index = accessor["bufferView"].AsUnsigned(0);
+    auto [data, length] = GetBufferView(json, buffers, view_index);
+
+    size_t element_size = component_size * view.component_count;
+    size_t offset = accessor["byteOffset"].AsUnsigned(0);
+
+    // Without a byteStride the elements are tightly packed
+    const JsonValue& byte_stride =
+        json["bufferViews"][view_index]["byteStride"];
+    view.stride = byte_stride.AsUnsigned(element_size);
+    if (!byte_stride.IsNull() &&
+        (view.stride < GLTF_MIN_STRIDE || view.stride > GLTF_MAX_STRIDE ||
+         view.stride % 4 != 0 || view.stride < element_size)) {
+        throw std::runtime_error(name + ": invalid byteStride " +
+                                 std::to_string(view.stride) + "!");
+    }
+
+    // The last element has to end within the buffer view. The strides are
+    // compared to the bytes after the first element instead of multiplied,
+    // so a large count can not overflow.
+    if (offset > length) {
+        throw std::runtime_error(name + " exceeds its buffer view!");
+    }
+    size_t available = length - offset;
+    if (view.count > 0 &&
+        (element_size > available ||
+         view.count - 1 > (available - element_size) / view.stride)) {
+        throw std::runtime_error(name + " exceeds its buffer view!");
+    }
+
+    // Reading past the view, within the buffer, is harmless
+    const BufferData& buffer =
+        buffers[json["bufferViews"][view_index]["buffer"].AsUnsigned(0)];
+    view.data = data + offset;
+    view.buffer_end = buffer.data + buffer.size;
+
+    return view;
+}
+
+void ComputeBounds(const AccessorView& positions, std::array<float, 3>& min,
+                   std::array<float, 3>& max) {
+    /* Bounds of the positions when the accessor does not have min and max,
+    which the specification requires but not every exporter writes */
+    min.fill(std::numeric_limits<float>::max());
+    max.fill(std::numeric_limits<float>::lowest());
+
+    for (size_t i = 0; i < positions.count; i++) {
+        const uint8_t* element = positions.data + i * positions.stride;
+
+        for (size_t axis = 0; axis < 3; axis++) {
+            float value = 0.0F;
+            std::memcpy(&value, element + axis * sizeof(float), sizeof(value));
+            min[axis] = std::min(min[axis], value);
+            max[axis] = std::max(max[axis], value);
+        }
+    }
+}
+
+void WriteSequentialIndices(size_t first, size_t count, uint32_t index_size,
+                            uint8_t* output) {
+    for (size_t i = 0; i < count; i++) {
+        auto index = static_cast<uint32_t>(first + i);
+
+        if (index_size == 2) {
+            auto narrow = static_cast<uint16_t>(index);
+            std::memcpy(output + i * 2, &narrow, sizeof(narrow));
+        } else {
+            std::memcpy(output + i * 4, &index, sizeof(index));
+        }
+    }
+}
+
+void QueuePrimitiveConversion(const JsonValue& json,
+                              const std::vector<BufferData>& buffers,
+                              const JsonValue& primitive, MeshData& mesh,
+                              ThreadPool& thread_pool,
+                              ConversionTasks& conversion) {
+    /* The views are validated here, the tasks only convert ranges of them
+    into the already allocated streams of the mesh */
+    const JsonValue& attributes = primitive["attributes"];
+
+    if (attributes["POSITION"].IsNull()) {
+        throw std::runtime_error("a primitive has no POSITION attribute!");
+    }
+
+    AccessorView positions = GetAccessorView(
+        json, buffers, attributes["POSITION"].AsUnsigned(0));
+    if (positions.component_type != ComponentType::FLOAT ||
+        positions.component_count != 3) {
+        throw std::runtime_error("POSITION must be a float VEC3 accessor!");
+    }
+
+    size_t vertex_count = positions.count;
+    std::optional<AccessorView> normals;
+    std::optional<AccessorView> uvs;
+
+    if (!attributes["NORMAL"].IsNull()) {
+        normals = GetAccessorView(json, buffers,
+                                  attributes["NORMAL"].AsUnsigned(0));
+    }
+    if (!attributes["TEXCOORD_0"].IsNull()) {
+        uvs = GetAccessorView(json, buffers,
+                              attributes["TEXCOORD_0"].AsUnsigned(0));
+    }
+    if ((normals.has_value() && normals->count != vertex_count) ||
+        (uvs.has_value() && uvs->count != vertex_count)) {
+        throw std::runtime_error(
+            "the attributes of a primitive have different counts!");
+    }
+
+    // min and max of POSITION are the bounds the positions are quantized to
+    const JsonValue& position_accessor =
+        json["accessors"][attributes["POSITION"].AsUnsigned(0)];
+    const JsonValue& min = position_accessor["min"];
+    const JsonValue& max = position_accessor["max"];
+
+    if (min.Size() == 3 && max.Size() == 3) {
+        for (size_t axis = 0; axis < 3; axis++) {
+            mesh.bounds_min[axis] = static_cast<float>(min[axis].AsNumber(0));
+            mesh.bounds_max[axis] = static_cast<float>(max[axis].AsNumber(0));
+        }
+    } else {
+        ComputeBounds(positions, mesh.bounds_min, mesh.bounds_max);
+    }
+
+    std::optional<AccessorView> indices;
+    if (!primitive["indices"].IsNull()) {
+        indices =
+            GetAccessorView(json, buffers, primitive["indices"].AsUnsigned(0));
+
+        if (indices->component_count != 1 ||
+            indices->component_type == ComponentType::BYTE ||
+            indices->component_type == ComponentType::SHORT ||
+            indices->component_type == ComponentType::FLOAT) {
+            throw std::runtime_error("invalid index accessor!");
+        }
+    }
+
+    // The index count of a mesh is 32 bits
+    size_t index_count = indices.has_value() ? indices->count : vertex_count;
+    if (index_count > UINT32_MAX) {
+        throw std::runtime_error("too many indices in a primitive!");
+    }
+
+    // Same rule as BuildMesh, 16 bit indices whenever they are enough
+    mesh.index_count = static_cast<uint32_t>(index_count);
+    mesh.index_size = vertex_count <= UINT16_MAX + 1 ? 2 : 4;
+    mesh.vertices.resize(vertex_count);
+    mesh.indices.resize(size_t{mesh.index_count} * mesh.index_size);
+    mesh.lods = {{0, mesh.index_count, 0, 0.0F}};
+
+    PositionQuantization quantization =
+        GetPositionQuantization(mesh.bounds_min, mesh.bounds_max);
+
+    for (size_t first = 0; first < vertex_count;
+         first += CONVERSION_CHUNK_VERTICES) {
+        size_t count =
+            std::min(CONVERSION_CHUNK_VERTICES, vertex_count - first);
+
+        conversion.tasks.push_back(thread_pool.Submit([=, &mesh]() {
+            MeshVertex* vertices = mesh.vertices.data() + first;
+            ConvertPositions(positions, first, count, quantization, vertices);
+            if (normals.has_value()) {
+                ConvertNormals(normals.value(), first, count, vertices);
+            }
+            if (uvs.has_value()) {
+                ConvertUvs(uvs.value(), first, count, vertices);
+            }
+        }));
+    }
+
+    for (size_t first = 0; first < mesh.index_count;
+         first += CONVERSION_CHUNK_INDICES) {
+        size_t count =
+            std::min(CONVERSION_CHUNK_INDICES, mesh.index_count - first);
+
+        conversion.tasks.push_back(thread_pool.Submit([=, &mesh]() {
+            uint8_t* output = mesh.indices.data() + first * mesh.index_size;
+
+            // Without indices the primitive is a plain triangle list
+            if (!indices.has_value()) {
+                WriteSequentialIndices(first, count, mesh.index_size, output);
+                return;
+            }
+
+            // Indices out of range would make the GPU read past the vertices.
+            // The source indices are checked, the narrowing to 16 bits would
+            // bring them into range.
+            if (ConvertIndices(indices.value(), first, count, mesh.index_size,
+                               output) >= vertex_count) {
+                throw std::runtime_error("index out of range!");
+            }
+        }));
+    }
+}
+
+GltfImage DecodeImage(const JsonValue& json,
+                      const std::vector<BufferData>& buffers,
+                      const std::filesystem::path& directory,
+                      size_t image_index) {
+    const JsonValue& image = json["images"][image_index];
+
+    GltfImage result;
+    result.mime_type =
+        image["mimeType"].IsString() ? image["mimeType"].AsString() : "";
+
+    if (image["uri"].IsString()) {
+        const std::string& uri = image["uri"].AsString();
+        result.name = IsDataUri(uri) ? "" : uri;
+        result.data = ReadUri(uri, directory);
+
+        if (EndsWith(uri, ".ktx2")) {
+            result.mime_type = "image/ktx2";
+        }
+    } else if (image["bufferView"].IsNumber()) {
+        auto [data, size] =
+            GetBufferView(json, buffers, image["bufferView"].AsUnsigned(0));
+        result.data.assign(data, data + size);
+    } else {
+        throw std::runtime_error("image " + std::to_string(image_index) +
+                                 " has no data!");
+    }
+
+    if (result.name.empty()) {
+        result.name = "image " + std::to_string(image_index);
+    }
+
+    /* KTX2 images are parsed for streaming. Textures the streamer can not
+    read, e.g. supercompressed Basis Universal, are kept encoded like PNG and
+    JPEG images. */
+    if (result.mime_type == "image/ktx2") {
+        try {
+            result.texture = ParseKtx2File(result.data);
+            result.data.clear();
+            result.data.shrink_to_fit();
+        } catch (const std::runtime_error&) {
+            result.texture.reset();
+        }
+    }
+
+    return result;
+}
+
+GltfScene LoadScene(const std::string& filename, ThreadPool& thread_pool) {
+    std::filesystem::path directory =
+        std::filesystem::path(filename).parent_path();
+    std::vector<uint8_t> file_data = ReadFile(filename);
+
+    GltfScene scene;
+    scene.source_bytes = file_data.size();
+
+    /* A .glb holds the JSON and the first buffer in chunks, a .gltf is the
+    JSON alone */
+    const char* json_text = reinterpret_cast<const char*>(file_data.data());
+    size_t json_size = file_data.size();
+    const uint8_t* binary_chunk = nullptr;
+    size_t binary_chunk_size = 0;
+
+    if (file_data.size() >= GLB_HEADER_SIZE &&
+        ReadUint32(file_data.data()) == GLB_MAGIC) {
+        if (ReadUint32(file_data.data() + 4) != 2) {
+            throw std::runtime_error("unsupported binary glTF version!");
+        }
+
+        size_t offset = GLB_HEADER_SIZE;
+        size_t end = std::min<size_t>(ReadUint32(file_data.data() + 8),
+                                      file_data.size());
+        json_size = 0;
+
+        while (offset + GLB_CHUNK_HEADER_SIZE <= end) {
+            size_t chunk_size = ReadUint32(file_data.data() + offset);
+            uint32_t chunk_type = ReadUint32(file_data.data() + offset + 4);
+            offset += GLB_CHUNK_HEADER_SIZE;
+
+            if (chunk_size > end - offset) {
+                throw std::runtime_error("truncated binary glTF chunk!");
+            }
+
+            if (chunk_type == GLB_CHUNK_JSON && json_size == 0) {
+                json_text =
+                    reinterpret_cast<const char*>(file_data.data() + offset);
+                json_size = chunk_size;
+            } else if (chunk_type == GLB_CHUNK_BIN && binary_chunk == nullptr) {
+                binary_chunk = file_data.data() + offset;
+                binary_chunk_size = chunk_size;
+            }
+
+            // Chunks are padded to 4 bytes
+            offset += (chunk_size + 3) / 4 * 4;
+        }
+
+        if (json_size == 0) {
+            throw std::runtime_error("binary glTF without a JSON chunk!");
+        }
+    }
+
+    JsonValue json = ParseJson(json_text, json_size);
+
+    std::string version = json["asset"]["version"].IsString()
+                              ? json["asset"]["version"].AsString()
+                              : "";
+    if (version.compare(0, 2, "2.") != 0) {
+        throw std::runtime_error("only glTF 2.0 is supported!");
+    }
+
+    /* Read the buffers and the images with a URI in parallel */
+    size_t buffer_count = json["buffers"].Size();
+    size_t image_count = json["images"].Size();
+
+    std::vector<BufferData> buffers(buffer_count);
+    std::vector<std::future<std::vector<uint8_t>>> buffer_tasks(buffer_count);
+    std::vector<std::future<GltfImage>> image_tasks(image_count);
+
+    for (size_t i = 0; i < buffer_count; i++) {
+        if (!json["buffers"][i]["uri"].IsString() &&
+            (i != 0 || binary_chunk == nullptr)) {
+            throw std::runtime_error("buffer " + std::to_string(i) +
+                                     " has no data!");
+        }
+    }
+
+    for (size_t i = 0; i < buffer_count; i++) {
+        const JsonValue& buffer = json["buffers"][i];
+
+        if (buffer["uri"].IsString()) {
+            buffer_tasks[i] = thread_pool.Submit([&buffer, &directory]() {
+                return ReadUri(buffer["uri"].AsString(), directory);
+            });
+        } else {
+            buffers[i].data = binary_chunk;
+            buffers[i].size = binary_chunk_size;
+        }
+    }
+
+    for (size_t i = 0; i < image_count; i++) {
+        if (json["images"][i]["uri"].IsString()) {
+            image_tasks[i] =
+                thread_pool.Submit([&json, &buffers, &directory, i]() {
+                    return DecodeImage(json, buffers, directory, i);
+                });
+        }
+    }
+
+    // Every task is waited for before an exception leaves the function
+    std::exception_ptr error;
+    for (size_t i = 0; i < buffer_count; i++) {
+        if (!buffer_tasks[i].valid()) {
+            continue;
+        }
+
+        try {
+            buffers[i].storage = buffer_tasks[i].get();
+            buffers[i].data = buffers[i].storage.data();
+            buffers[i].size = buffers[i].storage.size();
+
+            // Data URIs are part of the file already
+            if (!IsDataUri(json["buffers"][i]["uri"].AsString())) {
+                scene.source_bytes += buffers[i].size;
+            }
+        } catch (...) {
+            error = error != nullptr ? error : std::current_exception();
+        }
+    }
+
+    for (size_t i = 0; i < buffer_count && error == nullptr; i++) {
+        if (buffers[i].size < json["buffers"][i]["byteLength"].AsUnsigned(0)) {
+            error = std::make_exception_ptr(std::runtime_error(
+                "buffer " + std::to_string(i) + " is too short!"));
+        }
+    }
+
+    /* Images in buffer views and the accessors need the buffers */
+    std::vector<const JsonValue*> primitives;
+    for (const JsonValue& mesh : json["meshes"].AsArray()) {
+        for (const JsonValue& primitive : mesh["primitives"].AsArray()) {
+            if (primitive["mode"].AsUnsigned(PRIMITIVE_MODE_TRIANGLES) ==
+                PRIMITIVE_MODE_TRIANGLES) {
+                primitives.push_back(&primitive);
+            } else {
+                scene.skipped_primitives++;
+            }
+        }
+    }
+
+    // The tasks write into the meshes, they must not be reallocated
+    scene.meshes.resize(primitives.size());
+    ConversionTasks conversion;
+
+    if (error == nullptr) {
+        try {
+            for (size_t i = 0; i < image_count; i++) {
+                if (!image_tasks[i].valid()) {
+                    image_tasks[i] =
+                        thread_pool.Submit([&json, &buffers, &directory, i]() {
+                            return DecodeImage(json, buffers, directory, i);
+                        });
+                }
+            }
+
+            for (size_t i = 0; i < primitives.size(); i++) {
+                QueuePrimitiveConversion(json, buffers, *primitives[i],
+                                         scene.meshes[i], thread_pool,
+                                         conversion);
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+
+    try {
+        conversion.Wait();
+    } catch (...) {
+        error = error != nullptr ? error : std::current_exception();
+    }
+
+    for (auto& image_task : image_tasks) {
+        if (!image_task.valid()) {
+            continue;
+        }
+
+        try {
+            scene.images.push_back(image_task.get());
+        } catch (...) {
+            error = error != nullptr ? error : std::current_exception();
+        }
+    }
+
+    if (error != nullptr) {
+        std::rethrow_exception(error);
+    }
+
+    // Images in buffer views are part of the buffers already
+    for (size_t i = 0; i < image_count; i++) {
+        const JsonValue& uri = json["images"][i]["uri"];
+
+        if (uri.IsString() && !IsDataUri(uri.AsString())) {
+            const GltfImage& image = scene.images[i];
+            scene.source_bytes += image.texture.has_value()
+                                      ? image.texture->data.size()
+                                      : image.data.size();
+        }
+    }
+
+    return scene;
+}
+
+}  // namespace
+
+GltfScene LoadGltfFile(const std::string& filename, ThreadPool& thread_pool) {
+    try {
+        return LoadScene(filename, thread_pool);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(filename + ": " + e.what());
+    }
+}
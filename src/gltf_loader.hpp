@@ -0,0 +1,50 @@
+#ifndef GLTF_LOADER_H
+#define GLTF_LOADER_H
+
+/* Local header files */
+#include "ktx2_file.hpp"
+#include "mesh_file.hpp"
+#include "thread_pool.hpp"
+
+/* Standard libraries */
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Image of a glTF file. KTX2 images (KHR_texture_basisu or a image/ktx2
+// mime type) are parsed and ready to stream, other images are kept encoded.
+struct GltfImage {
+    std::string name;
+    std::string mime_type;
+    std::vector<uint8_t> data;
+    std::optional<Ktx2File> texture;
+};
+
+struct GltfScene {
+    // One mesh per triangle list primitive, in the layout of the binary mesh
+    // container without meshlets
+    std::vector<MeshData> meshes;
+    std::vector<GltfImage> images;
+
+    size_t skipped_primitives = 0;  // Points, lines and strips
+    size_t source_bytes = 0;        // The file, its buffers and images
+};
+
+/* glTF 2.0 reader (.gltf with external or data URI buffers, and .glb)
+
+The decoding runs on the thread pool: the buffers and images are read in
+parallel, then the accessors of every primitive are converted into
+MeshVertex and 16 or 32 bit indices in ranges of a fixed number of vertices,
+so a single large primitive is spread over all threads. The conversion of
+float attributes uses SIMD, see vertex_conversion.hpp.
+
+Only the geometry of the primitives is read: POSITION, NORMAL and TEXCOORD_0
+(missing normals are zero, missing texture coordinates are 0, 0). The node
+hierarchy, materials and animations are ignored. Throws std::runtime_error
+for files that can not be read or are not valid, sparse accessors are not
+supported.
+*/
+GltfScene LoadGltfFile(const std::string& filename, ThreadPool& thread_pool);
+
+#endif  // GLTF_LOADER_H
@@ -0,0 +1,358 @@
+/* Local header files */
+#include "json_value.hpp"
+
+/* Standard libraries */
+#include <cmath>
+#include <cstdint>  // Required for uint32_t
+#include <cstdlib>  // Required for std::strtod
+#include <limits>   // Required for std::numeric_limits
+#include <stdexcept>
+
+namespace {
+
+const JsonValue NULL_VALUE;
+const std::string EMPTY_STRING;
+const JsonValue::Array EMPTY_ARRAY;
+
+// Nesting limit, so malicious files can not overflow the stack
+constexpr size_t MAX_DEPTH = 256;
+
+class JsonParser {
+   public:
+    JsonParser(const char* begin, const char* end)
+        : cursor(begin), end(end) {}
+
+    JsonValue ParseDocument() {
+        JsonValue value = ParseValue(0);
+        SkipWhitespace();
+
+        if (cursor != end) {
+            Fail("unexpected data after the document");
+        }
+
+        return value;
+    }
+
+   private:
+    const char* cursor;
+    const char* end;
+
+    [[noreturn]] static void Fail(const std::string& message) {
+        throw std::runtime_error("JSON Error: " + message + "!");
+    }
+
+    void SkipWhitespace() {
+        while (cursor < end && (*cursor == ' ' || *cursor == '\t' ||
+                                *cursor == '\n' || *cursor == '\r')) {
+            cursor++;
+        }
+    }
+
+    void Expect(char c) {
+        SkipWhitespace();
+        if (cursor >= end || *cursor != c) {
+            Fail(std::string("expected '") + c + "'");
+        }
+        cursor++;
+    }
+
+    bool Consume(const char* literal) {
+        const char* position = cursor;
+        for (; *literal != '\0'; literal++, position++) {
+            if (position >= end || *position != *literal) {
+                return false;
+            }
+        }
+        cursor = position;
+        return true;
+    }
+
+    JsonValue ParseValue(size_t depth) {
+        if (depth > MAX_DEPTH) {
+            Fail("document nested too deeply");
+        }
+
+        SkipWhitespace();
+        if (cursor >= end) {
+            Fail("unexpected end of the document");
+        }
+
+        switch (*cursor) {
+            case '{':
+                return ParseObject(depth);
+            case '[':
+                return ParseArray(depth);
+            case '"':
+                return JsonValue(ParseString());
+            default:
+                break;
+        }
+
+        if (Consume("true")) {
+            return JsonValue(true);
+        }
+        if (Consume("false")) {
+            return JsonValue(false);
+        }
+        if (Consume("null")) {
+            return {};
+        }
+
+        return JsonValue(ParseNumber());
+    }
+
+    JsonValue ParseObject(size_t depth) {
+        Expect('{');
+        JsonValue::Object object;
+
+        SkipWhitespace();
+        if (cursor < end && *cursor == '}') {
+            cursor++;
+            return JsonValue(std::move(object));
+        }
+
+        while (true) {
+            SkipWhitespace();
+            std::string key = ParseString();
+            Expect(':');
+            object.emplace_back(std::move(key), ParseValue(depth + 1));
+
+            SkipWhitespace();
+            if (cursor < end && *cursor == ',') {
+                cursor++;
+                continue;
+            }
+
+            Expect('}');
+            return JsonValue(std::move(object));
+        }
+    }
+
+    JsonValue ParseArray(size_t depth) {
+        Expect('[');
+        JsonValue::Array array;
+
+        SkipWhitespace();
+        if (cursor < end && *cursor == ']') {
+            cursor++;
+            return JsonValue(std::move(array));
+        }
+
+        while (true) {
+            array.push_back(ParseValue(depth + 1));
+
+            SkipWhitespace();
+            if (cursor < end && *cursor == ',') {
+                cursor++;
+                continue;
+            }
+
+            Expect(']');
+            return JsonValue(std::move(array));
+        }
+    }
+
+    double ParseNumber() {
+        // strtod would read past the end of unterminated text, the number is
+        // copied first
+        const char* start = cursor;
+        while (cursor < end &&
+               (std::string("+-.0123456789eE").find(*cursor) !=
+                std::string::npos)) {
+            cursor++;
+        }
+
+        std::string text(start, cursor);
+        char* number_end = nullptr;
+        double value = std::strtod(text.c_str(), &number_end);
+
+        if (text.empty() || number_end != text.c_str() + text.size()) {
+            Fail("invalid value");
+        }
+
+        return value;
+    }
+
+    uint32_t ParseHexDigits() {
+        if (end - cursor < 4) {
+            Fail("invalid escape sequence");
+        }
+
+        std::string digits(cursor, cursor + 4);
+        char* digits_end = nullptr;
+        auto code = static_cast<uint32_t>(std::strtoul(digits.c_str(),
+                                                       &digits_end, 16));
+        if (digits_end != digits.c_str() + 4) {
+            Fail("invalid escape sequence");
+        }
+
+        cursor += 4;
+        return code;
+    }
+
+    static void AppendUtf8(std::string& text, uint32_t code) {
+        if (code < 0x80) {
+            text += static_cast<char>(code);
+        } else if (code < 0x800) {
+            text += static_cast<char>(0xC0 | (code >> 6));
+            text += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            text += static_cast<char>(0xE0 | (code >> 12));
+            text += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            text += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            text += static_cast<char>(0xF0 | (code >> 18));
+            text += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            text += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            text += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    std::string ParseString() {
+        Expect('"');
+        std::string text;
+
+        while (true) {
+            if (cursor >= end) {
+                Fail("unterminated string");
+            }
+
+            char c = *cursor++;
+            if (c == '"') {
+                return text;
+            }
+
+            if (c != '\\') {
+                text += c;
+                continue;
+            }
+
+            if (cursor >= end) {
+                Fail("unterminated string");
+            }
+
+            char escape = *cursor++;
+            switch (escape) {
+                case '"':
+                case '\\':
+                case '/':
+                    text += escape;
+                    break;
+                case 'b':
+                    text += '\b';
+                    break;
+                case 'f':
+                    text += '\f';
+                    break;
+                case 'n':
+                    text += '\n';
+                    break;
+                case 'r':
+                    text += '\r';
+                    break;
+                case 't':
+                    text += '\t';
+                    break;
+                case 'u': {
+                    uint32_t code = ParseHexDigits();
+
+                    // Characters outside the basic multilingual plane are
+                    // escaped as surrogate pairs, a surrogate on its own is
+                    // not a character
+                    if (code >= 0xDC00 && code < 0xE000) {
+                        Fail("unpaired low surrogate");
+                    }
+                    if (code >= 0xD800 && code < 0xDC00) {
+                        if (!Consume("\\u")) {
+                            Fail("unpaired high surrogate");
+                        }
+                        uint32_t low = ParseHexDigits();
+                        if (low < 0xDC00 || low >= 0xE000) {
+                            Fail("invalid low surrogate");
+                        }
+                        code = 0x10000 + ((code - 0xD800) << 10) +
+                               (low - 0xDC00);
+                    }
+
+                    AppendUtf8(text, code);
+                    break;
+                }
+                default:
+                    Fail("invalid escape sequence");
+            }
+        }
+    }
+};
+
+}  // namespace
+
+JsonValue::JsonValue(bool value) : type(Type::BOOLEAN), boolean(value) {}
+
+JsonValue::JsonValue(double value) : type(Type::NUMBER), number(value) {}
+
+JsonValue::JsonValue(std::string value)
+    : type(Type::STRING), string(std::move(value)) {}
+
+JsonValue::JsonValue(Array value)
+    : type(Type::ARRAY), array(std::move(value)) {}
+
+JsonValue::JsonValue(Object value)
+    : type(Type::OBJECT), object(std::move(value)) {}
+
+bool JsonValue::AsBool(bool default_value) const {
+    return type == Type::BOOLEAN ? boolean : default_value;
+}
+
+double JsonValue::AsNumber(double default_value) const {
+    return type == Type::NUMBER ? number : default_value;
+}
+
+size_t JsonValue::AsUnsigned(size_t default_value) const {
+    if (type != Type::NUMBER) {
+        return default_value;
+    }
+
+    // The cast is undefined for values outside of the range of size_t, the
+    // bound 2^digits is exact as a double
+    double limit = std::ldexp(1.0, std::numeric_limits<size_t>::digits);
+    if (!std::isfinite(number) || number < 0 || number >= limit) {
+        throw std::runtime_error(
+            "JSON Error: a number is not a valid unsigned integer!");
+    }
+
+    return static_cast<size_t>(number);
+}
+
+const std::string& JsonValue::AsString() const {
+    return type == Type::STRING ? string : EMPTY_STRING;
+}
+
+const JsonValue::Array& JsonValue::AsArray() const {
+    return type == Type::ARRAY ? array : EMPTY_ARRAY;
+}
+
+const JsonValue& JsonValue::operator[](const std::string& key) const {
+    for (const auto& member : object) {
+        if (member.first == key) {
+            return member.second;
+        }
+    }
+
+    return NULL_VALUE;
+}
+
+const JsonValue& JsonValue::operator[](size_t index) const {
+    return index < array.size() ? array[index] : NULL_VALUE;
+}
+
+size_t JsonValue::Size() const {
+    if (type == Type::ARRAY) {
+        return array.size();
+    }
+
+    return type == Type::OBJECT ? object.size() : 0;
+}
+
+JsonValue ParseJson(const char* text, size_t size) {
+    return JsonParser(text, text + size).ParseDocument();
+}
@@ -0,0 +1,69 @@
+#ifndef JSON_VALUE_H
+#define JSON_VALUE_H
+
+/* Standard libraries */
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* Parsed JSON document
+
+A small reader for the JSON of asset formats such as glTF. Looking up a
+missing member or element returns a null value, so optional properties are
+read with a default:
+
+    uint32_t stride = view["byteStride"].AsUnsigned(0);
+*/
+class JsonValue {
+   public:
+    enum class Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+    using Array = std::vector<JsonValue>;
+    using Object = std::vector<std::pair<std::string, JsonValue>>;
+
+    JsonValue() = default;
+    explicit JsonValue(bool value);
+    explicit JsonValue(double value);
+    explicit JsonValue(std::string value);
+    explicit JsonValue(Array value);
+    explicit JsonValue(Object value);
+
+    Type GetType() const { return type; }
+    bool IsNull() const { return type == Type::NUL; }
+    bool IsNumber() const { return type == Type::NUMBER; }
+    bool IsString() const { return type == Type::STRING; }
+    bool IsArray() const { return type == Type::ARRAY; }
+    bool IsObject() const { return type == Type::OBJECT; }
+
+    // Values of a type, or the default if the value has another type.
+    // AsUnsigned throws std::runtime_error for a number that is negative,
+    // not finite or too large for size_t.
+    bool AsBool(bool default_value) const;
+    double AsNumber(double default_value) const;
+    size_t AsUnsigned(size_t default_value) const;
+    const std::string& AsString() const;
+    const Array& AsArray() const;
+
+    // Member of an object, or null
+    const JsonValue& operator[](const std::string& key) const;
+
+    // Element of an array, or null
+    const JsonValue& operator[](size_t index) const;
+
+    // Number of elements of an array or members of an object
+    size_t Size() const;
+
+   private:
+    Type type = Type::NUL;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    Array array;
+    Object object;
+};
+
+// Parse a JSON text. Throws std::runtime_error for malformed JSON.
+JsonValue ParseJson(const char* text, size_t size);
+
+#endif  // JSON_VALUE_H
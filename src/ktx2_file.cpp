@@ -0,0 +1,143 @@
+/* Local header files */
+#include "ktx2_file.hpp"
+
+#include "texture_format.hpp"
+
+/* Standard libraries */
+#include <algorithm>  // Required for std::max
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+
+namespace {
+
+// «KTX 20»\r\n\x1A\n
+const std::array<uint8_t, 12> KTX2_IDENTIFIER = {
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+// Identifier, header, index and level index layout of the specification
+constexpr size_t HEADER_SIZE = 80;
+constexpr size_t LEVEL_INDEX_ENTRY_SIZE = 24;
+
+enum class HeaderField : size_t {
+    VK_FORMAT = 12,
+    TYPE_SIZE = 16,
+    PIXEL_WIDTH = 20,
+    PIXEL_HEIGHT = 24,
+    PIXEL_DEPTH = 28,
+    LAYER_COUNT = 32,
+    FACE_COUNT = 36,
+    LEVEL_COUNT = 40,
+    SUPERCOMPRESSION_SCHEME = 44,
+};
+
+template <typename T>
+T Read(const std::vector<uint8_t>& data, size_t offset) {
+    // KTX2 files are little endian, like every platform the renderer runs on
+    T value{};
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+}
+
+uint32_t ReadField(const std::vector<uint8_t>& data, HeaderField field) {
+    return Read<uint32_t>(data, static_cast<size_t>(field));
+}
+
+}  // namespace
+
+Ktx2File LoadKtx2File(const std::string& filename) {
+    std::ifstream file(filename, std::ios::ate | std::ios::binary);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("failed to open file: " + filename + "!");
+    }
+
+    auto file_size = static_cast<size_t>(file.tellg());
+    std::vector<uint8_t> data(file_size);
+
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(data.data()),
+              static_cast<std::streamsize>(file_size));
+
+    try {
+        return ParseKtx2File(std::move(data));
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(filename + ": " + e.what());
+    }
+}
+
+Ktx2File ParseKtx2File(std::vector<uint8_t> data) {
+    if (data.size() < HEADER_SIZE ||
+        !std::equal(KTX2_IDENTIFIER.begin(), KTX2_IDENTIFIER.end(),
+                    data.begin())) {
+        throw std::runtime_error("not a KTX2 file!");
+    }
+
+    Ktx2File ktx;
+    ktx.format = static_cast<VkFormat>(ReadField(data, HeaderField::VK_FORMAT));
+    ktx.width = ReadField(data, HeaderField::PIXEL_WIDTH);
+    ktx.height = ReadField(data, HeaderField::PIXEL_HEIGHT);
+
+    if (ktx.format == VK_FORMAT_UNDEFINED) {
+        throw std::runtime_error(
+            "Basis Universal textures are not supported, transcode them to "
+            "BCn or ASTC!");
+    }
+
+    if (ReadField(data, HeaderField::SUPERCOMPRESSION_SCHEME) != 0) {
+        throw std::runtime_error("supercompressed textures are not supported!");
+    }
+
+    std::optional<FormatBlock> block = GetFormatBlock(ktx.format);
+    if (!block.has_value()) {
+        throw std::runtime_error("the texture format is not supported!");
+    }
+
+    // Only 2D textures with a single layer and face
+    if (ktx.width == 0 || ktx.height == 0 ||
+        ReadField(data, HeaderField::PIXEL_DEPTH) > 1 ||
+        ReadField(data, HeaderField::LAYER_COUNT) > 1 ||
+        ReadField(data, HeaderField::FACE_COUNT) != 1) {
+        throw std::runtime_error("only 2D textures are supported!");
+    }
+
+    // A level count of 0 asks the loader to generate the mip chain, the
+    // file stores level 0 only
+    uint32_t level_count =
+        std::max(ReadField(data, HeaderField::LEVEL_COUNT), 1U);
+
+    if (data.size() < HEADER_SIZE + level_count * LEVEL_INDEX_ENTRY_SIZE) {
+        throw std::runtime_error("the level index is truncated!");
+    }
+
+    for (uint32_t level = 0; level < level_count; level++) {
+        size_t entry = HEADER_SIZE + level * LEVEL_INDEX_ENTRY_SIZE;
+
+        Ktx2Level ktx_level;
+        ktx_level.width = std::max(ktx.width >> level, 1U);
+        ktx_level.height = std::max(ktx.height >> level, 1U);
+        ktx_level.offset = Read<uint64_t>(data, entry);
+        ktx_level.size = Read<uint64_t>(data, entry + 8);
+
+        if (ktx_level.size !=
+                GetLevelSize(block.value(), ktx_level.width,
+                             ktx_level.height) ||
+            ktx_level.offset > data.size() ||
+            ktx_level.size > data.size() - ktx_level.offset) {
+            throw std::runtime_error("level " + std::to_string(level) +
+                                     " is malformed!");
+        }
+
+        ktx.levels.push_back(ktx_level);
+
+        // Stop at the 1x1 level, whatever the level count says
+        if (ktx_level.width == 1 && ktx_level.height == 1) {
+            break;
+        }
+    }
+
+    ktx.data = std::move(data);
+    return ktx;
+}
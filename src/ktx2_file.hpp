@@ -0,0 +1,45 @@
+#ifndef KTX2_FILE_H
+#define KTX2_FILE_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Standard libraries */
+#include <cstdint>  // Required for uint32_t
+#include <string>
+#include <vector>
+
+/* KTX 2.0 texture container
+
+Only what the texture streamer needs is read: the Vulkan format, the size and
+the image levels of a 2D texture with a single layer and face. Supercompressed
+files (BasisLZ, Zstandard) and Basis Universal textures are rejected, they
+have to be transcoded to BCn or ASTC offline.
+*/
+struct Ktx2Level {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    size_t offset = 0;  // Offset of the level in the file data
+    size_t size = 0;
+};
+
+struct Ktx2File {
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    // Levels stored in the file, level 0 is the full size image. A file
+    // may store fewer levels than the full mip chain.
+    std::vector<Ktx2Level> levels;
+
+    std::vector<uint8_t> data;
+};
+
+// Read and validate a KTX2 file. Throws std::runtime_error for files that
+// can not be read or are not supported.
+Ktx2File LoadKtx2File(const std::string& filename);
+
+// Parse KTX2 file data that is already in memory
+Ktx2File ParseKtx2File(std::vector<uint8_t> data);
+
+#endif  // KTX2_FILE_H
@@ -0,0 +1,126 @@
+/* Local header files */
+#include "latency_tracker.hpp"
+
+#include "frame_statistics.hpp"
+
+/* Standard libraries */
+#include <iomanip>
+
+namespace {
+
+double Milliseconds(LatencyTracker::Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void PrintSummary(std::ostream& stream, const std::string& stage,
+                  const std::vector<double>& samples) {
+    SampleSummary summary = Summarize(samples);
+    stream << "    " << std::left << std::setw(20) << stage << std::right
+           << std::fixed << std::setprecision(3) << " p50 " << std::setw(8)
+           << summary.p50 << " p90 " << std::setw(8) << summary.p90
+           << " p99 " << std::setw(8) << summary.p99 << " max "
+           << std::setw(8) << summary.max << " ms (" << summary.count
+           << " samples)\n";
+}
+
+}  // namespace
+
+void LatencyTracker::SetConfiguration(const std::string& label) {
+    // Frames of the previous configuration can no longer be attributed
+    frames.clear();
+    pending_input.reset();
+    configurations.emplace_back(label, ConfigurationSamples{});
+}
+
+void LatencyTracker::StampInput(Clock::time_point time) {
+    // Keep the oldest unconsumed input, it has the highest latency
+    if (!pending_input.has_value()) {
+        pending_input = time;
+    }
+}
+
+void LatencyTracker::BeginFrame(uint64_t frame_id) {
+    if (!pending_input.has_value()) {
+        return;
+    }
+
+    FrameStamps stamps;
+    stamps.input = pending_input.value();
+    frames[frame_id] = stamps;
+    pending_input.reset();
+}
+
+void LatencyTracker::MarkRecorded(uint64_t frame_id) {
+    auto frame = frames.find(frame_id);
+    if (frame != frames.end()) {
+        frame->second.recorded = Clock::now();
+    }
+}
+
+void LatencyTracker::MarkSubmitted(uint64_t frame_id) {
+    auto frame = frames.find(frame_id);
+    if (frame != frames.end()) {
+        frame->second.submitted = Clock::now();
+    }
+}
+
+void LatencyTracker::MarkPresented(uint64_t frame_id) {
+    auto frame = frames.find(frame_id);
+    if (frame != frames.end()) {
+        frame->second.presented = Clock::now();
+    }
+}
+
+void LatencyTracker::MarkCompleted(uint64_t frame_id, Clock::time_point time) {
+    auto frame = frames.find(frame_id);
+    if (frame == frames.end()) {
+        return;
+    }
+
+    const FrameStamps& stamps = frame->second;
+
+    // Only frames that went through every stage produce a sample
+    if (stamps.recorded.has_value() && stamps.submitted.has_value() &&
+        stamps.presented.has_value()) {
+        ConfigurationSamples& samples = CurrentConfiguration();
+        samples.to_record.push_back(
+            Milliseconds(stamps.recorded.value() - stamps.input));
+        samples.to_submit.push_back(
+            Milliseconds(stamps.submitted.value() - stamps.input));
+        samples.to_present.push_back(
+            Milliseconds(stamps.presented.value() - stamps.input));
+        samples.to_complete.push_back(Milliseconds(time - stamps.input));
+    }
+
+    frames.erase(frame);
+}
+
+void LatencyTracker::DiscardFrame(uint64_t frame_id) {
+    frames.erase(frame_id);
+}
+
+size_t LatencyTracker::CompletedFrameCount() const {
+    if (configurations.empty()) {
+        return 0;
+    }
+    return configurations.back().second.to_complete.size();
+}
+
+void LatencyTracker::Report(std::ostream& stream) const {
+    stream << "Input-to-present latency\n";
+
+    for (const auto& [label, samples] : configurations) {
+        stream << "  " << label << '\n';
+        PrintSummary(stream, "input -> record", samples.to_record);
+        PrintSummary(stream, "input -> submit", samples.to_submit);
+        PrintSummary(stream, "input -> present", samples.to_present);
+        PrintSummary(stream, "input -> complete", samples.to_complete);
+    }
+}
+
+LatencyTracker::ConfigurationSamples& LatencyTracker::CurrentConfiguration() {
+    if (configurations.empty()) {
+        configurations.emplace_back("default", ConfigurationSamples{});
+    }
+    return configurations.back().second;
+}
@@ -0,0 +1,75 @@
+#ifndef LATENCY_TRACKER_H
+#define LATENCY_TRACKER_H
+
+/* Standard libraries */
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* Follows input events through the stages of a frame
+
+An input timestamp is taken when an event is read from GLFW. The next frame
+that starts consumes the earliest pending input and is then stamped when its
+command buffer is recorded, submitted, handed to the presentation engine and
+finally completed. Completion is either the present completion reported by
+VK_KHR_present_wait or the in flight fence of the frame.
+
+Samples are grouped by configuration, e.g. present mode and frames in flight,
+so one run can sweep over several configurations and report each of them.
+*/
+class LatencyTracker {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    // Start collecting samples for a new configuration
+    void SetConfiguration(const std::string& label);
+
+    // An input event was read at the given time
+    void StampInput(Clock::time_point time);
+
+    // Frame stages. The frame id must be unique and increasing.
+    void BeginFrame(uint64_t frame_id);
+    void MarkRecorded(uint64_t frame_id);
+    void MarkSubmitted(uint64_t frame_id);
+    void MarkPresented(uint64_t frame_id);
+    void MarkCompleted(uint64_t frame_id, Clock::time_point time);
+
+    // The frame will never complete, e.g. the swap chain was out of date
+    void DiscardFrame(uint64_t frame_id);
+
+    // Number of frames that completed with an input sample for the current
+    // configuration
+    size_t CompletedFrameCount() const;
+
+    // Print the latency percentiles of every configuration
+    void Report(std::ostream& stream) const;
+
+   private:
+    struct FrameStamps {
+        Clock::time_point input;
+        std::optional<Clock::time_point> recorded;
+        std::optional<Clock::time_point> submitted;
+        std::optional<Clock::time_point> presented;
+    };
+
+    // Latencies in milliseconds from the input event to each frame stage
+    struct ConfigurationSamples {
+        std::vector<double> to_record;
+        std::vector<double> to_submit;
+        std::vector<double> to_present;
+        std::vector<double> to_complete;
+    };
+
+    std::optional<Clock::time_point> pending_input;
+    std::map<uint64_t, FrameStamps> frames;
+    std::vector<std::pair<std::string, ConfigurationSamples>> configurations;
+
+    ConfigurationSamples& CurrentConfiguration();
+};
+
+#endif  // LATENCY_TRACKER_H
@@ -0,0 +1,153 @@
+/* Local header files */
+#include "lod_generator.hpp"
+
+/* Standard libraries */
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <utility>  // Required for std::move
+
+namespace {
+
+SourceLod ClusterVertices(const SourceMesh& source, const glm::vec3& min,
+                          const glm::vec3& cell_size, uint32_t cells) {
+    bool has_normals = source.normals.size() == source.positions.size();
+    bool has_uvs = source.uvs.size() == source.positions.size();
+
+    /* Cell of every vertex, the cells are numbered in the order their first
+    vertex appears so the output does not depend on the hash map */
+    std::unordered_map<uint64_t, uint32_t> cell_vertices;
+    std::vector<uint32_t> remap(source.positions.size());
+    std::vector<uint32_t> cluster_sizes;
+
+    SourceLod lod;
+    SourceMesh& mesh = lod.mesh;
+
+    for (size_t i = 0; i < source.positions.size(); i++) {
+        const glm::vec3& position = source.positions[i];
+        uint64_t key = 0;
+        for (size_t axis = 0; axis < 3; axis++) {
+            auto cell = static_cast<uint64_t>(std::clamp(
+                (position[axis] - min[axis]) / cell_size[axis], 0.0F,
+                static_cast<float>(cells - 1)));
+            key = key * cells + cell;
+        }
+
+        auto [it, inserted] = cell_vertices.emplace(
+            key, static_cast<uint32_t>(mesh.positions.size()));
+        if (inserted) {
+            mesh.positions.emplace_back(0.0F, 0.0F, 0.0F);
+            if (has_normals) {
+                mesh.normals.emplace_back(0.0F, 0.0F, 0.0F);
+            }
+            if (has_uvs) {
+                mesh.uvs.emplace_back(0.0F, 0.0F);
+            }
+            cluster_sizes.push_back(0);
+        }
+
+        uint32_t cluster = it->second;
+        remap[i] = cluster;
+        cluster_sizes[cluster]++;
+
+        // Sums for now, averaged below. The normals stay sums, BuildMesh
+        // normalizes them.
+        glm::vec3& sum = mesh.positions[cluster];
+        sum = {sum.x + position.x, sum.y + position.y, sum.z + position.z};
+        if (has_normals) {
+            glm::vec3& normal = mesh.normals[cluster];
+            const glm::vec3& source_normal = source.normals[i];
+            normal = {normal.x + source_normal.x, normal.y + source_normal.y,
+                      normal.z + source_normal.z};
+        }
+        if (has_uvs) {
+            glm::vec2& uv = mesh.uvs[cluster];
+            uv = {uv.x + source.uvs[i].x, uv.y + source.uvs[i].y};
+        }
+    }
+
+    for (size_t cluster = 0; cluster < mesh.positions.size(); cluster++) {
+        auto size = static_cast<float>(cluster_sizes[cluster]);
+        glm::vec3& position = mesh.positions[cluster];
+        position = {position.x / size, position.y / size, position.z / size};
+        if (has_uvs) {
+            glm::vec2& uv = mesh.uvs[cluster];
+            uv = {uv.x / size, uv.y / size};
+        }
+    }
+
+    // The error is how far the farthest vertex moved to its cluster
+    for (size_t i = 0; i < source.positions.size(); i++) {
+        const glm::vec3& a = source.positions[i];
+        const glm::vec3& b = mesh.positions[remap[i]];
+        float dx = a.x - b.x;
+        float dy = a.y - b.y;
+        float dz = a.z - b.z;
+        lod.error = std::max(lod.error, std::sqrt(dx * dx + dy * dy + dz * dz));
+    }
+
+    /* Triangles with two corners in the same cell collapse */
+    for (size_t i = 0; i + 2 < source.indices.size(); i += 3) {
+        uint32_t a = remap[source.indices[i]];
+        uint32_t b = remap[source.indices[i + 1]];
+        uint32_t c = remap[source.indices[i + 2]];
+        if (a != b && b != c && a != c) {
+            mesh.indices.insert(mesh.indices.end(), {a, b, c});
+        }
+    }
+
+    return lod;
+}
+
+}  // namespace
+
+std::vector<SourceLod> GenerateLods(const SourceMesh& source,
+                                    uint32_t max_lod_count) {
+    std::vector<SourceLod> lods;
+    if (source.positions.empty() || max_lod_count == 0) {
+        return lods;
+    }
+
+    glm::vec3 min = source.positions[0];
+    glm::vec3 max = min;
+    for (const auto& position : source.positions) {
+        min = {std::min(min.x, position.x), std::min(min.y, position.y),
+               std::min(min.z, position.z)};
+        max = {std::max(max.x, position.x), std::max(max.y, position.y),
+               std::max(max.z, position.z)};
+    }
+
+    // Power of two cells per axis near sqrt(vertex count), the vertices of a
+    // surface grow with the square of its resolution
+    uint32_t cells = 1;
+    auto target_cells = static_cast<uint32_t>(
+        std::sqrt(static_cast<double>(source.positions.size())));
+    while (cells * 2 <= target_cells) {
+        cells *= 2;
+    }
+
+    size_t previous_triangles = source.indices.size() / 3;
+
+    for (; cells >= 2 && lods.size() < max_lod_count; cells /= 2) {
+        // Cubic cells along the largest axis of the bounds
+        float largest = std::max({max.x - min.x, max.y - min.y, max.z - min.z});
+        float size = std::max(largest / static_cast<float>(cells), 1e-20F);
+        glm::vec3 cell_size(size, size, size);
+
+        SourceLod lod = ClusterVertices(source, min, cell_size, cells);
+        size_t triangles = lod.mesh.indices.size() / 3;
+
+        if (triangles < LOD_MIN_TRIANGLES) {
+            break;
+        }
+        if (static_cast<float>(triangles) >
+            LOD_MAX_TRIANGLE_RATIO * static_cast<float>(previous_triangles)) {
+            continue;
+        }
+
+        previous_triangles = triangles;
+        lods.push_back(std::move(lod));
+    }
+
+    return lods;
+}
@@ -0,0 +1,30 @@
+#ifndef LOD_GENERATOR_H
+#define LOD_GENERATOR_H
+
+/* Local header files */
+#include "mesh_builder.hpp"
+
+/* Standard libraries */
+#include <cstdint>  // Required for uint32_t
+#include <vector>
+
+/* Levels of detail of a source mesh by vertex clustering
+
+Every level is built from the full mesh: the bounds are split into a grid
+of cells, the vertices of a cell merge into one at their average position
+and the triangles that collapse are dropped. The grid starts at about
+sqrt(vertex count) cells per axis and halves per level. A level is kept only
+if it has at most LOD_MAX_TRIANGLE_RATIO of the triangles of the previous
+one, and no level goes below LOD_MIN_TRIANGLES. The error of a level is the
+largest distance a vertex moved.
+
+Returns up to max_lod_count levels, coarsest last, the full mesh is not
+included.
+*/
+const float LOD_MAX_TRIANGLE_RATIO = 0.6F;
+const uint32_t LOD_MIN_TRIANGLES = 64;
+
+std::vector<SourceLod> GenerateLods(const SourceMesh& source,
+                                    uint32_t max_lod_count);
+
+#endif  // LOD_GENERATOR_H
@@ -0,0 +1,87 @@
+/* Local header files */
+#include "lod_selection.hpp"
+
+/* Standard libraries */
+#include <algorithm>
+#include <cmath>
+#include <utility>  // Required for std::move
+
+void LodSelector::SetChain(uint32_t chain, std::vector<MeshLod> lods) {
+    if (chain >= chains.size()) {
+        chains.resize(size_t{chain} + 1);
+    }
+    chains[chain] = std::move(lods);
+}
+
+void LodSelector::SetObjectChain(uint32_t object, uint32_t chain) {
+    if (object >= object_chains.size()) {
+        object_chains.resize(size_t{object} + 1, NO_CHAIN);
+        levels.resize(size_t{object} + 1, 0);
+    }
+    object_chains[object] = chain;
+    levels[object] = 0;
+}
+
+void LodSelector::Clear() {
+    chains.clear();
+    object_chains.clear();
+    levels.clear();
+    selected_triangles = 0;
+    full_triangles = 0;
+}
+
+const MeshLod* LodSelector::GetLod(uint32_t object) const {
+    if (object >= object_chains.size() || object_chains[object] == NO_CHAIN ||
+        object_chains[object] >= chains.size()) {
+        return nullptr;
+    }
+
+    const std::vector<MeshLod>& chain = chains[object_chains[object]];
+    return chain.empty() ? nullptr : &chain[levels[object]];
+}
+
+void LodSelector::Select(const LodView& view, const CullingSet& culling_set,
+                         const uint32_t* visible, uint32_t visible_count) {
+    selected_triangles = 0;
+    full_triangles = 0;
+
+    float coarser_threshold = view.threshold_pixels * (1.0F - view.hysteresis);
+
+    for (uint32_t i = 0; i < visible_count; i++) {
+        uint32_t object = visible[i];
+        if (object >= object_chains.size() ||
+            object_chains[object] == NO_CHAIN ||
+            object_chains[object] >= chains.size() ||
+            chains[object_chains[object]].empty()) {
+            continue;
+        }
+
+        const std::vector<MeshLod>& chain = chains[object_chains[object]];
+        auto last = static_cast<uint32_t>(chain.size() - 1);
+        uint32_t level = std::min(levels[object], last);
+
+        // Pixels per unit of error at the nearest point of the sphere, the
+        // camera inside the sphere always gets the finest level
+        glm::vec3 center = culling_set.GetCenter(object);
+        float dx = center.x - view.camera_position.x;
+        float dy = center.y - view.camera_position.y;
+        float dz = center.z - view.camera_position.z;
+        float distance = std::sqrt(dx * dx + dy * dy + dz * dz) -
+                         culling_set.GetRadius(object);
+        float pixels_per_unit =
+            view.projection_scale / std::max(distance, 1e-6F);
+
+        while (level > 0 &&
+               chain[level].error * pixels_per_unit > view.threshold_pixels) {
+            level--;
+        }
+        while (level < last &&
+               chain[level + 1].error * pixels_per_unit <= coarser_threshold) {
+            level++;
+        }
+
+        levels[object] = level;
+        selected_triangles += chain[level].index_count / 3;
+        full_triangles += chain[0].index_count / 3;
+    }
+}
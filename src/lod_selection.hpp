@@ -0,0 +1,72 @@
+#ifndef LOD_SELECTION_H
+#define LOD_SELECTION_H
+
+/* Local header files */
+#include "frustum_culling.hpp"
+#include "mesh_file.hpp"
+
+/* Third party libraries */
+#include <glm/vec3.hpp>
+
+/* Standard libraries */
+#include <cstdint>  // Required for uint32_t
+#include <vector>
+
+// Camera for the screen space error, projection_scale is the size in pixels
+// of one unit at distance 1: viewport height * projection[1][1] / 2
+struct LodView {
+    glm::vec3 camera_position = glm::vec3(0.0F, 0.0F, 0.0F);
+    float projection_scale = 1.0F;
+
+    // Largest error in pixels a level may have
+    float threshold_pixels = 1.0F;
+
+    // A coarser level is only taken once its error is this fraction below
+    // the threshold, so objects near the threshold do not switch every frame
+    float hysteresis = 0.25F;
+};
+
+/* Discrete level of detail selection by projected screen space error
+
+Every mesh has a chain of levels (MeshLod), every object of the culling set
+uses one chain and keeps its current level between frames. The error of a
+level projects to error * projection_scale / distance pixels, the distance
+to the nearest point of the bounding sphere. An object moves to a finer
+level when its current level is above the threshold, and to a coarser level
+only when that level is below threshold * (1 - hysteresis).
+*/
+class LodSelector {
+   public:
+    static constexpr uint32_t NO_CHAIN = UINT32_MAX;
+
+    // Levels of a mesh, finest first, replaces an existing chain
+    void SetChain(uint32_t chain, std::vector<MeshLod> lods);
+
+    // Chain of an object of the culling set, NO_CHAIN for objects without
+    // levels of detail
+    void SetObjectChain(uint32_t object, uint32_t chain);
+    void Clear();
+
+    // Select the level of every visible object, the objects are indices into
+    // the culling set as Cull writes them
+    void Select(const LodView& view, const CullingSet& culling_set,
+                const uint32_t* visible, uint32_t visible_count);
+
+    uint32_t GetLevel(uint32_t object) const { return levels[object]; }
+    const MeshLod* GetLod(uint32_t object) const;
+
+    // Triangles of the levels of the last selection, and of the finest levels
+    // of the same objects
+    uint64_t GetSelectedTriangles() const { return selected_triangles; }
+    uint64_t GetFullTriangles() const { return full_triangles; }
+
+   private:
+    std::vector<std::vector<MeshLod>> chains;
+    std::vector<uint32_t> object_chains;
+    std::vector<uint32_t> levels;
+
+    uint64_t selected_triangles = 0;
+    uint64_t full_triangles = 0;
+};
+
+#endif  // LOD_SELECTION_H
@@ -1,10 +1,18 @@
 /* Local header files */
+#include "application_options.hpp"
 #include "triangle_application.hpp"
 
-int main() {
-    TriangleApplication app;
+// The release executable is built with the compile time production
+// configuration, the default executable is configured at runtime
+#ifdef PRODUCTION_RENDERER
+using Application = TriangleApplication<ProductionConfig>;
+#else
+using Application = TriangleApplication<DiagnosticConfig>;
+#endif
 
+int main(int argc, char** argv) {
     try {
+        Application app(ParseApplicationOptions(argc, argv));
         app.Run();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
@@ -0,0 +1,125 @@
+/* Local header files */
+#include "memory_allocator.hpp"
+
+/* Standard libraries */
+#include <stdexcept>
+
+MemoryAllocator::MemoryAllocator(VkPhysicalDevice physical_device,
+                                 VkDevice device)
+    : device(device) {
+    vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_properties);
+}
+
+void MemoryAllocator::SetMetrics(RendererMetrics* metrics) {
+    this->metrics = metrics;
+    PublishLive();
+}
+
+uint32_t MemoryAllocator::FindMemoryType(
+    uint32_t type_filter, VkMemoryPropertyFlags properties) const {
+    /* Graphics cards offer different types of memory, each type varies in
+    terms of allowed operations and performance characteristics. Find a type
+    that is allowed by the filter and has all of the requested properties. */
+    for (uint32_t i = 0; i < memory_properties.memoryTypeCount; i++) {
+        if ((type_filter & (1U << i)) != 0 &&
+            (memory_properties.memoryTypes[i].propertyFlags & properties) ==
+                properties) {
+            return i;
+        }
+    }
+
+    throw std::runtime_error(
+        "vkGetPhysicalDeviceMemoryProperties Error: failed to find suitable "
+        "memory type!");
+}
+
+bool MemoryAllocator::HasMemoryType(uint32_t type_filter,
+                                    VkMemoryPropertyFlags properties) const {
+    for (uint32_t i = 0; i < memory_properties.memoryTypeCount; i++) {
+        if ((type_filter & (1U << i)) != 0 &&
+            (memory_properties.memoryTypes[i].propertyFlags & properties) ==
+                properties) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+VkDeviceMemory MemoryAllocator::Allocate(
+    const VkMemoryRequirements& requirements,
+    VkMemoryPropertyFlags properties, const std::string& name) {
+    VkMemoryAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    alloc_info.allocationSize = requirements.size;
+    alloc_info.memoryTypeIndex =
+        FindMemoryType(requirements.memoryTypeBits, properties);
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    if (vkAllocateMemory(device, &alloc_info, nullptr, &memory) !=
+        VK_SUCCESS) {
+        throw std::runtime_error("vkAllocateMemory Error: failed to allocate " +
+                                 name + " memory!");
+    }
+
+    live_sizes[memory] = alloc_info.allocationSize;
+    live_bytes += alloc_info.allocationSize;
+
+    if (metrics != nullptr) {
+        RendererMetrics::Increment(metrics->device_allocations);
+        RendererMetrics::Increment(metrics->device_allocated_bytes,
+                                   alloc_info.allocationSize);
+    }
+    PublishLive();
+
+    return memory;
+}
+
+void MemoryAllocator::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+                                   VkMemoryPropertyFlags properties,
+                                   VkBuffer& buffer,
+                                   VkDeviceMemory& buffer_memory,
+                                   const std::string& name) {
+    VkBufferCreateInfo buffer_info{};
+    buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_info.size = size;
+    buffer_info.usage = usage;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(device, &buffer_info, nullptr, &buffer) != VK_SUCCESS) {
+        throw std::runtime_error("vkCreateBuffer Error: failed to create " +
+                                 name + " buffer!");
+    }
+
+    // Allocate memory that fits the requirements of the buffer and bind it
+    VkMemoryRequirements memory_requirements;
+    vkGetBufferMemoryRequirements(device, buffer, &memory_requirements);
+    buffer_memory = Allocate(memory_requirements, properties, name);
+
+    vkBindBufferMemory(device, buffer, buffer_memory, 0);
+}
+
+void MemoryAllocator::Free(VkDeviceMemory memory) {
+    if (memory == VK_NULL_HANDLE) {
+        return;
+    }
+
+    vkFreeMemory(device, memory, nullptr);
+
+    auto live = live_sizes.find(memory);
+    if (live != live_sizes.end()) {
+        live_bytes -= live->second;
+        live_sizes.erase(live);
+    }
+    PublishLive();
+}
+
+void MemoryAllocator::PublishLive() {
+    if (metrics == nullptr) {
+        return;
+    }
+
+    metrics->device_live_allocations.store(live_sizes.size(),
+                                           std::memory_order_relaxed);
+    metrics->device_live_bytes.store(live_bytes, std::memory_order_relaxed);
+}
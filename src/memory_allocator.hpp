@@ -0,0 +1,67 @@
+#ifndef MEMORY_ALLOCATOR_H
+#define MEMORY_ALLOCATOR_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Local header files */
+#include "renderer_metrics.hpp"
+
+/* Standard libraries */
+#include <cstdint>  // Required for uint32_t
+#include <string>
+#include <unordered_map>
+
+/* Device memory of the buffers and images of the renderer and its modules
+
+Every allocation and every free goes through the allocator, so the metrics
+count all of them and know the memory that is live. A buffer or an image has
+a dedicated allocation, the allocator does not suballocate. The memory types
+are queried once, they do not change while the device lives.
+*/
+class MemoryAllocator {
+   public:
+    MemoryAllocator(VkPhysicalDevice physical_device, VkDevice device);
+
+    // Count the allocations in the metrics from now on, nullptr stops it.
+    // The live gauges start at the memory that is live when they are set.
+    // The metrics must outlive the allocator or be unset first.
+    void SetMetrics(RendererMetrics* metrics);
+
+    // A memory type allowed by the filter with all of the properties, throws
+    // std::runtime_error if there is none
+    uint32_t FindMemoryType(uint32_t type_filter,
+                            VkMemoryPropertyFlags properties) const;
+    bool HasMemoryType(uint32_t type_filter,
+                       VkMemoryPropertyFlags properties) const;
+
+    // Allocate memory for the requirements of a buffer or an image, the name
+    // goes into the error message
+    VkDeviceMemory Allocate(const VkMemoryRequirements& requirements,
+                            VkMemoryPropertyFlags properties,
+                            const std::string& name);
+
+    // Create a buffer and bind memory of its own to it
+    void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+                      VkMemoryPropertyFlags properties, VkBuffer& buffer,
+                      VkDeviceMemory& buffer_memory, const std::string& name);
+
+    // Free memory of Allocate or CreateBuffer, VK_NULL_HANDLE is ignored
+    void Free(VkDeviceMemory memory);
+
+    uint64_t GetLiveAllocations() const { return live_sizes.size(); }
+    uint64_t GetLiveBytes() const { return live_bytes; }
+
+   private:
+    VkDevice device;
+    VkPhysicalDeviceMemoryProperties memory_properties{};
+    RendererMetrics* metrics = nullptr;
+
+    // Size of every allocation that was not freed yet
+    std::unordered_map<VkDeviceMemory, VkDeviceSize> live_sizes;
+    uint64_t live_bytes = 0;
+
+    void PublishLive();
+};
+
+#endif  // MEMORY_ALLOCATOR_H
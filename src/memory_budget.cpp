@@ -0,0 +1,173 @@
+/* Local header files */
+#include "memory_budget.hpp"
+
+/* Standard libraries */
+#include <algorithm>
+
+namespace {
+
+double Mebibytes(VkDeviceSize bytes) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+}  // namespace
+
+MemoryBudget::MemoryBudget(VkInstance instance,
+                           VkPhysicalDevice physical_device,
+                           bool extension_enabled)
+    : physical_device(physical_device) {
+    // The budget is chained to the memory properties of
+    // VK_KHR_get_physical_device_properties2
+    if (extension_enabled) {
+        get_memory_properties =
+            reinterpret_cast<PFN_vkGetPhysicalDeviceMemoryProperties2KHR>(
+                vkGetInstanceProcAddr(
+                    instance, "vkGetPhysicalDeviceMemoryProperties2KHR"));
+    }
+
+    VkPhysicalDeviceMemoryProperties memory_properties{};
+    vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_properties);
+
+    heaps.resize(memory_properties.memoryHeapCount);
+    for (uint32_t i = 0; i < memory_properties.memoryHeapCount; i++) {
+        const VkMemoryHeap& heap = memory_properties.memoryHeaps[i];
+        heaps[i].size = heap.size;
+        heaps[i].budget = heap.size;
+        heaps[i].device_local =
+            (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+    }
+    peak_usage.resize(heaps.size(), 0);
+
+    Poll();
+}
+
+void MemoryBudget::Update() {
+    if (++frames_since_poll >= MEMORY_BUDGET_POLL_FRAMES) {
+        Poll();
+    }
+}
+
+void MemoryBudget::Poll() {
+    frames_since_poll = 0;
+
+    if (get_memory_properties == nullptr) {
+        return;
+    }
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget_properties{};
+    budget_properties.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+    VkPhysicalDeviceMemoryProperties2KHR memory_properties{};
+    memory_properties.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2_KHR;
+    memory_properties.pNext = &budget_properties;
+
+    get_memory_properties(physical_device, &memory_properties);
+
+    for (size_t i = 0; i < heaps.size(); i++) {
+        heaps[i].budget = budget_properties.heapBudget[i];
+        heaps[i].usage = budget_properties.heapUsage[i];
+        peak_usage[i] = std::max(peak_usage[i], heaps[i].usage);
+    }
+
+    MemoryPressure new_pressure = EvaluatePressure(heaps, pressure);
+    if (new_pressure == pressure) {
+        return;
+    }
+
+    pressure = new_pressure;
+    pressure_changes++;
+
+    for (const auto& callback : callbacks) {
+        callback(pressure, heaps);
+    }
+}
+
+void MemoryBudget::AddPressureCallback(PressureCallback callback) {
+    callbacks.push_back(std::move(callback));
+}
+
+VkDeviceSize MemoryBudget::GetDeviceLocalUsage() const {
+    VkDeviceSize usage = 0;
+    for (const auto& heap : heaps) {
+        if (heap.device_local) {
+            usage += heap.usage;
+        }
+    }
+    return usage;
+}
+
+VkDeviceSize MemoryBudget::GetDeviceLocalBudget() const {
+    VkDeviceSize budget = 0;
+    for (const auto& heap : heaps) {
+        if (heap.device_local) {
+            budget += heap.budget;
+        }
+    }
+    return budget;
+}
+
+void MemoryBudget::Report(std::ostream& out) const {
+    if (!IsSupported()) {
+        out << "Memory budget: VK_EXT_memory_budget is not supported"
+            << std::endl;
+        return;
+    }
+
+    out << "Memory budget: " << pressure_changes
+        << " pressure changes, now " << MemoryPressureName(pressure)
+        << std::endl;
+
+    for (size_t i = 0; i < heaps.size(); i++) {
+        out << "  heap " << i
+            << (heaps[i].device_local ? " (device local)" : "")
+            << ": peak " << Mebibytes(peak_usage[i]) << " MiB of "
+            << Mebibytes(heaps[i].budget) << " MiB budget, "
+            << Mebibytes(heaps[i].size) << " MiB heap" << std::endl;
+    }
+}
+
+MemoryPressure MemoryBudget::EvaluatePressure(
+    const std::vector<MemoryHeapBudget>& heaps, MemoryPressure current) {
+    /* The most used heap decides. A level is entered at its threshold and
+    kept until the usage falls the hysteresis below it. */
+    double high = MEMORY_PRESSURE_HIGH;
+    double critical = MEMORY_PRESSURE_CRITICAL;
+
+    if (current == MemoryPressure::CRITICAL) {
+        critical -= MEMORY_PRESSURE_HYSTERESIS;
+    }
+    if (current != MemoryPressure::NONE) {
+        high -= MEMORY_PRESSURE_HYSTERESIS;
+    }
+
+    double usage = 0.0;
+    for (const auto& heap : heaps) {
+        if (heap.budget > 0) {
+            usage = std::max(usage, static_cast<double>(heap.usage) /
+                                        static_cast<double>(heap.budget));
+        }
+    }
+
+    if (usage >= critical) {
+        return MemoryPressure::CRITICAL;
+    }
+
+    if (usage >= high) {
+        return MemoryPressure::HIGH;
+    }
+
+    return MemoryPressure::NONE;
+}
+
+const char* MemoryPressureName(MemoryPressure pressure) {
+    switch (pressure) {
+        case MemoryPressure::HIGH:
+            return "high";
+        case MemoryPressure::CRITICAL:
+            return "critical";
+        default:
+            return "none";
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Standard libraries */
+#include <cstdint>  // Required for uint32_t
+#include <functional>
+#include <ostream>
+#include <vector>
+
+// Frames between two queries of the budget, the driver updates it about as
+// often and the query is not free
+const uint32_t MEMORY_BUDGET_POLL_FRAMES = 30;
+
+// Fractions of the budget of a heap at which the pressure rises. It falls
+// again MEMORY_PRESSURE_HYSTERESIS below them, so a usage around a threshold
+// does not toggle the response of the subsystems every poll.
+const double MEMORY_PRESSURE_HIGH = 0.85;
+const double MEMORY_PRESSURE_CRITICAL = 0.95;
+const double MEMORY_PRESSURE_HYSTERESIS = 0.05;
+
+// How close the most used heap is to its budget
+enum class MemoryPressure { NONE, HIGH, CRITICAL };
+
+// Budget and usage of a memory heap in bytes, for the whole process
+struct MemoryHeapBudget {
+    VkDeviceSize size = 0;
+    VkDeviceSize budget = 0;
+    VkDeviceSize usage = 0;
+    bool device_local = false;
+};
+
+/* Polls the memory budget of the device with VK_EXT_memory_budget
+
+The budget of a heap is what the process can allocate from it before the
+driver starts to evict or allocations fail, it shrinks when other processes
+use the device. Subsystems register a pressure callback and shrink their
+allocations when the pressure rises, instead of running into
+VK_ERROR_OUT_OF_DEVICE_MEMORY after hours of a session.
+
+Without the extension the budget of a heap is its size and the usage is
+unknown, so the pressure stays NONE.
+*/
+class MemoryBudget {
+   public:
+    using PressureCallback = std::function<void(
+        MemoryPressure pressure, const std::vector<MemoryHeapBudget>& heaps)>;
+
+    // The extension must have been enabled on the device if it is used
+    MemoryBudget(VkInstance instance, VkPhysicalDevice physical_device,
+                 bool extension_enabled);
+
+    // Poll every MEMORY_BUDGET_POLL_FRAMES calls, called once per frame
+    void Update();
+
+    // Query the budget now and call the callbacks if the pressure changed
+    void Poll();
+
+    // Called on the thread that polls whenever the pressure changes
+    void AddPressureCallback(PressureCallback callback);
+
+    bool IsSupported() const { return get_memory_properties != nullptr; }
+
+    MemoryPressure GetPressure() const { return pressure; }
+
+    const std::vector<MemoryHeapBudget>& GetHeaps() const { return heaps; }
+
+    // Usage and budget summed over the device local heaps
+    VkDeviceSize GetDeviceLocalUsage() const;
+    VkDeviceSize GetDeviceLocalBudget() const;
+
+    // Print the budget and the peak usage of every heap
+    void Report(std::ostream& out) const;
+
+    // Pressure of the heaps, rising at the thresholds and falling with the
+    // hysteresis below them
+    static MemoryPressure EvaluatePressure(
+        const std::vector<MemoryHeapBudget>& heaps, MemoryPressure current);
+
+   private:
+    VkPhysicalDevice physical_device;
+    PFN_vkGetPhysicalDeviceMemoryProperties2KHR get_memory_properties =
+        nullptr;
+
+    std::vector<MemoryHeapBudget> heaps;
+    std::vector<VkDeviceSize> peak_usage;
+    MemoryPressure pressure = MemoryPressure::NONE;
+    std::vector<PressureCallback> callbacks;
+
+    uint32_t frames_since_poll = 0;
+    uint32_t pressure_changes = 0;
+};
+
+const char* MemoryPressureName(MemoryPressure pressure);
+
+#endif  // MEMORY_BUDGET_H
@@ -0,0 +1,329 @@
+/* Local header files */
+#include "mesh_builder.hpp"
+
+/* Standard libraries */
+#include <algorithm>  // Required for std::clamp
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+glm::vec3 Subtract(const glm::vec3& a, const glm::vec3& b) {
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+glm::vec3 Cross(const glm::vec3& a, const glm::vec3& b) {
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z,
+            a.x * b.y - a.y * b.x};
+}
+
+float Length(const glm::vec3& v) {
+    return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+}
+
+std::vector<glm::vec3> ComputeFaceNormals(const SourceMesh& source) {
+    /* Smooth normals: the area weighted normals of the faces around each
+    vertex, the cross product is already weighted by the area */
+    std::vector<glm::vec3> normals(source.positions.size(),
+                                   glm::vec3{0.0F, 0.0F, 0.0F});
+
+    for (size_t i = 0; i + 2 < source.indices.size(); i += 3) {
+        const glm::vec3& a = source.positions[source.indices[i]];
+        const glm::vec3& b = source.positions[source.indices[i + 1]];
+        const glm::vec3& c = source.positions[source.indices[i + 2]];
+        glm::vec3 face_normal = Cross(Subtract(b, a), Subtract(c, a));
+
+        for (size_t corner = 0; corner < 3; corner++) {
+            glm::vec3& normal = normals[source.indices[i + corner]];
+            normal = {normal.x + face_normal.x, normal.y + face_normal.y,
+                      normal.z + face_normal.z};
+        }
+    }
+
+    return normals;
+}
+
+class MeshletBuilder {
+   public:
+    MeshletBuilder(const SourceMesh& source, MeshData& mesh)
+        : source(source),
+          mesh(mesh),
+          local_indices(source.positions.size(), -1) {}
+
+    void AddTriangle(const std::array<uint32_t, 3>& triangle) {
+        // Vertices of the triangle that are not in the meshlet yet
+        uint32_t new_vertex_count = 0;
+        for (size_t corner = 0; corner < 3; corner++) {
+            bool repeated = (corner > 0 && triangle[corner] == triangle[0]) ||
+                            (corner > 1 && triangle[corner] == triangle[1]);
+            if (local_indices[triangle[corner]] < 0 && !repeated) {
+                new_vertex_count++;
+            }
+        }
+
+        if (meshlet.vertex_count + new_vertex_count > MESHLET_MAX_VERTICES ||
+            meshlet.triangle_count == MESHLET_MAX_TRIANGLES) {
+            Flush();
+        }
+
+        for (uint32_t vertex : triangle) {
+            if (local_indices[vertex] < 0) {
+                local_indices[vertex] =
+                    static_cast<int32_t>(meshlet.vertex_count++);
+                mesh.meshlet_vertices.push_back(vertex);
+            }
+
+            mesh.meshlet_triangles.push_back(
+                static_cast<uint8_t>(local_indices[vertex]));
+        }
+
+        meshlet.triangle_count++;
+    }
+
+    void Flush() {
+        if (meshlet.triangle_count == 0) {
+            return;
+        }
+
+        // Bounding sphere around the center of the bounds of the meshlet
+        const uint32_t* vertices =
+            mesh.meshlet_vertices.data() + meshlet.vertex_offset;
+        glm::vec3 min = source.positions[vertices[0]];
+        glm::vec3 max = min;
+
+        for (uint32_t i = 0; i < meshlet.vertex_count; i++) {
+            const glm::vec3& position = source.positions[vertices[i]];
+            min = {std::min(min.x, position.x), std::min(min.y, position.y),
+                   std::min(min.z, position.z)};
+            max = {std::max(max.x, position.x), std::max(max.y, position.y),
+                   std::max(max.z, position.z)};
+        }
+
+        glm::vec3 center{(min.x + max.x) / 2, (min.y + max.y) / 2,
+                         (min.z + max.z) / 2};
+        meshlet.center = {center.x, center.y, center.z};
+        meshlet.radius = 0.0F;
+
+        for (uint32_t i = 0; i < meshlet.vertex_count; i++) {
+            meshlet.radius = std::max(
+                meshlet.radius,
+                Length(Subtract(source.positions[vertices[i]], center)));
+            local_indices[vertices[i]] = -1;
+        }
+
+        // The triangles of the next meshlet start at a multiple of 4 bytes
+        while (mesh.meshlet_triangles.size() % 4 != 0) {
+            mesh.meshlet_triangles.push_back(0);
+        }
+
+        mesh.meshlets.push_back(meshlet);
+
+        meshlet = {};
+        meshlet.vertex_offset =
+            static_cast<uint32_t>(mesh.meshlet_vertices.size());
+        meshlet.triangle_offset =
+            static_cast<uint32_t>(mesh.meshlet_triangles.size());
+    }
+
+   private:
+    const SourceMesh& source;
+    MeshData& mesh;
+    Meshlet meshlet{};
+
+    // Index of each vertex of the mesh within the current meshlet, -1 if
+    // the meshlet does not contain it
+    std::vector<int32_t> local_indices;
+};
+
+}  // namespace
+
+MeshData BuildMesh(const SourceMesh& source,
+                   const std::vector<SourceLod>& lods) {
+    /* The full mesh is level 0, the vertices of every level are appended to
+    one vertex stream and its indices to one index stream */
+    std::vector<const SourceMesh*> levels = {&source};
+    for (const auto& lod : lods) {
+        levels.push_back(&lod.mesh);
+    }
+
+    size_t vertex_count = 0;
+    size_t index_count = 0;
+    size_t largest_level = 0;
+
+    for (const SourceMesh* level : levels) {
+        if (level->positions.empty() || level->indices.empty() ||
+            level->indices.size() % 3 != 0) {
+            throw std::invalid_argument("the mesh has no triangles!");
+        }
+
+        for (uint32_t index : level->indices) {
+            if (index >= level->positions.size()) {
+                throw std::invalid_argument("mesh index out of range!");
+            }
+        }
+
+        vertex_count += level->positions.size();
+        largest_level = std::max(largest_level, level->positions.size());
+        index_count += level->indices.size();
+    }
+
+    MeshData mesh;
+
+    /* Bounds, the positions are quantized to their extent */
+    glm::vec3 min = source.positions[0];
+    glm::vec3 max = min;
+    for (const SourceMesh* level : levels) {
+        for (const auto& position : level->positions) {
+            min = {std::min(min.x, position.x), std::min(min.y, position.y),
+                   std::min(min.z, position.z)};
+            max = {std::max(max.x, position.x), std::max(max.y, position.y),
+                   std::max(max.z, position.z)};
+        }
+    }
+
+    mesh.bounds_min = {min.x, min.y, min.z};
+    mesh.bounds_max = {max.x, max.y, max.z};
+
+    std::array<float, 3> center{};
+    std::array<float, 3> extent{};
+    for (size_t axis = 0; axis < 3; axis++) {
+        center[axis] = (mesh.bounds_min[axis] + mesh.bounds_max[axis]) / 2;
+        extent[axis] = std::max(
+            (mesh.bounds_max[axis] - mesh.bounds_min[axis]) / 2, 1e-20F);
+    }
+
+    /* Indices, 16 bits are enough for most meshes and halve the size. The
+    indices of a level start at its first vertex, so only the largest level
+    decides. */
+    mesh.index_count = static_cast<uint32_t>(index_count);
+    mesh.index_size = largest_level <= UINT16_MAX + 1 ? 2 : 4;
+    mesh.indices.resize(index_count * mesh.index_size);
+    mesh.vertices.reserve(vertex_count);
+
+    for (size_t level_index = 0; level_index < levels.size(); level_index++) {
+        const SourceMesh& level = *levels[level_index];
+        MeshLod lod{};
+        lod.index_offset = mesh.lods.empty() ? 0
+                                             : mesh.lods.back().index_offset +
+                                                   mesh.lods.back().index_count;
+        lod.index_count = static_cast<uint32_t>(level.indices.size());
+        lod.vertex_offset = static_cast<uint32_t>(mesh.vertices.size());
+        lod.error = level_index == 0 ? 0.0F : lods[level_index - 1].error;
+        mesh.lods.push_back(lod);
+
+        /* Vertices */
+        std::vector<glm::vec3> normals = level.normals.size() ==
+                                                 level.positions.size()
+                                             ? level.normals
+                                             : ComputeFaceNormals(level);
+        bool has_uvs = level.uvs.size() == level.positions.size();
+
+        for (size_t i = 0; i < level.positions.size(); i++) {
+            const glm::vec3& position = level.positions[i];
+            MeshVertex vertex{};
+
+            vertex.position = {
+                QuantizeSnorm16((position.x - center[0]) / extent[0]),
+                QuantizeSnorm16((position.y - center[1]) / extent[1]),
+                QuantizeSnorm16((position.z - center[2]) / extent[2]), 32767};
+
+            float length = std::max(Length(normals[i]), 1e-20F);
+            vertex.normal = {QuantizeSnorm8(normals[i].x / length),
+                             QuantizeSnorm8(normals[i].y / length),
+                             QuantizeSnorm8(normals[i].z / length), 0};
+
+            vertex.uv = {0, 0};
+            if (has_uvs) {
+                vertex.uv = {FloatToHalf(level.uvs[i].x),
+                             FloatToHalf(level.uvs[i].y)};
+            }
+
+            mesh.vertices.push_back(vertex);
+        }
+
+        uint8_t* output =
+            mesh.indices.data() + size_t{lod.index_offset} * mesh.index_size;
+        for (size_t i = 0; i < level.indices.size(); i++) {
+            if (mesh.index_size == 2) {
+                auto index = static_cast<uint16_t>(level.indices[i]);
+                std::memcpy(output + i * 2, &index, 2);
+            } else {
+                std::memcpy(output + i * 4, &level.indices[i], 4);
+            }
+        }
+    }
+
+    /* Meshlets of the full mesh, the triangles are added in index order */
+    MeshletBuilder meshlet_builder(source, mesh);
+    for (size_t i = 0; i < source.indices.size(); i += 3) {
+        meshlet_builder.AddTriangle({source.indices[i], source.indices[i + 1],
+                                     source.indices[i + 2]});
+    }
+    meshlet_builder.Flush();
+
+    return mesh;
+}
+
+int16_t QuantizeSnorm16(float value) {
+    return static_cast<int16_t>(
+        std::lround(std::clamp(value, -1.0F, 1.0F) * 32767.0F));
+}
+
+int8_t QuantizeSnorm8(float value) {
+    return static_cast<int8_t>(
+        std::lround(std::clamp(value, -1.0F, 1.0F) * 127.0F));
+}
+
+uint16_t FloatToHalf(float value) {
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // Infinity and NaN
+    if (exponent == 0xFF) {
+        uint32_t nan_bit = mantissa != 0 ? 0x200 : 0;
+        return static_cast<uint16_t>(sign | 0x7C00 | nan_bit);
+    }
+
+    int32_t half_exponent = static_cast<int32_t>(exponent) - 127 + 15;
+
+    // Too large, rounds to infinity
+    if (half_exponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+
+    // Subnormal halves, or zero if even the smallest subnormal is too large
+    if (half_exponent <= 0) {
+        if (half_exponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+
+        mantissa |= 0x800000;
+        auto shift = static_cast<uint32_t>(14 - half_exponent);
+        uint32_t half_mantissa = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1U << shift) - 1);
+        uint32_t halfway = 1U << (shift - 1);
+
+        if (remainder > halfway ||
+            (remainder == halfway && (half_mantissa & 1) != 0)) {
+            half_mantissa++;
+        }
+
+        return static_cast<uint16_t>(sign | half_mantissa);
+    }
+
+    // A carry out of the mantissa correctly increments the exponent
+    uint32_t half = sign | (static_cast<uint32_t>(half_exponent) << 10) |
+                    (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1FFF;
+
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1) != 0)) {
+        half++;
+    }
+
+    return static_cast<uint16_t>(half);
+}
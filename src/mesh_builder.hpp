@@ -0,0 +1,55 @@
+#ifndef MESH_BUILDER_H
+#define MESH_BUILDER_H
+
+/* Third party libraries */
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+/* Local header files */
+#include "mesh_file.hpp"
+
+/* Standard libraries */
+#include <cstdint>  // Required for uint32_t
+#include <vector>
+
+// Indexed triangle list as read from a source format, e.g. Wavefront OBJ.
+// The normals and texture coordinates are optional, if present there is one
+// per position.
+struct SourceMesh {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> uvs;
+    std::vector<uint32_t> indices;
+};
+
+// Coarser version of a source mesh with its own vertices. The error is the
+// largest distance, in the units of the positions, between the surface of the
+// full mesh and this level.
+struct SourceLod {
+    SourceMesh mesh;
+    float error = 0.0F;
+};
+
+/* Convert a source mesh into the streams of the binary mesh container
+
+This is the per vertex work the runtime does not do: the positions are
+quantized to the bounds, the normals to 8 bits (computed from the faces if
+the source has none), the texture coordinates to half floats, the indices
+are narrowed to 16 bits when possible and the triangles are grouped into
+meshlets. The levels of detail, coarsest last, are appended to the vertex
+and index streams and listed in the LODS stream after the full mesh; the
+meshlets cover the full mesh only. Throws std::invalid_argument for an empty
+mesh or indices out of range.
+*/
+MeshData BuildMesh(const SourceMesh& source,
+                   const std::vector<SourceLod>& lods = {});
+
+// Quantize a value in [-1, 1] to a signed normalized integer, values
+// outside are clamped
+int16_t QuantizeSnorm16(float value);
+int8_t QuantizeSnorm8(float value);
+
+// IEEE 754 binary16 of a float, rounded to nearest even
+uint16_t FloatToHalf(float value);
+
+#endif  // MESH_BUILDER_H
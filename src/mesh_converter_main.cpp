@@ -0,0 +1,95 @@
+/* Local header files */
+#include "lod_generator.hpp"
+#include "mesh_builder.hpp"
+#include "mesh_file.hpp"
+#include "obj_loader.hpp"
+
+/* Standard libraries */
+#include <algorithm>  // Required for std::sort
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>  // Required for std::move
+#include <vector>
+
+/* Offline converter from source meshes to the binary mesh container
+
+    MeshConverter <input.obj> <output.vmesh> [--lods=<n>]
+                  [--lod=<error>:<file.obj>]...
+
+--lods generates up to n levels of detail by vertex clustering, --lod adds a
+level made by hand with its error in the units of the mesh. Supplied levels
+replace the generated ones and are sorted by error.
+
+All per vertex processing happens here, at runtime the .vmesh file is mapped
+and copied to the GPU as it is.
+*/
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0]
+                  << " <input.obj> <output.vmesh> [--lods=<n>]"
+                     " [--lod=<error>:<file.obj>]..."
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        uint32_t generated_lods = 0;
+        std::vector<SourceLod> lods;
+
+        for (int i = 3; i < argc; i++) {
+            std::string argument = argv[i];
+
+            if (argument.rfind("--lods=", 0) == 0) {
+                generated_lods = static_cast<uint32_t>(
+                    std::stoul(argument.substr(std::string("--lods=").size())));
+            } else if (argument.rfind("--lod=", 0) == 0) {
+                std::string value =
+                    argument.substr(std::string("--lod=").size());
+                size_t separator = value.find(':');
+                if (separator == std::string::npos) {
+                    throw std::invalid_argument(
+                        "--lod expects <error>:<file.obj>!");
+                }
+
+                SourceLod lod;
+                lod.error = std::stof(value.substr(0, separator));
+                lod.mesh = LoadObjFile(value.substr(separator + 1));
+                lods.push_back(std::move(lod));
+            } else {
+                throw std::invalid_argument("unknown option " + argument + "!");
+            }
+        }
+
+        SourceMesh source = LoadObjFile(argv[1]);
+
+        if (lods.empty()) {
+            lods = GenerateLods(source, generated_lods);
+        } else {
+            std::sort(lods.begin(), lods.end(),
+                      [](const SourceLod& a, const SourceLod& b) {
+                          return a.error < b.error;
+                      });
+        }
+
+        MeshData mesh = BuildMesh(source, lods);
+        WriteMeshFile(mesh, argv[2]);
+
+        std::cout << argv[2] << ": " << mesh.vertices.size() << " vertices, "
+                  << mesh.lods[0].index_count / 3 << " triangles, "
+                  << mesh.index_size * 8 << " bit indices, "
+                  << mesh.meshlets.size() << " meshlets" << std::endl;
+
+        for (size_t i = 1; i < mesh.lods.size(); i++) {
+            std::cout << "  lod " << i << ": " << mesh.lods[i].index_count / 3
+                      << " triangles, error " << mesh.lods[i].error
+                      << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
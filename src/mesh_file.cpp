@@ -0,0 +1,260 @@
+/* Local header files */
+#include "mesh_file.hpp"
+
+/* Standard libraries */
+#include <fcntl.h>     // Required for open
+#include <sys/mman.h>  // Required for mmap
+#include <sys/stat.h>  // Required for fstat
+#include <unistd.h>    // Required for close
+
+#include <algorithm>  // Required for std::min
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+uint64_t AlignStreamOffset(uint64_t offset) {
+    return (offset + MESH_STREAM_ALIGNMENT - 1) / MESH_STREAM_ALIGNMENT *
+           MESH_STREAM_ALIGNMENT;
+}
+
+size_t StreamIndex(MeshStream stream) { return static_cast<size_t>(stream); }
+
+std::array<std::pair<const void*, uint64_t>,
+           static_cast<size_t>(MeshStream::COUNT)>
+GetStreamData(const MeshData& mesh) {
+    return {{
+        {mesh.vertices.data(), mesh.vertices.size() * sizeof(MeshVertex)},
+        {mesh.indices.data(), mesh.indices.size()},
+        {mesh.meshlets.data(), mesh.meshlets.size() * sizeof(Meshlet)},
+        {mesh.meshlet_vertices.data(),
+         mesh.meshlet_vertices.size() * sizeof(uint32_t)},
+        {mesh.meshlet_triangles.data(), mesh.meshlet_triangles.size()},
+        {mesh.lods.data(), mesh.lods.size() * sizeof(MeshLod)},
+    }};
+}
+
+}  // namespace
+
+MeshFileHeader LayoutMeshFile(const MeshData& mesh) {
+    /* Lay out the streams one after the other at aligned offsets */
+    MeshFileHeader header{};
+    header.magic = MESH_FILE_MAGIC;
+    header.version = MESH_FILE_VERSION;
+    header.vertex_count = static_cast<uint32_t>(mesh.vertices.size());
+    header.index_count = mesh.index_count;
+    header.meshlet_count = static_cast<uint32_t>(mesh.meshlets.size());
+    header.index_size = mesh.index_size;
+    header.lod_count = static_cast<uint32_t>(mesh.lods.size());
+    header.bounds_min = mesh.bounds_min;
+    header.bounds_max = mesh.bounds_max;
+
+    auto streams = GetStreamData(mesh);
+    uint64_t offset = AlignStreamOffset(sizeof(MeshFileHeader));
+    for (size_t i = 0; i < streams.size(); i++) {
+        header.streams[i] = {offset, streams[i].second};
+        offset = AlignStreamOffset(offset + streams[i].second);
+    }
+
+    return header;
+}
+
+void CopyMeshStreams(const MeshData& mesh, const MeshFileHeader& header,
+                     uint8_t* payload) {
+    // The padding between the streams is left as it is
+    auto streams = GetStreamData(mesh);
+    uint64_t payload_offset = header.streams[0].offset;
+
+    for (size_t i = 0; i < streams.size(); i++) {
+        if (streams[i].second > 0) {
+            std::memcpy(payload + header.streams[i].offset - payload_offset,
+                        streams[i].first, streams[i].second);
+        }
+    }
+}
+
+size_t GetMeshPayloadSize(const MeshFileHeader& header) {
+    const MeshStreamRange& last = header.streams.back();
+    return static_cast<size_t>(last.offset + last.size -
+                               header.streams.front().offset);
+}
+
+uint32_t GetMaxIndex(const uint8_t* indices, size_t count,
+                     uint32_t index_size) {
+    uint32_t max_index = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t index = 0;
+
+        if (index_size == 2) {
+            uint16_t narrow = 0;
+            std::memcpy(&narrow, indices + i * 2, sizeof(narrow));
+            index = narrow;
+        } else {
+            std::memcpy(&index, indices + i * 4, sizeof(index));
+        }
+
+        max_index = std::max(max_index, index);
+    }
+
+    return max_index;
+}
+
+void WriteMeshFile(const MeshData& mesh, const std::string& filename) {
+    MeshFileHeader header = LayoutMeshFile(mesh);
+    auto streams = GetStreamData(mesh);
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("failed to open file: " + filename + "!");
+    }
+
+    // The padding between the streams is written as zeros
+    const std::array<char, MESH_STREAM_ALIGNMENT> padding{};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t written = sizeof(header);
+
+    for (size_t i = 0; i < streams.size(); i++) {
+        file.write(padding.data(),
+                   static_cast<std::streamsize>(header.streams[i].offset -
+                                                written));
+        file.write(static_cast<const char*>(streams[i].first),
+                   static_cast<std::streamsize>(streams[i].second));
+        written = header.streams[i].offset + streams[i].second;
+    }
+
+    if (!file) {
+        throw std::runtime_error("failed to write file: " + filename + "!");
+    }
+}
+
+MeshFile::MeshFile(const std::string& filename) {
+    int descriptor = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (descriptor < 0) {
+        throw std::runtime_error("failed to open file: " + filename + "!");
+    }
+
+    struct stat file_stat {};
+    if (fstat(descriptor, &file_stat) != 0 ||
+        static_cast<size_t>(file_stat.st_size) < sizeof(MeshFileHeader)) {
+        close(descriptor);
+        throw std::runtime_error(filename + " is not a mesh file!");
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    mapping_size = static_cast<size_t>(file_stat.st_size);
+    void* address =
+        mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("failed to map file: " + filename + "!");
+    }
+
+    mapping = static_cast<const uint8_t*>(address);
+
+    // The whole file is read once, front to back, on its way to the GPU
+    madvise(address, mapping_size, MADV_SEQUENTIAL);
+    madvise(address, mapping_size, MADV_WILLNEED);
+
+    std::copy(mapping, mapping + sizeof(MeshFileHeader),
+              reinterpret_cast<uint8_t*>(&header));
+
+    /* Validate the header before any stream is read */
+    std::string error;
+    if (header.magic != MESH_FILE_MAGIC) {
+        error = " is not a mesh file!";
+    } else if (header.version != MESH_FILE_VERSION) {
+        error = " has an unsupported mesh file version!";
+    } else if (header.index_size != 2 && header.index_size != 4) {
+        error = " has an invalid index size!";
+    }
+
+    payload_offset = mapping_size;
+    size_t payload_end = 0;
+    for (const auto& range : header.streams) {
+        if (!error.empty()) {
+            break;
+        }
+
+        if (range.offset % MESH_STREAM_ALIGNMENT != 0 ||
+            range.offset > mapping_size ||
+            range.size > mapping_size - range.offset) {
+            error = " has an invalid stream!";
+            break;
+        }
+
+        payload_offset =
+            std::min(payload_offset, static_cast<size_t>(range.offset));
+        payload_end = std::max(payload_end,
+                               static_cast<size_t>(range.offset + range.size));
+    }
+
+    uint64_t vertices_size = uint64_t{header.vertex_count} * sizeof(MeshVertex);
+    uint64_t indices_size = uint64_t{header.index_count} * header.index_size;
+    uint64_t meshlets_size = uint64_t{header.meshlet_count} * sizeof(Meshlet);
+    uint64_t lods_size = uint64_t{header.lod_count} * sizeof(MeshLod);
+
+    if (error.empty() &&
+        (GetStreamRange(MeshStream::VERTICES).size != vertices_size ||
+         GetStreamRange(MeshStream::INDICES).size != indices_size ||
+         GetStreamRange(MeshStream::MESHLETS).size != meshlets_size ||
+         GetStreamRange(MeshStream::LODS).size != lods_size ||
+         header.lod_count == 0)) {
+        error = " has streams that do not match its header!";
+    }
+
+    // Every level of detail is a range of the indices
+    for (uint32_t i = 0; i < header.lod_count && error.empty(); i++) {
+        MeshLod lod{};
+        std::memcpy(&lod, GetStream(MeshStream::LODS) + i * sizeof(MeshLod),
+                    sizeof(lod));
+
+        if (lod.index_offset > header.index_count ||
+            lod.index_count > header.index_count - lod.index_offset ||
+            lod.vertex_offset >= header.vertex_count) {
+            error = " has an invalid level of detail!";
+            break;
+        }
+
+        // The indices of the level are relative to its first vertex, an
+        // index past the vertices would be read out of the vertex buffer
+        uint32_t max_index = GetMaxIndex(
+            GetStream(MeshStream::INDICES) +
+                uint64_t{lod.index_offset} * header.index_size,
+            lod.index_count, header.index_size);
+        if (lod.index_count > 0 &&
+            uint64_t{lod.vertex_offset} + max_index >= header.vertex_count) {
+            error = " has indices out of range of its vertices!";
+        }
+    }
+
+    if (!error.empty()) {
+        munmap(address, mapping_size);
+        throw std::runtime_error(filename + error);
+    }
+
+    payload_size = payload_end - payload_offset;
+}
+
+MeshFile::~MeshFile() {
+    munmap(const_cast<uint8_t*>(mapping), mapping_size);
+}
+
+std::vector<MeshLod> MeshFile::GetLods() const {
+    std::vector<MeshLod> lods(header.lod_count);
+    std::memcpy(lods.data(), GetStream(MeshStream::LODS),
+                lods.size() * sizeof(MeshLod));
+    return lods;
+}
+
+const uint8_t* MeshFile::GetStream(MeshStream stream) const {
+    return mapping + GetStreamRange(stream).offset;
+}
+
+const MeshStreamRange& MeshFile::GetStreamRange(MeshStream stream) const {
+    return header.streams[StreamIndex(stream)];
+}
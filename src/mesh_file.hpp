@@ -0,0 +1,186 @@
+#ifndef MESH_FILE_H
+#define MESH_FILE_H
+
+/* Standard libraries */
+#include <array>
+#include <cstddef>
+#include <cstdint>  // Required for uint32_t
+#include <string>
+#include <vector>
+
+/* Binary mesh container (.vmesh)
+
+A GPU ready mesh written by the MeshConverter tool. The file starts with a
+MeshFileHeader, followed by the streams of the mesh. Every stream starts at a
+multiple of MESH_STREAM_ALIGNMENT and holds the data in the layout the GPU
+reads, so the streams are copied to a buffer as they are:
+
+- VERTICES: MeshVertex, positions quantized to the bounds of the mesh
+- INDICES: uint16_t or uint32_t triangle list, see index_size
+- MESHLETS: Meshlet, clusters of up to MESHLET_MAX_VERTICES vertices and
+  MESHLET_MAX_TRIANGLES triangles
+- MESHLET_VERTICES: uint32_t indices into the vertices of the mesh
+- MESHLET_TRIANGLES: uint8_t triangles of indices into the meshlet vertices,
+  each meshlet padded to 4 bytes
+- LODS: MeshLod, the levels of detail from the full mesh to the coarsest.
+  Every level is a range of INDICES relative to its first vertex, so each
+  level fits 16 bit indices on its own. The meshlets cover the full mesh
+  only.
+
+All values are little endian, like every platform the renderer runs on.
+*/
+const std::array<char, 4> MESH_FILE_MAGIC = {'V', 'M', 'S', 'H'};
+const uint32_t MESH_FILE_VERSION = 2;
+
+// Alignment of the streams in the file, the largest
+// minStorageBufferOffsetAlignment the specification allows, so the payload
+// is bound from a single buffer
+const uint64_t MESH_STREAM_ALIGNMENT = 256;
+
+// Meshlet limits that suit mesh shaders and cluster culling
+const uint32_t MESHLET_MAX_VERTICES = 64;
+const uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+enum class MeshStream : uint32_t {
+    VERTICES,
+    INDICES,
+    MESHLETS,
+    MESHLET_VERTICES,
+    MESHLET_TRIANGLES,
+    LODS,
+    COUNT,
+};
+
+/* Vertex of the binary mesh, 16 bytes
+- position: VK_FORMAT_R16G16B16A16_SNORM, the position is
+  center + position.xyz * extent with the bounds of the header
+- normal: VK_FORMAT_R8G8B8A8_SNORM
+- uv: VK_FORMAT_R16G16_SFLOAT
+*/
+struct MeshVertex {
+    std::array<int16_t, 4> position;
+    std::array<int8_t, 4> normal;
+    std::array<uint16_t, 2> uv;
+};
+static_assert(sizeof(MeshVertex) == 16, "MeshVertex must be 16 bytes");
+
+struct Meshlet {
+    uint32_t vertex_offset;    // First entry in MESHLET_VERTICES
+    uint32_t vertex_count;
+    uint32_t triangle_offset;  // First byte in MESHLET_TRIANGLES
+    uint32_t triangle_count;
+
+    // Bounding sphere for culling
+    std::array<float, 3> center;
+    float radius;
+};
+static_assert(sizeof(Meshlet) == 32, "Meshlet must be 32 bytes");
+
+struct MeshLod {
+    uint32_t index_offset;   // First index of the level
+    uint32_t index_count;
+    uint32_t vertex_offset;  // Added to the indices, the vertexOffset of
+                             // vkCmdDrawIndexed
+
+    // Largest distance between the full mesh and this level in object
+    // space, 0 for the full mesh
+    float error;
+};
+static_assert(sizeof(MeshLod) == 16, "MeshLod must be 16 bytes");
+
+struct MeshStreamRange {
+    uint64_t offset;  // Offset from the start of the file
+    uint64_t size;
+};
+
+struct MeshFileHeader {
+    std::array<char, 4> magic;
+    uint32_t version;
+    uint32_t vertex_count;
+    uint32_t index_count;
+    uint32_t meshlet_count;
+    uint32_t index_size;  // 2 or 4 bytes
+    uint32_t lod_count;   // At least 1, the full mesh
+
+    // Axis aligned bounds, the positions are quantized to them
+    std::array<float, 3> bounds_min;
+    std::array<float, 3> bounds_max;
+
+    std::array<MeshStreamRange, static_cast<size_t>(MeshStream::COUNT)>
+        streams;
+};
+
+// Streams of a mesh in memory, as written by WriteMeshFile
+struct MeshData {
+    std::array<float, 3> bounds_min{};
+    std::array<float, 3> bounds_max{};
+    uint32_t index_size = 4;
+    uint32_t index_count = 0;
+
+    std::vector<MeshVertex> vertices;
+    std::vector<uint8_t> indices;
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> meshlet_vertices;
+    std::vector<uint8_t> meshlet_triangles;
+    std::vector<MeshLod> lods;
+};
+
+// Header of the mesh with the offsets of its streams in a .vmesh file
+MeshFileHeader LayoutMeshFile(const MeshData& mesh);
+
+// Copy the streams of the mesh to their offsets in the payload of the
+// layout, payload points to the first stream
+void CopyMeshStreams(const MeshData& mesh, const MeshFileHeader& header,
+                     uint8_t* payload);
+
+// Size of the payload of the layout, from the first stream to the end of
+// the last one
+size_t GetMeshPayloadSize(const MeshFileHeader& header);
+
+// Largest of count indices of index_size (2 or 4) bytes each
+uint32_t GetMaxIndex(const uint8_t* indices, size_t count, uint32_t index_size);
+
+// Write the mesh to a .vmesh file. Throws std::runtime_error if the file can
+// not be written.
+void WriteMeshFile(const MeshData& mesh, const std::string& filename);
+
+/* A .vmesh file mapped into memory
+
+The file is mapped read only, the streams are read straight from the mapping
+without copying or converting them. The payload, from the first stream to the
+end of the last one, is contiguous, so it is copied to the GPU with a single
+copy.
+*/
+class MeshFile {
+   public:
+    // Map and validate the file. Throws std::runtime_error for files that
+    // can not be read or are not valid.
+    explicit MeshFile(const std::string& filename);
+    ~MeshFile();
+
+    MeshFile(const MeshFile&) = delete;
+    MeshFile& operator=(const MeshFile&) = delete;
+
+    const MeshFileHeader& GetHeader() const { return header; }
+
+    // Stream data within the mapping
+    const uint8_t* GetStream(MeshStream stream) const;
+    const MeshStreamRange& GetStreamRange(MeshStream stream) const;
+
+    // Copy of the levels of detail, for the selection on the CPU
+    std::vector<MeshLod> GetLods() const;
+
+    // Contiguous data of all streams
+    const uint8_t* GetPayload() const { return mapping + payload_offset; }
+    size_t GetPayloadSize() const { return payload_size; }
+    size_t GetPayloadOffset() const { return payload_offset; }
+
+   private:
+    const uint8_t* mapping = nullptr;
+    size_t mapping_size = 0;
+    MeshFileHeader header{};
+    size_t payload_offset = 0;
+    size_t payload_size = 0;
+};
+
+#endif  // MESH_FILE_H
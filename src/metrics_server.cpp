@@ -0,0 +1,140 @@
+/* Local header files */
+#include "metrics_server.hpp"
+
+/* Standard libraries */
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+/* Linux libraries */
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+// How often the thread checks whether it is stopping, in milliseconds
+const int METRICS_POLL_INTERVAL = 100;
+
+// Time a client has to send its request, in milliseconds
+const int METRICS_REQUEST_TIMEOUT = 1000;
+
+// Longest request read, the request line is all that is needed
+const size_t METRICS_MAX_REQUEST = 4096;
+
+void SendAll(int connection, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t result = send(connection, data.data() + sent,
+                              data.size() - sent, MSG_NOSIGNAL);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return;
+        }
+        sent += static_cast<size_t>(result);
+    }
+}
+
+std::string Response(const std::string& status, const std::string& type,
+                     const std::string& body) {
+    return "HTTP/1.1 " + status + "\r\nContent-Type: " + type +
+           "\r\nContent-Length: " + std::to_string(body.size()) +
+           "\r\nConnection: close\r\n\r\n" + body;
+}
+
+}  // namespace
+
+MetricsServer::MetricsServer(const RendererMetrics& metrics, uint16_t port)
+    : metrics(metrics) {
+    listen_socket = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_socket < 0) {
+        throw std::runtime_error(std::string("socket Error: ") +
+                                 std::strerror(errno) + "!");
+    }
+
+    int reuse = 1;
+    setsockopt(listen_socket, SOL_SOCKET, SO_REUSEADDR, &reuse,
+               sizeof(reuse));
+
+    // Loopback only, the metrics are not exposed to the network
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+
+    if (bind(listen_socket, reinterpret_cast<sockaddr*>(&address),
+             sizeof(address)) != 0 ||
+        listen(listen_socket, 4) != 0) {
+        std::string error = std::strerror(errno);
+        close(listen_socket);
+        throw std::runtime_error("bind Error: failed to listen on port " +
+                                 std::to_string(port) + ": " + error + "!");
+    }
+
+    socklen_t address_size = sizeof(address);
+    getsockname(listen_socket, reinterpret_cast<sockaddr*>(&address),
+                &address_size);
+    this->port = ntohs(address.sin_port);
+
+    thread = std::thread(&MetricsServer::ServeLoop, this);
+}
+
+MetricsServer::~MetricsServer() {
+    stopping = true;
+    thread.join();
+    close(listen_socket);
+}
+
+void MetricsServer::ServeLoop() {
+    while (!stopping) {
+        pollfd listen_poll{listen_socket, POLLIN, 0};
+        if (poll(&listen_poll, 1, METRICS_POLL_INTERVAL) <= 0) {
+            continue;
+        }
+
+        int connection = accept4(listen_socket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection < 0) {
+            continue;
+        }
+
+        ServeConnection(connection);
+        close(connection);
+    }
+}
+
+void MetricsServer::ServeConnection(int connection) {
+    /* Read until the end of the request headers, a scrape has no body */
+    std::string request;
+    std::array<char, 1024> buffer{};
+
+    while (request.find("\r\n\r\n") == std::string::npos &&
+           request.size() < METRICS_MAX_REQUEST) {
+        pollfd connection_poll{connection, POLLIN, 0};
+        if (poll(&connection_poll, 1, METRICS_REQUEST_TIMEOUT) <= 0) {
+            return;
+        }
+
+        ssize_t received = recv(connection, buffer.data(), buffer.size(), 0);
+        if (received <= 0) {
+            return;
+        }
+        request.append(buffer.data(), static_cast<size_t>(received));
+    }
+
+    // The request line is "GET /metrics HTTP/1.1", a query is ignored
+    if (request.rfind("GET /metrics ", 0) == 0 ||
+        request.rfind("GET /metrics?", 0) == 0) {
+        SendAll(connection,
+                Response("200 OK", "text/plain; version=0.0.4; charset=utf-8",
+                         metrics.Format()));
+    } else {
+        SendAll(connection, Response("404 Not Found", "text/plain",
+                                     "Metrics are served at /metrics\n"));
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+/* Local header files */
+#include "renderer_metrics.hpp"
+
+/* Standard libraries */
+#include <atomic>
+#include <cstdint>  // Required for uint16_t
+#include <thread>
+
+/* Loopback HTTP endpoint serving the renderer metrics
+
+GET /metrics on 127.0.0.1:<port> returns the metrics in the Prometheus text
+format, any other request a 404. The server runs on its own thread and
+answers one connection at a time, it only reads the atomics of the metrics,
+so a scrape never blocks a frame. Destroying the server stops and joins the
+thread.
+*/
+class MetricsServer {
+   public:
+    // Throws std::runtime_error if the port can not be bound
+    MetricsServer(const RendererMetrics& metrics, uint16_t port);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // Port the server listens on, the one chosen by the system for port 0
+    uint16_t GetPort() const { return port; }
+
+   private:
+    const RendererMetrics& metrics;
+    int listen_socket = -1;
+    uint16_t port = 0;
+    std::atomic<bool> stopping{false};
+    std::thread thread;
+
+    void ServeLoop();
+    void ServeConnection(int connection);
+};
+
+#endif  // METRICS_SERVER_H
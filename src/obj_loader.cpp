@@ -0,0 +1,230 @@
+/* Local header files */
+#include "obj_loader.hpp"
+
+/* Standard libraries */
+#include <cstdlib>  // Required for std::strtof
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Indices of a face corner into the position, texture coordinate and normal
+// lists. As read they are 1 based or negative and 0 if absent, once resolved
+// they are 0 based and -1 if absent.
+struct ObjCorner {
+    int64_t position = 0;
+    int64_t uv = 0;
+    int64_t normal = 0;
+
+    bool operator==(const ObjCorner& other) const {
+        return position == other.position && uv == other.uv &&
+               normal == other.normal;
+    }
+};
+
+struct ObjCornerHash {
+    size_t operator()(const ObjCorner& corner) const {
+        size_t hash = std::hash<int64_t>()(corner.position);
+        hash = hash * 31 + std::hash<int64_t>()(corner.uv);
+        return hash * 31 + std::hash<int64_t>()(corner.normal);
+    }
+};
+
+class ObjParser {
+   public:
+    ObjParser(const char* begin, const char* end) : cursor(begin), end(end) {}
+
+    bool AtEnd() const { return cursor >= end; }
+
+    void SkipSpaces() {
+        while (cursor < end && (*cursor == ' ' || *cursor == '\t')) {
+            cursor++;
+        }
+    }
+
+    void SkipLine() {
+        while (cursor < end && *cursor != '\n') {
+            cursor++;
+        }
+        if (cursor < end) {
+            cursor++;
+        }
+    }
+
+    bool AtLineEnd() {
+        SkipSpaces();
+        return cursor >= end || *cursor == '\n' || *cursor == '\r' ||
+               *cursor == '#';
+    }
+
+    std::string ReadKeyword() {
+        SkipSpaces();
+        const char* start = cursor;
+        while (cursor < end && *cursor != ' ' && *cursor != '\t' &&
+               *cursor != '\n' && *cursor != '\r') {
+            cursor++;
+        }
+        return {start, cursor};
+    }
+
+    float ReadFloat() {
+        // The file data is terminated, strtof stops at the end of the line
+        SkipSpaces();
+        char* number_end = nullptr;
+        float value = std::strtof(cursor, &number_end);
+        cursor = number_end;
+        return value;
+    }
+
+    int64_t ReadIndex() {
+        char* number_end = nullptr;
+        int64_t value = std::strtoll(cursor, &number_end, 10);
+        cursor = number_end;
+        return value;
+    }
+
+    ObjCorner ReadCorner() {
+        // v, v/vt, v//vn or v/vt/vn
+        SkipSpaces();
+        ObjCorner corner;
+        corner.position = ReadIndex();
+
+        if (cursor < end && *cursor == '/') {
+            cursor++;
+            if (cursor < end && *cursor != '/') {
+                corner.uv = ReadIndex();
+            }
+            if (cursor < end && *cursor == '/') {
+                cursor++;
+                corner.normal = ReadIndex();
+            }
+        }
+
+        return corner;
+    }
+
+   private:
+    const char* cursor;
+    const char* end;
+};
+
+// Resolve a 1 based or negative (relative to the end) OBJ index
+int64_t ResolveIndex(int64_t index, size_t count, const std::string& filename) {
+    int64_t resolved = index < 0 ? static_cast<int64_t>(count) + index
+                                 : index - 1;
+
+    if (resolved < 0 || resolved >= static_cast<int64_t>(count)) {
+        throw std::runtime_error(filename + ": face index out of range!");
+    }
+
+    return resolved;
+}
+
+ObjCorner ResolveCorner(const ObjCorner& corner, size_t position_count,
+                        size_t uv_count, size_t normal_count,
+                        const std::string& filename) {
+    ObjCorner resolved;
+    resolved.position = ResolveIndex(corner.position, position_count, filename);
+    resolved.uv =
+        corner.uv != 0 ? ResolveIndex(corner.uv, uv_count, filename) : -1;
+    resolved.normal = corner.normal != 0
+                          ? ResolveIndex(corner.normal, normal_count, filename)
+                          : -1;
+    return resolved;
+}
+
+}  // namespace
+
+SourceMesh LoadObjFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::ate | std::ios::binary);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("failed to open file: " + filename + "!");
+    }
+
+    // The data is terminated so the number parsing stops at its end
+    auto file_size = static_cast<size_t>(file.tellg());
+    std::vector<char> data(file_size + 1, '\0');
+    file.seekg(0);
+    file.read(data.data(), static_cast<std::streamsize>(file_size));
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> uvs;
+    std::vector<glm::vec3> normals;
+
+    SourceMesh mesh;
+    std::unordered_map<ObjCorner, uint32_t, ObjCornerHash> vertices;
+    std::vector<uint32_t> polygon;
+
+    ObjParser parser(data.data(), data.data() + file_size);
+
+    while (!parser.AtEnd()) {
+        std::string keyword = parser.ReadKeyword();
+
+        if (keyword == "v") {
+            float x = parser.ReadFloat();
+            float y = parser.ReadFloat();
+            float z = parser.ReadFloat();
+            positions.push_back({x, y, z});
+        } else if (keyword == "vt") {
+            float u = parser.ReadFloat();
+            float v = parser.ReadFloat();
+            uvs.push_back({u, v});
+        } else if (keyword == "vn") {
+            float x = parser.ReadFloat();
+            float y = parser.ReadFloat();
+            float z = parser.ReadFloat();
+            normals.push_back({x, y, z});
+        } else if (keyword == "f") {
+            polygon.clear();
+
+            while (!parser.AtLineEnd()) {
+                // Corners are compared by their resolved indices, so
+                // relative and absolute references share a vertex
+                ObjCorner corner =
+                    ResolveCorner(parser.ReadCorner(), positions.size(),
+                                  uvs.size(), normals.size(), filename);
+                auto inserted = vertices.emplace(
+                    corner, static_cast<uint32_t>(mesh.positions.size()));
+
+                if (inserted.second) {
+                    mesh.positions.push_back(positions[corner.position]);
+                    mesh.uvs.push_back(corner.uv >= 0
+                                           ? uvs[corner.uv]
+                                           : glm::vec2{0.0F, 0.0F});
+                    mesh.normals.push_back(corner.normal >= 0
+                                               ? normals[corner.normal]
+                                               : glm::vec3{0.0F, 0.0F, 0.0F});
+                }
+
+                polygon.push_back(inserted.first->second);
+            }
+
+            if (polygon.size() < 3) {
+                throw std::runtime_error(filename +
+                                         ": face with less than 3 vertices!");
+            }
+
+            // Triangle fan around the first corner
+            for (size_t i = 1; i + 1 < polygon.size(); i++) {
+                mesh.indices.insert(mesh.indices.end(),
+                                    {polygon[0], polygon[i], polygon[i + 1]});
+            }
+        }
+
+        parser.SkipLine();
+    }
+
+    // Without normals in the file they are computed from the faces
+    if (normals.empty()) {
+        mesh.normals.clear();
+    }
+
+    if (uvs.empty()) {
+        mesh.uvs.clear();
+    }
+
+    return mesh;
+}
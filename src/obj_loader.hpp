@@ -0,0 +1,21 @@
+#ifndef OBJ_LOADER_H
+#define OBJ_LOADER_H
+
+/* Local header files */
+#include "mesh_builder.hpp"
+
+/* Standard libraries */
+#include <string>
+
+/* Wavefront OBJ reader
+
+Reads the positions (v), texture coordinates (vt), normals (vn) and faces (f)
+of all objects into a single indexed mesh. Every distinct combination of
+position, texture coordinate and normal of a face corner becomes a vertex,
+polygons are split into triangle fans. Materials, groups and everything else
+are ignored. Throws std::runtime_error for files that can not be read or
+have invalid faces.
+*/
+SourceMesh LoadObjFile(const std::string& filename);
+
+#endif  // OBJ_LOADER_H
@@ -0,0 +1,803 @@
+/* Local header files */
+#include "occlusion_culling.hpp"
+
+/* Standard libraries */
+#include <algorithm>  // Required for std::max
+#include <cstring>
+#include <stdexcept>
+#include <utility>  // Required for std::make_pair
+
+namespace {
+
+// Push constants of shaders/occlusion_cull.comp
+struct CullParameters {
+    uint32_t depth_width;
+    uint32_t depth_height;
+    uint32_t draw_count;
+    uint32_t phase;
+    uint32_t pyramid_levels;  // 0 without a valid pyramid, all draws pass
+    uint32_t frame_slot;
+    uint32_t predicate_offset;  // First predicate of the frame, in draws
+    uint32_t use_predicates;
+};
+
+}  // namespace
+
+std::vector<OcclusionDraw> MakeSceneOcclusionDraws(uint32_t count) {
+    std::vector<OcclusionDraw> draws;
+    draws.reserve(count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        OcclusionDraw draw{};
+        draw.bounds_min = {-0.5F, -0.5F};
+        draw.bounds_max = {0.5F, 0.5F};
+        draw.min_depth = 1.0F / (2.0F + static_cast<float>(i));
+        draw.vertex_count = 3;
+        draw.first_instance = i;
+        draws.push_back(draw);
+    }
+
+    return draws;
+}
+
+std::vector<OcclusionDraw> MakeOcclusionTestScene(uint32_t layers) {
+    const uint32_t cells = OCCLUSION_TEST_GRID * OCCLUSION_TEST_GRID;
+    const float cell_size = 2.0F / static_cast<float>(OCCLUSION_TEST_GRID);
+
+    std::vector<OcclusionDraw> draws;
+    draws.reserve(static_cast<size_t>(layers) * cells);
+
+    for (uint32_t i = 0; i < layers * cells; i++) {
+        uint32_t cell = i % cells;
+        uint32_t layer = i / cells;
+        float x = -1.0F + static_cast<float>(cell % OCCLUSION_TEST_GRID) *
+                              cell_size;
+        float y = -1.0F + static_cast<float>(cell / OCCLUSION_TEST_GRID) *
+                              cell_size;
+
+        // The right triangle has legs of three cells and covers its own
+        // cell, the bounds are clamped to the view
+        OcclusionDraw draw{};
+        draw.bounds_min = {x, y};
+        draw.bounds_max = {std::min(x + 3.0F * cell_size, 1.0F),
+                           std::min(y + 3.0F * cell_size, 1.0F)};
+        draw.min_depth = 1.0F / (2.0F + static_cast<float>(layer));
+        draw.vertex_count = 3;
+        draw.first_instance = i;
+        draws.push_back(draw);
+    }
+
+    return draws;
+}
+
+OcclusionCuller::OcclusionCuller(VkDevice device,
+                                 MemoryAllocator& memory_allocator,
+                                 uint32_t frame_slot_count,
+                                 bool conditional_rendering,
+                                 bool multi_draw_indirect)
+    : device(device),
+      memory_allocator(memory_allocator),
+      frame_slot_count(frame_slot_count),
+      conditional_rendering(conditional_rendering),
+      multi_draw_indirect(multi_draw_indirect) {
+    // The commands of VK_EXT_conditional_rendering are extension functions
+    // and have to be looked up from the device
+    if (conditional_rendering) {
+        begin_conditional_rendering =
+            reinterpret_cast<PFN_vkCmdBeginConditionalRenderingEXT>(
+                vkGetDeviceProcAddr(device,
+                                    "vkCmdBeginConditionalRenderingEXT"));
+        end_conditional_rendering =
+            reinterpret_cast<PFN_vkCmdEndConditionalRenderingEXT>(
+                vkGetDeviceProcAddr(device, "vkCmdEndConditionalRenderingEXT"));
+        this->conditional_rendering = begin_conditional_rendering != nullptr &&
+                                      end_conditional_rendering != nullptr;
+    }
+
+    // The counters are written with atomics by the cull pass and read and
+    // cleared by the host once the fence of the slot was signaled
+    VkDeviceSize counter_size = frame_slot_count * sizeof(SlotCounters);
+    memory_allocator.CreateBuffer(counter_size,
+                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                  counter_buffer, counter_memory,
+                                  "occlusion counter");
+
+    void* data = nullptr;
+    if (vkMapMemory(device, counter_memory, 0, counter_size, 0, &data) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkMapMemory Error: failed to map occlusion counter memory!");
+    }
+    counters = static_cast<SlotCounters*>(data);
+    std::memset(counters, 0, counter_size);
+
+    CreateSampler();
+}
+
+void OcclusionCuller::Destroy() {
+    DestroyPyramid();
+    DestroyDrawBuffers();
+
+    vkUnmapMemory(device, counter_memory);
+    counters = nullptr;
+    vkDestroyBuffer(device, counter_buffer, nullptr);
+    memory_allocator.Free(counter_memory);
+    counter_buffer = VK_NULL_HANDLE;
+    counter_memory = VK_NULL_HANDLE;
+
+    vkDestroySampler(device, sampler, nullptr);
+    sampler = VK_NULL_HANDLE;
+
+    // The set layouts belong to the layout cache
+    vkDestroyPipeline(device, pyramid_pipeline, nullptr);
+    vkDestroyPipelineLayout(device, pyramid_layout, nullptr);
+    vkDestroyPipeline(device, cull_pipeline, nullptr);
+    vkDestroyPipelineLayout(device, cull_layout, nullptr);
+    pyramid_pipeline = VK_NULL_HANDLE;
+    pyramid_layout = VK_NULL_HANDLE;
+    cull_pipeline = VK_NULL_HANDLE;
+    cull_layout = VK_NULL_HANDLE;
+}
+
+void OcclusionCuller::CreatePipelines(VkPipelineCache cache,
+                                      DescriptorLayoutCache& layout_cache,
+                                      VkShaderModule pyramid_shader,
+                                      VkShaderModule cull_shader) {
+    /* The pyramid pass reads the level below, or the depth buffer, at
+    binding 0 and writes its level at binding 1 */
+    std::vector<VkDescriptorSetLayoutBinding> pyramid_bindings(2);
+    pyramid_bindings[0].descriptorType =
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    pyramid_bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+
+    /* The cull pass reads the draws, the pyramid and the predicates and
+    writes the culled flags, the draw commands and the counters */
+    std::vector<VkDescriptorSetLayoutBinding> cull_bindings(6);
+    for (VkDescriptorSetLayoutBinding& binding : cull_bindings) {
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    }
+    cull_bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+
+    for (auto* bindings : {&pyramid_bindings, &cull_bindings}) {
+        for (uint32_t i = 0; i < bindings->size(); i++) {
+            (*bindings)[i].binding = i;
+            (*bindings)[i].descriptorCount = 1;
+            (*bindings)[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+    }
+    pyramid_set_layout = layout_cache.Get(pyramid_bindings);
+    cull_set_layout = layout_cache.Get(cull_bindings);
+
+    VkPipelineLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_info.setLayoutCount = 1;
+    layout_info.pSetLayouts = &pyramid_set_layout;
+
+    if (vkCreatePipelineLayout(device, &layout_info, nullptr,
+                               &pyramid_layout) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreatePipelineLayout Error: failed to create depth pyramid "
+            "layout!");
+    }
+
+    VkPushConstantRange push_constant_range{};
+    push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    push_constant_range.offset = 0;
+    push_constant_range.size = sizeof(CullParameters);
+
+    layout_info.pSetLayouts = &cull_set_layout;
+    layout_info.pushConstantRangeCount = 1;
+    layout_info.pPushConstantRanges = &push_constant_range;
+
+    if (vkCreatePipelineLayout(device, &layout_info, nullptr, &cull_layout) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreatePipelineLayout Error: failed to create occlusion cull "
+            "layout!");
+    }
+
+    VkComputePipelineCreateInfo pipeline_info{};
+    pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipeline_info.stage.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipeline_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipeline_info.stage.module = pyramid_shader;
+    pipeline_info.stage.pName = "main";
+    pipeline_info.layout = pyramid_layout;
+
+    if (vkCreateComputePipelines(device, cache, 1, &pipeline_info, nullptr,
+                                 &pyramid_pipeline) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateComputePipelines Error: failed to create depth pyramid "
+            "pipeline!");
+    }
+
+    pipeline_info.stage.module = cull_shader;
+    pipeline_info.layout = cull_layout;
+
+    if (vkCreateComputePipelines(device, cache, 1, &pipeline_info, nullptr,
+                                 &cull_pipeline) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateComputePipelines Error: failed to create occlusion cull "
+            "pipeline!");
+    }
+}
+
+void OcclusionCuller::SetDraws(const std::vector<OcclusionDraw>& new_draws) {
+    if (new_draws.empty()) {
+        throw std::invalid_argument(
+            "occlusion culling needs at least one draw!");
+    }
+
+    DestroyDrawBuffers();
+    draws = new_draws;
+
+    auto count = static_cast<VkDeviceSize>(draws.size());
+    VkMemoryPropertyFlags host_properties =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    // The draws are written once
+    memory_allocator.CreateBuffer(count * sizeof(OcclusionDraw),
+                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                  host_properties, draw_buffer, draw_memory,
+                                  "occlusion draw");
+
+    void* data = nullptr;
+    if (vkMapMemory(device, draw_memory, 0, VK_WHOLE_SIZE, 0, &data) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkMapMemory Error: failed to map occlusion draw memory!");
+    }
+    std::memcpy(data, draws.data(), draws.size() * sizeof(OcclusionDraw));
+    vkUnmapMemory(device, draw_memory);
+
+    memory_allocator.CreateBuffer(
+        count * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, culled_buffer, culled_memory,
+        "occlusion culled");
+    memory_allocator.CreateBuffer(
+        2 * count * sizeof(VkDrawIndirectCommand),
+        VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, indirect_buffer, indirect_memory,
+        "occlusion indirect");
+
+    // Every draw passes until the first query results are copied
+    VkBufferUsageFlags predicate_usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                         VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    if (conditional_rendering) {
+        predicate_usage |= VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT;
+    }
+    VkDeviceSize predicate_size = frame_slot_count * count * sizeof(uint32_t);
+    memory_allocator.CreateBuffer(predicate_size, predicate_usage,
+                                  host_properties, predicate_buffer,
+                                  predicate_memory, "occlusion predicate");
+
+    if (vkMapMemory(device, predicate_memory, 0, VK_WHOLE_SIZE, 0, &data) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkMapMemory Error: failed to map occlusion predicate memory!");
+    }
+    std::fill_n(static_cast<uint32_t*>(data), frame_slot_count * count, 1U);
+    vkUnmapMemory(device, predicate_memory);
+    predicate_slot = -1;
+
+    if (conditional_rendering) {
+        VkQueryPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        pool_info.queryType = VK_QUERY_TYPE_OCCLUSION;
+        pool_info.queryCount =
+            frame_slot_count * static_cast<uint32_t>(draws.size());
+
+        if (vkCreateQueryPool(device, &pool_info, nullptr, &query_pool) !=
+            VK_SUCCESS) {
+            throw std::runtime_error(
+                "vkCreateQueryPool Error: failed to create occlusion query "
+                "pool!");
+        }
+    }
+
+    // The pyramid holds the depth of the previous draws
+    pyramid_valid = false;
+    std::memset(counters, 0, frame_slot_count * sizeof(SlotCounters));
+    ResetStatistics();
+}
+
+void OcclusionCuller::CreatePyramid(VkExtent2D depth_extent) {
+    this->depth_extent = depth_extent;
+
+    // Every level halves the one below, rounded down, down to one texel
+    VkExtent2D base_extent = {std::max(depth_extent.width / 2, 1U),
+                              std::max(depth_extent.height / 2, 1U)};
+    uint32_t level_count = 1;
+    while ((std::max(base_extent.width, base_extent.height) >> level_count) >
+           0) {
+        level_count++;
+    }
+
+    level_extents.clear();
+    for (uint32_t level = 0; level < level_count; level++) {
+        level_extents.push_back({std::max(base_extent.width >> level, 1U),
+                                 std::max(base_extent.height >> level, 1U)});
+    }
+
+    VkImageCreateInfo image_info{};
+    image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.extent = {base_extent.width, base_extent.height, 1};
+    image_info.mipLevels = level_count;
+    image_info.arrayLayers = 1;
+    image_info.format = DEPTH_PYRAMID_FORMAT;
+    image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image_info.usage =
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateImage(device, &image_info, nullptr, &pyramid_image) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateImage Error: failed to create depth pyramid image!");
+    }
+
+    VkMemoryRequirements mem_requirements{};
+    vkGetImageMemoryRequirements(device, pyramid_image, &mem_requirements);
+    pyramid_memory = memory_allocator.Allocate(
+        mem_requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, "depth pyramid");
+    vkBindImageMemory(device, pyramid_image, pyramid_memory, 0);
+
+    // The cull pass samples all levels, the pyramid pass writes one level
+    // at a time
+    VkImageViewCreateInfo view_info{};
+    view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    view_info.image = pyramid_image;
+    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_info.format = DEPTH_PYRAMID_FORMAT;
+    view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    view_info.subresourceRange.levelCount = level_count;
+    view_info.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(device, &view_info, nullptr, &pyramid_view) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateImageView Error: failed to create depth pyramid view!");
+    }
+
+    level_views.resize(level_count, VK_NULL_HANDLE);
+    view_info.subresourceRange.levelCount = 1;
+    for (uint32_t level = 0; level < level_count; level++) {
+        view_info.subresourceRange.baseMipLevel = level;
+        if (vkCreateImageView(device, &view_info, nullptr,
+                              &level_views[level]) != VK_SUCCESS) {
+            throw std::runtime_error(
+                "vkCreateImageView Error: failed to create depth pyramid "
+                "level view!");
+        }
+    }
+
+    pyramid_valid = false;
+}
+
+void OcclusionCuller::DestroyPyramid() {
+    for (VkImageView level_view : level_views) {
+        vkDestroyImageView(device, level_view, nullptr);
+    }
+    level_views.clear();
+    level_extents.clear();
+
+    vkDestroyImageView(device, pyramid_view, nullptr);
+    vkDestroyImage(device, pyramid_image, nullptr);
+    memory_allocator.Free(pyramid_memory);
+    pyramid_view = VK_NULL_HANDLE;
+    pyramid_image = VK_NULL_HANDLE;
+    pyramid_memory = VK_NULL_HANDLE;
+    pyramid_valid = false;
+}
+
+void OcclusionCuller::RecordCull(VkCommandBuffer command_buffer,
+                                 uint32_t frame_slot, OcclusionPhase phase,
+                                 VkImageView depth_view,
+                                 DescriptorAllocator& allocator) {
+    if (phase == OcclusionPhase::FIRST) {
+        // The fence of the frame slot was signaled, its counters are final
+        CollectCounters(frame_slot);
+
+        if (query_pool != VK_NULL_HANDLE) {
+            auto count = static_cast<uint32_t>(draws.size());
+            vkCmdResetQueryPool(command_buffer, query_pool,
+                                frame_slot * count, count);
+        }
+
+        // Without a pyramid the cull pass does not read it, it only has to
+        // be in the layout of the descriptor
+        if (!pyramid_valid) {
+            VkImageMemoryBarrier image_barrier{};
+            image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            image_barrier.image = pyramid_image;
+            image_barrier.subresourceRange.aspectMask =
+                VK_IMAGE_ASPECT_COLOR_BIT;
+            image_barrier.subresourceRange.levelCount =
+                static_cast<uint32_t>(level_views.size());
+            image_barrier.subresourceRange.layerCount = 1;
+            image_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            image_barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+            image_barrier.srcAccessMask = 0;
+            image_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            vkCmdPipelineBarrier(command_buffer,
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                                 nullptr, 0, nullptr, 1, &image_barrier);
+        }
+
+        // The previous frame drew from the commands and its second phase
+        // read the culled flags
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask =
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(command_buffer,
+                             VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+                             &barrier, 0, nullptr, 0, nullptr);
+    } else {
+        RecordPyramid(command_buffer, depth_view, allocator);
+    }
+
+    RecordDispatch(command_buffer, frame_slot, phase, allocator);
+
+    // The draws read the commands, the host reads the counters after the
+    // fence wait
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask =
+        VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(
+        command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0,
+        1, &barrier, 0, nullptr, 0, nullptr);
+
+    if (phase == OcclusionPhase::SECOND) {
+        pyramid_valid = true;
+    }
+}
+
+void OcclusionCuller::RecordDraws(VkCommandBuffer command_buffer,
+                                  OcclusionPhase phase) const {
+    auto count = static_cast<uint32_t>(draws.size());
+    VkDeviceSize stride = sizeof(VkDrawIndirectCommand);
+    VkDeviceSize offset = phase == OcclusionPhase::FIRST ? 0 : count * stride;
+
+    // A culled draw has no instances. Only the draws of the first phase are
+    // gated by the queries of the previous frame.
+    bool gated = phase == OcclusionPhase::FIRST && UsingPredicates();
+    if (!gated && multi_draw_indirect) {
+        vkCmdDrawIndirect(command_buffer, indirect_buffer, offset, count,
+                          static_cast<uint32_t>(stride));
+        return;
+    }
+
+    VkConditionalRenderingBeginInfoEXT conditional_info{};
+    conditional_info.sType =
+        VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT;
+    conditional_info.buffer = predicate_buffer;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (gated) {
+            conditional_info.offset =
+                (static_cast<VkDeviceSize>(predicate_slot) * count + i) *
+                sizeof(uint32_t);
+            begin_conditional_rendering(command_buffer, &conditional_info);
+        }
+
+        vkCmdDrawIndirect(command_buffer, indirect_buffer, offset + i * stride,
+                          1, static_cast<uint32_t>(stride));
+
+        if (gated) {
+            end_conditional_rendering(command_buffer);
+        }
+    }
+}
+
+void OcclusionCuller::RecordQueries(VkCommandBuffer command_buffer,
+                                    uint32_t frame_slot) const {
+    /* Every draw is tested against the finished depth buffer with a depth
+    only pipeline that does not write it, a hidden draw passes no samples */
+    auto count = static_cast<uint32_t>(draws.size());
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t query = frame_slot * count + i;
+        vkCmdBeginQuery(command_buffer, query_pool, query, 0);
+        vkCmdDraw(command_buffer, draws[i].vertex_count, 1, 0,
+                  draws[i].first_instance);
+        vkCmdEndQuery(command_buffer, query_pool, query);
+    }
+}
+
+void OcclusionCuller::RecordQueryCopy(VkCommandBuffer command_buffer,
+                                      uint32_t frame_slot) {
+    auto count = static_cast<uint32_t>(draws.size());
+    VkDeviceSize region_offset =
+        static_cast<VkDeviceSize>(frame_slot) * count * sizeof(uint32_t);
+
+    // The predicates of the slot were last read by the frame after its
+    // previous use
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    vkCmdPipelineBarrier(command_buffer,
+                         VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT |
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                         nullptr, 0, nullptr);
+
+    // The sample counts are the predicates, any non-zero count passes
+    vkCmdCopyQueryPoolResults(command_buffer, query_pool, frame_slot * count,
+                              count, predicate_buffer, region_offset,
+                              sizeof(uint32_t), VK_QUERY_RESULT_WAIT_BIT);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_CONDITIONAL_RENDERING_READ_BIT_EXT |
+                            VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT |
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    predicate_slot = frame_slot;
+}
+
+OcclusionStatistics OcclusionCuller::GetStatistics() const {
+    OcclusionStatistics statistics;
+    statistics.frames = measured_frames;
+    if (measured_frames == 0 || tested_sum == 0) {
+        return statistics;
+    }
+
+    auto tested = static_cast<double>(tested_sum);
+    uint64_t pyramid_culled = first_phase_culled_sum - second_phase_sum;
+
+    statistics.draws = tested / static_cast<double>(measured_frames);
+    statistics.pyramid_culled = static_cast<double>(pyramid_culled) / tested;
+    statistics.query_skipped =
+        static_cast<double>(query_skipped_sum) / tested;
+    statistics.culled = statistics.pyramid_culled + statistics.query_skipped;
+    statistics.second_phase = static_cast<double>(second_phase_sum) / tested;
+    return statistics;
+}
+
+void OcclusionCuller::ResetStatistics() {
+    measured_frames = 0;
+    tested_sum = 0;
+    first_phase_culled_sum = 0;
+    query_skipped_sum = 0;
+    second_phase_sum = 0;
+}
+
+void OcclusionCuller::Report(std::ostream& out) const {
+    out << "Occlusion culling: " << draws.size() << " draws, "
+        << (UsesQueries() ? "depth pyramid and occlusion queries"
+                          : "depth pyramid")
+        << std::endl;
+
+    OcclusionStatistics statistics = GetStatistics();
+    if (statistics.frames == 0) {
+        out << "  No culled frames" << std::endl;
+        return;
+    }
+
+    out << "  Culled: " << 100.0 * statistics.culled << "% ("
+        << 100.0 * statistics.pyramid_culled << "% by the pyramid, "
+        << 100.0 * statistics.query_skipped << "% by the queries)"
+        << std::endl;
+    out << "  Drawn in the second phase: " << 100.0 * statistics.second_phase
+        << "%, over " << statistics.frames << " frames" << std::endl;
+}
+
+void OcclusionCuller::SetDebugNames(const DebugUtils& debug_utils) const {
+    debug_utils.SetObjectName(pyramid_pipeline, VK_OBJECT_TYPE_PIPELINE,
+                              "Depth pyramid");
+    debug_utils.SetObjectName(cull_pipeline, VK_OBJECT_TYPE_PIPELINE,
+                              "Occlusion cull");
+}
+
+void OcclusionCuller::DestroyDrawBuffers() {
+    vkDestroyQueryPool(device, query_pool, nullptr);
+    query_pool = VK_NULL_HANDLE;
+
+    for (auto [buffer, memory] :
+         {std::make_pair(&draw_buffer, &draw_memory),
+          std::make_pair(&culled_buffer, &culled_memory),
+          std::make_pair(&indirect_buffer, &indirect_memory),
+          std::make_pair(&predicate_buffer, &predicate_memory)}) {
+        vkDestroyBuffer(device, *buffer, nullptr);
+        memory_allocator.Free(*memory);
+        *buffer = VK_NULL_HANDLE;
+        *memory = VK_NULL_HANDLE;
+    }
+
+    draws.clear();
+}
+
+void OcclusionCuller::CreateSampler() {
+    // The passes only fetch texels, the sampler is required by the combined
+    // image sampler descriptors
+    VkSamplerCreateInfo sampler_info{};
+    sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    sampler_info.magFilter = VK_FILTER_NEAREST;
+    sampler_info.minFilter = VK_FILTER_NEAREST;
+    sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.maxLod = VK_LOD_CLAMP_NONE;
+
+    if (vkCreateSampler(device, &sampler_info, nullptr, &sampler) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateSampler Error: failed to create depth pyramid sampler!");
+    }
+}
+
+void OcclusionCuller::CollectCounters(uint32_t frame_slot) {
+    /* A slot whose commands were recorded but not submitted, e.g. by a
+    benchmark, still has cleared counters and is skipped */
+    SlotCounters& slot_counters = counters[frame_slot];
+    if (slot_counters.tested == 0) {
+        return;
+    }
+
+    measured_frames++;
+    tested_sum += slot_counters.tested;
+    first_phase_culled_sum += slot_counters.first_phase_culled;
+    query_skipped_sum += slot_counters.query_skipped;
+    second_phase_sum += slot_counters.second_phase_drawn;
+    slot_counters = {};
+}
+
+void OcclusionCuller::RecordPyramid(VkCommandBuffer command_buffer,
+                                    VkImageView depth_view,
+                                    DescriptorAllocator& allocator) {
+    /* Every level is rebuilt, the previous contents were read by the first
+    phase and are not needed */
+    VkImageMemoryBarrier image_barrier{};
+    image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    image_barrier.image = pyramid_image;
+    image_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    image_barrier.subresourceRange.levelCount =
+        static_cast<uint32_t>(level_views.size());
+    image_barrier.subresourceRange.layerCount = 1;
+    image_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image_barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    image_barrier.srcAccessMask = 0;
+    image_barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr,
+                         0, nullptr, 1, &image_barrier);
+
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                      pyramid_pipeline);
+
+    for (uint32_t level = 0; level < level_views.size(); level++) {
+        // Level 0 reduces the depth buffer, every other level the one below
+        VkDescriptorImageInfo source_info{
+            sampler, depth_view,
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL};
+        if (level > 0) {
+            source_info = {sampler, level_views[level - 1],
+                           VK_IMAGE_LAYOUT_GENERAL};
+        }
+        VkDescriptorImageInfo target_info{VK_NULL_HANDLE, level_views[level],
+                                          VK_IMAGE_LAYOUT_GENERAL};
+
+        VkDescriptorSet set = allocator.Allocate(pyramid_set_layout);
+
+        std::array<VkWriteDescriptorSet, 2> writes{};
+        for (uint32_t binding = 0; binding < writes.size(); binding++) {
+            writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[binding].dstSet = set;
+            writes[binding].dstBinding = binding;
+            writes[binding].descriptorCount = 1;
+        }
+        writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        writes[0].pImageInfo = &source_info;
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        writes[1].pImageInfo = &target_info;
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()),
+                               writes.data(), 0, nullptr);
+
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                                pyramid_layout, 0, 1, &set, 0, nullptr);
+
+        VkExtent2D extent = level_extents[level];
+        vkCmdDispatch(
+            command_buffer,
+            (extent.width + DEPTH_PYRAMID_TILE_SIZE - 1) /
+                DEPTH_PYRAMID_TILE_SIZE,
+            (extent.height + DEPTH_PYRAMID_TILE_SIZE - 1) /
+                DEPTH_PYRAMID_TILE_SIZE,
+            1);
+
+        // The next level or the cull pass reads the level
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(command_buffer,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+                             &barrier, 0, nullptr, 0, nullptr);
+    }
+}
+
+void OcclusionCuller::RecordDispatch(VkCommandBuffer command_buffer,
+                                     uint32_t frame_slot, OcclusionPhase phase,
+                                     DescriptorAllocator& allocator) {
+    // The pyramid view changes with the swap chain, so the set is written
+    // every frame
+    VkDescriptorSet set = allocator.Allocate(cull_set_layout);
+
+    std::array<VkDescriptorBufferInfo, 6> buffer_infos = {{
+        {draw_buffer, 0, VK_WHOLE_SIZE},
+        {},
+        {culled_buffer, 0, VK_WHOLE_SIZE},
+        {indirect_buffer, 0, VK_WHOLE_SIZE},
+        {counter_buffer, 0, VK_WHOLE_SIZE},
+        {predicate_buffer, 0, VK_WHOLE_SIZE},
+    }};
+    VkDescriptorImageInfo pyramid_info{sampler, pyramid_view,
+                                       VK_IMAGE_LAYOUT_GENERAL};
+
+    std::array<VkWriteDescriptorSet, 6> writes{};
+    for (uint32_t binding = 0; binding < writes.size(); binding++) {
+        writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[binding].dstSet = set;
+        writes[binding].dstBinding = binding;
+        writes[binding].descriptorCount = 1;
+        writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[binding].pBufferInfo = &buffer_infos[binding];
+    }
+    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    writes[1].pBufferInfo = nullptr;
+    writes[1].pImageInfo = &pyramid_info;
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()),
+                           writes.data(), 0, nullptr);
+
+    // The first phase of the first frame has no pyramid yet
+    bool with_pyramid = phase == OcclusionPhase::SECOND || pyramid_valid;
+
+    CullParameters parameters{};
+    parameters.depth_width = depth_extent.width;
+    parameters.depth_height = depth_extent.height;
+    parameters.draw_count = static_cast<uint32_t>(draws.size());
+    parameters.phase = phase == OcclusionPhase::FIRST ? 0 : 1;
+    parameters.pyramid_levels =
+        with_pyramid ? static_cast<uint32_t>(level_views.size()) : 0;
+    parameters.frame_slot = frame_slot;
+    parameters.use_predicates =
+        phase == OcclusionPhase::FIRST && UsingPredicates() ? 1 : 0;
+    parameters.predicate_offset =
+        parameters.use_predicates != 0
+            ? static_cast<uint32_t>(predicate_slot) * parameters.draw_count
+            : 0;
+
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                      cull_pipeline);
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                            cull_layout, 0, 1, &set, 0, nullptr);
+    vkCmdPushConstants(command_buffer, cull_layout,
+                       VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(parameters),
+                       &parameters);
+    vkCmdDispatch(command_buffer,
+                  (parameters.draw_count + OCCLUSION_CULL_GROUP_SIZE - 1) /
+                      OCCLUSION_CULL_GROUP_SIZE,
+                  1, 1);
+}
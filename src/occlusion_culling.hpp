@@ -0,0 +1,234 @@
+#ifndef OCCLUSION_CULLING_H
+#define OCCLUSION_CULLING_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Local header files */
+#include "debug_utils.hpp"
+#include "descriptor_allocator.hpp"
+#include "memory_allocator.hpp"
+
+/* Standard libraries */
+#include <array>
+#include <cstdint>  // Required for uint32_t
+#include <ostream>
+#include <vector>
+
+// Format of the depth pyramid, every device supports it as storage image
+const VkFormat DEPTH_PYRAMID_FORMAT = VK_FORMAT_R32_SFLOAT;
+
+// Workgroup sizes of shaders/depth_pyramid.comp in both dimensions and of
+// shaders/occlusion_cull.comp
+const uint32_t DEPTH_PYRAMID_TILE_SIZE = 8;
+const uint32_t OCCLUSION_CULL_GROUP_SIZE = 64;
+
+// Cells per row and column of the occlusion test scene, see
+// shaders/occlusion_test.vert
+const uint32_t OCCLUSION_TEST_GRID = 16;
+
+// Screen bounds of a draw of the scene. The bounds are in clip space, x and
+// y in [-1, 1] with y pointing down, the depth in [0, 1]. The layout matches
+// the draw buffer of shaders/occlusion_cull.comp.
+struct OcclusionDraw {
+    std::array<float, 2> bounds_min;
+    std::array<float, 2> bounds_max;
+    float min_depth;  // Nearest depth of the draw
+    uint32_t vertex_count;
+    uint32_t first_instance;
+    uint32_t padding;
+};
+static_assert(sizeof(OcclusionDraw) == 32, "OcclusionDraw must be 32 bytes");
+
+// Draws of the layered triangles of shaders/shader.vert, the first instance
+// is the farthest
+std::vector<OcclusionDraw> MakeSceneOcclusionDraws(uint32_t count);
+
+// Draws of shaders/occlusion_test.vert: layers of triangles that each cover
+// one cell of a OCCLUSION_TEST_GRID grid over the whole view, drawn back to
+// front. Only the nearest layer is visible.
+std::vector<OcclusionDraw> MakeOcclusionTestScene(uint32_t layers);
+
+// Half of the scene is drawn before the depth pyramid is built, the other
+// half after it
+enum class OcclusionPhase { FIRST, SECOND };
+
+// Averages over the frames since the last reset, as fractions of the draws
+struct OcclusionStatistics {
+    uint64_t frames = 0;
+    double draws = 0.0;           // Draws per frame
+    double culled = 0.0;          // Not drawn in either phase
+    double pyramid_culled = 0.0;  // Culled by the pyramid in both phases
+    double query_skipped = 0.0;   // Skipped by conditional rendering
+    double second_phase = 0.0;    // Culled in the first, drawn in the second
+};
+
+/* Two-phase occlusion culling of the scene draws on the GPU
+
+The depth pyramid holds the farthest depth of ever larger tiles of the depth
+buffer, each level halves the one below. A draw whose nearest depth is
+behind the farthest depth of the 2x2 texels of the level that its screen
+bounds fit into is hidden.
+
+1. Before the render pass, a compute pass tests every draw against the
+   pyramid of the previous frame and writes an indirect draw command per
+   draw, with an instance count of 0 if it is hidden.
+2. The render pass is split. The first half draws the draws that passed,
+   which are the bulk of the visible scene.
+3. Between the halves the pyramid is rebuilt from that depth buffer and the
+   draws culled in the first phase are tested again. The second half draws
+   the ones that became visible, so a draw is never missing because the
+   view changed since the previous frame. The pyramid is kept for the next
+   frame.
+
+With VK_EXT_conditional_rendering every draw is also drawn depth only inside
+an occlusion query at the end of the second half, and the query results are
+copied into a predicate per draw. The next frame skips the first phase draws
+whose query passed no samples, which catches draws the conservative pyramid
+test keeps, e.g. triangles whose bounds also cover the background. A draw
+that becomes visible is skipped for one frame, the second phase does not
+test it again.
+
+The buffers and the pyramid are shared by the frames in flight, the frames
+are executed in submission order on one queue. The pyramid is rebuilt
+before the second phase reads it, so a frame that was recorded but not
+submitted only costs the first phase of the next frame its culling. The
+counters of a frame slot are read back when the slot is recorded again.
+*/
+class OcclusionCuller {
+   public:
+    OcclusionCuller(VkDevice device, MemoryAllocator& memory_allocator,
+                    uint32_t frame_slot_count, bool conditional_rendering,
+                    bool multi_draw_indirect);
+
+    // Destroy the buffers, the pyramid and the pipelines, the device must be
+    // idle
+    void Destroy();
+
+    void CreatePipelines(VkPipelineCache cache,
+                         DescriptorLayoutCache& layout_cache,
+                         VkShaderModule pyramid_shader,
+                         VkShaderModule cull_shader);
+
+    // Replace the draws and forget the visibility of the previous frames,
+    // the device must be idle. Throws std::invalid_argument without draws.
+    void SetDraws(const std::vector<OcclusionDraw>& new_draws);
+    uint32_t GetDrawCount() const {
+        return static_cast<uint32_t>(draws.size());
+    }
+
+    // The pyramid has the size of the depth buffer and is recreated with it
+    void CreatePyramid(VkExtent2D depth_extent);
+    void DestroyPyramid();
+
+    // Record the culling of a phase, outside of the render pass. The second
+    // phase builds the pyramid from the depth view, which is in the
+    // DEPTH_STENCIL_READ_ONLY_OPTIMAL layout.
+    void RecordCull(VkCommandBuffer command_buffer, uint32_t frame_slot,
+                    OcclusionPhase phase, VkImageView depth_view,
+                    DescriptorAllocator& allocator);
+
+    // Record the draws of a phase with the bound scene pipeline
+    void RecordDraws(VkCommandBuffer command_buffer,
+                     OcclusionPhase phase) const;
+
+    // Record the occlusion queries with the bound depth only pipeline after
+    // the second phase, and copy their results after the render pass. Only
+    // with conditional rendering.
+    void RecordQueries(VkCommandBuffer command_buffer,
+                       uint32_t frame_slot) const;
+    void RecordQueryCopy(VkCommandBuffer command_buffer, uint32_t frame_slot);
+
+    bool UsesQueries() const { return query_pool != VK_NULL_HANDLE; }
+
+    OcclusionStatistics GetStatistics() const;
+    void ResetStatistics();
+
+    // Print the culled fractions
+    void Report(std::ostream& out) const;
+
+    // Name the pipelines for capture tools
+    void SetDebugNames(const DebugUtils& debug_utils) const;
+
+   private:
+    // Counters of a frame slot, see shaders/occlusion_cull.comp
+    struct SlotCounters {
+        uint32_t tested;
+        uint32_t first_phase_culled;
+        uint32_t query_skipped;
+        uint32_t second_phase_drawn;
+    };
+
+    VkDevice device;
+    MemoryAllocator& memory_allocator;
+    uint32_t frame_slot_count;
+    bool conditional_rendering;
+    bool multi_draw_indirect;
+
+    PFN_vkCmdBeginConditionalRenderingEXT begin_conditional_rendering =
+        nullptr;
+    PFN_vkCmdEndConditionalRenderingEXT end_conditional_rendering = nullptr;
+
+    std::vector<OcclusionDraw> draws;
+
+    // Host visible: the draws and the counters of every frame slot
+    VkBuffer draw_buffer = VK_NULL_HANDLE;
+    VkDeviceMemory draw_memory = VK_NULL_HANDLE;
+    VkBuffer counter_buffer = VK_NULL_HANDLE;
+    VkDeviceMemory counter_memory = VK_NULL_HANDLE;
+    SlotCounters* counters = nullptr;
+
+    // Device local: whether the first phase culled a draw, and the draw
+    // commands of both phases one after the other
+    VkBuffer culled_buffer = VK_NULL_HANDLE;
+    VkDeviceMemory culled_memory = VK_NULL_HANDLE;
+    VkBuffer indirect_buffer = VK_NULL_HANDLE;
+    VkDeviceMemory indirect_memory = VK_NULL_HANDLE;
+
+    // Query results of every frame slot, one predicate per draw. The first
+    // phase reads the results of the slot copied last, -1 for none. The
+    // cull pass reads them as well to count the skipped draws, so the buffer
+    // also exists without queries.
+    VkQueryPool query_pool = VK_NULL_HANDLE;
+    VkBuffer predicate_buffer = VK_NULL_HANDLE;
+    VkDeviceMemory predicate_memory = VK_NULL_HANDLE;
+    int64_t predicate_slot = -1;
+
+    // Level 0 is half the depth buffer. The pyramid is only valid once it
+    // was built from a depth buffer of the current draws and extent.
+    VkImage pyramid_image = VK_NULL_HANDLE;
+    VkDeviceMemory pyramid_memory = VK_NULL_HANDLE;
+    VkImageView pyramid_view = VK_NULL_HANDLE;
+    std::vector<VkImageView> level_views;
+    std::vector<VkExtent2D> level_extents;
+    VkExtent2D depth_extent{};
+    bool pyramid_valid = false;
+    VkSampler sampler = VK_NULL_HANDLE;
+
+    VkDescriptorSetLayout pyramid_set_layout = VK_NULL_HANDLE;
+    VkPipelineLayout pyramid_layout = VK_NULL_HANDLE;
+    VkPipeline pyramid_pipeline = VK_NULL_HANDLE;
+    VkDescriptorSetLayout cull_set_layout = VK_NULL_HANDLE;
+    VkPipelineLayout cull_layout = VK_NULL_HANDLE;
+    VkPipeline cull_pipeline = VK_NULL_HANDLE;
+
+    // Sums over the collected frames
+    uint64_t measured_frames = 0;
+    uint64_t tested_sum = 0;
+    uint64_t first_phase_culled_sum = 0;
+    uint64_t query_skipped_sum = 0;
+    uint64_t second_phase_sum = 0;
+
+    void DestroyDrawBuffers();
+    void CreateSampler();
+    void CollectCounters(uint32_t frame_slot);
+    bool UsingPredicates() const {
+        return query_pool != VK_NULL_HANDLE && predicate_slot >= 0;
+    }
+    void RecordPyramid(VkCommandBuffer command_buffer, VkImageView depth_view,
+                       DescriptorAllocator& allocator);
+    void RecordDispatch(VkCommandBuffer command_buffer, uint32_t frame_slot,
+                        OcclusionPhase phase, DescriptorAllocator& allocator);
+};
+
+#endif  // OCCLUSION_CULLING_H
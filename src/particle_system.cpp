@@ -0,0 +1,515 @@
+/* Local header files */
+#include "particle_system.hpp"
+
+/* Standard libraries */
+#include <algorithm>  // Required for std::min
+#include <cstddef>    // Required for offsetof
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Parameters of shaders/particles.comp
+struct SimulationParameters {
+    uint32_t capacity;
+    uint32_t emit_count;
+    uint32_t seed;
+    uint32_t prewarm;
+    float delta_time;
+};
+
+// Draw command of an empty buffer, 6 vertices per quad
+const VkDrawIndirectCommand EMPTY_DRAW = {6, 0, 0, 0};
+
+}  // namespace
+
+ParticleSystem::ParticleSystem(VkDevice device,
+                               MemoryAllocator& memory_allocator,
+                               uint32_t capacity, uint32_t frame_slot_count)
+    : device(device), memory_allocator(memory_allocator), capacity(capacity) {
+    if (capacity == 0 || capacity > PARTICLE_MAX_CAPACITY) {
+        throw std::invalid_argument(
+            "the particle capacity must be between 1 and " +
+            std::to_string(PARTICLE_MAX_CAPACITY) + "!");
+    }
+
+    for (auto& particle_buffer : particle_buffers) {
+        memory_allocator.CreateBuffer(
+            PARTICLE_DATA_OFFSET + capacity * PARTICLE_SIZE,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, particle_buffer.buffer,
+            particle_buffer.memory, "particle");
+    }
+
+    // The counts are read on the host after the fence, coherent memory needs
+    // no invalidation
+    VkDeviceSize readback_size = frame_slot_count * sizeof(uint32_t);
+    memory_allocator.CreateBuffer(readback_size,
+                                  VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                  readback_buffer, readback_memory,
+                                  "particle readback");
+
+    void* mapped = nullptr;
+    if (vkMapMemory(device, readback_memory, 0, readback_size, 0, &mapped) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkMapMemory Error: failed to map particle readback memory!");
+    }
+    readback_counts = static_cast<uint32_t*>(mapped);
+    for (uint32_t i = 0; i < frame_slot_count; i++) {
+        readback_counts[i] = 0;
+    }
+
+    CreateDescriptorSets();
+}
+
+void ParticleSystem::Destroy() {
+    vkDestroyPipeline(device, simulation_pipeline, nullptr);
+    vkDestroyPipelineLayout(device, simulation_layout, nullptr);
+    vkDestroyPipeline(device, draw_pipeline, nullptr);
+    vkDestroyPipelineLayout(device, draw_layout, nullptr);
+
+    // Destroying the pool frees its descriptor sets
+    vkDestroyDescriptorPool(device, descriptor_pool, nullptr);
+    vkDestroyDescriptorSetLayout(device, simulation_set_layout, nullptr);
+    vkDestroyDescriptorSetLayout(device, draw_set_layout, nullptr);
+
+    for (auto& particle_buffer : particle_buffers) {
+        vkDestroyBuffer(device, particle_buffer.buffer, nullptr);
+        memory_allocator.Free(particle_buffer.memory);
+        particle_buffer = {};
+    }
+
+    vkDestroyBuffer(device, readback_buffer, nullptr);
+    memory_allocator.Free(readback_memory);
+    readback_buffer = VK_NULL_HANDLE;
+    readback_memory = VK_NULL_HANDLE;
+    readback_counts = nullptr;
+}
+
+void ParticleSystem::CreatePipelines(VkRenderPass render_pass,
+                                     uint32_t subpass,
+                                     VkSampleCountFlagBits samples,
+                                     VkPipelineCache cache,
+                                     VkShaderModule simulation_shader,
+                                     VkShaderModule vert_shader,
+                                     VkShaderModule frag_shader) {
+    /* Simulation */
+    VkPushConstantRange push_constant_range{};
+    push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    push_constant_range.offset = 0;
+    push_constant_range.size = sizeof(SimulationParameters);
+
+    VkPipelineLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_info.setLayoutCount = 1;
+    layout_info.pSetLayouts = &simulation_set_layout;
+    layout_info.pushConstantRangeCount = 1;
+    layout_info.pPushConstantRanges = &push_constant_range;
+
+    if (vkCreatePipelineLayout(device, &layout_info, nullptr,
+                               &simulation_layout) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreatePipelineLayout Error: failed to create particle "
+            "simulation layout!");
+    }
+
+    VkComputePipelineCreateInfo pipeline_info{};
+    pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipeline_info.stage.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipeline_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipeline_info.stage.module = simulation_shader;
+    pipeline_info.stage.pName = "main";
+    pipeline_info.layout = simulation_layout;
+
+    if (vkCreateComputePipelines(device, cache, 1, &pipeline_info, nullptr,
+                                 &simulation_pipeline) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateComputePipelines Error: failed to create particle "
+            "simulation pipeline!");
+    }
+
+    CreateDrawPipeline(render_pass, subpass, samples, cache, vert_shader,
+                       frag_shader);
+}
+
+void ParticleSystem::RecordSimulation(VkCommandBuffer command_buffer,
+                                      uint32_t frame_slot, float delta_time) {
+    /* Emission rate
+    A particle lives PARTICLE_MEAN_LIFETIME seconds on average, emitting
+    capacity / PARTICLE_MEAN_LIFETIME particles per second replaces the ones
+    that die. The first frame fills the whole buffer with particles of random
+    age, so the fountain starts in its steady state. */
+    uint32_t emit_count = capacity;
+    if (simulated) {
+        emit_remainder += static_cast<float>(capacity) * delta_time /
+                          PARTICLE_MEAN_LIFETIME;
+        emit_count = static_cast<uint32_t>(
+            std::min(emit_remainder, static_cast<float>(capacity)));
+        emit_remainder -= static_cast<float>(emit_count);
+    }
+
+    uint32_t source_buffer = 1 - target_buffer;
+    VkBuffer source = particle_buffers[source_buffer].buffer;
+    VkBuffer target = particle_buffers[target_buffer].buffer;
+
+    // The previous simulations and draws are done with the buffers before
+    // the draw command of the target is reset, and the particles written by
+    // the last simulation are visible
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask =
+        VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(command_buffer,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                             VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                             VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT |
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    // The source of the first simulation is empty
+    if (!simulated) {
+        vkCmdUpdateBuffer(command_buffer, source, 0, sizeof(EMPTY_DRAW),
+                          &EMPTY_DRAW);
+    }
+    vkCmdUpdateBuffer(command_buffer, target, 0, sizeof(EMPTY_DRAW),
+                      &EMPTY_DRAW);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask =
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier,
+                         0, nullptr, 0, nullptr);
+
+    /* Simulation over the whole capacity, the invocations past the source
+    particles and the emission return early */
+    SimulationParameters parameters{};
+    parameters.capacity = capacity;
+    parameters.emit_count = emit_count;
+    parameters.seed = seed++;
+    parameters.prewarm = simulated ? 0 : 1;
+    parameters.delta_time = delta_time;
+
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                      simulation_pipeline);
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                            simulation_layout, 0, 1,
+                            &simulation_sets[target_buffer], 0, nullptr);
+    vkCmdPushConstants(command_buffer, simulation_layout,
+                       VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(parameters),
+                       &parameters);
+    vkCmdDispatch(command_buffer,
+                  (capacity + PARTICLE_WORKGROUP_SIZE - 1) /
+                      PARTICLE_WORKGROUP_SIZE,
+                  1, 1);
+
+    // The draw reads the draw command and the particles, the readback copy
+    // the count
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT |
+                            VK_ACCESS_SHADER_READ_BIT |
+                            VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                             VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    VkBufferCopy copy{};
+    copy.srcOffset = offsetof(VkDrawIndirectCommand, instanceCount);
+    copy.dstOffset = frame_slot * sizeof(uint32_t);
+    copy.size = sizeof(uint32_t);
+    vkCmdCopyBuffer(command_buffer, target, readback_buffer, 1, &copy);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0,
+                         nullptr, 0, nullptr);
+
+    // The particles of this frame are the source of the next one
+    target_buffer = source_buffer;
+    simulated = true;
+}
+
+void ParticleSystem::RecordDraw(VkCommandBuffer command_buffer,
+                                VkExtent2D extent) const {
+    if (!simulated) {
+        return;
+    }
+
+    // The last simulation wrote the buffer that is the next target
+    uint32_t drawn_buffer = 1 - target_buffer;
+
+    // Clip space spans 2 units over the extent
+    std::array<float, 2> half_size = {
+        PARTICLE_PIXEL_SIZE / static_cast<float>(extent.width),
+        PARTICLE_PIXEL_SIZE / static_cast<float>(extent.height)};
+
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                      draw_pipeline);
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            draw_layout, 0, 1, &draw_sets[drawn_buffer], 0,
+                            nullptr);
+    vkCmdPushConstants(command_buffer, draw_layout,
+                       VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(half_size),
+                       half_size.data());
+    vkCmdDrawIndirect(command_buffer, particle_buffers[drawn_buffer].buffer,
+                      0, 1, sizeof(VkDrawIndirectCommand));
+}
+
+void ParticleSystem::SetDebugNames(const DebugUtils& debug_utils) const {
+    debug_utils.SetObjectName(particle_buffers[0].buffer,
+                              VK_OBJECT_TYPE_BUFFER, "Particles 0");
+    debug_utils.SetObjectName(particle_buffers[1].buffer,
+                              VK_OBJECT_TYPE_BUFFER, "Particles 1");
+    debug_utils.SetObjectName(readback_buffer, VK_OBJECT_TYPE_BUFFER,
+                              "Particle counts");
+    debug_utils.SetObjectName(simulation_pipeline, VK_OBJECT_TYPE_PIPELINE,
+                              "Particle simulation");
+    debug_utils.SetObjectName(draw_pipeline, VK_OBJECT_TYPE_PIPELINE,
+                              "Particle draw");
+}
+
+void ParticleSystem::CreateDescriptorSets() {
+    /* The simulation reads the draw command and particles of one buffer and
+    appends to the other, the draw reads the particles of one buffer. Each
+    has a set per buffer, selected by the parity of the frame. */
+    std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_info.bindingCount = static_cast<uint32_t>(bindings.size());
+    layout_info.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layout_info, nullptr,
+                                    &simulation_set_layout) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateDescriptorSetLayout Error: failed to create particle "
+            "simulation set layout!");
+    }
+
+    bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    layout_info.bindingCount = 1;
+
+    if (vkCreateDescriptorSetLayout(device, &layout_info, nullptr,
+                                    &draw_set_layout) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateDescriptorSetLayout Error: failed to create particle "
+            "draw set layout!");
+    }
+
+    VkDescriptorPoolSize pool_size{};
+    pool_size.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pool_size.descriptorCount = 2 * bindings.size() + 2;
+
+    VkDescriptorPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.maxSets = 4;
+    pool_info.poolSizeCount = 1;
+    pool_info.pPoolSizes = &pool_size;
+
+    if (vkCreateDescriptorPool(device, &pool_info, nullptr,
+                               &descriptor_pool) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateDescriptorPool Error: failed to create particle "
+            "descriptor pool!");
+    }
+
+    std::array<VkDescriptorSetLayout, 4> set_layouts = {
+        simulation_set_layout, simulation_set_layout, draw_set_layout,
+        draw_set_layout};
+    std::array<VkDescriptorSet, 4> sets{};
+
+    VkDescriptorSetAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.descriptorPool = descriptor_pool;
+    alloc_info.descriptorSetCount = static_cast<uint32_t>(sets.size());
+    alloc_info.pSetLayouts = set_layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &alloc_info, sets.data()) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkAllocateDescriptorSets Error: failed to allocate particle "
+            "descriptor sets!");
+    }
+
+    simulation_sets = {sets[0], sets[1]};
+    draw_sets = {sets[2], sets[3]};
+
+    VkDeviceSize particles_size = capacity * PARTICLE_SIZE;
+
+    for (uint32_t target = 0; target < 2; target++) {
+        VkBuffer source_buffer = particle_buffers[1 - target].buffer;
+        VkBuffer target_buffer = particle_buffers[target].buffer;
+
+        // Draw command and particles of the source, then of the target
+        std::array<VkDescriptorBufferInfo, 4> buffer_infos = {{
+            {source_buffer, 0, sizeof(VkDrawIndirectCommand)},
+            {source_buffer, PARTICLE_DATA_OFFSET, particles_size},
+            {target_buffer, 0, sizeof(VkDrawIndirectCommand)},
+            {target_buffer, PARTICLE_DATA_OFFSET, particles_size},
+        }};
+
+        std::array<VkWriteDescriptorSet, 5> writes{};
+        for (uint32_t i = 0; i < writes.size(); i++) {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = simulation_sets[target];
+            writes[i].dstBinding = i;
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].pBufferInfo = &buffer_infos[i % buffer_infos.size()];
+        }
+
+        // The draw set of a buffer reads its particles
+        writes[4].dstSet = draw_sets[target];
+        writes[4].dstBinding = 0;
+        writes[4].pBufferInfo = &buffer_infos[3];
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()),
+                               writes.data(), 0, nullptr);
+    }
+}
+
+void ParticleSystem::CreateDrawPipeline(VkRenderPass render_pass,
+                                        uint32_t subpass,
+                                        VkSampleCountFlagBits samples,
+                                        VkPipelineCache cache,
+                                        VkShaderModule vert_shader,
+                                        VkShaderModule frag_shader) {
+    VkPushConstantRange push_constant_range{};
+    push_constant_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    push_constant_range.offset = 0;
+    push_constant_range.size = 2 * sizeof(float);
+
+    VkPipelineLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_info.setLayoutCount = 1;
+    layout_info.pSetLayouts = &draw_set_layout;
+    layout_info.pushConstantRangeCount = 1;
+    layout_info.pPushConstantRanges = &push_constant_range;
+
+    if (vkCreatePipelineLayout(device, &layout_info, nullptr, &draw_layout) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreatePipelineLayout Error: failed to create particle draw "
+            "layout!");
+    }
+
+    std::array<VkPipelineShaderStageCreateInfo, 2> shader_stages{};
+    shader_stages[0].sType =
+        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shader_stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shader_stages[0].module = vert_shader;
+    shader_stages[0].pName = "main";
+    shader_stages[1].sType =
+        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shader_stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shader_stages[1].module = frag_shader;
+    shader_stages[1].pName = "main";
+
+    // The quads are built from the vertex and instance index
+    VkPipelineVertexInputStateCreateInfo vertex_input_info{};
+    vertex_input_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+    VkPipelineInputAssemblyStateCreateInfo input_assembly{};
+    input_assembly.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkPipelineViewportStateCreateInfo viewport_state{};
+    viewport_state.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewport_state.viewportCount = 1;
+    viewport_state.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0F;
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = samples;
+    multisampling.minSampleShading = 1.0F;
+
+    // The particles glow over the scene, they are neither tested against
+    // nor written to the depth
+    VkPipelineDepthStencilStateCreateInfo depth_stencil{};
+    depth_stencil.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depth_stencil.depthTestEnable = VK_FALSE;
+    depth_stencil.depthWriteEnable = VK_FALSE;
+
+    // Additive blending, the order of the particles does not matter
+    VkPipelineColorBlendAttachmentState color_blend_attachment{};
+    color_blend_attachment.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    color_blend_attachment.blendEnable = VK_TRUE;
+    color_blend_attachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+    color_blend_attachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+    color_blend_attachment.colorBlendOp = VK_BLEND_OP_ADD;
+    color_blend_attachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    color_blend_attachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    color_blend_attachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo color_blending{};
+    color_blending.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    color_blending.attachmentCount = 1;
+    color_blending.pAttachments = &color_blend_attachment;
+
+    std::array<VkDynamicState, 2> dynamic_states = {VK_DYNAMIC_STATE_VIEWPORT,
+                                                    VK_DYNAMIC_STATE_SCISSOR};
+
+    VkPipelineDynamicStateCreateInfo dynamic_state{};
+    dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamic_state.dynamicStateCount =
+        static_cast<uint32_t>(dynamic_states.size());
+    dynamic_state.pDynamicStates = dynamic_states.data();
+
+    VkGraphicsPipelineCreateInfo pipeline_info{};
+    pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipeline_info.stageCount = static_cast<uint32_t>(shader_stages.size());
+    pipeline_info.pStages = shader_stages.data();
+    pipeline_info.pVertexInputState = &vertex_input_info;
+    pipeline_info.pInputAssemblyState = &input_assembly;
+    pipeline_info.pViewportState = &viewport_state;
+    pipeline_info.pRasterizationState = &rasterizer;
+    pipeline_info.pMultisampleState = &multisampling;
+    pipeline_info.pDepthStencilState = &depth_stencil;
+    pipeline_info.pColorBlendState = &color_blending;
+    pipeline_info.pDynamicState = &dynamic_state;
+    pipeline_info.layout = draw_layout;
+    pipeline_info.renderPass = render_pass;
+    pipeline_info.subpass = subpass;
+
+    if (vkCreateGraphicsPipelines(device, cache, 1, &pipeline_info, nullptr,
+                                  &draw_pipeline) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateGraphicsPipelines Error: failed to create particle draw "
+            "pipeline!");
+    }
+}
@@ -0,0 +1,132 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Local header files */
+#include "debug_utils.hpp"
+#include "memory_allocator.hpp"
+
+/* Standard libraries */
+#include <array>
+#include <cstdint>  // Required for uint32_t
+#include <vector>
+
+// Bytes of a particle in the buffers, see shaders/particles.comp
+const VkDeviceSize PARTICLE_SIZE = 32;
+
+// Offset of the particles behind the draw command of a buffer, the largest
+// minStorageBufferOffsetAlignment the specification allows
+const VkDeviceSize PARTICLE_DATA_OFFSET = 256;
+
+// Particles per workgroup of the simulation, the capacity is limited by the
+// workgroup count every device supports
+const uint32_t PARTICLE_WORKGROUP_SIZE = 256;
+const uint32_t PARTICLE_MAX_CAPACITY = 65535 * PARTICLE_WORKGROUP_SIZE;
+
+// Average lifetime of a particle in seconds, the emission rate keeps the
+// buffer about full
+const float PARTICLE_MEAN_LIFETIME = 3.0F;
+
+// Size of a particle on screen
+const float PARTICLE_PIXEL_SIZE = 2.0F;
+
+/* Particle fountain simulated and drawn entirely on the GPU
+
+Every frame one compute dispatch ages and moves the particles of the
+previous frame, emits new ones and compacts the survivors and the new
+particles into the other of two particle buffers. Each buffer starts with
+the VkDrawIndirectCommand of its particles, the compute shader counts them
+into its instance count, so the particles are drawn as instanced quads with
+vkCmdDrawIndirect and the CPU never touches a particle.
+
+The two buffers alternate every frame. The frames in flight are executed in
+submission order on the same queue, and the simulation of a frame waits for
+the draws and simulations recorded before it, so two buffers serve any
+number of frames in flight.
+*/
+class ParticleSystem {
+   public:
+    // Throws std::invalid_argument if the capacity is 0 or above
+    // PARTICLE_MAX_CAPACITY
+    ParticleSystem(VkDevice device, MemoryAllocator& memory_allocator,
+                   uint32_t capacity, uint32_t frame_slot_count);
+
+    // Destroy the buffers and pipelines, the device must be idle
+    void Destroy();
+
+    // The draw pipeline is created for the given subpass of the render pass.
+    // The fragment shader takes the color of the particle at location 0.
+    void CreatePipelines(VkRenderPass render_pass, uint32_t subpass,
+                         VkSampleCountFlagBits samples, VkPipelineCache cache,
+                         VkShaderModule simulation_shader,
+                         VkShaderModule vert_shader,
+                         VkShaderModule frag_shader);
+
+    // Record the simulation of one frame, outside of a render pass. The
+    // number of particles alive afterwards is copied to the readback slot
+    // of the frame slot.
+    void RecordSimulation(VkCommandBuffer command_buffer, uint32_t frame_slot,
+                          float delta_time);
+
+    // Record the draw of the particles of the last simulation, inside the
+    // render pass. Nothing is drawn before the first simulation.
+    void RecordDraw(VkCommandBuffer command_buffer, VkExtent2D extent) const;
+
+    // Particles alive after the last simulation of the frame slot, valid
+    // once the fence of the frame slot was signaled
+    uint32_t GetAliveCount(uint32_t frame_slot) const {
+        return readback_counts[frame_slot];
+    }
+
+    uint32_t GetCapacity() const { return capacity; }
+
+    // Name the buffers and pipelines for capture tools
+    void SetDebugNames(const DebugUtils& debug_utils) const;
+
+   private:
+    struct ParticleBuffer {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+    };
+
+    VkDevice device;
+    MemoryAllocator& memory_allocator;
+    uint32_t capacity;
+
+    // Draw command at offset 0, the particles at PARTICLE_DATA_OFFSET
+    std::array<ParticleBuffer, 2> particle_buffers{};
+    uint32_t target_buffer = 0;
+    bool simulated = false;
+
+    // Fractional particles to emit, carried over to the next frame
+    float emit_remainder = 0.0F;
+    uint32_t seed = 0;
+
+    // Persistently mapped particle counts, one per frame slot
+    VkBuffer readback_buffer = VK_NULL_HANDLE;
+    VkDeviceMemory readback_memory = VK_NULL_HANDLE;
+    uint32_t* readback_counts = nullptr;
+
+    VkDescriptorSetLayout simulation_set_layout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout draw_set_layout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
+
+    // Index is the target buffer of the simulation, or the buffer drawn
+    std::array<VkDescriptorSet, 2> simulation_sets{};
+    std::array<VkDescriptorSet, 2> draw_sets{};
+
+    VkPipelineLayout simulation_layout = VK_NULL_HANDLE;
+    VkPipeline simulation_pipeline = VK_NULL_HANDLE;
+    VkPipelineLayout draw_layout = VK_NULL_HANDLE;
+    VkPipeline draw_pipeline = VK_NULL_HANDLE;
+
+    void CreateDescriptorSets();
+    void CreateDrawPipeline(VkRenderPass render_pass, uint32_t subpass,
+                            VkSampleCountFlagBits samples,
+                            VkPipelineCache cache, VkShaderModule vert_shader,
+                            VkShaderModule frag_shader);
+};
+
+#endif  // PARTICLE_SYSTEM_H
@@ -0,0 +1,582 @@
+/* Local header files */
+#include "performance_hud.hpp"
+
+#include "application_options.hpp"
+
+/* Standard libraries */
+#include <algorithm>  // Required for std::min
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+/* Linux libraries */
+#include <unistd.h>
+
+namespace {
+
+/* 5x7 bitmap font, ASCII 32 to 95. Each glyph is 7 rows from the top, the
+leftmost pixel of a row is bit 4. */
+const std::array<std::array<uint8_t, HUD_GLYPH_HEIGHT>, HUD_GLYPH_COUNT>
+    HUD_FONT = {{
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // Space
+        {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04},  // !
+        {0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00},  // "
+        {0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A},  // #
+        {0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04},  // $
+        {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03},  // %
+        {0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D},  // &
+        {0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00},  // '
+        {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02},  // (
+        {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08},  // )
+        {0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00},  // *
+        {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00},  // +
+        {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08},  // ,
+        {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00},  // -
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C},  // .
+        {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00},  // /
+        {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E},  // 0
+        {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E},  // 1
+        {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F},  // 2
+        {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E},  // 3
+        {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02},  // 4
+        {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E},  // 5
+        {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E},  // 6
+        {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08},  // 7
+        {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E},  // 8
+        {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C},  // 9
+        {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00},  // :
+        {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08},  // ;
+        {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02},  // <
+        {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00},  // =
+        {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08},  // >
+        {0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04},  // ?
+        {0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E},  // @
+        {0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11},  // A
+        {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E},  // B
+        {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E},  // C
+        {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C},  // D
+        {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F},  // E
+        {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10},  // F
+        {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F},  // G
+        {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11},  // H
+        {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E},  // I
+        {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C},  // J
+        {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11},  // K
+        {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F},  // L
+        {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11},  // M
+        {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11},  // N
+        {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E},  // O
+        {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10},  // P
+        {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D},  // Q
+        {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11},  // R
+        {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E},  // S
+        {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04},  // T
+        {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E},  // U
+        {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04},  // V
+        {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A},  // W
+        {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11},  // X
+        {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04},  // Y
+        {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F},  // Z
+        {0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E},  // [
+        {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00},  // Backslash
+        {0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E},  // ]
+        {0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00},  // ^
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F},  // _
+    }};
+
+// The 35 bits of a glyph in two words, bit row * 5 + column
+const VkDeviceSize HUD_FONT_BYTES = HUD_GLYPH_COUNT * 2 * sizeof(uint32_t);
+
+// Layout in pixels, a font pixel is HUD_SCALE pixels on screen
+const float HUD_SCALE = 2.0F;
+const float HUD_ADVANCE = (HUD_GLYPH_WIDTH + 1) * HUD_SCALE;
+const float HUD_LINE_HEIGHT = (HUD_GLYPH_HEIGHT + 2) * HUD_SCALE;
+const float HUD_MARGIN = 8.0F;
+const float HUD_PADDING = 8.0F;
+const float HUD_BAR_ADVANCE = 3.0F;
+const float HUD_BAR_WIDTH = 2.0F;
+const float HUD_GRAPH_HEIGHT = 60.0F;
+const uint32_t HUD_TEXT_LINES = 4;
+
+// The text is formatted again after this interval
+const std::chrono::milliseconds HUD_REFRESH_INTERVAL(500);
+
+// Frame time of 60 frames per second, marked by a line in the graph
+const float HUD_TARGET_MS = 16.7F;
+
+// RGBA8 colors, red in the lowest byte
+const uint32_t HUD_TEXT_COLOR = 0xFFFFFFFF;
+const uint32_t HUD_PANEL_COLOR = 0xB0000000;
+const uint32_t HUD_LINE_COLOR = 0x80FFFFFF;
+const uint32_t HUD_FAST_COLOR = 0xFF40FF40;
+const uint32_t HUD_SLOW_COLOR = 0xFF40E0FF;
+const uint32_t HUD_DROPPED_COLOR = 0xFF4040FF;
+
+// Resident memory of the process in MiB, 0 if it can not be read
+double ReadResidentMegabytes() {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size_pages = 0;
+    uint64_t resident_pages = 0;
+
+    if (!(statm >> size_pages >> resident_pages)) {
+        return 0.0;
+    }
+
+    return static_cast<double>(resident_pages) *
+           static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+}
+
+}  // namespace
+
+PerformanceHud::PerformanceHud(VkDevice device,
+                               MemoryAllocator& memory_allocator,
+                               uint32_t frame_slot_count)
+    : device(device),
+      memory_allocator(memory_allocator),
+      instance_counts(frame_slot_count, 0) {
+    CreateBuffer(frame_slot_count);
+    CreateDescriptorSet();
+}
+
+void PerformanceHud::Destroy() {
+    vkDestroyPipeline(device, pipeline, nullptr);
+    vkDestroyPipelineLayout(device, pipeline_layout, nullptr);
+
+    // Destroying the pool frees the font set
+    vkDestroyDescriptorPool(device, descriptor_pool, nullptr);
+    vkDestroyDescriptorSetLayout(device, set_layout, nullptr);
+
+    vkDestroyBuffer(device, buffer, nullptr);
+    memory_allocator.Free(buffer_memory);
+    buffer = VK_NULL_HANDLE;
+    buffer_memory = VK_NULL_HANDLE;
+    mapped = nullptr;
+}
+
+void PerformanceHud::CreatePipeline(VkRenderPass render_pass,
+                                    uint32_t subpass,
+                                    VkSampleCountFlagBits samples,
+                                    VkPipelineCache cache,
+                                    VkShaderModule vert_shader,
+                                    VkShaderModule frag_shader) {
+    VkPushConstantRange push_constant_range{};
+    push_constant_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    push_constant_range.offset = 0;
+    push_constant_range.size = 2 * sizeof(float);
+
+    VkPipelineLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_info.setLayoutCount = 1;
+    layout_info.pSetLayouts = &set_layout;
+    layout_info.pushConstantRangeCount = 1;
+    layout_info.pPushConstantRanges = &push_constant_range;
+
+    if (vkCreatePipelineLayout(device, &layout_info, nullptr,
+                               &pipeline_layout) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreatePipelineLayout Error: failed to create overlay pipeline "
+            "layout!");
+    }
+
+    std::array<VkPipelineShaderStageCreateInfo, 2> shader_stages{};
+    shader_stages[0].sType =
+        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shader_stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shader_stages[0].module = vert_shader;
+    shader_stages[0].pName = "main";
+    shader_stages[1].sType =
+        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shader_stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shader_stages[1].module = frag_shader;
+    shader_stages[1].pName = "main";
+
+    // One HudInstance per quad, the corners come from the vertex index
+    VkVertexInputBindingDescription binding_description{};
+    binding_description.binding = 0;
+    binding_description.stride = sizeof(HudInstance);
+    binding_description.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+    std::array<VkVertexInputAttributeDescription, 4> attribute_descriptions{};
+    attribute_descriptions[0] = {0, 0, VK_FORMAT_R32G32_SFLOAT,
+                                 offsetof(HudInstance, position)};
+    attribute_descriptions[1] = {1, 0, VK_FORMAT_R32G32_SFLOAT,
+                                 offsetof(HudInstance, size)};
+    attribute_descriptions[2] = {2, 0, VK_FORMAT_R32_UINT,
+                                 offsetof(HudInstance, glyph)};
+    attribute_descriptions[3] = {3, 0, VK_FORMAT_R8G8B8A8_UNORM,
+                                 offsetof(HudInstance, color)};
+
+    VkPipelineVertexInputStateCreateInfo vertex_input_info{};
+    vertex_input_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertex_input_info.vertexBindingDescriptionCount = 1;
+    vertex_input_info.pVertexBindingDescriptions = &binding_description;
+    vertex_input_info.vertexAttributeDescriptionCount =
+        static_cast<uint32_t>(attribute_descriptions.size());
+    vertex_input_info.pVertexAttributeDescriptions =
+        attribute_descriptions.data();
+
+    VkPipelineInputAssemblyStateCreateInfo input_assembly{};
+    input_assembly.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkPipelineViewportStateCreateInfo viewport_state{};
+    viewport_state.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewport_state.viewportCount = 1;
+    viewport_state.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0F;
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = samples;
+    multisampling.minSampleShading = 1.0F;
+
+    // The overlay is drawn over everything
+    VkPipelineDepthStencilStateCreateInfo depth_stencil{};
+    depth_stencil.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depth_stencil.depthTestEnable = VK_FALSE;
+    depth_stencil.depthWriteEnable = VK_FALSE;
+
+    // The panel is translucent
+    VkPipelineColorBlendAttachmentState color_blend_attachment{};
+    color_blend_attachment.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    color_blend_attachment.blendEnable = VK_TRUE;
+    color_blend_attachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    color_blend_attachment.dstColorBlendFactor =
+        VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    color_blend_attachment.colorBlendOp = VK_BLEND_OP_ADD;
+    color_blend_attachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    color_blend_attachment.dstAlphaBlendFactor =
+        VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    color_blend_attachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo color_blending{};
+    color_blending.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    color_blending.attachmentCount = 1;
+    color_blending.pAttachments = &color_blend_attachment;
+
+    std::array<VkDynamicState, 2> dynamic_states = {VK_DYNAMIC_STATE_VIEWPORT,
+                                                    VK_DYNAMIC_STATE_SCISSOR};
+
+    VkPipelineDynamicStateCreateInfo dynamic_state{};
+    dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamic_state.dynamicStateCount =
+        static_cast<uint32_t>(dynamic_states.size());
+    dynamic_state.pDynamicStates = dynamic_states.data();
+
+    VkGraphicsPipelineCreateInfo pipeline_info{};
+    pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipeline_info.stageCount = static_cast<uint32_t>(shader_stages.size());
+    pipeline_info.pStages = shader_stages.data();
+    pipeline_info.pVertexInputState = &vertex_input_info;
+    pipeline_info.pInputAssemblyState = &input_assembly;
+    pipeline_info.pViewportState = &viewport_state;
+    pipeline_info.pRasterizationState = &rasterizer;
+    pipeline_info.pMultisampleState = &multisampling;
+    pipeline_info.pDepthStencilState = &depth_stencil;
+    pipeline_info.pColorBlendState = &color_blending;
+    pipeline_info.pDynamicState = &dynamic_state;
+    pipeline_info.layout = pipeline_layout;
+    pipeline_info.renderPass = render_pass;
+    pipeline_info.subpass = subpass;
+
+    if (vkCreateGraphicsPipelines(device, cache, 1, &pipeline_info, nullptr,
+                                  &pipeline) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateGraphicsPipelines Error: failed to create overlay "
+            "pipeline!");
+    }
+}
+
+void PerformanceHud::Update(const HudFrameStats& stats, uint32_t frame_slot) {
+    graph_ms[graph_head] = static_cast<float>(stats.frame_ms);
+    graph_head = (graph_head + 1) % HUD_GRAPH_FRAMES;
+
+    frame_ms_sum += stats.frame_ms;
+    cpu_ms_sum += stats.cpu_ms;
+    frame_sum_count++;
+    if (stats.gpu_ms >= 0.0) {
+        gpu_ms_sum += stats.gpu_ms;
+        gpu_sum_count++;
+    }
+
+    // Formatting the text is the expensive part, it is only done when the
+    // numbers are readable anyway
+    auto now = Clock::now();
+    if (text_instances.empty() || now - refresh_time >= HUD_REFRESH_INTERVAL) {
+        FormatText(stats);
+        refresh_time = now;
+        frame_ms_sum = 0.0;
+        cpu_ms_sum = 0.0;
+        gpu_ms_sum = 0.0;
+        frame_sum_count = 0;
+        gpu_sum_count = 0;
+    }
+
+    /* Quads of the frame: the panel and the text, then the graph from the
+    oldest frame on the left to the newest */
+    auto* instances = reinterpret_cast<HudInstance*>(
+        mapped + HUD_FONT_BYTES +
+        frame_slot * HUD_MAX_INSTANCES * sizeof(HudInstance));
+
+    std::memcpy(instances, text_instances.data(),
+                text_instances.size() * sizeof(HudInstance));
+    auto count = static_cast<uint32_t>(text_instances.size());
+
+    float graph_x = HUD_MARGIN + HUD_PADDING;
+    float graph_y = HUD_MARGIN + HUD_PADDING +
+                    HUD_TEXT_LINES * HUD_LINE_HEIGHT + HUD_SCALE;
+    float graph_bottom = graph_y + HUD_GRAPH_HEIGHT;
+
+    for (uint32_t i = 0; i < HUD_GRAPH_FRAMES; i++) {
+        float frame_ms = graph_ms[(graph_head + i) % HUD_GRAPH_FRAMES];
+        float height =
+            std::min(frame_ms / HUD_GRAPH_MAX_MS, 1.0F) * HUD_GRAPH_HEIGHT;
+
+        uint32_t color = HUD_DROPPED_COLOR;
+        if (frame_ms <= HUD_TARGET_MS) {
+            color = HUD_FAST_COLOR;
+        } else if (frame_ms <= HUD_GRAPH_MAX_MS) {
+            color = HUD_SLOW_COLOR;
+        }
+
+        instances[count++] = {{graph_x + i * HUD_BAR_ADVANCE,
+                               graph_bottom - height},
+                              {HUD_BAR_WIDTH, height},
+                              HUD_SOLID_GLYPH,
+                              color};
+    }
+
+    instances[count++] = {
+        {graph_x,
+         graph_bottom - HUD_TARGET_MS / HUD_GRAPH_MAX_MS * HUD_GRAPH_HEIGHT},
+        {HUD_GRAPH_FRAMES * HUD_BAR_ADVANCE, 1.0F},
+        HUD_SOLID_GLYPH,
+        HUD_LINE_COLOR};
+
+    instance_counts[frame_slot] = count;
+}
+
+void PerformanceHud::RecordDraw(VkCommandBuffer command_buffer,
+                                uint32_t frame_slot, VkExtent2D extent) const {
+    // Pixels to clip space
+    std::array<float, 2> scale = {2.0F / static_cast<float>(extent.width),
+                                  2.0F / static_cast<float>(extent.height)};
+    VkDeviceSize offset = HUD_FONT_BYTES + frame_slot * HUD_MAX_INSTANCES *
+                                               sizeof(HudInstance);
+
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                      pipeline);
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            pipeline_layout, 0, 1, &font_set, 0, nullptr);
+    vkCmdBindVertexBuffers(command_buffer, 0, 1, &buffer, &offset);
+    vkCmdPushConstants(command_buffer, pipeline_layout,
+                       VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(scale),
+                       scale.data());
+    vkCmdDraw(command_buffer, 6, instance_counts[frame_slot], 0, 0);
+}
+
+void PerformanceHud::SetDebugNames(const DebugUtils& debug_utils) const {
+    debug_utils.SetObjectName(buffer, VK_OBJECT_TYPE_BUFFER,
+                              "Overlay font and quads");
+    debug_utils.SetObjectName(pipeline, VK_OBJECT_TYPE_PIPELINE, "Overlay");
+}
+
+void PerformanceHud::FormatText(const HudFrameStats& stats) {
+    double frames = frame_sum_count > 0 ? frame_sum_count : 1.0;
+    double frame_ms = frame_sum_count > 0 ? frame_ms_sum / frames
+                                          : stats.frame_ms;
+    double cpu_ms = frame_sum_count > 0 ? cpu_ms_sum / frames : stats.cpu_ms;
+
+    std::array<std::array<char, 64>, HUD_TEXT_LINES> lines{};
+    std::snprintf(lines[0].data(), lines[0].size(), "FPS %.1f  FRAME %.2f MS",
+                  frame_ms > 0.0 ? 1000.0 / frame_ms : 0.0, frame_ms);
+
+    if (gpu_sum_count > 0) {
+        std::snprintf(lines[1].data(), lines[1].size(),
+                      "CPU %.2f MS  GPU %.2f MS", cpu_ms,
+                      gpu_ms_sum / gpu_sum_count);
+    } else {
+        std::snprintf(lines[1].data(), lines[1].size(),
+                      "CPU %.2f MS  GPU -", cpu_ms);
+    }
+
+    std::snprintf(lines[2].data(), lines[2].size(), "MEM %.0f MIB  %s %ux%u",
+                  ReadResidentMegabytes(),
+                  PresentModeName(stats.present_mode).c_str(),
+                  stats.extent.width, stats.extent.height);
+
+    if (stats.device_budget > 0) {
+        std::snprintf(lines[3].data(), lines[3].size(),
+                      "VRAM %.0f OF %.0f MIB",
+                      static_cast<double>(stats.device_usage) / 1048576.0,
+                      static_cast<double>(stats.device_budget) / 1048576.0);
+    } else {
+        std::snprintf(lines[3].data(), lines[3].size(), "VRAM -");
+    }
+
+    // The panel is the first quad, sized once the text is known
+    text_instances.clear();
+    text_instances.push_back({});
+
+    size_t longest_line = 0;
+    float y = HUD_MARGIN + HUD_PADDING;
+    for (const auto& line : lines) {
+        AddText(line.data(), HUD_MARGIN + HUD_PADDING, y, HUD_TEXT_COLOR);
+        longest_line = std::max(longest_line, std::strlen(line.data()));
+        y += HUD_LINE_HEIGHT;
+    }
+
+    float width = std::max(longest_line * HUD_ADVANCE,
+                           HUD_GRAPH_FRAMES * HUD_BAR_ADVANCE);
+    float height =
+        HUD_TEXT_LINES * HUD_LINE_HEIGHT + HUD_SCALE + HUD_GRAPH_HEIGHT;
+    text_instances[0] = {{HUD_MARGIN, HUD_MARGIN},
+                         {width + 2 * HUD_PADDING, height + 2 * HUD_PADDING},
+                         HUD_SOLID_GLYPH,
+                         HUD_PANEL_COLOR};
+}
+
+void PerformanceHud::AddText(const char* text, float x, float y,
+                             uint32_t color) {
+    // The graph always fits, long text is cut off
+    size_t text_limit = HUD_MAX_INSTANCES - HUD_GRAPH_FRAMES - 1;
+
+    for (const char* c = text; *c != '\0'; c++, x += HUD_ADVANCE) {
+        auto character = static_cast<uint32_t>(static_cast<uint8_t>(*c));
+        if (character >= 'a' && character <= 'z') {
+            character -= 'a' - 'A';
+        }
+        if (character < HUD_FIRST_GLYPH ||
+            character >= HUD_FIRST_GLYPH + HUD_GLYPH_COUNT) {
+            character = '?';
+        }
+
+        // Spaces only advance
+        if (character == ' ' || text_instances.size() >= text_limit) {
+            continue;
+        }
+
+        text_instances.push_back({{x, y},
+                                  {HUD_GLYPH_WIDTH * HUD_SCALE,
+                                   HUD_GLYPH_HEIGHT * HUD_SCALE},
+                                  character - HUD_FIRST_GLYPH,
+                                  color});
+    }
+}
+
+void PerformanceHud::CreateBuffer(uint32_t frame_slot_count) {
+    /* The quads are written by the CPU every frame and read once by the GPU,
+    host visible memory avoids a copy */
+    VkDeviceSize size = HUD_FONT_BYTES + frame_slot_count * HUD_MAX_INSTANCES *
+                                             sizeof(HudInstance);
+
+    memory_allocator.CreateBuffer(
+        size,
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        buffer, buffer_memory, "overlay");
+
+    void* data = nullptr;
+    if (vkMapMemory(device, buffer_memory, 0, size, 0, &data) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkMapMemory Error: failed to map overlay memory!");
+    }
+    mapped = static_cast<uint8_t*>(data);
+
+    /* Font atlas, the pixels of a glyph packed into two words */
+    auto* font = reinterpret_cast<uint32_t*>(mapped);
+    std::memset(font, 0, HUD_FONT_BYTES);
+
+    for (uint32_t glyph = 0; glyph < HUD_GLYPH_COUNT; glyph++) {
+        for (uint32_t row = 0; row < HUD_GLYPH_HEIGHT; row++) {
+            for (uint32_t column = 0; column < HUD_GLYPH_WIDTH; column++) {
+                uint32_t shift = HUD_GLYPH_WIDTH - 1 - column;
+                if (((HUD_FONT[glyph][row] >> shift) & 1U) == 0) {
+                    continue;
+                }
+
+                uint32_t bit = row * HUD_GLYPH_WIDTH + column;
+                font[glyph * 2 + bit / 32] |= 1U << (bit % 32);
+            }
+        }
+    }
+}
+
+void PerformanceHud::CreateDescriptorSet() {
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_info.bindingCount = 1;
+    layout_info.pBindings = &binding;
+
+    if (vkCreateDescriptorSetLayout(device, &layout_info, nullptr,
+                                    &set_layout) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateDescriptorSetLayout Error: failed to create overlay set "
+            "layout!");
+    }
+
+    VkDescriptorPoolSize pool_size{};
+    pool_size.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pool_size.descriptorCount = 1;
+
+    VkDescriptorPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.maxSets = 1;
+    pool_info.poolSizeCount = 1;
+    pool_info.pPoolSizes = &pool_size;
+
+    if (vkCreateDescriptorPool(device, &pool_info, nullptr,
+                               &descriptor_pool) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateDescriptorPool Error: failed to create overlay "
+            "descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.descriptorPool = descriptor_pool;
+    alloc_info.descriptorSetCount = 1;
+    alloc_info.pSetLayouts = &set_layout;
+
+    if (vkAllocateDescriptorSets(device, &alloc_info, &font_set) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkAllocateDescriptorSets Error: failed to allocate overlay "
+            "descriptor set!");
+    }
+
+    VkDescriptorBufferInfo buffer_info{buffer, 0, HUD_FONT_BYTES};
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = font_set;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &buffer_info;
+
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
@@ -0,0 +1,139 @@
+#ifndef PERFORMANCE_HUD_H
+#define PERFORMANCE_HUD_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Local header files */
+#include "debug_utils.hpp"
+#include "memory_allocator.hpp"
+
+/* Standard libraries */
+#include <array>
+#include <chrono>
+#include <cstdint>  // Required for uint32_t
+#include <vector>
+
+// Frames shown by the frame time graph, one bar per frame
+const uint32_t HUD_GRAPH_FRAMES = 120;
+
+// Frame time at the top of the graph in milliseconds, two 60 Hz intervals
+const float HUD_GRAPH_MAX_MS = 33.3F;
+
+// Most quads drawn per frame: the panel, the glyphs and the graph
+const uint32_t HUD_MAX_INSTANCES = 512;
+
+// Glyphs of the bitmap font, ASCII 32 (space) to 95 (underscore). Lower case
+// letters are drawn with the upper case glyphs.
+const uint32_t HUD_FIRST_GLYPH = 32;
+const uint32_t HUD_GLYPH_COUNT = 64;
+const uint32_t HUD_GLYPH_WIDTH = 5;
+const uint32_t HUD_GLYPH_HEIGHT = 7;
+
+// Glyph index of a solid quad, used for the panel and the graph bars
+const uint32_t HUD_SOLID_GLYPH = 0xFFFFFFFF;
+
+// Quad of the overlay, one instance of the draw. The layout matches the
+// vertex input of shaders/hud.vert.
+struct HudInstance {
+    std::array<float, 2> position;  // Top left corner in pixels
+    std::array<float, 2> size;      // In pixels
+    uint32_t glyph;                 // Index into the font, or HUD_SOLID_GLYPH
+    uint32_t color;                 // RGBA8, red in the lowest byte
+};
+static_assert(sizeof(HudInstance) == 24, "HudInstance must be 24 bytes");
+
+// Measurements of one frame shown by the overlay
+struct HudFrameStats {
+    double frame_ms = 0.0;  // Time since the start of the previous frame
+    double cpu_ms = 0.0;    // CPU time of the previous frame
+    double gpu_ms = -1.0;   // GPU time of the frame, negative if unknown
+    VkPresentModeKHR present_mode = VK_PRESENT_MODE_FIFO_KHR;
+    VkExtent2D extent{};
+
+    // Device local memory of the process, unknown without a budget
+    VkDeviceSize device_usage = 0;
+    VkDeviceSize device_budget = 0;
+};
+
+/* Performance overlay drawn over the scene
+
+Shows the frame rate, the CPU and GPU time of a frame, the resident memory
+of the process, the present mode and a graph of the recent frame times. The
+text is formatted twice a second from the averages since the last refresh,
+the graph is updated every frame.
+
+Every glyph, the panel and the graph bars are quads of one instanced draw.
+The quads of a frame are written to a persistently mapped buffer of the frame
+slot. The 1 bit font atlas is in the same buffer, its bits are tested in the
+fragment shader, so the overlay needs no image, sampler or upload.
+*/
+class PerformanceHud {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    PerformanceHud(VkDevice device, MemoryAllocator& memory_allocator,
+                   uint32_t frame_slot_count);
+
+    // Destroy the buffer and the pipeline, the device must be idle
+    void Destroy();
+
+    // The pipeline is created for the given subpass of the render pass
+    void CreatePipeline(VkRenderPass render_pass, uint32_t subpass,
+                        VkSampleCountFlagBits samples, VkPipelineCache cache,
+                        VkShaderModule vert_shader,
+                        VkShaderModule frag_shader);
+
+    // Add the measurements of a frame and write the quads of the frame slot,
+    // the slot must not be in use by the GPU anymore
+    void Update(const HudFrameStats& stats, uint32_t frame_slot);
+
+    // Record the draw of the quads of the frame slot, inside the render pass
+    void RecordDraw(VkCommandBuffer command_buffer, uint32_t frame_slot,
+                    VkExtent2D extent) const;
+
+    uint32_t GetInstanceCount(uint32_t frame_slot) const {
+        return instance_counts[frame_slot];
+    }
+
+    // Name the buffer and the pipeline for capture tools
+    void SetDebugNames(const DebugUtils& debug_utils) const;
+
+   private:
+    VkDevice device;
+    MemoryAllocator& memory_allocator;
+
+    // The font at offset 0, then HUD_MAX_INSTANCES quads per frame slot
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory buffer_memory = VK_NULL_HANDLE;
+    uint8_t* mapped = nullptr;
+    std::vector<uint32_t> instance_counts;
+
+    VkDescriptorSetLayout set_layout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
+    VkDescriptorSet font_set = VK_NULL_HANDLE;
+    VkPipelineLayout pipeline_layout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+
+    // Frame times of the graph, a ring starting at graph_head
+    std::array<float, HUD_GRAPH_FRAMES> graph_ms{};
+    uint32_t graph_head = 0;
+
+    // Sums since the text was last formatted
+    Clock::time_point refresh_time;
+    double frame_ms_sum = 0.0;
+    double cpu_ms_sum = 0.0;
+    double gpu_ms_sum = 0.0;
+    uint32_t frame_sum_count = 0;
+    uint32_t gpu_sum_count = 0;
+
+    // Panel and glyphs of the formatted text, copied every frame
+    std::vector<HudInstance> text_instances;
+
+    void CreateBuffer(uint32_t frame_slot_count);
+    void CreateDescriptorSet();
+    void FormatText(const HudFrameStats& stats);
+    void AddText(const char* text, float x, float y, uint32_t color);
+};
+
+#endif  // PERFORMANCE_HUD_H
@@ -0,0 +1,133 @@
+/* Local header files */
+#include "pipeline_compiler.hpp"
+
+PipelineCompiler::PipelineCompiler(VkDevice device, size_t thread_count)
+    : device(device), thread_pool(thread_count) {}
+
+void PipelineCompiler::Destroy() {
+    for (auto& compilation : compilations) {
+        if (compilation.state == State::COMPILING) {
+            // A failed compilation has nothing to destroy
+            try {
+                compilation.pipeline = compilation.result.get();
+            } catch (const std::exception&) {
+                compilation.pipeline = VK_NULL_HANDLE;
+            }
+            compilation.state = State::PUBLISHED;
+        }
+
+        vkDestroyPipeline(device, compilation.pipeline, nullptr);
+        compilation.pipeline = VK_NULL_HANDLE;
+    }
+
+    pending_count = 0;
+}
+
+PipelineCompiler::Handle PipelineCompiler::Request(const std::string& name,
+                                                   CompileFunction compile,
+                                                   VkPipeline fallback) {
+    Compilation compilation;
+    compilation.name = name;
+    compilation.fallback = fallback;
+    compilation.request_frame = frame_count;
+    compilation.compile_ms = std::make_shared<double>(0.0);
+
+    // The worker only writes the compile time, it is read after the future
+    // is ready
+    std::shared_ptr<double> compile_ms = compilation.compile_ms;
+    compilation.result =
+        thread_pool.Submit([compile = std::move(compile), compile_ms]() {
+            auto start = Clock::now();
+            VkPipeline pipeline = compile();
+            *compile_ms = std::chrono::duration<double, std::milli>(
+                              Clock::now() - start)
+                              .count();
+            return pipeline;
+        });
+
+    auto handle = static_cast<Handle>(compilations.size());
+    compilations.push_back(std::move(compilation));
+    pending_count++;
+
+    return handle;
+}
+
+uint32_t PipelineCompiler::PublishReady() {
+    frame_count++;
+
+    if (pending_count == 0) {
+        return 0;
+    }
+
+    uint32_t published = 0;
+    for (auto& compilation : compilations) {
+        if (compilation.state == State::COMPILING &&
+            compilation.result.wait_for(std::chrono::seconds(0)) ==
+                std::future_status::ready) {
+            Publish(compilation);
+            published++;
+        }
+    }
+
+    return published;
+}
+
+void PipelineCompiler::Wait(Handle handle) {
+    Compilation& compilation = compilations[handle];
+    if (compilation.state == State::COMPILING) {
+        compilation.result.wait();
+        Publish(compilation);
+    }
+}
+
+void PipelineCompiler::WaitAll() {
+    for (auto& compilation : compilations) {
+        if (compilation.state == State::COMPILING) {
+            compilation.result.wait();
+            Publish(compilation);
+        }
+    }
+}
+
+void PipelineCompiler::Discard(Handle handle) {
+    Wait(handle);
+
+    Compilation& compilation = compilations[handle];
+    vkDestroyPipeline(device, compilation.pipeline, nullptr);
+    compilation.pipeline = VK_NULL_HANDLE;
+    compilation.state = State::DISCARDED;
+}
+
+void PipelineCompiler::Publish(Compilation& compilation) {
+    // Rethrows the exception of a failed compilation
+    compilation.pipeline = compilation.result.get();
+    compilation.state = State::PUBLISHED;
+    compilation.publish_frame = frame_count;
+    pending_count--;
+}
+
+void PipelineCompiler::Report(std::ostream& out) const {
+    out << "Pipeline compiler: " << compilations.size() << " pipelines, "
+        << pending_count << " still compiling" << std::endl;
+
+    for (const auto& compilation : compilations) {
+        out << "  " << compilation.name << ": ";
+
+        if (compilation.state != State::COMPILING) {
+            out << "compiled in " << *compilation.compile_ms
+                << " ms, published after "
+                << compilation.publish_frame - compilation.request_frame
+                << " frames";
+            if (compilation.state == State::DISCARDED) {
+                out << ", discarded";
+            }
+        } else {
+            out << "compiling";
+        }
+
+        out << (compilation.fallback != VK_NULL_HANDLE
+                    ? ", drawn with the fallback before"
+                    : ", skipped before")
+            << std::endl;
+    }
+}
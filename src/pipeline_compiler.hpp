@@ -0,0 +1,132 @@
+#ifndef PIPELINE_COMPILER_H
+#define PIPELINE_COMPILER_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Local header files */
+#include "thread_pool.hpp"
+
+/* Standard libraries */
+#include <chrono>
+#include <cstdint>  // Required for uint32_t
+#include <functional>
+#include <future>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Worker threads of the compiler. Drivers compile a pipeline on the calling
+// thread, two workers take the compilations off the render thread without
+// competing with the loading threads for every core.
+const size_t PIPELINE_COMPILER_THREADS = 2;
+
+/* Compiles pipelines on worker threads without stalling frames
+
+A new material or state combination needs a pipeline, and creating it inline
+hitches the frame by the compile time of the driver. Request queues the
+compilation on the workers of a ThreadPool and returns a handle. Until the
+pipeline is published, Get returns the fallback given with the request: a
+pipeline that draws something acceptable, or VK_NULL_HANDLE to skip the
+draw.
+
+Finished compilations only become visible in PublishReady, which the
+renderer calls at the start of a frame. So the pipelines that a frame binds
+do not change while it is recorded. A compilation that failed rethrows its
+exception from PublishReady or Wait on the calling thread.
+
+The compile functions run on the workers, everything they read must stay
+unchanged until they are done. vkCreateGraphicsPipelines and a pipeline
+cache without VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT may be
+used from several threads at once. The compiler owns the compiled pipelines,
+the fallbacks stay owned by the caller.
+*/
+class PipelineCompiler {
+   public:
+    using Clock = std::chrono::steady_clock;
+    using Handle = uint32_t;
+    using CompileFunction = std::function<VkPipeline()>;
+
+    PipelineCompiler(VkDevice device,
+                     size_t thread_count = PIPELINE_COMPILER_THREADS);
+
+    // Wait for the running compilations and destroy the compiled pipelines,
+    // the device must be idle
+    void Destroy();
+
+    // Queue a compilation, the name is used in the report
+    Handle Request(const std::string& name, CompileFunction compile,
+                   VkPipeline fallback);
+
+    // Publish the pipelines whose compilation finished since the last call,
+    // called once per frame before recording. Returns the number published.
+    uint32_t PublishReady();
+
+    // Block until the compilation is done and publish it, e.g. behind a
+    // loading screen
+    void Wait(Handle handle);
+
+    // Block until every compilation is done and publish them, before
+    // anything the compile functions read is destroyed
+    void WaitAll();
+
+    // Wait for the compilation and destroy its pipeline, e.g. when the
+    // render pass it was compiled for is recreated. Get returns
+    // VK_NULL_HANDLE afterwards. The device must no longer use the pipeline.
+    void Discard(Handle handle);
+
+    bool IsReady(Handle handle) const {
+        return compilations[handle].state == State::PUBLISHED;
+    }
+
+    // The published pipeline, or the fallback while it compiles
+    VkPipeline Get(Handle handle) const {
+        const auto& compilation = compilations[handle];
+        switch (compilation.state) {
+            case State::COMPILING:
+                return compilation.fallback;
+            case State::PUBLISHED:
+                return compilation.pipeline;
+            case State::DISCARDED:
+                break;
+        }
+        return VK_NULL_HANDLE;
+    }
+
+    size_t GetPendingCount() const { return pending_count; }
+    size_t GetRequestCount() const { return compilations.size(); }
+
+    // Print the compile time of every pipeline and the frames until it was
+    // published
+    void Report(std::ostream& out) const;
+
+   private:
+    enum class State { COMPILING, PUBLISHED, DISCARDED };
+
+    struct Compilation {
+        std::string name;
+        State state = State::COMPILING;
+        std::future<VkPipeline> result;
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkPipeline fallback = VK_NULL_HANDLE;
+
+        // Measured on the worker from the start of the compilation
+        std::shared_ptr<double> compile_ms;
+        uint64_t request_frame = 0;
+        uint64_t publish_frame = 0;
+    };
+
+    VkDevice device;
+    std::vector<Compilation> compilations;
+    size_t pending_count = 0;
+    uint64_t frame_count = 0;
+
+    // Declared last, so the workers are joined before the compilations
+    // are destroyed
+    ThreadPool thread_pool;
+
+    void Publish(Compilation& compilation);
+};
+
+#endif  // PIPELINE_COMPILER_H
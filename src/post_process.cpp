@@ -0,0 +1,429 @@
+/* Local header files */
+#include "post_process.hpp"
+
+/* Standard libraries */
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+std::string PostStageName(PostStage stage) {
+    switch (stage) {
+        case PostStage::TONEMAP:
+            return "tonemap";
+        case PostStage::FXAA:
+            return "fxaa";
+        case PostStage::GRADE:
+            return "grade";
+    }
+    return "unknown";
+}
+
+PostStage ParsePostStage(const std::string& name) {
+    for (PostStage stage :
+         {PostStage::TONEMAP, PostStage::FXAA, PostStage::GRADE}) {
+        if (name == PostStageName(stage)) {
+            return stage;
+        }
+    }
+
+    throw std::invalid_argument("unknown post-processing stage: " + name);
+}
+
+std::string PostStageShaderFile(PostStage stage) {
+    return "shaders/post_" + PostStageName(stage) + "_comp.spv";
+}
+
+std::string PostStageOutputShaderFile(PostStage stage) {
+    return "shaders/post_" + PostStageName(stage) + "_output_comp.spv";
+}
+
+PostProcessChain::PostProcessChain(VkPhysicalDevice physical_device,
+                                   VkDevice device, uint32_t queue_family,
+                                   std::vector<PostStage> stages,
+                                   uint32_t frame_slot_count)
+    : device(device),
+      stages(std::move(stages)),
+      slot_recorded(frame_slot_count, false) {
+    if (this->stages.empty()) {
+        throw std::invalid_argument(
+            "the post-processing chain needs at least one stage");
+    }
+
+    // The GPU time of the output follows the stages
+    stage_ms_sums.assign(this->stages.size() + 1, 0.0);
+
+    /* Timestamps are only written on queues whose family has valid bits,
+    without them the stages are not timed */
+    uint32_t queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device,
+                                             &queue_family_count, nullptr);
+    std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(
+        physical_device, &queue_family_count, queue_families.data());
+
+    uint32_t valid_bits = queue_families[queue_family].timestampValidBits;
+    if (valid_bits == 0) {
+        return;
+    }
+
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(physical_device, &properties);
+    timestamp_period = properties.limits.timestampPeriod;
+    timestamp_mask =
+        valid_bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << valid_bits) - 1;
+
+    queries_per_slot = static_cast<uint32_t>(this->stages.size()) + 2;
+
+    VkQueryPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    pool_info.queryCount = queries_per_slot * frame_slot_count;
+
+    if (vkCreateQueryPool(device, &pool_info, nullptr, &query_pool) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateQueryPool Error: failed to create post-processing "
+            "query pool!");
+    }
+}
+
+void PostProcessChain::Destroy() {
+    for (VkPipeline pipeline : pipelines) {
+        vkDestroyPipeline(device, pipeline, nullptr);
+    }
+    pipelines.clear();
+    vkDestroyPipeline(device, output_pipeline, nullptr);
+    output_pipeline = VK_NULL_HANDLE;
+
+    // The set layout belongs to the layout cache
+    vkDestroyPipelineLayout(device, pipeline_layout, nullptr);
+    vkDestroyQueryPool(device, query_pool, nullptr);
+    pipeline_layout = VK_NULL_HANDLE;
+    query_pool = VK_NULL_HANDLE;
+}
+
+void PostProcessChain::CreatePipelines(
+    VkPipelineCache cache, DescriptorLayoutCache& layout_cache,
+    const std::vector<VkShaderModule>& shaders, VkShaderModule output_shader) {
+    /* Every stage reads the source image at binding 0 and writes the target
+    image at binding 1, so all stages share one pipeline layout */
+    std::vector<VkDescriptorSetLayoutBinding> bindings(2);
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    set_layout = layout_cache.Get(bindings);
+
+    VkPushConstantRange push_constant_range{};
+    push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    push_constant_range.offset = 0;
+    push_constant_range.size = sizeof(PostParameters);
+
+    VkPipelineLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_info.setLayoutCount = 1;
+    layout_info.pSetLayouts = &set_layout;
+    layout_info.pushConstantRangeCount = 1;
+    layout_info.pPushConstantRanges = &push_constant_range;
+
+    if (vkCreatePipelineLayout(device, &layout_info, nullptr,
+                               &pipeline_layout) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreatePipelineLayout Error: failed to create post-processing "
+            "layout!");
+    }
+
+    auto create_pipeline = [&](VkShaderModule shader) {
+        VkComputePipelineCreateInfo pipeline_info{};
+        pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipeline_info.stage.sType =
+            VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipeline_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipeline_info.stage.module = shader;
+        pipeline_info.stage.pName = "main";
+        pipeline_info.layout = pipeline_layout;
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        if (vkCreateComputePipelines(device, cache, 1, &pipeline_info, nullptr,
+                                     &pipeline) != VK_SUCCESS) {
+            throw std::runtime_error(
+                "vkCreateComputePipelines Error: failed to create "
+                "post-processing pipeline!");
+        }
+        return pipeline;
+    };
+
+    pipelines.reserve(stages.size());
+    for (size_t i = 0; i < stages.size(); i++) {
+        pipelines.push_back(create_pipeline(shaders[i]));
+    }
+
+    if (output_shader != VK_NULL_HANDLE) {
+        output_pipeline = create_pipeline(output_shader);
+    }
+}
+
+void PostProcessChain::Record(VkCommandBuffer command_buffer,
+                              uint32_t frame_slot, const PostTargets& targets,
+                              DescriptorAllocator& allocator) {
+    // The fence of the frame slot was signaled, its last timings are final
+    CollectTimings(frame_slot);
+
+    if (query_pool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(command_buffer, query_pool,
+                            frame_slot * queries_per_slot, queries_per_slot);
+        WriteTimestamp(command_buffer, frame_slot, 0);
+    }
+
+    bool storage_output = targets.output_view != VK_NULL_HANDLE;
+    if (storage_output && output_pipeline == VK_NULL_HANDLE) {
+        throw std::invalid_argument(
+            "the post-processing chain has no output pipeline for the output "
+            "view!");
+    }
+
+    /* The output image is written after the acquire semaphore was waited
+    for at the color attachment output stage, the barrier waits for that
+    stage so it chains onto the semaphore wait */
+    VkImageMemoryBarrier image_barrier{};
+    image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    image_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    image_barrier.subresourceRange.levelCount = 1;
+    image_barrier.subresourceRange.layerCount = 1;
+
+    image_barrier.image = targets.output_image;
+    image_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image_barrier.newLayout = storage_output
+                                  ? VK_IMAGE_LAYOUT_GENERAL
+                                  : VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    image_barrier.srcAccessMask = 0;
+    image_barrier.dstAccessMask = storage_output
+                                      ? VK_ACCESS_SHADER_WRITE_BIT
+                                      : VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(command_buffer,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         storage_output ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                                        : VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &image_barrier);
+
+    // The push constants stay set across the pipelines of the same layout
+    vkCmdPushConstants(command_buffer, pipeline_layout,
+                       VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(parameters),
+                       &parameters);
+
+    uint32_t group_count_x =
+        (targets.extent.width + POST_TILE_SIZE - 1) / POST_TILE_SIZE;
+    uint32_t group_count_y =
+        (targets.extent.height + POST_TILE_SIZE - 1) / POST_TILE_SIZE;
+
+    VkImage current_image = targets.scene_image;
+    VkImageView current_view = targets.scene_view;
+    VkImage other_image = targets.scratch_image;
+    VkImageView other_view = targets.scratch_view;
+
+    for (size_t i = 0; i < stages.size(); i++) {
+        bool last = i + 1 == stages.size();
+        bool to_other = stages[i] == PostStage::FXAA;
+
+        VkImageView target_view = current_view;
+        if (last && storage_output) {
+            target_view = targets.output_view;
+            to_other = false;
+        } else if (to_other) {
+            target_view = other_view;
+
+            // Its contents are not needed, the reads of the previous frame
+            // only have to be done
+            image_barrier.image = other_image;
+            image_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            image_barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+            image_barrier.srcAccessMask = 0;
+            image_barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            vkCmdPipelineBarrier(command_buffer,
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                                     VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                                 nullptr, 0, nullptr, 1, &image_barrier);
+        }
+
+        // The views change with the swap chain image, so the sets are
+        // written every frame
+        VkDescriptorSet set = allocator.Allocate(set_layout);
+
+        std::array<VkDescriptorImageInfo, 2> image_infos = {{
+            {VK_NULL_HANDLE, current_view, VK_IMAGE_LAYOUT_GENERAL},
+            {VK_NULL_HANDLE, target_view, VK_IMAGE_LAYOUT_GENERAL},
+        }};
+
+        std::array<VkWriteDescriptorSet, 2> writes{};
+        for (uint32_t binding = 0; binding < writes.size(); binding++) {
+            writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[binding].dstSet = set;
+            writes[binding].dstBinding = binding;
+            writes[binding].descriptorCount = 1;
+            writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            writes[binding].pImageInfo = &image_infos[binding];
+        }
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()),
+                               writes.data(), 0, nullptr);
+
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                          last && storage_output ? output_pipeline
+                                                 : pipelines[i]);
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                                pipeline_layout, 0, 1, &set, 0, nullptr);
+        vkCmdDispatch(command_buffer, group_count_x, group_count_y, 1);
+
+        if (query_pool != VK_NULL_HANDLE) {
+            WriteTimestamp(command_buffer, frame_slot,
+                           static_cast<uint32_t>(i) + 1);
+        }
+
+        // The next stage or the blit reads what the stage wrote
+        if (!last || !storage_output) {
+            VkMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT |
+                                    VK_ACCESS_SHADER_WRITE_BIT |
+                                    VK_ACCESS_TRANSFER_READ_BIT;
+            vkCmdPipelineBarrier(command_buffer,
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                                     VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        }
+
+        if (to_other) {
+            std::swap(current_image, other_image);
+            std::swap(current_view, other_view);
+        }
+    }
+
+    /* Output */
+    if (!storage_output) {
+        // Same extent, the blit only converts the format
+        VkImageBlit blit{};
+        blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        blit.srcOffsets[1] = {static_cast<int32_t>(targets.extent.width),
+                              static_cast<int32_t>(targets.extent.height), 1};
+        blit.dstSubresource = blit.srcSubresource;
+        blit.dstOffsets[1] = blit.srcOffsets[1];
+
+        vkCmdBlitImage(command_buffer, current_image, VK_IMAGE_LAYOUT_GENERAL,
+                       targets.output_image,
+                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit,
+                       VK_FILTER_NEAREST);
+    }
+
+    // The presentation engine waits for the render finished semaphore, no
+    // access has to be made visible to it
+    image_barrier.image = targets.output_image;
+    image_barrier.oldLayout = storage_output
+                                  ? VK_IMAGE_LAYOUT_GENERAL
+                                  : VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    image_barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    image_barrier.srcAccessMask = storage_output
+                                      ? VK_ACCESS_SHADER_WRITE_BIT
+                                      : VK_ACCESS_TRANSFER_WRITE_BIT;
+    image_barrier.dstAccessMask = 0;
+    vkCmdPipelineBarrier(command_buffer,
+                         storage_output ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                                        : VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+                         0, nullptr, 1, &image_barrier);
+
+    if (query_pool != VK_NULL_HANDLE) {
+        WriteTimestamp(command_buffer, frame_slot,
+                       static_cast<uint32_t>(stages.size()) + 1);
+        slot_recorded[frame_slot] = true;
+    }
+
+    blit_output = !storage_output;
+}
+
+std::vector<double> PostProcessChain::GetAverageStageTimes() const {
+    std::vector<double> averages;
+    if (measured_frames == 0) {
+        return averages;
+    }
+
+    for (double sum : stage_ms_sums) {
+        averages.push_back(sum / static_cast<double>(measured_frames));
+    }
+    return averages;
+}
+
+void PostProcessChain::Report(std::ostream& out) const {
+    out << "Post-processing:";
+    for (PostStage stage : stages) {
+        out << " " << PostStageName(stage);
+    }
+    out << ", output by " << (blit_output ? "blit" : "storage write")
+        << std::endl;
+
+    std::vector<double> averages = GetAverageStageTimes();
+    if (averages.empty()) {
+        out << "  No GPU timings" << std::endl;
+        return;
+    }
+
+    for (size_t i = 0; i < stages.size(); i++) {
+        out << "  " << PostStageName(stages[i]) << ": " << averages[i]
+            << " ms" << std::endl;
+    }
+    out << "  Output: " << averages.back() << " ms, over " << measured_frames
+        << " frames" << std::endl;
+}
+
+void PostProcessChain::SetDebugNames(const DebugUtils& debug_utils) const {
+    for (size_t i = 0; i < stages.size(); i++) {
+        std::string name = "Post-processing " + PostStageName(stages[i]);
+        debug_utils.SetObjectName(pipelines[i], VK_OBJECT_TYPE_PIPELINE,
+                                  name.c_str());
+    }
+
+    if (output_pipeline != VK_NULL_HANDLE) {
+        std::string name =
+            "Post-processing " + PostStageName(stages.back()) + " output";
+        debug_utils.SetObjectName(output_pipeline, VK_OBJECT_TYPE_PIPELINE,
+                                  name.c_str());
+    }
+}
+
+void PostProcessChain::CollectTimings(uint32_t frame_slot) {
+    /* A slot whose commands were recorded but not submitted, e.g. by a
+    benchmark, returns VK_NOT_READY and is skipped */
+    if (!slot_recorded[frame_slot]) {
+        return;
+    }
+    slot_recorded[frame_slot] = false;
+
+    std::vector<uint64_t> timestamps(queries_per_slot);
+    if (vkGetQueryPoolResults(device, query_pool,
+                              frame_slot * queries_per_slot, queries_per_slot,
+                              timestamps.size() * sizeof(uint64_t),
+                              timestamps.data(), sizeof(uint64_t),
+                              VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+        return;
+    }
+
+    for (size_t i = 0; i + 1 < timestamps.size(); i++) {
+        uint64_t ticks = (timestamps[i + 1] - timestamps[i]) & timestamp_mask;
+        stage_ms_sums[i] +=
+            static_cast<double>(ticks) * timestamp_period / 1000000.0;
+    }
+    measured_frames++;
+}
+
+void PostProcessChain::WriteTimestamp(VkCommandBuffer command_buffer,
+                                      uint32_t frame_slot,
+                                      uint32_t index) const {
+    // Written once all earlier commands are complete
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                        query_pool, frame_slot * queries_per_slot + index);
+}
@@ -0,0 +1,150 @@
+#ifndef POST_PROCESS_H
+#define POST_PROCESS_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Local header files */
+#include "debug_utils.hpp"
+#include "descriptor_allocator.hpp"
+
+/* Standard libraries */
+#include <cstdint>  // Required for uint32_t
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Format of the image the scene is rendered to, HDR for the tonemapping.
+// Every device supports it as color attachment, storage image and blit
+// source.
+const VkFormat POST_IMAGE_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+// Workgroup size of the stages in both dimensions, see shaders/post_*.comp
+const uint32_t POST_TILE_SIZE = 16;
+
+enum class PostStage { TONEMAP, FXAA, GRADE };
+
+// Convert a stage to and from its command line spelling. ParsePostStage
+// throws std::invalid_argument for an unknown name.
+std::string PostStageName(PostStage stage);
+PostStage ParsePostStage(const std::string& name);
+
+// SPIR-V file of the compute shader of a stage, it writes a POST_IMAGE_FORMAT
+// image
+std::string PostStageShaderFile(PostStage stage);
+
+// SPIR-V file of the variant of a stage that writes the swap chain image,
+// whose target has no format qualifier
+std::string PostStageOutputShaderFile(PostStage stage);
+
+// Push constants of every stage, each stage reads its own
+struct PostParameters {
+    float exposure = 1.0F;
+    float contrast = 1.05F;
+    float saturation = 1.1F;
+    float fxaa_threshold = 0.125F;  // Relative contrast of an edge
+};
+
+// Images of one frame. Both scene images are in the GENERAL layout, the
+// scene was rendered to the first one. The output view is only set if the
+// last stage writes the output image directly.
+struct PostTargets {
+    VkImage scene_image = VK_NULL_HANDLE;
+    VkImageView scene_view = VK_NULL_HANDLE;
+    VkImage scratch_image = VK_NULL_HANDLE;
+    VkImageView scratch_view = VK_NULL_HANDLE;
+    VkImage output_image = VK_NULL_HANDLE;
+    VkImageView output_view = VK_NULL_HANDLE;
+    VkExtent2D extent{};
+};
+
+/* Chain of compute shader post-processing stages
+
+The scene is rendered to an offscreen image and every stage is a compute
+dispatch over it, so tonemapping, FXAA and color grading add no render
+passes. A stage that only reads its own pixel (tonemapping, grading) runs in
+place. A stage that reads neighbors (FXAA) loads its tile with an apron into
+shared memory and writes to the other scene image, the next stages continue
+there.
+
+The stages declare their target as POST_IMAGE_FORMAT. The last stage writes
+the swap chain image itself if the swap chain supports
+VK_IMAGE_USAGE_STORAGE_BIT, with an output variant of its shader whose target
+has no format qualifier, which requires the
+shaderStorageImageWriteWithoutFormat feature. Otherwise the result is blitted
+to the swap chain image, which converts it to its format.
+
+The descriptor sets are allocated from the frame allocator every frame, the
+views they point to change with the swap chain image. A timestamp is
+written after every stage, the average GPU time of each stage is reported.
+*/
+class PostProcessChain {
+   public:
+    // Throws std::invalid_argument without stages
+    PostProcessChain(VkPhysicalDevice physical_device, VkDevice device,
+                     uint32_t queue_family, std::vector<PostStage> stages,
+                     uint32_t frame_slot_count);
+
+    // Destroy the pipelines and the query pool, the device must be idle
+    void Destroy();
+
+    // One shader module per stage, in the order of the stages. The output
+    // shader is the output variant of the last stage, VK_NULL_HANDLE if the
+    // result is always blitted.
+    void CreatePipelines(VkPipelineCache cache,
+                         DescriptorLayoutCache& layout_cache,
+                         const std::vector<VkShaderModule>& shaders,
+                         VkShaderModule output_shader);
+
+    // Record the stages and the output after the render pass. The output
+    // view may only be set if the chain has an output shader. The output
+    // image is in the PRESENT_SRC_KHR layout afterwards. The commands that
+    // wait for the acquire semaphore must wait at the color attachment
+    // output stage.
+    void Record(VkCommandBuffer command_buffer, uint32_t frame_slot,
+                const PostTargets& targets, DescriptorAllocator& allocator);
+
+    const std::vector<PostStage>& GetStages() const { return stages; }
+    void SetParameters(const PostParameters& new_parameters) {
+        parameters = new_parameters;
+    }
+
+    // Average GPU time of every stage and of the output in milliseconds,
+    // empty without timestamps or before the first frame completed
+    std::vector<double> GetAverageStageTimes() const;
+
+    // Print the average GPU time of every stage
+    void Report(std::ostream& out) const;
+
+    // Name the pipelines for capture tools
+    void SetDebugNames(const DebugUtils& debug_utils) const;
+
+   private:
+    VkDevice device;
+    std::vector<PostStage> stages;
+    PostParameters parameters;
+
+    VkDescriptorSetLayout set_layout = VK_NULL_HANDLE;
+    VkPipelineLayout pipeline_layout = VK_NULL_HANDLE;
+    std::vector<VkPipeline> pipelines;
+    VkPipeline output_pipeline = VK_NULL_HANDLE;
+    bool blit_output = false;
+
+    // A timestamp before the stages, after each stage and after the output,
+    // per frame slot
+    VkQueryPool query_pool = VK_NULL_HANDLE;
+    uint32_t queries_per_slot = 0;
+    double timestamp_period = 0.0;
+    uint64_t timestamp_mask = 0;
+    std::vector<bool> slot_recorded;
+
+    // Sum of the GPU times of every stage and the output
+    std::vector<double> stage_ms_sums;
+    uint64_t measured_frames = 0;
+
+    void CollectTimings(uint32_t frame_slot);
+    void WriteTimestamp(VkCommandBuffer command_buffer, uint32_t frame_slot,
+                        uint32_t index) const;
+};
+
+#endif  // POST_PROCESS_H
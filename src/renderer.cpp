@@ -0,0 +1,4255 @@
+/* Local header files */
+#include "renderer.hpp"
+
+#include "frame_statistics.hpp"
+
+template <typename Config>
+bool Renderer<Config>::QueueFamilyIndices::IsComplete() {
+    // Checks if the graphicsFamily and presentFamily objects
+    // contain a value
+    return graphics_family.has_value() && present_family.has_value();
+}
+
+template <typename Config>
+Renderer<Config>::Renderer(ApplicationOptions app_options)
+    : options(std::move(app_options)) {
+    if constexpr (Config::RUNTIME_CONFIGURED) {
+        frames_in_flight =
+            options.frames_in_flight.value_or(Config::FRAMES_IN_FLIGHT);
+
+        if (frames_in_flight > Config::MAX_FRAMES_IN_FLIGHT) {
+            throw std::invalid_argument(
+                "frames in flight must be at most " +
+                std::to_string(Config::MAX_FRAMES_IN_FLIGHT) + "!");
+        }
+
+        preferred_present_mode = options.present_mode;
+        enable_validation =
+            options.validation.value_or(Config::ENABLE_VALIDATION);
+        sample_count = options.sample_count.value_or(Config::SAMPLE_COUNT);
+        draw_count = options.draw_count;
+    } else {
+        // The compile time configuration fixes these settings and does not
+        // contain the diagnostic modes
+        if (options.frames_in_flight.has_value() ||
+            options.present_mode.has_value() ||
+            options.validation.has_value() ||
+            options.sample_count.has_value() || options.draw_count != 1 ||
+            options.measure_latency || options.resize_storm) {
+            throw std::invalid_argument(
+                "the option is only available in the diagnostic build!");
+        }
+    }
+
+    // The lighting subpass has nothing to shade the G-buffer with otherwise
+    if (options.deferred && options.lights == 0) {
+        throw std::invalid_argument(
+            "deferred shading requires at least one light!");
+    }
+
+    // The culled draws are recorded in two halves of the forward render
+    // pass, which the G-buffer subpasses and the pre-pass do not have
+    if (options.occlusion_culling &&
+        (options.deferred || options.depth_prepass)) {
+        throw std::invalid_argument(
+            "occlusion culling requires forward shading without a depth "
+            "pre-pass!");
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::Initialize(RendererSurface surface) {
+    /* Initialize Vulkan */
+    surface_source = std::move(surface);
+
+    // The metrics count from the first allocation on
+    if (options.metrics_port != 0) {
+        metrics = std::make_unique<RendererMetrics>();
+    }
+
+    CreateInstance();
+    SetupDebugMessenger();
+    CreateSurface();
+    PickPhysicalDevice();
+    CreateLogicalDevice();
+
+    memory_allocator = std::make_unique<MemoryAllocator>(physical_device,
+                                                         device);
+    memory_allocator->SetMetrics(metrics.get());
+
+    if constexpr (Config::DEBUG_LABELS) {
+        if (debug_utils_enabled) {
+            debug_utils.Load(instance, device);
+        }
+    }
+
+    memory_budget = std::make_unique<MemoryBudget>(instance, physical_device,
+                                                   memory_budget_supported);
+    memory_budget->AddPressureCallback(
+        [this](MemoryPressure pressure,
+               const std::vector<MemoryHeapBudget>& /*heaps*/) {
+            RespondToMemoryPressure(pressure);
+        });
+
+    CreateSwapChain();
+    CreateImageViews();
+    CreateRenderPass();
+    LoadShaders();
+    CreatePipelineCache();
+    pipeline_compiler = std::make_unique<PipelineCompiler>(device);
+    descriptor_layout_cache = std::make_unique<DescriptorLayoutCache>(device);
+    frame_descriptors = std::make_unique<DescriptorAllocator>(
+        device, Config::MAX_FRAMES_IN_FLIGHT);
+    CreateLighting();
+    CreateGraphicsPipeline();
+
+    if (OcclusionCulling()) {
+        CreateOcclusionCuller();
+    }
+
+    CreateColorResources();
+    CreatePostResources();
+    CreateGBuffer();
+    CreateDepthResources();
+    CreateFramebuffers();
+    CreateCommandPools();
+    CreateCommandBuffers();
+    CreateSyncObjects();
+    ConfigureFramePacing();
+
+    if (options.particles > 0) {
+        CreateParticleSystem(options.particles);
+    }
+
+    if (options.hud) {
+        CreateHud();
+    }
+
+    if (PostProcessing()) {
+        CreatePostChain();
+    }
+
+    if (MeasuringFrameTimings()) {
+        CreateTimestampQueries();
+        timing_frame_start = std::chrono::steady_clock::now();
+        timing_cpu_start = timing_frame_start;
+    }
+
+    if (metrics != nullptr) {
+        metrics_server = std::make_unique<MetricsServer>(
+            *metrics, static_cast<uint16_t>(options.metrics_port));
+    }
+
+    if (MeasuringLatency()) {
+        StartLatencyMeasurement();
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::Shutdown() {
+    /* Clean up resources */
+    // The endpoint thread reads the metrics until it is joined
+    metrics_server.reset();
+    memory_allocator->SetMetrics(nullptr);
+    metrics.reset();
+
+    CleanupSwapChain();
+
+    // Waits for the compilations that still use the layout and the cache
+    pipeline_compiler->Destroy();
+    pipeline_compiler.reset();
+
+    // The layouts of the chain, the lighting and the culling belong to the
+    // layout cache
+    DestroyPostChain();
+    DestroyLighting();
+    DestroyOcclusionCuller();
+    frame_descriptors->Destroy();
+    frame_descriptors.reset();
+    descriptor_layout_cache->Destroy();
+    descriptor_layout_cache.reset();
+
+    vkDestroyPipeline(device, graphics_pipeline, nullptr);
+    vkDestroyPipeline(device, occlusion_proxy_pipeline, nullptr);
+    vkDestroyPipelineLayout(device, pipeline_layout, nullptr);
+    SavePipelineCache();
+    vkDestroyPipelineCache(device, pipeline_cache, nullptr);
+
+    DestroyRenderPasses();
+
+    for (size_t i = 0; i < Config::MAX_FRAMES_IN_FLIGHT; i++) {
+        vkDestroySemaphore(device, image_available_semaphores[i], nullptr);
+        vkDestroySemaphore(device, render_finished_semaphores[i], nullptr);
+        vkDestroyFence(device, in_flight_fences[i], nullptr);
+    }
+
+    if (texture_streamer != nullptr) {
+        texture_streamer->Destroy();
+        texture_streamer.reset();
+    }
+
+    DestroyParticleSystem();
+    DestroyHud();
+    vkDestroyQueryPool(device, timestamp_query_pool, nullptr);
+    DestroyMeshes();
+    vkDestroyCommandPool(device, load_command_pool, nullptr);
+
+    // Destroying a pool frees its command buffers
+    for (auto& frame_command_pool : frame_command_pools) {
+        vkDestroyCommandPool(device, frame_command_pool.pool, nullptr);
+        frame_command_pool = {};
+    }
+
+    // Every buffer and image is destroyed by now, live memory was leaked
+    if (memory_allocator->GetLiveAllocations() > 0) {
+        std::cerr << "Warning: " << memory_allocator->GetLiveAllocations()
+                  << " device memory allocations ("
+                  << memory_allocator->GetLiveBytes()
+                  << " bytes) were not freed" << std::endl;
+    }
+
+    memory_allocator.reset();
+    vkDestroyDevice(device, nullptr);
+
+    if (ValidationEnabled()) {
+        DestroyDebugUtilsMessengerEXT(instance, debug_messenger, nullptr);
+    }
+
+    vkDestroySurfaceKHR(instance, surface, nullptr);
+    vkDestroyInstance(instance, nullptr);
+}
+
+template <typename Config>
+void Renderer<Config>::WaitIdle() {
+    /* This helps to prevent any asynchronous issues with drawing a frame. It
+    is not a good idea to clean up resources while drawing and presenation
+    operations are happening. */
+
+    // Wait for operations in a specific command queue to be finished
+    vkDeviceWaitIdle(device);
+}
+
+template <typename Config>
+void Renderer<Config>::ReportDiagnostics(std::ostream& out) {
+    /* Report the results of the diagnostic modes, the device must be idle */
+    if (MeasuringLatency()) {
+        DiscardPendingPresents();
+        latency_tracker.Report(out);
+    }
+
+    if (RunningResizeStorm()) {
+        resize_storm.Report(out);
+    }
+
+    if (texture_streamer != nullptr) {
+        texture_streamer->Report(out);
+    }
+
+    memory_budget->Report(out);
+
+    if (shader_manifest.has_value()) {
+        shader_manifest->Report(out);
+    }
+
+    out << "Pipeline cache: ";
+    if (pipeline_cache_loaded_size > 0) {
+        out << pipeline_cache_loaded_size << " bytes of the previous run";
+    } else {
+        out << "cold";
+    }
+    out << ", key " << std::hex << pipeline_cache_key << std::dec
+        << std::endl;
+
+    if (pipeline_compiler->GetRequestCount() > 0) {
+        pipeline_compiler->Report(out);
+    }
+
+    if (frame_descriptors->GetAllocationCount() > 0) {
+        frame_descriptors->Report(out);
+    }
+
+    if (post_chain != nullptr) {
+        post_chain->Report(out);
+    }
+
+    if (occlusion_culler != nullptr) {
+        occlusion_culler->Report(out);
+    }
+
+    if (scene_lights != nullptr) {
+        out << "Lighting: " << scene_lights->GetCount() << " lights, "
+            << (DeferredShading() ? "deferred" : "forward");
+
+        // Lazily allocated memory is only committed if the G-buffer had to
+        // leave the tile memory
+        if (DeferredShading() && gbuffer_lazily_allocated) {
+            VkDeviceSize committed_bytes = 0;
+            for (const AttachmentImage& gbuffer_image : gbuffer_images) {
+                VkDeviceSize image_bytes = 0;
+                vkGetDeviceMemoryCommitment(device, gbuffer_image.memory,
+                                            &image_bytes);
+                committed_bytes += image_bytes;
+            }
+            out << ", " << committed_bytes
+                << " bytes of the G-buffer committed";
+        } else if (DeferredShading()) {
+            out << ", G-buffer in device memory";
+        }
+        out << std::endl;
+    }
+
+    if (lod_frame_count > 0) {
+        auto frames = static_cast<double>(lod_frame_count);
+        double selected = static_cast<double>(lod_selected_triangles) / frames;
+        double full = static_cast<double>(lod_full_triangles) / frames;
+
+        out << "Level of detail: " << selected
+            << " triangles per frame selected, " << full
+            << " without levels of detail ("
+            << (full > 0.0 ? 100.0 * selected / full : 100.0) << "%)"
+            << std::endl;
+    }
+
+    if (particle_frame_count > 0) {
+        out << "Particles: "
+            << static_cast<double>(particle_alive_sum) /
+                   static_cast<double>(particle_frame_count)
+            << " per frame of " << particle_system->GetCapacity()
+            << std::endl;
+    }
+}
+
+template <typename Config>
+TextureStreamer::TextureHandle Renderer<Config>::LoadTexture(
+    const std::string& filename) {
+    return GetTextureStreamer().LoadTexture(filename);
+}
+
+template <typename Config>
+TextureStreamer::TextureHandle Renderer<Config>::LoadTexture(
+    const std::string& name, Ktx2File texture) {
+    return GetTextureStreamer().AddTexture(name, std::move(texture));
+}
+
+template <typename Config>
+TextureStreamer& Renderer<Config>::GetTextureStreamer() {
+    /* The streamer is created with the first texture, so a renderer without
+    textures does not allocate staging memory */
+    if (texture_streamer == nullptr) {
+        if (!timeline_semaphore_supported) {
+            throw std::runtime_error(
+                "LoadTexture Error: texture streaming requires "
+                "VK_KHR_timeline_semaphore!");
+        }
+
+        // Every frame slot has its own staging buffer
+        texture_streamer = std::make_unique<TextureStreamer>(
+            physical_device, device, *memory_allocator,
+            Config::MAX_FRAMES_IN_FLIGHT,
+            static_cast<VkDeviceSize>(options.texture_budget) * 1024);
+
+        if constexpr (Config::DEBUG_LABELS) {
+            texture_streamer->SetDebugUtils(&debug_utils);
+        }
+
+        RespondToMemoryPressure(memory_budget->GetPressure());
+    }
+
+    return *texture_streamer;
+}
+
+template <typename Config>
+VkImageView Renderer<Config>::GetTextureView(
+    TextureStreamer::TextureHandle texture) const {
+    if (texture_streamer == nullptr) {
+        return VK_NULL_HANDLE;
+    }
+
+    return texture_streamer->GetImageView(texture);
+}
+
+template <typename Config>
+typename Renderer<Config>::MeshHandle Renderer<Config>::LoadMesh(
+    const std::string& filename) {
+    /* The streams of the file are already in the layout the GPU reads, the
+    mapped payload is copied into the staging buffer with a single memcpy */
+    MeshFile file(filename);
+
+    GpuMesh mesh;
+    mesh.header = file.GetHeader();
+    mesh.payload_offset = file.GetPayloadOffset();
+
+    memory_allocator->CreateBuffer(
+        file.GetPayloadSize(),
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+            VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, mesh.buffer, mesh.memory,
+        "mesh");
+    NameObject(mesh.buffer, VK_OBJECT_TYPE_BUFFER, filename.c_str());
+
+    UploadToBuffer(file.GetPayload(), file.GetPayloadSize(), mesh.buffer, 0);
+
+    mesh.lods = file.GetLods();
+    lod_selector.SetChain(static_cast<uint32_t>(meshes.size()), mesh.lods);
+
+    meshes.push_back(mesh);
+    return static_cast<MeshHandle>(meshes.size() - 1);
+}
+
+template <typename Config>
+typename Renderer<Config>::MeshHandle Renderer<Config>::UploadMesh(
+    const MeshData& data) {
+    /* Same layout as a .vmesh file, the streams are copied straight into the
+    staging buffer */
+    GpuMesh mesh;
+    mesh.header = LayoutMeshFile(data);
+    mesh.payload_offset = mesh.header.streams.front().offset;
+    VkDeviceSize payload_size = GetMeshPayloadSize(mesh.header);
+
+    memory_allocator->CreateBuffer(
+        payload_size,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+            VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, mesh.buffer, mesh.memory,
+        "mesh");
+    if constexpr (Config::DEBUG_LABELS) {
+        std::string name = "Mesh " + std::to_string(meshes.size());
+        NameObject(mesh.buffer, VK_OBJECT_TYPE_BUFFER, name.c_str());
+    }
+
+    UploadToBuffer(payload_size, mesh.buffer, 0, [&](uint8_t* staging) {
+        CopyMeshStreams(data, mesh.header, staging);
+    });
+
+    mesh.lods = data.lods;
+    lod_selector.SetChain(static_cast<uint32_t>(meshes.size()), mesh.lods);
+
+    meshes.push_back(mesh);
+    return static_cast<MeshHandle>(meshes.size() - 1);
+}
+
+template <typename Config>
+void Renderer<Config>::DestroyMeshes() {
+    for (const auto& mesh : meshes) {
+        vkDestroyBuffer(device, mesh.buffer, nullptr);
+        memory_allocator->Free(mesh.memory);
+    }
+    meshes.clear();
+
+    // The objects of the culling set keep their bounds but lose their levels
+    lod_selector.Clear();
+}
+
+template <typename Config>
+uint32_t Renderer<Config>::AddObject(MeshHandle mesh, const glm::vec3& center,
+                                     float radius) {
+    if (mesh >= meshes.size()) {
+        throw std::invalid_argument("AddObject Error: invalid mesh handle!");
+    }
+
+    uint32_t object = culling_set.Add(center, radius);
+    lod_selector.SetObjectChain(object, mesh);
+    return object;
+}
+
+template <typename Config>
+void Renderer<Config>::NotifySurfaceResized() {
+    // The swap chain is recreated at the start of the next frame
+    framebuffer_resized = true;
+}
+
+template <typename Config>
+void Renderer<Config>::StampInput() {
+    // Timestamp an input event for the latency measurement
+    if (MeasuringLatency()) {
+        latency_tracker.StampInput(LatencyTracker::Clock::now());
+    }
+}
+
+template <typename Config>
+bool Renderer<Config>::InstanceExtensionSupported(const char* extension_name) {
+    uint32_t extension_count = 0;
+    vkEnumerateInstanceExtensionProperties(nullptr, &extension_count, nullptr);
+
+    std::vector<VkExtensionProperties> extensions(extension_count);
+    vkEnumerateInstanceExtensionProperties(nullptr, &extension_count,
+                                           extensions.data());
+
+    for (const auto& extension : extensions) {
+        if (std::strcmp(extension.extensionName, extension_name) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename Config>
+void Renderer<Config>::CheckExtensionSupport() {
+    /* Checking for extension support */
+    // Count the amount of supported extensions
+    uint32_t extension_count = 0;
+    vkEnumerateInstanceExtensionProperties(nullptr, &extension_count, nullptr);
+
+    // Query extension details
+    std::vector<VkExtensionProperties> extensions(extension_count);
+    vkEnumerateInstanceExtensionProperties(nullptr, &extension_count,
+                                           extensions.data());
+
+    std::cout << "available extensions: " << std::endl;
+    for (const auto& extension : extensions) {
+        std::cout << '\t' << extension.extensionName << '\n';
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CreateInstance() {
+    /* Create instance */
+    if (ValidationEnabled() && !CheckValidationLayerSupport()) {
+        throw std::runtime_error(
+            "validation layers requested, but not available!");
+    }
+
+    // Fill in some information about the application
+    // This data is optional.
+    VkApplicationInfo app_info{};
+    app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    app_info.pApplicationName = "Triangle";
+    app_info.applicationVersion = VK_MAKE_VERSION(0, 1, 0);
+    app_info.pEngineName = "No Engine";
+    app_info.engineVersion = VK_MAKE_VERSION(0, 1, 0);
+    app_info.apiVersion = VK_API_VERSION_1_0;
+
+    // Informs the Vulkan driver which global extensions and
+    // validation layers we want to use
+    VkInstanceCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    create_info.pApplicationInfo = &app_info;
+
+    // Retreive the required list of extensions
+    auto extensions = GetRequiredExtensions();
+    debug_utils_enabled =
+        std::any_of(extensions.begin(), extensions.end(),
+                    [](const char* extension) {
+                        return std::strcmp(extension,
+                                           VK_EXT_DEBUG_UTILS_EXTENSION_NAME) ==
+                               0;
+                    });
+
+    // Add the extensions to inferface with the window system of the host
+    create_info.enabledExtensionCount =
+        static_cast<uint32_t>(extensions.size());
+    create_info.ppEnabledExtensionNames = extensions.data();
+
+    VkDebugUtilsMessengerCreateInfoEXT debug_create_info{};
+
+    // Modify the VkInstanceCreateInfo struct to include the validation layer
+    // names if they are enabled
+    if (ValidationEnabled()) {
+        create_info.enabledLayerCount =
+            static_cast<uint32_t>(VALIDATION_LAYERS.size());
+        create_info.ppEnabledLayerNames = VALIDATION_LAYERS.data();
+
+        PopulateDebugMessengerCreateInfo(debug_create_info);
+        create_info.pNext = &debug_create_info;
+    } else {
+        create_info.enabledLayerCount = 0;
+        create_info.pNext = nullptr;
+    }
+
+    // Create an instance
+    if (vkCreateInstance(&create_info, nullptr, &instance) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateInstance ERROR: failed to create instance!");
+    }
+
+    // CheckExtensionSupport();
+}
+
+template <typename Config>
+bool Renderer<Config>::CheckValidationLayerSupport() {
+    /* Checks if all of the requested layers are available */
+    // List all of the available layers
+    uint32_t layer_count = 0;
+    vkEnumerateInstanceLayerProperties(&layer_count, nullptr);
+
+    std::vector<VkLayerProperties> available_layers(layer_count);
+    vkEnumerateInstanceLayerProperties(&layer_count, available_layers.data());
+
+    // Check if all of the layers in the validationLayers exist in the
+    // availableLayers list
+    for (const char* layer_name : VALIDATION_LAYERS) {
+        bool layer_found = false;
+
+        for (const auto& layer_properties : available_layers) {
+            if (strcmp(layer_name, layer_properties.layerName) == 0) {
+                layer_found = true;
+                break;
+            }
+        }
+
+        if (!layer_found) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename Config>
+std::vector<const char*> Renderer<Config>::GetRequiredExtensions() const {
+    /* Retrieve the required list of extensions based on if the
+    validation layers are enabled or disabled */
+    // The host lists the extensions required to create its surface
+    std::vector<const char*> extensions = surface_source.instance_extensions;
+
+    // The validation layers report through VK_EXT_debug_utils. Without them
+    // the extension is still enabled for the object names and labels if a
+    // layer, e.g. of a capture tool, provides it.
+    if (ValidationEnabled()) {
+        extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    } else if (Config::DEBUG_LABELS &&
+               InstanceExtensionSupported(VK_EXT_DEBUG_UTILS_EXTENSION_NAME)) {
+        extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    }
+
+    /*
+     * VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME:
+     * the VK_KHR_get_physical_device_properties2 instance extension
+     */
+    extensions.push_back(
+        VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+
+    return extensions;
+}
+
+template <typename Config>
+VKAPI_ATTR VkBool32 VKAPI_CALL Renderer<Config>::DebugCallback(
+    VkDebugUtilsMessageSeverityFlagBitsEXT message_severity,
+    VkDebugUtilsMessageTypeFlagsEXT message_type,
+    const VkDebugUtilsMessengerCallbackDataEXT* p_callback_data,
+    void* p_user_data) {
+    /* Debug to the console for validation layers */
+    std::string debug_msg = "validation layer: " +
+                            static_cast<std::string>(p_callback_data->pMessage);
+    std::cerr << debug_msg << std::endl;
+
+    if (message_severity >= VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) {
+        // Message is important enought to show
+        debug_msg = "validation layer ERROR: " +
+                    static_cast<std::string>(p_callback_data->pMessage);
+        throw std::runtime_error(debug_msg.c_str());
+    }
+
+    return VK_FALSE;
+}
+
+template <typename Config>
+void Renderer<Config>::SetupDebugMessenger() {
+    if (!ValidationEnabled()) {
+        return;
+    }
+
+    // Fill in the details about the messenger and its callback
+    VkDebugUtilsMessengerCreateInfoEXT create_info{};
+    PopulateDebugMessengerCreateInfo(create_info);
+
+    // Create the extension object if it is available
+    if (CreateDebugUtilsMessengerEXT(instance, &create_info, nullptr,
+                                     &debug_messenger) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "CreateDebugUtilsMessengerEXT Error: failed to set up debug "
+            "messenger!");
+    }
+}
+
+template <typename Config>
+VkResult Renderer<Config>::CreateDebugUtilsMessengerEXT(
+    VkInstance instance,
+    const VkDebugUtilsMessengerCreateInfoEXT* p_create_info,
+    const VkAllocationCallbacks* p_allocator,
+    VkDebugUtilsMessengerEXT* p_debug_messenger) {
+    /* Proxy function to create the debug messenger */
+    // Looks up the address of the VkDebugUtilsMessengerEXT object
+    auto func = reinterpret_cast<PFN_vkCreateDebugUtilsMessengerEXT>(
+        vkGetInstanceProcAddr(instance, "vkCreateDebugUtilsMessengerEXT"));
+
+    if (func != nullptr) {
+        return func(instance, p_create_info, p_allocator, p_debug_messenger);
+    }
+
+    return VK_ERROR_EXTENSION_NOT_PRESENT;
+}
+
+template <typename Config>
+void Renderer<Config>::DestroyDebugUtilsMessengerEXT(
+    VkInstance instance, VkDebugUtilsMessengerEXT debug_messenger,
+    const VkAllocationCallbacks* p_allocator) {
+    /* Proxy function to destroy the debug messenger */
+    auto func = reinterpret_cast<PFN_vkDestroyDebugUtilsMessengerEXT>(
+        vkGetInstanceProcAddr(instance, "vkDestroyDebugUtilsMessengerEXT"));
+
+    if (func != nullptr) {
+        func(instance, debug_messenger, p_allocator);
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::PopulateDebugMessengerCreateInfo(
+    VkDebugUtilsMessengerCreateInfoEXT& create_info) {
+    /* Fill in the details about the messenger and its callback to the structure
+     */
+    create_info = {};
+    create_info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
+    create_info.messageSeverity =
+        VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT |
+        VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
+        VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+    create_info.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT |
+                              VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
+                              VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+    create_info.pfnUserCallback = DebugCallback;
+}
+
+template <typename Config>
+void Renderer<Config>::PickPhysicalDevice() {
+    // Count the number of graphics cards with Vulkan support
+    uint32_t device_count = 0;
+    vkEnumeratePhysicalDevices(instance, &device_count, nullptr);
+
+    if (device_count == 0) {
+        throw std::runtime_error(
+            "vkEnumeratePhysicalDevices Error: failed to find GPUs with Vulkan "
+            "support!");
+    }
+
+    // Allocate an array to hold all of the VkPhysicalDevice handles
+    std::vector<VkPhysicalDevice> devices(device_count);
+    vkEnumeratePhysicalDevices(instance, &device_count, devices.data());
+
+    // Device suitability checks
+    for (const auto& device : devices) {
+        if (IsDeviceSuitable(device)) {
+            physical_device = device;
+            break;
+        }
+    }
+
+    if (physical_device == VK_NULL_HANDLE) {
+        throw std::runtime_error(
+            "vkEnumeratePhysicalDevices Error: failed to find a suitable GPU!");
+    }
+
+    present_wait_supported = CheckPresentWaitSupport(physical_device);
+    timeline_semaphore_supported =
+        CheckTimelineSemaphoreSupport(physical_device);
+    memory_budget_supported = GetAvailableDeviceExtensions(physical_device)
+                                  .count(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) >
+                              0;
+    // Enabled where supported, the render pass may be rebuilt with
+    // occlusion culling later
+    conditional_rendering_supported =
+        CheckConditionalRenderingSupport(physical_device);
+
+    msaa_samples = ChooseSampleCount();
+}
+
+template <typename Config>
+bool Renderer<Config>::IsDeviceSuitable(VkPhysicalDevice device) {
+    /* Queue family lookup function to ensure the device can process the
+    commands to use */
+    QueueFamilyIndices indices = FindQueueFamilies(device);
+
+    bool extensions_supported = CheckDeviceExtensionSupport(device);
+
+    // Verify swap chain support is adequate
+    bool swap_chain_adequate = false;
+    if (extensions_supported) {
+        SwapChainSupportDetails swap_chain_support =
+            QuerySwapChainSupport(device);
+        swap_chain_adequate = !swap_chain_support.formats.empty() &&
+                              !swap_chain_support.present_modes.empty();
+    }
+
+    return indices.IsComplete() && extensions_supported && swap_chain_adequate;
+}
+
+template <typename Config>
+typename Renderer<Config>::QueueFamilyIndices
+Renderer<Config>::FindQueueFamilies(VkPhysicalDevice device) {
+    /* Logic to find queue family indices to populate the struct with */
+    QueueFamilyIndices indices;
+
+    // The process to retreive the list of queue families
+    uint32_t queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count,
+                                             nullptr);
+
+    std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count,
+                                             queue_families.data());
+
+    // Find at lest one queue family that supports VK_QUEUE_GRAPHICS_BIT
+    int i = 0;
+    for (const auto& queue_family : queue_families) {
+        if (queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+            indices.graphics_family = i;
+        }
+
+        // Look for a queue family that is capable of presenting to the window
+        // surface
+        VkBool32 present_support = false;
+        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface,
+                                             &present_support);
+
+        if (present_support) {
+            indices.present_family = i;
+        }
+
+        if (indices.IsComplete()) {
+            break;
+        }
+
+        i++;
+    }
+
+    return indices;
+}
+
+template <typename Config>
+void Renderer<Config>::CreateLogicalDevice() {
+    // Specify the queues to be created
+    QueueFamilyIndices indices = FindQueueFamilies(physical_device);
+
+    // Set multiple VkDeviceQueueCreateInfo structs to create a queue
+    // from both families which are mandatory for the required queues
+    std::vector<VkDeviceQueueCreateInfo> queue_create_infos;
+
+    std::set<uint32_t> unique_queue_families = {};
+
+    if (indices.graphics_family.has_value() &&
+        indices.present_family.has_value()) {
+        unique_queue_families.insert(indices.graphics_family.value());
+        unique_queue_families.insert(indices.present_family.value());
+    } else {
+        throw std::runtime_error(
+            "Indices's graphics and present families contain no value!");
+    }
+
+    float queue_priority = 1.0F;
+
+    for (uint32_t queue_family : unique_queue_families) {
+        VkDeviceQueueCreateInfo queue_create_info{};
+        queue_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queue_create_info.queueFamilyIndex = queue_family;
+        queue_create_info.queueCount = 1;
+        queue_create_info.pQueuePriorities = &queue_priority;
+        queue_create_infos.push_back(queue_create_info);
+    }
+
+    // Specify the device features to be used
+    VkPhysicalDeviceFeatures device_features{};
+    VkPhysicalDeviceFeatures supported_features{};
+    vkGetPhysicalDeviceFeatures(physical_device, &supported_features);
+
+    // The last post-processing stage can only write the swap chain image,
+    // whose format has no shader qualifier, with this feature
+    if (PostProcessing()) {
+        storage_write_without_format =
+            supported_features.shaderStorageImageWriteWithoutFormat == VK_TRUE;
+        device_features.shaderStorageImageWriteWithoutFormat =
+            supported_features.shaderStorageImageWriteWithoutFormat;
+    }
+
+    // The occlusion culling draws all commands of a phase with a single
+    // indirect draw if the device supports it, otherwise one per draw
+    multi_draw_indirect_supported =
+        supported_features.multiDrawIndirect == VK_TRUE;
+    device_features.multiDrawIndirect = supported_features.multiDrawIndirect;
+
+    std::vector<const char*> device_extensions(DEVICE_EXTENSIONS.begin(),
+                                               DEVICE_EXTENSIONS.end());
+
+    // Enable present ids and waiting for presents if they are supported.
+    // The extension features are enabled by chaining them to pNext.
+    VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features{};
+    present_wait_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    present_wait_features.presentWait = VK_TRUE;
+
+    VkPhysicalDevicePresentIdFeaturesKHR present_id_features{};
+    present_id_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    present_id_features.pNext = &present_wait_features;
+    present_id_features.presentId = VK_TRUE;
+
+    // Enable timeline semaphores for texture streaming if they are supported
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_features{};
+    timeline_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+    timeline_features.timelineSemaphore = VK_TRUE;
+
+    void* features_chain = nullptr;
+
+    if (timeline_semaphore_supported) {
+        device_extensions.insert(device_extensions.end(),
+                                 TIMELINE_SEMAPHORE_EXTENSIONS.begin(),
+                                 TIMELINE_SEMAPHORE_EXTENSIONS.end());
+        timeline_features.pNext = features_chain;
+        features_chain = &timeline_features;
+    }
+
+    if (present_wait_supported) {
+        device_extensions.insert(device_extensions.end(),
+                                 PRESENT_WAIT_EXTENSIONS.begin(),
+                                 PRESENT_WAIT_EXTENSIONS.end());
+        present_wait_features.pNext = features_chain;
+        features_chain = &present_id_features;
+    }
+
+    // Enable conditional rendering for the occlusion queries if it is
+    // supported, whether the culling is on or not
+    VkPhysicalDeviceConditionalRenderingFeaturesEXT conditional_features{};
+    conditional_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT;
+    conditional_features.conditionalRendering = VK_TRUE;
+
+    if (conditional_rendering_supported) {
+        device_extensions.insert(device_extensions.end(),
+                                 CONDITIONAL_RENDERING_EXTENSIONS.begin(),
+                                 CONDITIONAL_RENDERING_EXTENSIONS.end());
+        conditional_features.pNext = features_chain;
+        features_chain = &conditional_features;
+    }
+
+    // The memory budget has no features to enable
+    if (memory_budget_supported) {
+        device_extensions.insert(device_extensions.end(),
+                                 MEMORY_BUDGET_EXTENSIONS.begin(),
+                                 MEMORY_BUDGET_EXTENSIONS.end());
+    }
+
+    // Create the logical device
+    VkDeviceCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    create_info.queueCreateInfoCount =
+        static_cast<uint32_t>(queue_create_infos.size());
+    create_info.pQueueCreateInfos = queue_create_infos.data();
+    create_info.pEnabledFeatures = &device_features;
+    create_info.pNext = features_chain;
+
+    // Enabling device extensions
+    // Using a swapchain requires enabling the VK_KHR_swapchain
+    create_info.enabledExtensionCount =
+        static_cast<uint32_t>(device_extensions.size());
+    create_info.ppEnabledExtensionNames = device_extensions.data();
+
+    // Specify the validation layers for the logical device if the validation
+    // layers is enabled
+    if (ValidationEnabled()) {
+        create_info.enabledLayerCount =
+            static_cast<uint32_t>(VALIDATION_LAYERS.size());
+        create_info.ppEnabledLayerNames = VALIDATION_LAYERS.data();
+    } else {
+        create_info.enabledLayerCount = 0;
+    }
+
+    // Instantiate the logical device
+    if (vkCreateDevice(physical_device, &create_info, nullptr, &device) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateDevice Error: failed to create logical device!");
+    }
+
+    if (indices.graphics_family.has_value() &&
+        indices.present_family.has_value()) {
+        // Retrieve queue handles
+        vkGetDeviceQueue(device, indices.graphics_family.value(), 0,
+                         &graphics_queue);
+        vkGetDeviceQueue(device, indices.present_family.value(), 0,
+                         &present_queue);
+    } else {
+        throw std::runtime_error(
+            "Indices's graphics and present Families contain no value!");
+    }
+
+    if (present_wait_supported) {
+        // vkWaitForPresentKHR is an extension function and has to be looked
+        // up from the device
+        wait_for_present = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+            vkGetDeviceProcAddr(device, "vkWaitForPresentKHR"));
+        present_wait_supported = wait_for_present != nullptr;
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CreateSurface() {
+    // The surface is created by the host, e.g. for a GLFW window or a
+    // headless surface
+    surface = surface_source.create_surface(instance);
+
+    if (surface == VK_NULL_HANDLE) {
+        throw std::runtime_error(
+            "CreateSurface Error: the host failed to create a surface!");
+    }
+}
+
+template <typename Config>
+std::set<std::string> Renderer<Config>::GetAvailableDeviceExtensions(
+    VkPhysicalDevice device) {
+    /* Enumerate the names of the extensions supported by the device */
+    uint32_t extension_count = 0;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count,
+                                         nullptr);
+
+    std::vector<VkExtensionProperties> available_extensions(extension_count);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count,
+                                         available_extensions.data());
+
+    std::set<std::string> extension_names;
+    for (const auto& extension : available_extensions) {
+        extension_names.insert(extension.extensionName);
+    }
+
+    return extension_names;
+}
+
+template <typename Config>
+bool Renderer<Config>::CheckDeviceExtensionSupport(VkPhysicalDevice device) {
+    /* Enumerate the extensions and check if all of the required
+    extensions are included in them */
+    std::set<std::string> available_extensions =
+        GetAvailableDeviceExtensions(device);
+
+    return std::all_of(DEVICE_EXTENSIONS.begin(), DEVICE_EXTENSIONS.end(),
+                       [&](const char* extension) {
+                           return available_extensions.count(extension) > 0;
+                       });
+}
+
+template <typename Config>
+bool Renderer<Config>::CheckPresentWaitSupport(VkPhysicalDevice device) {
+    /* VK_KHR_present_id and VK_KHR_present_wait are only used if both
+    extensions and their features are supported by the device */
+    std::set<std::string> available_extensions =
+        GetAvailableDeviceExtensions(device);
+
+    for (const char* extension : PRESENT_WAIT_EXTENSIONS) {
+        if (available_extensions.count(extension) == 0) {
+            return false;
+        }
+    }
+
+    // Query the extension features through the
+    // VK_KHR_get_physical_device_properties2 instance extension
+    auto get_features = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(
+        vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceFeatures2KHR"));
+
+    if (get_features == nullptr) {
+        return false;
+    }
+
+    VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features{};
+    present_wait_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+    VkPhysicalDevicePresentIdFeaturesKHR present_id_features{};
+    present_id_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    present_id_features.pNext = &present_wait_features;
+
+    VkPhysicalDeviceFeatures2KHR features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+    features.pNext = &present_id_features;
+
+    get_features(device, &features);
+
+    return present_id_features.presentId == VK_TRUE &&
+           present_wait_features.presentWait == VK_TRUE;
+}
+
+template <typename Config>
+bool Renderer<Config>::CheckTimelineSemaphoreSupport(VkPhysicalDevice device) {
+    /* VK_KHR_timeline_semaphore is only used if the extension and its feature
+    are supported by the device */
+    std::set<std::string> available_extensions =
+        GetAvailableDeviceExtensions(device);
+
+    for (const char* extension : TIMELINE_SEMAPHORE_EXTENSIONS) {
+        if (available_extensions.count(extension) == 0) {
+            return false;
+        }
+    }
+
+    auto get_features = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(
+        vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceFeatures2KHR"));
+
+    if (get_features == nullptr) {
+        return false;
+    }
+
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_features{};
+    timeline_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+
+    VkPhysicalDeviceFeatures2KHR features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+    features.pNext = &timeline_features;
+
+    get_features(device, &features);
+
+    return timeline_features.timelineSemaphore == VK_TRUE;
+}
+
+template <typename Config>
+bool Renderer<Config>::CheckConditionalRenderingSupport(
+    VkPhysicalDevice device) {
+    /* VK_EXT_conditional_rendering is only used if the extension and its
+    feature are supported by the device */
+    std::set<std::string> available_extensions =
+        GetAvailableDeviceExtensions(device);
+
+    for (const char* extension : CONDITIONAL_RENDERING_EXTENSIONS) {
+        if (available_extensions.count(extension) == 0) {
+            return false;
+        }
+    }
+
+    auto get_features = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(
+        vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceFeatures2KHR"));
+
+    if (get_features == nullptr) {
+        return false;
+    }
+
+    VkPhysicalDeviceConditionalRenderingFeaturesEXT conditional_features{};
+    conditional_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT;
+
+    VkPhysicalDeviceFeatures2KHR features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+    features.pNext = &conditional_features;
+
+    get_features(device, &features);
+
+    return conditional_features.conditionalRendering == VK_TRUE;
+}
+
+template <typename Config>
+typename Renderer<Config>::SwapChainSupportDetails
+Renderer<Config>::QuerySwapChainSupport(VkPhysicalDevice device) {
+    SwapChainSupportDetails details;
+
+    // Query basic surface capabilities
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface,
+                                              &details.capabilities);
+
+    // Querying the supported surface formats
+    uint32_t format_count = 0;
+    vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &format_count,
+                                         nullptr);
+
+    if (format_count != 0) {
+        details.formats.resize(format_count);
+        vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &format_count,
+                                             details.formats.data());
+    }
+
+    // Querying the supported presentation modes
+    uint32_t present_mode_count = 0;
+    vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface,
+                                              &present_mode_count, nullptr);
+
+    if (present_mode_count != 0) {
+        details.present_modes.resize(present_mode_count);
+        vkGetPhysicalDeviceSurfacePresentModesKHR(
+            device, surface, &present_mode_count, details.present_modes.data());
+    }
+
+    return details;
+}
+
+template <typename Config>
+VkSurfaceFormatKHR Renderer<Config>::ChooseSwapSurfaceFormat(
+    const std::vector<VkSurfaceFormatKHR>& available_formats) {
+    // Go through a list to find if the preferred combination is available
+    //
+    // VK_COLOR_SPACE_SRGB_NONLINEAR_KHR: SRGB color space is supported
+    // or not supported
+    //
+    // VK_FORMAT_B8G8R8A8_SRGB: store the BGRA channels in that order
+    // with each channels containing a 8 bit unsigned integer.
+    // This would result in a total of 32 bits per pixel.
+    for (const auto& available_format : available_formats) {
+        if (available_format.format == VK_FORMAT_B8G8R8A8_SRGB &&
+            available_format.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
+            return available_format;
+        }
+    }
+
+    return available_formats[0];
+}
+
+template <typename Config>
+VkPresentModeKHR Renderer<Config>::ChooseSwapPresentMode(
+    const std::vector<VkPresentModeKHR>& available_present_modes) const {
+    // Use the configured present mode if the surface supports it
+    std::optional<VkPresentModeKHR> preferred = PreferredPresentMode();
+    if (preferred.has_value() &&
+        std::find(available_present_modes.begin(),
+                  available_present_modes.end(),
+                  preferred.value()) != available_present_modes.end()) {
+        return preferred.value();
+    }
+
+    // VK_PRESENT_MODE_MAILBOX_KHR: This helps to avoid tearing and maintain a
+    // low letency. Use this if energy is not an issue.
+    //
+    // VK_PRESENT_MODE_FIFO_KHR: If energy usage is an issue, use this.
+    // This is recommended for mobile devices.
+    for (const auto& available_present_mode : available_present_modes) {
+        if (available_present_mode == VK_PRESENT_MODE_MAILBOX_KHR) {
+            return available_present_mode;
+        }
+    }
+
+    return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+template <typename Config>
+VkExtent2D Renderer<Config>::ChooseSwapExtent(
+    const VkSurfaceCapabilitiesKHR& capabilities) {
+    // The swap extent is the resolution of the swap chain images and it's
+    // usually always exactly equal to the resolution of the window that the
+    // program draws in pixels.
+    //
+    // Using a high CPI display like Apple's Retina display), screen coordinates
+    // don't correspond to pixels. The issue is that the resolution of the
+    // window in pixels will be larger than the resolution in screen
+    // coordinates.
+    // The orginal WIDTH and HEIGHT variables will not work.
+    // The host reports the resolution of the surface in pixels, e.g. with
+    // glfwGetFramebufferSize for a GLFW window.
+    if (capabilities.currentExtent.width !=
+        std::numeric_limits<uint32_t>::max()) {
+        return capabilities.currentExtent;
+    }
+
+    VkExtent2D actual_extent = surface_source.get_extent();
+
+    actual_extent.width =
+        std::clamp(actual_extent.width, capabilities.minImageExtent.width,
+                   capabilities.maxImageExtent.width);
+
+    actual_extent.height =
+        std::clamp(actual_extent.height, capabilities.minImageExtent.height,
+                   capabilities.maxImageExtent.height);
+
+    return actual_extent;
+}
+
+template <typename Config>
+void Renderer<Config>::CreateSwapChain() {
+    SwapChainSupportDetails swap_chain_support =
+        QuerySwapChainSupport(physical_device);
+    VkSurfaceFormatKHR surface_format =
+        ChooseSwapSurfaceFormat(swap_chain_support.formats);
+    present_mode = ChooseSwapPresentMode(swap_chain_support.present_modes);
+    VkExtent2D extent = ChooseSwapExtent(swap_chain_support.capabilities);
+
+    // Decide how many images the program would like to have in the swap chain.
+    // Request one more image than the minimum to prevent waiting on the driver
+    // to complete internal operations before we can get another image to render
+    // to.
+    uint32_t image_count = swap_chain_support.capabilities.minImageCount + 1;
+
+    // Make sure the program does not exceed the maximum number of images while
+    // doing this. 0 means there is no maximum.
+    if (swap_chain_support.capabilities.maxImageCount > 0 &&
+        image_count > swap_chain_support.capabilities.maxImageCount) {
+        image_count = swap_chain_support.capabilities.maxImageCount;
+    }
+
+    // Specify the details of the swap chain
+    VkSwapchainCreateInfoKHR create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+    create_info.surface = surface;
+
+    // Specify the details of the swap chain images
+    create_info.minImageCount = image_count;
+    create_info.imageFormat = surface_format.format;
+    create_info.imageColorSpace = surface_format.colorSpace;
+    create_info.imageExtent = extent;
+    create_info.imageArrayLayers = 1;
+    create_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
+    // With post-processing the swap chain image is written by the last stage
+    // or by a blit
+    if (PostProcessing()) {
+        VkFormatProperties format_properties{};
+        vkGetPhysicalDeviceFormatProperties(
+            physical_device, surface_format.format, &format_properties);
+        VkImageUsageFlags supported_usage =
+            swap_chain_support.capabilities.supportedUsageFlags;
+
+        post_storage_output =
+            storage_write_without_format &&
+            (supported_usage & VK_IMAGE_USAGE_STORAGE_BIT) != 0 &&
+            (format_properties.optimalTilingFeatures &
+             VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+
+        if (post_storage_output) {
+            create_info.imageUsage |= VK_IMAGE_USAGE_STORAGE_BIT;
+        } else if ((supported_usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT) != 0 &&
+                   (format_properties.optimalTilingFeatures &
+                    VK_FORMAT_FEATURE_BLIT_DST_BIT) != 0) {
+            create_info.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        } else {
+            throw std::runtime_error(
+                "vkCreateSwapchainKHR Error: the swap chain images can not be "
+                "written by the post-processing!");
+        }
+    }
+
+    // Handle swap chain images that will be used across multiple queue
+    // families.
+    //
+    // VK_SHARING_MODE_EXCLUSIVE: An image is owned by one queue family at a
+    // time and this requires explicit ownership tranfers. This option offers
+    // the best performance.
+    //
+    // VK_SHARING_MODE_CONCURRENT: Images can be used across multiple queue
+    // faimilies without explicit onwership tranfers.
+
+    QueueFamilyIndices indices = FindQueueFamilies(physical_device);
+
+    std::array<uint32_t, 2> queue_family_indices = {0};
+
+    if (indices.graphics_family.has_value() &&
+        indices.present_family.has_value()) {
+        queue_family_indices[0] = indices.graphics_family.value();
+        queue_family_indices[1] = indices.present_family.value();
+    } else {
+        throw std::runtime_error(
+            "Indices's graphics and present Families contain no value!");
+    }
+
+    if (indices.graphics_family != indices.present_family) {
+        create_info.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+        create_info.queueFamilyIndexCount = 2;
+        create_info.pQueueFamilyIndices = queue_family_indices.data();
+    } else {
+        create_info.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        create_info.queueFamilyIndexCount = 0;      // Optional
+        create_info.pQueueFamilyIndices = nullptr;  // Optional
+    }
+
+    // Specify the transformation to be applied to images in the
+    // swap chain if it is supported
+    create_info.preTransform = swap_chain_support.capabilities.currentTransform;
+
+    // Specify if the alpha channel should be used for blending with other
+    // windows in the window system. It is a good idea to ignore the alpha
+    // channel via VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR.
+    create_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+
+    // Specify the presentation engine.
+    // Enabling clipping provides the program the best performace.
+    create_info.presentMode = present_mode;
+    create_info.clipped = VK_TRUE;
+
+    // Existing non-retried swapchain currently associated with the surface
+    create_info.oldSwapchain = VK_NULL_HANDLE;
+
+    // Create the swap chain
+    if (vkCreateSwapchainKHR(device, &create_info, nullptr, &swap_chain) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateSwapchainKHR Error: failed to create swap chain!");
+    }
+
+    // Retrieve the swap chain images
+    // 1. First query the final number of images via vkGetSwapchainImagesKHR.
+    // 2. Resize the container.
+    // 3. Retrieve the handles via the vkGetSwapchainImagesKHR again.
+    vkGetSwapchainImagesKHR(device, swap_chain, &image_count, nullptr);
+    swap_chain_images.resize(image_count);
+    vkGetSwapchainImagesKHR(device, swap_chain, &image_count,
+                            swap_chain_images.data());
+
+    if constexpr (Config::DEBUG_LABELS) {
+        for (size_t i = 0; i < swap_chain_images.size(); i++) {
+            std::string name = "Swap chain image " + std::to_string(i);
+            NameObject(swap_chain_images[i], VK_OBJECT_TYPE_IMAGE,
+                       name.c_str());
+        }
+    }
+
+    // Store the format and extent for the swap chain images
+    swap_chain_image_format = surface_format.format;
+    swap_chain_extent = extent;
+
+    // Present ids of earlier swap chains can not be waited on
+    swap_chain_first_present_id = present_id + 1;
+}
+
+template <typename Config>
+void Renderer<Config>::CreateImageViews() {
+    swap_chain_image_views.resize(swap_chain_images.size());
+
+    for (size_t i = 0; i < swap_chain_images.size(); i++) {
+        swap_chain_image_views[i] = CreateImageView(
+            swap_chain_images[i], swap_chain_image_format,
+            VK_IMAGE_ASPECT_COLOR_BIT);
+    }
+}
+
+template <typename Config>
+VkImageView Renderer<Config>::CreateImageView(
+    VkImage image, VkFormat format, VkImageAspectFlags aspect_flags) {
+    // Parameters for image view creation
+    VkImageViewCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    create_info.image = image;
+
+    // Specify how the image data should be interpreted
+    create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    create_info.format = format;
+
+    // Swizzle the color channels around
+    create_info.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+    create_info.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+    create_info.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+    create_info.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+
+    // The subresource describes the image's purpose
+    // and which part of the image should be accessed.
+    //
+    // The images will be used as attachments without
+    // any mipmapping levels or multiple layers.
+    create_info.subresourceRange.aspectMask = aspect_flags;
+    create_info.subresourceRange.baseMipLevel = 0;
+    create_info.subresourceRange.levelCount = 1;
+    create_info.subresourceRange.baseArrayLayer = 0;
+    create_info.subresourceRange.layerCount = 1;
+
+    // Create the image view
+    VkImageView image_view = VK_NULL_HANDLE;
+    if (vkCreateImageView(device, &create_info, nullptr, &image_view) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateImageView Error: failed to create image views!");
+    }
+
+    return image_view;
+}
+
+template <typename Config>
+void Renderer<Config>::UploadToBuffer(const void* data, VkDeviceSize size,
+                                      VkBuffer buffer,
+                                      VkDeviceSize buffer_offset) {
+    UploadToBuffer(size, buffer, buffer_offset, [&](uint8_t* staging) {
+        std::memcpy(staging, data, static_cast<size_t>(size));
+    });
+}
+
+template <typename Config>
+void Renderer<Config>::UploadToBuffer(
+    VkDeviceSize size, VkBuffer buffer, VkDeviceSize buffer_offset,
+    const std::function<void(uint8_t*)>& fill_staging) {
+    /* Staging path: the data is written into a host visible buffer, then
+    copied on the GPU into the device local buffer and the copy waited for */
+    VkBuffer staging_buffer = VK_NULL_HANDLE;
+    VkDeviceMemory staging_memory = VK_NULL_HANDLE;
+    memory_allocator->CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                       VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                   staging_buffer, staging_memory,
+                                   "mesh staging");
+    NameObject(staging_buffer, VK_OBJECT_TYPE_BUFFER, "Mesh staging");
+
+    void* mapped = nullptr;
+    vkMapMemory(device, staging_memory, 0, size, 0, &mapped);
+    fill_staging(static_cast<uint8_t*>(mapped));
+    vkUnmapMemory(device, staging_memory);
+
+    // One time command buffer of the load pool
+    VkCommandBufferAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    alloc_info.commandPool = load_command_pool;
+    alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    alloc_info.commandBufferCount = 1;
+
+    VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+    if (vkAllocateCommandBuffers(device, &alloc_info, &command_buffer) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkAllocateCommandBuffers Error: failed to allocate upload command "
+            "buffer!");
+    }
+    NameObject(command_buffer, VK_OBJECT_TYPE_COMMAND_BUFFER, "Mesh upload");
+
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(command_buffer, &begin_info);
+
+    VkBufferCopy copy_region{};
+    copy_region.srcOffset = 0;
+    copy_region.dstOffset = buffer_offset;
+    copy_region.size = size;
+    vkCmdCopyBuffer(command_buffer, staging_buffer, buffer, 1, &copy_region);
+
+    vkEndCommandBuffer(command_buffer);
+
+    // Wait for this copy only, not for the frames in flight
+    VkFenceCreateInfo fence_info{};
+    fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    VkFence fence = VK_NULL_HANDLE;
+    if (vkCreateFence(device, &fence_info, nullptr, &fence) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateFence Error: failed to create upload fence!");
+    }
+
+    VkSubmitInfo submit_info{};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &command_buffer;
+
+    if (vkQueueSubmit(graphics_queue, 1, &submit_info, fence) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkQueueSubmit Error: failed to submit upload command buffer!");
+    }
+
+    vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
+
+    vkDestroyFence(device, fence, nullptr);
+    vkFreeCommandBuffers(device, load_command_pool, 1, &command_buffer);
+    vkDestroyBuffer(device, staging_buffer, nullptr);
+    memory_allocator->Free(staging_memory);
+}
+
+template <typename Config>
+void Renderer<Config>::CreateImage(uint32_t width, uint32_t height,
+                                   VkSampleCountFlagBits samples,
+                                   VkFormat format, VkImageTiling tiling,
+                                   VkImageUsageFlags usage,
+                                   VkMemoryPropertyFlags properties,
+                                   VkImage& image,
+                                   VkDeviceMemory& image_memory) {
+    // Describe a 2D image without mipmapping levels or multiple layers
+    VkImageCreateInfo image_info{};
+    image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.extent.width = width;
+    image_info.extent.height = height;
+    image_info.extent.depth = 1;
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = 1;
+    image_info.format = format;
+    image_info.tiling = tiling;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image_info.usage = usage;
+    image_info.samples = samples;
+    image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateImage(device, &image_info, nullptr, &image) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateImage Error: failed to create image!");
+    }
+
+    // Allocate memory that fits the requirements of the image and bind it
+    VkMemoryRequirements memory_requirements;
+    vkGetImageMemoryRequirements(device, image, &memory_requirements);
+
+    // Lazily allocated memory is only a hint, tiled GPUs have it for
+    // transient attachments, other devices fall back to plain memory
+    if ((properties & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0 &&
+        !memory_allocator->HasMemoryType(memory_requirements.memoryTypeBits,
+                                         properties)) {
+        properties &= ~VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+    }
+
+    image_memory =
+        memory_allocator->Allocate(memory_requirements, properties, "image");
+    vkBindImageMemory(device, image, image_memory, 0);
+}
+
+template <typename Config>
+VkSampleCountFlagBits Renderer<Config>::GetMaxUsableSampleCount() {
+    /* The color attachment supports the sample counts of the framebuffer
+    color limits, pick the highest one */
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physical_device, &properties);
+
+    VkSampleCountFlags counts = properties.limits.framebufferColorSampleCounts;
+
+    for (VkSampleCountFlagBits sample_count :
+         {VK_SAMPLE_COUNT_64_BIT, VK_SAMPLE_COUNT_32_BIT,
+          VK_SAMPLE_COUNT_16_BIT, VK_SAMPLE_COUNT_8_BIT, VK_SAMPLE_COUNT_4_BIT,
+          VK_SAMPLE_COUNT_2_BIT}) {
+        if ((counts & sample_count) != 0) {
+            return sample_count;
+        }
+    }
+
+    return VK_SAMPLE_COUNT_1_BIT;
+}
+
+template <typename Config>
+VkSampleCountFlagBits Renderer<Config>::ChooseSampleCount() {
+    // The G-buffer is read per pixel by the lighting subpass, so the
+    // deferred path renders with one sample
+    if (DeferredShading()) {
+        return VK_SAMPLE_COUNT_1_BIT;
+    }
+
+    // The depth pyramid is built from the depth attachment, which has to
+    // have one sample per pixel to be sampled
+    if (OcclusionCulling()) {
+        return VK_SAMPLE_COUNT_1_BIT;
+    }
+
+    // Use the configured sample count if the device supports it, the sample
+    // count flag bits are ordered by their number of samples
+    return std::min(SampleCount(), GetMaxUsableSampleCount());
+}
+
+template <typename Config>
+void Renderer<Config>::CreateColorResources() {
+    /* Multisampled color target
+    The swap chain images have one sample per pixel, so the scene is rendered
+    into a multisampled image that is resolved into the swap chain image at
+    the end of the render pass. The image is only used within the render
+    pass, so it is a transient attachment that tiled GPUs never have to back
+    with memory. */
+    if (msaa_samples == VK_SAMPLE_COUNT_1_BIT) {
+        return;
+    }
+
+    CreateImage(swap_chain_extent.width, swap_chain_extent.height,
+                msaa_samples, SceneFormat(), VK_IMAGE_TILING_OPTIMAL,
+                VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT |
+                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                    VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
+                color_image, color_image_memory);
+    NameObject(color_image, VK_OBJECT_TYPE_IMAGE, "Multisampled color");
+    color_image_view = CreateImageView(color_image, SceneFormat(),
+                                       VK_IMAGE_ASPECT_COLOR_BIT);
+}
+
+template <typename Config>
+void Renderer<Config>::CreatePostResources() {
+    /* Post-processing targets
+    The scene is rendered or resolved to the first image, the stages read
+    and write both as storage images and the result may be blitted from
+    either. Their contents do not outlive a frame, so both frames in flight
+    share them like the depth attachment. */
+    if (!PostProcessing()) {
+        return;
+    }
+
+    const std::array<const char*, 2> names = {"Post-processing scene",
+                                              "Post-processing scratch"};
+    for (size_t i = 0; i < post_images.size(); i++) {
+        AttachmentImage& post_image = post_images[i];
+        CreateImage(swap_chain_extent.width, swap_chain_extent.height,
+                    VK_SAMPLE_COUNT_1_BIT, POST_IMAGE_FORMAT,
+                    VK_IMAGE_TILING_OPTIMAL,
+                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                        VK_IMAGE_USAGE_STORAGE_BIT |
+                        VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, post_image.image,
+                    post_image.memory);
+        NameObject(post_image.image, VK_OBJECT_TYPE_IMAGE, names[i]);
+        post_image.view = CreateImageView(post_image.image, POST_IMAGE_FORMAT,
+                                          VK_IMAGE_ASPECT_COLOR_BIT);
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CreateGBuffer() {
+    /* G-buffer of the deferred path
+    The scene writes the albedo and the normal in the first subpass, the
+    lighting subpass reads them as input attachments. Neither is loaded or
+    stored, so on tiled GPUs they stay in tile memory and their lazily
+    allocated memory is never committed. */
+    if (!DeferredShading()) {
+        return;
+    }
+
+    const std::array<VkFormat, 2> formats = {GBUFFER_ALBEDO_FORMAT,
+                                             GBUFFER_NORMAL_FORMAT};
+    const std::array<const char*, 2> names = {"G-buffer albedo",
+                                              "G-buffer normal"};
+    for (size_t i = 0; i < gbuffer_images.size(); i++) {
+        AttachmentImage& gbuffer_image = gbuffer_images[i];
+        CreateImage(swap_chain_extent.width, swap_chain_extent.height,
+                    VK_SAMPLE_COUNT_1_BIT, formats[i], VK_IMAGE_TILING_OPTIMAL,
+                    VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT |
+                        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                        VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
+                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                        VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
+                    gbuffer_image.image, gbuffer_image.memory);
+        NameObject(gbuffer_image.image, VK_OBJECT_TYPE_IMAGE, names[i]);
+        gbuffer_image.view = CreateImageView(gbuffer_image.image, formats[i],
+                                             VK_IMAGE_ASPECT_COLOR_BIT);
+    }
+
+    VkMemoryRequirements memory_requirements;
+    vkGetImageMemoryRequirements(device, gbuffer_images[0].image,
+                                 &memory_requirements);
+    gbuffer_lazily_allocated =
+        memory_allocator->HasMemoryType(
+            memory_requirements.memoryTypeBits,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+}
+
+template <typename Config>
+VkFormat Renderer<Config>::FindDepthFormat() {
+    /* The most precise depth format the device can render to with optimal
+    tiling, the stencil formats only in case the device has no pure depth
+    format. D16_UNORM is supported by every device. The depth pyramid of the
+    occlusion culling samples the depth attachment. */
+    VkFormatFeatureFlags features =
+        VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    if (OcclusionCulling()) {
+        features |= VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+    }
+
+    for (VkFormat format :
+         {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT,
+          VK_FORMAT_X8_D24_UNORM_PACK32, VK_FORMAT_D24_UNORM_S8_UINT,
+          VK_FORMAT_D16_UNORM}) {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(physical_device, format,
+                                            &properties);
+
+        if ((properties.optimalTilingFeatures & features) == features) {
+            return format;
+        }
+    }
+
+    throw std::runtime_error(
+        "vkGetPhysicalDeviceFormatProperties Error: failed to find a depth "
+        "format!");
+}
+
+template <typename Config>
+void Renderer<Config>::CreateDepthResources() {
+    /* Depth target
+    The depth is only needed within the render pass, it is cleared at the
+    start and not stored, so it is a transient attachment with the sample
+    count of the color attachment. The lighting subpass of the deferred path
+    reads it as an input attachment. With occlusion culling the depth is
+    stored and sampled by the depth pyramid pass, so it is a regular image
+    then. */
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT |
+                              VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                                       VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+    if (DeferredShading()) {
+        usage |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+    }
+    if (OcclusionCulling()) {
+        usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                VK_IMAGE_USAGE_SAMPLED_BIT;
+        properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    }
+
+    CreateImage(swap_chain_extent.width, swap_chain_extent.height,
+                msaa_samples, depth_format, VK_IMAGE_TILING_OPTIMAL, usage,
+                properties, depth_image, depth_image_memory);
+    NameObject(depth_image, VK_OBJECT_TYPE_IMAGE, "Depth");
+    depth_image_view = CreateImageView(depth_image, depth_format,
+                                       VK_IMAGE_ASPECT_DEPTH_BIT);
+
+    if (occlusion_culler != nullptr) {
+        occlusion_culler->CreatePyramid(swap_chain_extent);
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CreateGraphicsPipeline() {
+    // Retreive the vertex and fragment shader code. The deferred path
+    // writes the G-buffer, the forward path shades every fragment with the
+    // scene lights if there are any.
+    std::string frag_shader_file = "shaders/frag.spv";
+    if (DeferredShading()) {
+        frag_shader_file = "shaders/gbuffer_frag.spv";
+    } else if (scene_lights != nullptr) {
+        frag_shader_file = "shaders/lit_frag.spv";
+    }
+
+    const auto& vert_shader_code = GetShaderCode("shaders/vert.spv");
+    const auto& frag_shader_code = GetShaderCode(frag_shader_file);
+
+    // Create shader modules
+    VkShaderModule vert_shader_module = CreateShaderModule(vert_shader_code);
+    VkShaderModule frag_shader_module = CreateShaderModule(frag_shader_code);
+
+    // Fill in the information for the pipeline layout. The forward lit
+    // scene reads the lights from set 0.
+    VkDescriptorSetLayout light_set_layout =
+        scene_lights != nullptr ? scene_lights->GetSetLayout()
+                                : VK_NULL_HANDLE;
+    bool forward_lit = scene_lights != nullptr && !DeferredShading();
+
+    VkPipelineLayoutCreateInfo pipeline_layout_info;
+    pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipeline_layout_info.setLayoutCount = forward_lit ? 1 : 0;
+    pipeline_layout_info.pSetLayouts =
+        forward_lit ? &light_set_layout : nullptr;
+    pipeline_layout_info.pushConstantRangeCount = 0;     // Optional
+    pipeline_layout_info.pPushConstantRanges = nullptr;  // Optional
+    pipeline_layout_info.flags =
+        VK_PIPELINE_LAYOUT_CREATE_INDEPENDENT_SETS_BIT_EXT;
+    pipeline_layout_info.pNext = NULL;
+
+    // Create pipeline layout
+    if (vkCreatePipelineLayout(device, &pipeline_layout_info, nullptr,
+                               &pipeline_layout) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreatePipelineLayout Error: failed to create pipeline layout!");
+    }
+
+    // The single pass pipeline is always created, it is the fallback of
+    // the pre-pass pipelines
+    graphics_pipeline = CreatePipeline(vert_shader_module, frag_shader_module,
+                                       pipeline_cache, DepthPass::SINGLE);
+    NameObject(graphics_pipeline, VK_OBJECT_TYPE_PIPELINE, "Scene");
+
+    // The occlusion queries draw the scene depth only against the finished
+    // depth buffer
+    if (OcclusionCulling()) {
+        occlusion_proxy_pipeline =
+            CreatePipeline(vert_shader_module, frag_shader_module,
+                           pipeline_cache, DepthPass::PROXY);
+        NameObject(occlusion_proxy_pipeline, VK_OBJECT_TYPE_PIPELINE,
+                   "Occlusion proxy");
+    }
+
+    // With a pre-pass the depth is already complete when the scene is
+    // shaded. The pre-pass is skipped until its pipeline is compiled.
+    if (options.depth_prepass) {
+        prepass_pipeline_request =
+            RequestPipeline("Depth pre-pass", vert_shader_code, {},
+                            DepthPass::PRE_PASS, VK_NULL_HANDLE);
+        shading_pipeline_request =
+            RequestPipeline("Scene after the pre-pass", vert_shader_code,
+                            frag_shader_code, DepthPass::SHADING,
+                            graphics_pipeline);
+    }
+
+    // Destroy shader modules
+    vkDestroyShaderModule(device, frag_shader_module, nullptr);
+    vkDestroyShaderModule(device, vert_shader_module, nullptr);
+}
+
+template <typename Config>
+PipelineCompiler::Handle Renderer<Config>::RequestPipeline(
+    const std::string& name, std::vector<char> vert_code,
+    std::vector<char> frag_code, DepthPass depth_pass, VkPipeline fallback) {
+    /* The worker creates its own shader modules from the code, so the
+    caller does not have to keep them until the compilation is done. Only
+    the device, the layout, the render pass and the cache are shared, they
+    live until the compiler is destroyed. */
+    auto compile = [this, vert_code = std::move(vert_code),
+                    frag_code = std::move(frag_code), depth_pass]() {
+        VkShaderModule vert_shader_module = CreateShaderModule(vert_code);
+        VkShaderModule frag_shader_module =
+            frag_code.empty() ? VK_NULL_HANDLE : CreateShaderModule(frag_code);
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        try {
+            pipeline = CreatePipeline(vert_shader_module, frag_shader_module,
+                                      pipeline_cache, depth_pass);
+        } catch (const std::exception&) {
+            vkDestroyShaderModule(device, frag_shader_module, nullptr);
+            vkDestroyShaderModule(device, vert_shader_module, nullptr);
+            throw;
+        }
+
+        vkDestroyShaderModule(device, frag_shader_module, nullptr);
+        vkDestroyShaderModule(device, vert_shader_module, nullptr);
+        return pipeline;
+    };
+
+    return pipeline_compiler->Request(name, std::move(compile), fallback);
+}
+
+template <typename Config>
+void Renderer<Config>::DiscardPrepassPipelines() {
+    for (auto* request :
+         {&prepass_pipeline_request, &shading_pipeline_request}) {
+        if (request->has_value()) {
+            pipeline_compiler->Discard(request->value());
+            request->reset();
+        }
+    }
+
+    depth_prepass_pipeline = VK_NULL_HANDLE;
+    depth_shading_pipeline = VK_NULL_HANDLE;
+}
+
+template <typename Config>
+void Renderer<Config>::PublishPipelines() {
+    /* Called at the start of a frame, before it is recorded */
+    if (pipeline_compiler->PublishReady() == 0) {
+        return;
+    }
+
+    // The pre-pass and the shading after it only work together. The
+    // requests are kept, so a rebuild of the render pass can discard them.
+    if (depth_prepass_pipeline == VK_NULL_HANDLE &&
+        prepass_pipeline_request.has_value() &&
+        pipeline_compiler->IsReady(prepass_pipeline_request.value()) &&
+        pipeline_compiler->IsReady(shading_pipeline_request.value())) {
+        depth_prepass_pipeline =
+            pipeline_compiler->Get(prepass_pipeline_request.value());
+        depth_shading_pipeline =
+            pipeline_compiler->Get(shading_pipeline_request.value());
+
+        NameObject(depth_prepass_pipeline, VK_OBJECT_TYPE_PIPELINE,
+                   "Depth pre-pass");
+        NameObject(depth_shading_pipeline, VK_OBJECT_TYPE_PIPELINE,
+                   "Scene after the pre-pass");
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CreateParticleSystem(uint32_t capacity) {
+    particle_system = std::make_unique<ParticleSystem>(
+        device, *memory_allocator, capacity, Config::MAX_FRAMES_IN_FLIGHT);
+
+    // The particles are shaded with the fragment shader of the scene
+    VkShaderModule simulation_shader_module =
+        CreateShaderModule(GetShaderCode("shaders/particles_comp.spv"));
+    VkShaderModule vert_shader_module =
+        CreateShaderModule(GetShaderCode("shaders/particle_vert.spv"));
+    VkShaderModule frag_shader_module =
+        CreateShaderModule(GetShaderCode("shaders/frag.spv"));
+
+    particle_system->CreatePipelines(
+        render_pass, ColorSubpass(), msaa_samples, pipeline_cache,
+        simulation_shader_module, vert_shader_module, frag_shader_module);
+
+    vkDestroyShaderModule(device, frag_shader_module, nullptr);
+    vkDestroyShaderModule(device, vert_shader_module, nullptr);
+    vkDestroyShaderModule(device, simulation_shader_module, nullptr);
+
+    if constexpr (Config::DEBUG_LABELS) {
+        particle_system->SetDebugNames(debug_utils);
+    }
+
+    particle_time = std::chrono::steady_clock::now();
+    particle_frame_count = 0;
+    particle_alive_sum = 0;
+}
+
+template <typename Config>
+void Renderer<Config>::DestroyParticleSystem() {
+    if (particle_system != nullptr) {
+        particle_system->Destroy();
+        particle_system.reset();
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CreateHud() {
+    hud = std::make_unique<PerformanceHud>(device, *memory_allocator,
+                                           Config::MAX_FRAMES_IN_FLIGHT);
+
+    VkShaderModule vert_shader_module =
+        CreateShaderModule(GetShaderCode("shaders/hud_vert.spv"));
+    VkShaderModule frag_shader_module =
+        CreateShaderModule(GetShaderCode("shaders/hud_frag.spv"));
+
+    hud->CreatePipeline(render_pass, ColorSubpass(), msaa_samples,
+                        pipeline_cache, vert_shader_module,
+                        frag_shader_module);
+
+    vkDestroyShaderModule(device, frag_shader_module, nullptr);
+    vkDestroyShaderModule(device, vert_shader_module, nullptr);
+
+    if constexpr (Config::DEBUG_LABELS) {
+        hud->SetDebugNames(debug_utils);
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::DestroyHud() {
+    if (hud != nullptr) {
+        hud->Destroy();
+        hud.reset();
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CreatePostChain() {
+    uint32_t graphics_family =
+        FindQueueFamilies(physical_device).graphics_family.value();
+    post_chain = std::make_unique<PostProcessChain>(
+        physical_device, device, graphics_family, options.post_stages,
+        Config::MAX_FRAMES_IN_FLIGHT);
+
+    std::vector<VkShaderModule> shader_modules;
+    shader_modules.reserve(options.post_stages.size());
+    for (PostStage stage : options.post_stages) {
+        shader_modules.push_back(
+            CreateShaderModule(GetShaderCode(PostStageShaderFile(stage))));
+    }
+
+    // The swap chain image can only be written by the output variant of the
+    // last stage, which needs the feature
+    VkShaderModule output_shader_module = VK_NULL_HANDLE;
+    if (storage_write_without_format) {
+        output_shader_module = CreateShaderModule(GetShaderCode(
+            PostStageOutputShaderFile(options.post_stages.back())));
+    }
+
+    post_chain->CreatePipelines(pipeline_cache, *descriptor_layout_cache,
+                                shader_modules, output_shader_module);
+
+    for (VkShaderModule shader_module : shader_modules) {
+        vkDestroyShaderModule(device, shader_module, nullptr);
+    }
+    vkDestroyShaderModule(device, output_shader_module, nullptr);
+
+    if constexpr (Config::DEBUG_LABELS) {
+        post_chain->SetDebugNames(debug_utils);
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::DestroyPostChain() {
+    if (post_chain != nullptr) {
+        post_chain->Destroy();
+        post_chain.reset();
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CreateOcclusionCuller() {
+    /* The culler draws the configured draws of the scene, a culling set
+    replaces them with its own draws and is not culled by occlusion */
+    occlusion_culler = std::make_unique<OcclusionCuller>(
+        device, *memory_allocator, Config::MAX_FRAMES_IN_FLIGHT,
+        conditional_rendering_supported, multi_draw_indirect_supported);
+
+    VkShaderModule pyramid_shader =
+        CreateShaderModule(GetShaderCode("shaders/depth_pyramid_comp.spv"));
+    VkShaderModule cull_shader =
+        CreateShaderModule(GetShaderCode("shaders/occlusion_cull_comp.spv"));
+
+    occlusion_culler->CreatePipelines(pipeline_cache, *descriptor_layout_cache,
+                                      pyramid_shader, cull_shader);
+
+    vkDestroyShaderModule(device, cull_shader, nullptr);
+    vkDestroyShaderModule(device, pyramid_shader, nullptr);
+
+    occlusion_culler->SetDraws(MakeSceneOcclusionDraws(DrawCount()));
+
+    if constexpr (Config::DEBUG_LABELS) {
+        occlusion_culler->SetDebugNames(debug_utils);
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::DestroyOcclusionCuller() {
+    if (occlusion_culler != nullptr) {
+        occlusion_culler->Destroy();
+        occlusion_culler.reset();
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CreateLighting() {
+    /* The lights are created before the scene pipeline, whose layout has
+    their set in the forward path */
+    if (options.lights > 0) {
+        scene_lights = std::make_unique<SceneLights>(
+            device, *memory_allocator, *descriptor_layout_cache,
+            MakeLightGrid(options.lights));
+
+        if constexpr (Config::DEBUG_LABELS) {
+            scene_lights->SetDebugNames(debug_utils);
+        }
+    }
+
+    if (!DeferredShading()) {
+        return;
+    }
+
+    deferred_lighting = std::make_unique<DeferredLighting>(device);
+
+    VkShaderModule vert_shader_module =
+        CreateShaderModule(GetShaderCode("shaders/lighting_vert.spv"));
+    VkShaderModule frag_shader_module =
+        CreateShaderModule(GetShaderCode("shaders/lighting_frag.spv"));
+
+    deferred_lighting->CreatePipeline(
+        render_pass, pipeline_cache, *descriptor_layout_cache,
+        scene_lights->GetSetLayout(), vert_shader_module, frag_shader_module);
+
+    vkDestroyShaderModule(device, frag_shader_module, nullptr);
+    vkDestroyShaderModule(device, vert_shader_module, nullptr);
+
+    if constexpr (Config::DEBUG_LABELS) {
+        deferred_lighting->SetDebugNames(debug_utils);
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::DestroyLighting() {
+    if (deferred_lighting != nullptr) {
+        deferred_lighting->Destroy();
+        deferred_lighting.reset();
+    }
+
+    if (scene_lights != nullptr) {
+        scene_lights->Destroy();
+        scene_lights.reset();
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::RebuildRenderPass() {
+    /* The pipelines drawn in the render pass are created for it and the
+    attachments change with the shading path, so everything from the render
+    pass on is recreated. The particles restart with their capacity. */
+    std::optional<uint32_t> particle_capacity;
+    if (particle_system != nullptr) {
+        particle_capacity = particle_system->GetCapacity();
+    }
+    bool had_hud = hud != nullptr;
+
+    // The compilations read the layout, the render pass and the cache on the
+    // workers. The pre-pass pipelines were compiled for the old render pass,
+    // the scene is drawn with the graphics pipeline until the new ones are
+    // published.
+    pipeline_compiler->WaitAll();
+    DiscardPrepassPipelines();
+
+    DestroyParticleSystem();
+    DestroyHud();
+    DestroyLighting();
+    DestroyOcclusionCuller();
+    vkDestroyPipeline(device, graphics_pipeline, nullptr);
+    vkDestroyPipeline(device, occlusion_proxy_pipeline, nullptr);
+    occlusion_proxy_pipeline = VK_NULL_HANDLE;
+    vkDestroyPipelineLayout(device, pipeline_layout, nullptr);
+    DestroyRenderPasses();
+
+    msaa_samples = ChooseSampleCount();
+    CreateRenderPass();
+    CreateLighting();
+    CreateGraphicsPipeline();
+
+    // The pyramid is created with the depth attachment
+    if (OcclusionCulling()) {
+        CreateOcclusionCuller();
+    }
+
+    RecreateSwapChain();
+
+    if (particle_capacity.has_value()) {
+        CreateParticleSystem(particle_capacity.value());
+    }
+
+    if (had_hud) {
+        CreateHud();
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CreateTimestampQueries() {
+    /* Timestamps are only written on queues whose family has valid bits,
+    without them the overlay shows no GPU time */
+    uint32_t graphics_family =
+        FindQueueFamilies(physical_device).graphics_family.value();
+
+    uint32_t queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device,
+                                             &queue_family_count, nullptr);
+    std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(
+        physical_device, &queue_family_count, queue_families.data());
+
+    uint32_t valid_bits = queue_families[graphics_family].timestampValidBits;
+    if (valid_bits == 0) {
+        return;
+    }
+
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(physical_device, &properties);
+    timestamp_period = properties.limits.timestampPeriod;
+    timestamp_mask =
+        valid_bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << valid_bits) - 1;
+
+    VkQueryPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    pool_info.queryCount = 2 * Config::MAX_FRAMES_IN_FLIGHT;
+
+    if (vkCreateQueryPool(device, &pool_info, nullptr,
+                          &timestamp_query_pool) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateQueryPool Error: failed to create timestamp query "
+            "pool!");
+    }
+}
+
+template <typename Config>
+double Renderer<Config>::ReadGpuFrameTime(uint32_t frame) {
+    if (timestamp_query_pool == VK_NULL_HANDLE) {
+        return -1.0;
+    }
+
+    // The fence of the frame slot was signaled, the results of its last
+    // submission are available. A slot that was not submitted yet returns
+    // VK_NOT_READY.
+    std::array<uint64_t, 2> timestamps{};
+    if (vkGetQueryPoolResults(device, timestamp_query_pool, 2 * frame, 2,
+                              sizeof(timestamps), timestamps.data(),
+                              sizeof(uint64_t),
+                              VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+        return -1.0;
+    }
+
+    uint64_t ticks = (timestamps[1] - timestamps[0]) & timestamp_mask;
+    return static_cast<double>(ticks) * timestamp_period / 1000000.0;
+}
+
+template <typename Config>
+void Renderer<Config>::MeasureFrameTimings() {
+    auto now = std::chrono::steady_clock::now();
+    frame_timings.frame_ms =
+        std::chrono::duration<double, std::milli>(now - timing_frame_start)
+            .count();
+    frame_timings.gpu_ms = ReadGpuFrameTime(current_frame);
+    timing_frame_start = now;
+
+    if (metrics != nullptr) {
+        metrics->frame_time.Observe(frame_timings.frame_ms / 1000.0);
+        if (frame_timings.gpu_ms >= 0.0) {
+            metrics->gpu_time.Observe(frame_timings.gpu_ms / 1000.0);
+        }
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::UpdateMemoryBudget() {
+    /* Poll the budget, the pressure callbacks run inside */
+    memory_budget->Update();
+
+    if (metrics == nullptr || !memory_budget->IsSupported()) {
+        return;
+    }
+
+    const auto& heaps = memory_budget->GetHeaps();
+    size_t heap_count = std::min(heaps.size(), METRICS_MAX_HEAPS);
+    for (size_t i = 0; i < heap_count; i++) {
+        metrics->heap_budget_bytes[i].store(heaps[i].budget,
+                                            std::memory_order_relaxed);
+        metrics->heap_usage_bytes[i].store(heaps[i].usage,
+                                           std::memory_order_relaxed);
+    }
+    metrics->heap_count.store(heap_count, std::memory_order_relaxed);
+    metrics->memory_pressure.store(
+        static_cast<uint64_t>(memory_budget->GetPressure()),
+        std::memory_order_relaxed);
+}
+
+template <typename Config>
+void Renderer<Config>::RespondToMemoryPressure(MemoryPressure pressure) {
+    /* Textures loaded under pressure leave out their largest level, under
+    critical pressure their two largest. The textures that are already
+    resident are kept, the application decides which of them to drop. */
+    if (texture_streamer != nullptr) {
+        texture_streamer->SetSkippedMipLevels(static_cast<uint32_t>(pressure));
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::UpdateHud() {
+    HudFrameStats stats = frame_timings;
+    stats.present_mode = present_mode;
+    stats.extent = swap_chain_extent;
+
+    if (memory_budget->IsSupported()) {
+        stats.device_usage = memory_budget->GetDeviceLocalUsage();
+        stats.device_budget = memory_budget->GetDeviceLocalBudget();
+    }
+
+    hud->Update(stats, current_frame);
+}
+
+template <typename Config>
+VkPipeline Renderer<Config>::CreatePipeline(
+    VkShaderModule vert_shader_module, VkShaderModule frag_shader_module,
+    VkPipelineCache cache, DepthPass depth_pass) {
+    // Fill in the structure for the vertex shader
+    VkPipelineShaderStageCreateInfo vert_shader_stage_info{};
+    vert_shader_stage_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    vert_shader_stage_info.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    vert_shader_stage_info.module = vert_shader_module;
+    vert_shader_stage_info.pName = "main";
+
+    // Fill in the structure for the fragment shader
+    VkPipelineShaderStageCreateInfo frag_shader_stage_info{};
+    frag_shader_stage_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    frag_shader_stage_info.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    frag_shader_stage_info.module = frag_shader_module;
+    frag_shader_stage_info.pName = "main";
+
+    // Define an attray that contains these two structures
+    std::array<VkPipelineShaderStageCreateInfo, 2> shader_stages = {
+        vert_shader_stage_info, frag_shader_stage_info};
+
+    // Fill in the information for the vertex input
+    VkPipelineVertexInputStateCreateInfo vertex_input_info{};
+    vertex_input_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertex_input_info.vertexBindingDescriptionCount = 0;
+    vertex_input_info.pVertexBindingDescriptions = nullptr;  // Optional
+    vertex_input_info.vertexAttributeDescriptionCount = 0;
+    vertex_input_info.pVertexAttributeDescriptions = nullptr;  // Optional
+
+    // Fill in the information for the input assembly
+    VkPipelineInputAssemblyStateCreateInfo input_assembly{};
+    input_assembly.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    input_assembly.primitiveRestartEnable = VK_FALSE;
+
+    // Specify viewport and scissor
+    // A viewport describes the reigion of the framebuffer that the output will
+    // be rendered to.
+    //
+    // Difference between Viewport and Scissor
+    // A viewport define the transformation from the image to the framebuffer
+    // A scissor define which regions pixels will actually be stored
+
+    // Fill in the information for viewport state
+    VkPipelineViewportStateCreateInfo viewport_state{};
+    viewport_state.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewport_state.viewportCount = 1;
+    viewport_state.scissorCount = 1;
+
+    // Fill in the information for the rasterizer
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = VK_FALSE;
+    rasterizer.rasterizerDiscardEnable = VK_FALSE;
+    // polygonMode termines how the fragments are generated for geometry.
+    // The following modes are available:
+    // VK_POLYGON_MODE_FILL: fill the area of the polygon with fragments
+    // VK_POLYGON_MODE_LINE: polygon edges are drawn as lines
+    // VK_POLYGON_MODE_POINT: polygon vertices are drawn as points
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0F;
+    // The cullMode varaible determines the type of face culling to use
+    // You can disable culling, cull the front faces, cull the back faces
+    // or both
+    // The frontFace variable specifies the vertex order for faces to be
+    // considered front-facing.
+    // It can be clockwise or counterclockwise
+    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+    rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+    rasterizer.depthBiasEnable = VK_FALSE;
+    rasterizer.depthBiasConstantFactor = 0.0F;  // Optional
+    rasterizer.depthBiasClamp = 0.0F;           // Optional
+    rasterizer.depthBiasSlopeFactor = 0.0F;     // Optional
+
+    // Fill in the information for multisampling
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.sampleShadingEnable = VK_FALSE;
+    multisampling.rasterizationSamples = msaa_samples;
+    multisampling.minSampleShading = 1.0F;           // Optional
+    multisampling.pSampleMask = nullptr;             // Optional
+    multisampling.alphaToCoverageEnable = VK_FALSE;  // Optional
+    multisampling.alphaToOneEnable = VK_FALSE;       // Optional
+
+    // Color blending is when after a fragment shader has returned a color,
+    // it needs to be combined with the color that is already in the
+    // framebuffer.
+
+    // Configure color blending
+    VkPipelineColorBlendAttachmentState color_blend_attachment{};
+    color_blend_attachment.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    if (depth_pass == DepthPass::PRE_PASS || depth_pass == DepthPass::PROXY) {
+        color_blend_attachment.colorWriteMask = 0;
+    }
+    color_blend_attachment.blendEnable = VK_FALSE;
+    color_blend_attachment.srcColorBlendFactor =
+        VK_BLEND_FACTOR_ONE;  // Optional
+    color_blend_attachment.dstColorBlendFactor =
+        VK_BLEND_FACTOR_ZERO;                               // Optional
+    color_blend_attachment.colorBlendOp = VK_BLEND_OP_ADD;  // Optional
+    color_blend_attachment.srcAlphaBlendFactor =
+        VK_BLEND_FACTOR_ONE;  // Optional
+    color_blend_attachment.dstAlphaBlendFactor =
+        VK_BLEND_FACTOR_ZERO;                               // Optional
+    color_blend_attachment.alphaBlendOp = VK_BLEND_OP_ADD;  // Optional
+
+    // The G-buffer subpass of the deferred path writes the albedo and the
+    // normal with the same state
+    std::array<VkPipelineColorBlendAttachmentState, 2>
+        color_blend_attachments = {color_blend_attachment,
+                                   color_blend_attachment};
+
+    // Fill in the information for color blending state
+    VkPipelineColorBlendStateCreateInfo color_blending{};
+    color_blending.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    color_blending.logicOpEnable = VK_FALSE;
+    color_blending.logicOp = VK_LOGIC_OP_COPY;  // Optional
+    color_blending.attachmentCount = DeferredShading() ? 2 : 1;
+    color_blending.pAttachments = color_blend_attachments.data();
+    color_blending.blendConstants[0] = 0.0F;  // Optional
+    color_blending.blendConstants[1] = 0.0F;  // Optional
+    color_blending.blendConstants[2] = 0.0F;  // Optional
+    color_blending.blendConstants[3] = 0.0F;  // Optional
+
+    // Depth test, nearer fragments pass. After a pre-pass the depth buffer
+    // holds the nearest depth already, only the fragments of that depth are
+    // shaded and the depth is not written again.
+    VkPipelineDepthStencilStateCreateInfo depth_stencil{};
+    depth_stencil.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depth_stencil.depthTestEnable = VK_TRUE;
+    depth_stencil.depthWriteEnable = VK_TRUE;
+    depth_stencil.depthCompareOp = VK_COMPARE_OP_LESS;
+    depth_stencil.depthBoundsTestEnable = VK_FALSE;
+    depth_stencil.stencilTestEnable = VK_FALSE;
+
+    if (depth_pass == DepthPass::SHADING) {
+        depth_stencil.depthWriteEnable = VK_FALSE;
+        depth_stencil.depthCompareOp = VK_COMPARE_OP_EQUAL;
+    }
+
+    // The occlusion queries test the draws against the finished depth
+    // buffer, a visible draw passes with the depth it wrote
+    if (depth_pass == DepthPass::PROXY) {
+        depth_stencil.depthWriteEnable = VK_FALSE;
+        depth_stencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+    }
+
+    // Dynamic State
+    // Fill in the dynamic state's information
+    std::vector<VkDynamicState> dynamic_states = {VK_DYNAMIC_STATE_VIEWPORT,
+                                                  VK_DYNAMIC_STATE_SCISSOR};
+
+    VkPipelineDynamicStateCreateInfo dynamic_state{};
+    dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamic_state.dynamicStateCount =
+        static_cast<uint32_t>(dynamic_states.size());
+    dynamic_state.pDynamicStates = dynamic_states.data();
+
+    // Describe the graphics pipeline information
+    VkGraphicsPipelineCreateInfo pipeline_info{};
+    pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    // The depth only passes have no fragment shader, the depth comes from
+    // the rasterizer
+    pipeline_info.stageCount =
+        depth_pass == DepthPass::PRE_PASS || depth_pass == DepthPass::PROXY
+            ? 1
+            : 2;
+    pipeline_info.pStages = shader_stages.data();
+    pipeline_info.pVertexInputState = &vertex_input_info;
+    pipeline_info.pInputAssemblyState = &input_assembly;
+    pipeline_info.pViewportState = &viewport_state;
+    pipeline_info.pRasterizationState = &rasterizer;
+    pipeline_info.pMultisampleState = &multisampling;
+    pipeline_info.pDepthStencilState = &depth_stencil;
+    pipeline_info.pColorBlendState = &color_blending;
+    pipeline_info.pDynamicState = &dynamic_state;
+    pipeline_info.layout = pipeline_layout;
+    pipeline_info.renderPass = render_pass;
+    pipeline_info.subpass = 0;
+    pipeline_info.basePipelineHandle = VK_NULL_HANDLE;  // Optional;
+    pipeline_info.basePipelineIndex = -1;               // Optional
+
+    // Create graphics pipeline
+    // A pipeline cache lets the driver reuse the compiled shaders of a
+    // pipeline that was created before with the same state
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(device, cache, 1, &pipeline_info, nullptr,
+                                  &pipeline) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateGraphicsPipelines Error: failed to create graphics "
+            "pipeline!");
+    }
+
+    return pipeline;
+}
+
+template <typename Config>
+void Renderer<Config>::CreatePipelineCache() {
+    /* The cache of the previous run is only loaded if it was saved for the
+    same shaders, device and driver, otherwise the cache starts empty and is
+    filled by the pipelines created with it */
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(physical_device, &properties);
+
+    uint64_t key = shader_manifest.has_value() ? shader_manifest->GetCacheKey()
+                                               : HashBytes(nullptr, 0);
+    key = HashBytes(&properties.vendorID, sizeof(properties.vendorID), key);
+    key = HashBytes(&properties.deviceID, sizeof(properties.deviceID), key);
+    key = HashBytes(&properties.driverVersion,
+                    sizeof(properties.driverVersion), key);
+    key = HashBytes(properties.pipelineCacheUUID, VK_UUID_SIZE, key);
+    pipeline_cache_key = key;
+
+    // Header of the file: magic, key, then the data of the cache
+    std::vector<char> initial_data;
+    std::ifstream file(PIPELINE_CACHE_FILE, std::ios::binary);
+    uint32_t magic = 0;
+    uint64_t file_key = 0;
+    if (file.read(reinterpret_cast<char*>(&magic), sizeof(magic)) &&
+        file.read(reinterpret_cast<char*>(&file_key), sizeof(file_key)) &&
+        magic == PIPELINE_CACHE_FILE_MAGIC && file_key == pipeline_cache_key) {
+        initial_data.assign(std::istreambuf_iterator<char>(file),
+                            std::istreambuf_iterator<char>());
+    }
+
+    VkPipelineCacheCreateInfo cache_info{};
+    cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cache_info.initialDataSize = initial_data.size();
+    cache_info.pInitialData = initial_data.data();
+    pipeline_cache_loaded_size = initial_data.size();
+
+    if (vkCreatePipelineCache(device, &cache_info, nullptr, &pipeline_cache) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreatePipelineCache Error: failed to create pipeline cache!");
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::SavePipelineCache() {
+    /* Write the cache for the next run, a failure only costs the next run
+    its warm start */
+    size_t data_size = 0;
+    if (vkGetPipelineCacheData(device, pipeline_cache, &data_size, nullptr) !=
+        VK_SUCCESS) {
+        return;
+    }
+
+    std::vector<char> data(data_size);
+    if (vkGetPipelineCacheData(device, pipeline_cache, &data_size,
+                               data.data()) != VK_SUCCESS) {
+        return;
+    }
+
+    std::ofstream file(PIPELINE_CACHE_FILE, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Warning: failed to write " << PIPELINE_CACHE_FILE
+                  << std::endl;
+        return;
+    }
+
+    uint32_t magic = PIPELINE_CACHE_FILE_MAGIC;
+    file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+    file.write(reinterpret_cast<const char*>(&pipeline_cache_key),
+               sizeof(pipeline_cache_key));
+    file.write(data.data(), static_cast<std::streamsize>(data_size));
+}
+
+template <typename Config>
+void Renderer<Config>::LoadShaders() {
+    /* Pre-warm the shaders of the manifest, so no pipeline creation reads
+    from disk. Without a manifest the shaders were compiled by hand and are
+    read when a pipeline needs them. */
+    std::ifstream manifest_file(SHADER_MANIFEST_FILE);
+    if (!manifest_file.is_open()) {
+        return;
+    }
+    manifest_file.close();
+
+    shader_manifest = LoadShaderManifest(SHADER_MANIFEST_FILE);
+
+    for (const auto& variant : shader_manifest->variants) {
+        std::string filename = "shaders/" + variant.file;
+        std::vector<char> code = ReadFile(filename);
+
+        // The size fails fast, the hash catches a rebuild of the same size
+        if (code.size() != variant.size ||
+            Sha256Hex(code.data(), code.size()) != variant.sha256) {
+            throw std::runtime_error(
+                filename +
+                " is out of date with the shader manifest, rebuild the "
+                "Shaders target!");
+        }
+
+        shader_code[filename] = std::move(code);
+    }
+}
+
+template <typename Config>
+const std::vector<char>& Renderer<Config>::GetShaderCode(
+    const std::string& filename) {
+    auto code = shader_code.find(filename);
+    if (code == shader_code.end()) {
+        code = shader_code.emplace(filename, ReadFile(filename)).first;
+    }
+    return code->second;
+}
+
+template <typename Config>
+std::vector<char> Renderer<Config>::ReadFile(const std::string& filename) {
+    // load binary data from a file
+    std::ifstream file(filename, std::ios::ate | std::ios::binary);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("failed to open file: " + filename + "!");
+    }
+
+    // determine the size of the file and allocate a buffer
+    std::streamsize file_size = static_cast<std::streamsize>(file.tellg());
+    std::vector<char> buffer(file_size);
+
+    // seek back to the beginning of the file and read all of the bytes
+    // seekg: sets the position of the next chracter to be extracted
+    // from the input stream
+    file.seekg(0);
+    file.read(buffer.data(), file_size);
+
+    file.close();
+    return buffer;
+}
+
+template <typename Config>
+VkShaderModule Renderer<Config>::CreateShaderModule(
+    const std::vector<char>& code) {
+    // Specify the information for the shader module
+    VkShaderModuleCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    create_info.codeSize = code.size();
+    create_info.pCode = reinterpret_cast<const uint32_t*>(code.data());
+
+    // Create shader module
+    VkShaderModule shader_module = nullptr;
+    if (vkCreateShaderModule(device, &create_info, nullptr, &shader_module) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateShaderModule Error: failed to create shader module!");
+    }
+    return shader_module;
+}
+
+template <typename Config>
+void Renderer<Config>::CreateRenderPass() {
+    // The deferred path has a render pass of its own
+    if (DeferredShading()) {
+        CreateDeferredRenderPass();
+        return;
+    }
+
+    /* Attachement description */
+    // Describe the color buffer attachment represented by one of the images
+    // from the swap chain
+    VkAttachmentDescription color_attachment{};
+    color_attachment.format = SceneFormat();
+    color_attachment.samples = msaa_samples;
+
+    // loadOp and storeOp determine what to do with the data in the attachment
+    // before and after rendering
+    /*
+    The following choices for loadOp:
+    - VK_ATTACHMENT_LOAD_OP_LOAD: Preserve the existing contents of the
+    attachment
+    - VK_ATTACHMENT_LOAD_OP_CLEAR: Clear the values to a constant at the start
+    - VK_ATTACHMENT_LOAD_OP_DONT_CARE: Existing contents are undefined
+    */
+
+    /*
+    The two choices for storeOp:
+    - VK_ATTACHMENT_STORE_OP_STORE: Rendered contents will be stored in memeory
+    and can be read later
+    - VK_ATTACHMENT_STORE_OP_DONT_CARE: Contetns of the framebuffer will be
+    undefined after the rendering operation
+    */
+    color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+    // loadOp and storeOp apply to the color and depth data and stencilLoadOp
+    // and stencilStoreOp apply to the stencil data.
+    color_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    color_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+    // Textures and framebuffers are represented by VkImage objects with a
+    // certain pixel format. However the layout of the pixels in memeory can
+    // change based on what you're trying to do with an image.
+
+    /* Common layouts are:
+    - VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL: Images used as color attachment
+    - VK_IMAGE_LAYOUT_PRESENT_SRC_KHR: Images to be presented in the swap chain
+    - VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL: Images to be used as destinatino for
+    a memory copy operation
+    - VK_IMAGE_LAYOUT_UNDEFINED: we don't care about the layout of the image
+    */
+
+    // The initialLayout specifies which layout the image will contain before
+    // the render pass begins. The finalLayout specifies the layout to
+    // automatically transition to when the render pass finishes.
+    color_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    color_attachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    // A multisampled image can not be presented directly. It is resolved into
+    // the swap chain image, which is the second attachment then, and its own
+    // contents are not needed after the render pass.
+    bool multisampled = msaa_samples != VK_SAMPLE_COUNT_1_BIT;
+
+    VkAttachmentDescription color_attachment_resolve{};
+    color_attachment_resolve.format = SceneFormat();
+    color_attachment_resolve.samples = VK_SAMPLE_COUNT_1_BIT;
+    color_attachment_resolve.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    color_attachment_resolve.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    color_attachment_resolve.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    color_attachment_resolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    color_attachment_resolve.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    color_attachment_resolve.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    // With post-processing the scene image is read and written by the
+    // compute stages instead of being presented
+    if (PostProcessing()) {
+        color_attachment.finalLayout = VK_IMAGE_LAYOUT_GENERAL;
+        color_attachment_resolve.finalLayout = VK_IMAGE_LAYOUT_GENERAL;
+    }
+
+    if (multisampled) {
+        color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        color_attachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    }
+
+    // The depth is cleared at the start and not needed after the render
+    // pass, so it never has to leave the tile memory of tiled GPUs
+    depth_format = FindDepthFormat();
+
+    VkAttachmentDescription depth_attachment{};
+    depth_attachment.format = depth_format;
+    depth_attachment.samples = msaa_samples;
+    depth_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depth_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depth_attachment.finalLayout =
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    /* Subpasses and attachment references */
+    // Describe the color attachement references.
+    // The attachment parameter specifies the attachment to reference by its
+    // index.
+    // The layout specifies which layout we would like the attachment to
+    // have during a subpass VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL layout
+    // gives the best performance.
+    VkAttachmentReference color_attachment_ref{};
+    color_attachment_ref.attachment = 0;
+    color_attachment_ref.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    // Describe the subpass
+    VkSubpassDescription subpass{};
+
+    // Vulkan may support compute subpasses in the future, we have to be
+    // explcit about this being a graphics subpass.
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+    // The index of the attachement in this array is directly referenced from
+    // the fragment shader with the layout(location = 0) out vec4 outColor
+    // directive!
+    /* The other types of attachements that can be referenced by a subpass:
+    - pInputAttachments: Attachements that are read from a shader
+    - pResolveAttachments: Attachments used for multisampling color attachments
+    - pDepthStencilAttachment: Attachment for depth and stencil data
+    - pPreserveAttachments: Attachments that are not used by this subpass, but
+    for which the data must be preserved
+    */
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &color_attachment_ref;
+
+    VkAttachmentReference depth_attachment_ref{};
+    depth_attachment_ref.attachment = 1;
+    depth_attachment_ref.layout =
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    subpass.pDepthStencilAttachment = &depth_attachment_ref;
+
+    VkAttachmentReference color_attachment_resolve_ref{};
+    color_attachment_resolve_ref.attachment = 2;
+    color_attachment_resolve_ref.layout =
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    if (multisampled) {
+        subpass.pResolveAttachments = &color_attachment_resolve_ref;
+    }
+
+    /* Subpass dependencies */
+    VkSubpassDependency dependency{};
+
+    // The two fields specify the indices of the dependency and the
+    // dependent subpass.
+    // The special value VK_SUBPASS_EXTERNAL refers to implicit subpass before
+    // or after the render pass depending on whether it is specifed in
+    // srcSubpass or dstSubpass.
+    // The index 0 refers to the first and only one subpass.
+    // The dstSubpass must always be higher than srcSubpass to prevent cycles in
+    // the dependency graph (unless one of the subpasses is
+    // VK_SUBPASS_EXTERNAL).
+    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass = 0;
+
+    // The two fields specify the operations to wait on and the stages in which
+    // these operations occur. We need to wait for the swap chain to finish
+    // reading from the image before we can access it. This can be accomplished
+    // by waiting on the color attachment output stage itself.
+    // The depth attachment is shared by the frames in flight, so the depth
+    // writes of the previous frame must be done before it is cleared.
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                              VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    // The operations that should wait on this are in the color attachment stage
+    // and involve the writing of the color attachment. These settings will
+    // prevent the transition from happening until it's actually necessary (and
+    // allowed): when we want to start writing colors to it.
+    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                              VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                               VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    // The post-processing images are shared by the frames in flight as well,
+    // the stages and the blit of the previous frame must be done with them
+    // before the scene is rendered again. Its stages read the scene after
+    // the render pass.
+    std::array<VkSubpassDependency, 2> dependencies = {dependency};
+    uint32_t dependency_count = 1;
+
+    if (PostProcessing()) {
+        dependencies[0].srcStageMask |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                                        VK_PIPELINE_STAGE_TRANSFER_BIT;
+        dependencies[0].srcAccessMask |= VK_ACCESS_SHADER_WRITE_BIT;
+
+        dependencies[1].srcSubpass = 0;
+        dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[1].srcStageMask =
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                                       VK_PIPELINE_STAGE_TRANSFER_BIT;
+        dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT |
+                                        VK_ACCESS_SHADER_WRITE_BIT |
+                                        VK_ACCESS_TRANSFER_READ_BIT;
+        dependency_count = 2;
+    }
+
+    /* Render pass */
+    // Describe the informatioon for the render pass
+    std::array<VkAttachmentDescription, 3> attachments = {
+        color_attachment, depth_attachment, color_attachment_resolve};
+
+    VkRenderPassCreateInfo render_pass_info{};
+    render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    render_pass_info.attachmentCount = multisampled ? 3 : 2;
+    render_pass_info.pAttachments = attachments.data();
+    render_pass_info.subpassCount = 1;
+    render_pass_info.pSubpasses = &subpass;
+    render_pass_info.dependencyCount = dependency_count;
+    render_pass_info.pDependencies = dependencies.data();
+
+    if (vkCreateRenderPass(device, &render_pass_info, nullptr, &render_pass) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateRenderPass Error: failed to create render pass!");
+    }
+
+    if (!OcclusionCulling()) {
+        return;
+    }
+
+    /* With occlusion culling the frame is recorded in two halves of the
+    render pass, compatible with the one above, and the depth pyramid is
+    built between them. The first half stores the depth and leaves it
+    readable for the pyramid pass, the second half loads the color and the
+    depth and ends like the render pass above. There is one sample per
+    pixel, see ChooseSampleCount. */
+    std::array<VkAttachmentDescription, 3> first_attachments = attachments;
+    first_attachments[0].finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    first_attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    first_attachments[1].finalLayout =
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+    std::array<VkSubpassDependency, 2> first_dependencies = {dependencies[0]};
+    first_dependencies[1].srcSubpass = 0;
+    first_dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    first_dependencies[1].srcStageMask =
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    first_dependencies[1].srcAccessMask =
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    first_dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    first_dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    render_pass_info.pAttachments = first_attachments.data();
+    render_pass_info.dependencyCount =
+        static_cast<uint32_t>(first_dependencies.size());
+    render_pass_info.pDependencies = first_dependencies.data();
+
+    if (vkCreateRenderPass(device, &render_pass_info, nullptr,
+                           &occlusion_render_passes[0]) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateRenderPass Error: failed to create render pass!");
+    }
+
+    std::array<VkAttachmentDescription, 3> second_attachments = attachments;
+    second_attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    second_attachments[0].initialLayout =
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    second_attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    second_attachments[1].initialLayout =
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+    // The first half wrote the attachments and the pyramid pass read the
+    // depth before the second half writes them again
+    std::array<VkSubpassDependency, 2> second_dependencies = dependencies;
+    second_dependencies[0].srcStageMask =
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    second_dependencies[0].srcAccessMask =
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    second_dependencies[0].dstStageMask =
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    second_dependencies[0].dstAccessMask =
+        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    render_pass_info.pAttachments = second_attachments.data();
+    render_pass_info.dependencyCount = dependency_count;
+    render_pass_info.pDependencies = second_dependencies.data();
+
+    if (vkCreateRenderPass(device, &render_pass_info, nullptr,
+                           &occlusion_render_passes[1]) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateRenderPass Error: failed to create render pass!");
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CreateDeferredRenderPass() {
+    /* Two subpasses: the scene writes the albedo, the normal and the depth
+    in the first one, the lighting subpass reads them as input attachments
+    and writes the color attachment, which the particles and the overlay
+    are drawn over. Only the color attachment is stored, the G-buffer and
+    the depth never leave the tile memory of tiled GPUs. There is one sample
+    per pixel, see ChooseSampleCount. */
+    depth_format = FindDepthFormat();
+
+    // The lighting subpass writes every pixel, so the color is not cleared
+    VkAttachmentDescription color_attachment{};
+    color_attachment.format = SceneFormat();
+    color_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    color_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    color_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    color_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    color_attachment.finalLayout = PostProcessing()
+                                       ? VK_IMAGE_LAYOUT_GENERAL
+                                       : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    VkAttachmentDescription depth_attachment{};
+    depth_attachment.format = depth_format;
+    depth_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depth_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depth_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depth_attachment.finalLayout =
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+    // The albedo is cleared to black, pixels without a triangle stay unlit
+    VkAttachmentDescription albedo_attachment = depth_attachment;
+    albedo_attachment.format = GBUFFER_ALBEDO_FORMAT;
+    albedo_attachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkAttachmentDescription normal_attachment = albedo_attachment;
+    normal_attachment.format = GBUFFER_NORMAL_FORMAT;
+
+    std::array<VkAttachmentDescription, 4> attachments = {
+        color_attachment, depth_attachment, albedo_attachment,
+        normal_attachment};
+
+    /* G-buffer subpass */
+    std::array<VkAttachmentReference, 2> gbuffer_refs = {{
+        {2, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL},
+        {3, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL},
+    }};
+    VkAttachmentReference depth_attachment_ref{
+        1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+    std::array<VkSubpassDescription, 2> subpasses{};
+    VkSubpassDescription& gbuffer_subpass =
+        subpasses[DEFERRED_GBUFFER_SUBPASS];
+    gbuffer_subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    gbuffer_subpass.colorAttachmentCount =
+        static_cast<uint32_t>(gbuffer_refs.size());
+    gbuffer_subpass.pColorAttachments = gbuffer_refs.data();
+    gbuffer_subpass.pDepthStencilAttachment = &depth_attachment_ref;
+
+    /* Lighting subpass, the order of the inputs matches the bindings of
+    shaders/lighting.frag */
+    VkAttachmentReference color_attachment_ref{
+        0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    std::array<VkAttachmentReference, 3> input_refs = {{
+        {2, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+        {3, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+        {1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL},
+    }};
+
+    VkSubpassDescription& lighting_subpass =
+        subpasses[DEFERRED_LIGHTING_SUBPASS];
+    lighting_subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    lighting_subpass.colorAttachmentCount = 1;
+    lighting_subpass.pColorAttachments = &color_attachment_ref;
+    lighting_subpass.inputAttachmentCount =
+        static_cast<uint32_t>(input_refs.size());
+    lighting_subpass.pInputAttachments = input_refs.data();
+
+    /* Subpass dependencies */
+    // The attachments are shared by the frames in flight, the previous frame
+    // must be done with them before they are written again
+    std::vector<VkSubpassDependency> dependencies(3);
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = DEFERRED_GBUFFER_SUBPASS;
+    dependencies[0].srcStageMask =
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[0].srcAccessMask =
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dstStageMask =
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstAccessMask =
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    // The color attachment is written once the swap chain is done reading it
+    dependencies[1].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].dstSubpass = DEFERRED_LIGHTING_SUBPASS;
+    dependencies[1].srcStageMask =
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[1].srcAccessMask = 0;
+    dependencies[1].dstStageMask =
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+    // The lighting reads the pixel the G-buffer subpass wrote, so the
+    // dependency is by region and tiled GPUs do not flush the tile
+    dependencies[2].srcSubpass = DEFERRED_GBUFFER_SUBPASS;
+    dependencies[2].dstSubpass = DEFERRED_LIGHTING_SUBPASS;
+    dependencies[2].srcStageMask =
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[2].srcAccessMask =
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[2].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[2].dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+    dependencies[2].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    // The post-processing stages and the blit of the previous frame must be
+    // done with the scene image, and the stages read it after the render
+    // pass, see CreateRenderPass
+    if (PostProcessing()) {
+        dependencies[1].srcStageMask |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                                        VK_PIPELINE_STAGE_TRANSFER_BIT;
+        dependencies[1].srcAccessMask |= VK_ACCESS_SHADER_WRITE_BIT;
+
+        VkSubpassDependency post_dependency{};
+        post_dependency.srcSubpass = DEFERRED_LIGHTING_SUBPASS;
+        post_dependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+        post_dependency.srcStageMask =
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        post_dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        post_dependency.dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                                       VK_PIPELINE_STAGE_TRANSFER_BIT;
+        post_dependency.dstAccessMask = VK_ACCESS_SHADER_READ_BIT |
+                                        VK_ACCESS_SHADER_WRITE_BIT |
+                                        VK_ACCESS_TRANSFER_READ_BIT;
+        dependencies.push_back(post_dependency);
+    }
+
+    VkRenderPassCreateInfo render_pass_info{};
+    render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    render_pass_info.attachmentCount =
+        static_cast<uint32_t>(attachments.size());
+    render_pass_info.pAttachments = attachments.data();
+    render_pass_info.subpassCount = static_cast<uint32_t>(subpasses.size());
+    render_pass_info.pSubpasses = subpasses.data();
+    render_pass_info.dependencyCount =
+        static_cast<uint32_t>(dependencies.size());
+    render_pass_info.pDependencies = dependencies.data();
+
+    if (vkCreateRenderPass(device, &render_pass_info, nullptr, &render_pass) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateRenderPass Error: failed to create deferred render "
+            "pass!");
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::DestroyRenderPasses() {
+    vkDestroyRenderPass(device, render_pass, nullptr);
+    render_pass = VK_NULL_HANDLE;
+
+    for (VkRenderPass& occlusion_render_pass : occlusion_render_passes) {
+        vkDestroyRenderPass(device, occlusion_render_pass, nullptr);
+        occlusion_render_pass = VK_NULL_HANDLE;
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CreateFramebuffers() {
+    // Resize the container to hold all of the framebuffers
+    swap_chain_framebuffers.resize(swap_chain_image_views.size());
+
+    // iterate through the image views and create the framebuffers from them
+    for (size_t i = 0; i < swap_chain_image_views.size(); i++) {
+        // With multisampling the swap chain image is the resolve attachment.
+        // With post-processing the scene image takes its place.
+        VkImageView scene_view = PostProcessing() ? post_images[0].view
+                                                  : swap_chain_image_views[i];
+        std::array<VkImageView, 4> attachments = {scene_view, depth_image_view};
+        uint32_t attachment_count = 2;
+
+        if (DeferredShading()) {
+            attachments = {scene_view, depth_image_view,
+                           gbuffer_images[0].view, gbuffer_images[1].view};
+            attachment_count = 4;
+        } else if (msaa_samples != VK_SAMPLE_COUNT_1_BIT) {
+            attachments = {color_image_view, depth_image_view, scene_view};
+            attachment_count = 3;
+        }
+
+        // Describe the framebuffer information
+        VkFramebufferCreateInfo framebuffer_info{};
+        framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebuffer_info.renderPass = render_pass;
+        framebuffer_info.attachmentCount = attachment_count;
+        framebuffer_info.pAttachments = attachments.data();
+        framebuffer_info.width = swap_chain_extent.width;
+        framebuffer_info.height = swap_chain_extent.height;
+        framebuffer_info.layers = 1;
+
+        // Create the framebuffer
+        if (vkCreateFramebuffer(device, &framebuffer_info, nullptr,
+                                &swap_chain_framebuffers[i]) != VK_SUCCESS) {
+            throw std::runtime_error(
+                "vkCreateFramebuffer Error: failed to create framebuffer!");
+        }
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CreateCommandPools() {
+    QueueFamilyIndices queue_family_indices =
+        FindQueueFamilies(physical_device);
+
+    /* Possible flags for command pools:
+    - VK_COMMAND_POOL_CREATE_TRANSIENT_BIT: Hint that command buffers are
+    rerecorded with new commands very often. This may change memory allocation
+    behavior.
+    - VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT: Allow command buffers to
+    be rerecorded individually. Without this flag, they all have to be reset
+    together.
+    */
+
+    // Every frame slot has its own pool, which is reset with
+    // vkResetCommandPool instead of resetting each command buffer. Without
+    // VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT the driver can recycle
+    // the memory of the whole pool at once.
+
+    // Describe the pool information
+    VkCommandPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    if (queue_family_indices.graphics_family.has_value()) {
+        pool_info.queueFamilyIndex =
+            queue_family_indices.graphics_family.value();
+    } else {
+        throw std::runtime_error("Graphics family has no value!");
+    }
+
+    // Create the command pools
+    for (auto& frame_command_pool : frame_command_pools) {
+        if (vkCreateCommandPool(device, &pool_info, nullptr,
+                                &frame_command_pool.pool) != VK_SUCCESS) {
+            throw std::runtime_error(
+                "vkCreateCommandPool Error: failed to create command pool!");
+        }
+    }
+
+    // The one time command buffers of loads are freed individually
+    if (vkCreateCommandPool(device, &pool_info, nullptr, &load_command_pool) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateCommandPool Error: failed to create command pool!");
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CreateCommandBuffers() {
+    /* Allocate the command buffer of every frame slot up front, so the first
+    frames do not allocate. More command buffers are allocated on demand by
+    AcquireCommandBuffer. */
+    for (uint32_t frame = 0; frame < Config::MAX_FRAMES_IN_FLIGHT; frame++) {
+        AcquireCommandBuffer(frame);
+        ResetFrameCommandPool(frame);
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::ResetFrameCommandPool(uint32_t frame) {
+    /* Return all command buffers of the frame slot to the initial state with
+    a single call, the fence of the slot must be signaled */
+    FrameCommandPool& frame_command_pool = frame_command_pools[frame];
+
+    if (vkResetCommandPool(device, frame_command_pool.pool, 0) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkResetCommandPool Error: failed to reset command pool!");
+    }
+
+    frame_command_pool.used_count = 0;
+}
+
+template <typename Config>
+VkCommandBuffer Renderer<Config>::AcquireCommandBuffer(uint32_t frame) {
+    /* Hand out the next command buffer of the frame slot, they are reused in
+    the order they were allocated */
+    FrameCommandPool& frame_command_pool = frame_command_pools[frame];
+
+    if (frame_command_pool.used_count <
+        frame_command_pool.command_buffers.size()) {
+        return frame_command_pool
+            .command_buffers[frame_command_pool.used_count++];
+    }
+
+    /* The level parameter specifies if the allocated command bufers are primary
+     * or secondary command buffers.
+     - VK_COMMAND_BUFFER_LEVEL_PRIMARY: Can be submitted to a queue for
+     execution but it cannot be called from the other command buffers.
+     - VK_COMMAND_BUFFER_LEVEL_SECONDARY: Cannot be submitted directly, but it
+     can be called from the primary command buffers.
+     */
+    // Describe the allocation information for the command buffer
+    VkCommandBufferAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    alloc_info.commandPool = frame_command_pool.pool;
+    alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    alloc_info.commandBufferCount = 1;
+
+    // Allocate the command buffer
+    VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+    if (vkAllocateCommandBuffers(device, &alloc_info, &command_buffer) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkAllocateCommandBuffers Error: failed to allocate command "
+            "buffers!");
+    }
+
+    if constexpr (Config::DEBUG_LABELS) {
+        std::string name =
+            "Frame slot " + std::to_string(frame) + " command buffer " +
+            std::to_string(frame_command_pool.command_buffers.size());
+        NameObject(command_buffer, VK_OBJECT_TYPE_COMMAND_BUFFER,
+                   name.c_str());
+    }
+
+    frame_command_pool.command_buffers.push_back(command_buffer);
+    frame_command_pool.used_count++;
+
+    return command_buffer;
+}
+
+template <typename Config>
+void Renderer<Config>::RecordCommandBuffer(
+    VkCommandBuffer command_buffer, uint32_t image_index) {
+    /* Command buffer recording */
+    /* The flags parameter specifies how we're going to use the command buffer.
+    The following flags are available:
+    - VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT: The command buffer wil be
+    rerecorded right after executing it once.
+    - VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT: This is a secondary
+    command buffer that will be entirely within a single render pass.
+    - VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT: The command buffer can be
+    resubmitted while it is also already pending an execution.
+    */
+    // Describe the details about the usage of this specific command buffer
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = 0;                   // Optional
+    begin_info.pInheritanceInfo = nullptr;  // Optional
+
+    // Record the command buffer
+    if (vkBeginCommandBuffer(command_buffer, &begin_info) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkBeginCommandBuffer Error: failed to begin recording command "
+            "buffer!");
+    }
+
+    // The GPU time of the frame starts with its first command
+    if (timestamp_query_pool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(command_buffer, timestamp_query_pool,
+                            2 * current_frame, 2);
+        vkCmdWriteTimestamp(command_buffer,
+                            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                            timestamp_query_pool, 2 * current_frame);
+    }
+
+    // The particles are simulated before the render pass that draws them
+    if (particle_system != nullptr) {
+        DebugLabel label(debug_utils, command_buffer, "Particle simulation",
+                         DEBUG_LABEL_COMPUTE);
+        RecordParticleSimulation(command_buffer);
+    }
+
+    // The configured draws are tested against the depth pyramid of the
+    // previous frame before the render pass, the objects of a culling set
+    // are culled against the frustum instead
+    bool occlusion_culled =
+        occlusion_culler != nullptr && culling_set.Size() == 0;
+    if (occlusion_culled) {
+        DebugLabel label(debug_utils, command_buffer, "Occlusion culling",
+                         DEBUG_LABEL_COMPUTE);
+        occlusion_culler->RecordCull(command_buffer, current_frame,
+                                     OcclusionPhase::FIRST, depth_image_view,
+                                     *frame_descriptors);
+    }
+
+    /* Starting a render pass */
+    // Describe the render pass information
+    VkRenderPassBeginInfo render_pass_info{};
+    render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    render_pass_info.renderPass =
+        occlusion_culled ? occlusion_render_passes[0] : render_pass;
+    render_pass_info.framebuffer = swap_chain_framebuffers[image_index];
+
+    // The two parameters define the size of the render area
+    render_pass_info.renderArea.offset = {0, 0};
+    render_pass_info.renderArea.extent = swap_chain_extent;
+
+    // The two parameters define the clear values to use for
+    // VK_ATTACHMENT_LOAD_OP_CLEAR, which we used as the load operation for the
+    // color attachment. I've defined the clear color to simply be black with
+    // 100% opacity. The depth is cleared to the far plane.
+    // The deferred path clears the albedo and the normal as well.
+    std::array<VkClearValue, 4> clear_values{};
+    clear_values[0].color = {{0.0F, 0.0F, 0.0F, 1.0F}};
+    clear_values[1].depthStencil = {1.0F, 0};
+    clear_values[2].color = {{0.0F, 0.0F, 0.0F, 0.0F}};
+    clear_values[3].color = {{0.5F, 0.5F, 1.0F, 0.0F}};
+    render_pass_info.clearValueCount = DeferredShading() ? 4 : 2;
+    render_pass_info.pClearValues = clear_values.data();
+
+    /* The final parameter defines how the drawing commands within the render
+    pass will be provided. It can have one of the two values:
+    - VK_SUBPASS_CONTENTS_INLINE: The render pass commands will be embedded in
+    the primary command buffer itself and no secondary command buffers will be
+    executed.
+    - VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS: The render pass
+    commands will be executed from the secondary command buffers.
+    */
+
+    // Begin render pass
+    vkCmdBeginRenderPass(command_buffer, &render_pass_info,
+                         VK_SUBPASS_CONTENTS_INLINE);
+
+    /* Basic draw commands */
+    // Set the viewport and scissor state in the command buffer before issuing
+    // the draw command.
+    VkViewport viewport{};
+    viewport.x = 0.0F;
+    viewport.y = 0.0F;
+    viewport.width = static_cast<float>(swap_chain_extent.width);
+    viewport.height = static_cast<float>(swap_chain_extent.height);
+    viewport.minDepth = 0.0F;
+    viewport.maxDepth = 1.0F;
+    vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = swap_chain_extent;
+    vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+
+    // The forward lit scene reads the lights in every fragment
+    if (scene_lights != nullptr && !DeferredShading()) {
+        VkDescriptorSet light_set = scene_lights->GetSet();
+        vkCmdBindDescriptorSets(command_buffer,
+                                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                pipeline_layout, 0, 1, &light_set, 0, nullptr);
+    }
+
+    // The pre-pass fills the depth buffer, then the same draws are shaded.
+    // The viewport and scissor are dynamic state, so they stay set across the
+    // pipeline change.
+    VkPipeline scene_pipeline = graphics_pipeline;
+    if (depth_prepass_pipeline != VK_NULL_HANDLE) {
+        DebugLabel label(debug_utils, command_buffer, "Depth pre-pass",
+                         DEBUG_LABEL_DRAW);
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          depth_prepass_pipeline);
+        RecordDraws(command_buffer);
+        scene_pipeline = depth_shading_pipeline;
+    }
+
+    // Bind the graphics pipeline
+    {
+        DebugLabel label(debug_utils, command_buffer, "Scene",
+                         DEBUG_LABEL_DRAW);
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          scene_pipeline);
+        if (occlusion_culled) {
+            occlusion_culler->RecordDraws(command_buffer,
+                                          OcclusionPhase::FIRST);
+        } else {
+            RecordDraws(command_buffer);
+        }
+    }
+
+    /* The first half of the split render pass ends with the draws that
+    passed the first phase. The pyramid is rebuilt from their depth, and the
+    second half draws the draws that it finds visible now. The pipeline, the
+    sets and the dynamic state of the graphics bind point are kept across
+    the render passes and the compute work. */
+    if (occlusion_culled) {
+        vkCmdEndRenderPass(command_buffer);
+
+        {
+            DebugLabel label(debug_utils, command_buffer,
+                             "Depth pyramid and occlusion culling",
+                             DEBUG_LABEL_COMPUTE);
+            occlusion_culler->RecordCull(command_buffer, current_frame,
+                                         OcclusionPhase::SECOND,
+                                         depth_image_view, *frame_descriptors);
+        }
+
+        render_pass_info.renderPass = occlusion_render_passes[1];
+        vkCmdBeginRenderPass(command_buffer, &render_pass_info,
+                             VK_SUBPASS_CONTENTS_INLINE);
+
+        {
+            DebugLabel label(debug_utils, command_buffer,
+                             "Scene, second phase", DEBUG_LABEL_DRAW);
+            occlusion_culler->RecordDraws(command_buffer,
+                                          OcclusionPhase::SECOND);
+        }
+
+        // The queries of every draw against the finished depth gate the
+        // first phase of the next frame
+        if (occlusion_culler->UsesQueries()) {
+            DebugLabel label(debug_utils, command_buffer, "Occlusion queries",
+                             DEBUG_LABEL_DRAW);
+            vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              occlusion_proxy_pipeline);
+            occlusion_culler->RecordQueries(command_buffer, current_frame);
+        }
+    }
+
+    // The G-buffer is lit once per pixel, the particles and the overlay are
+    // drawn over the lit scene in the same subpass
+    if (deferred_lighting != nullptr) {
+        vkCmdNextSubpass(command_buffer, VK_SUBPASS_CONTENTS_INLINE);
+
+        DebugLabel label(debug_utils, command_buffer, "Lighting",
+                         DEBUG_LABEL_DRAW);
+        GBufferViews views;
+        views.albedo = gbuffer_images[0].view;
+        views.normal = gbuffer_images[1].view;
+        views.depth = depth_image_view;
+        deferred_lighting->RecordDraw(command_buffer, views,
+                                      scene_lights->GetSet(),
+                                      swap_chain_extent, *frame_descriptors);
+    }
+
+    if (particle_system != nullptr) {
+        DebugLabel label(debug_utils, command_buffer, "Particles",
+                         DEBUG_LABEL_DRAW);
+        particle_system->RecordDraw(command_buffer, swap_chain_extent);
+    }
+
+    // The overlay is drawn over the finished scene
+    if (hud != nullptr) {
+        DebugLabel label(debug_utils, command_buffer, "Overlay",
+                         DEBUG_LABEL_DRAW);
+        hud->RecordDraw(command_buffer, current_frame, swap_chain_extent);
+    }
+
+    /* Finishing up */
+    // End the render pass
+    vkCmdEndRenderPass(command_buffer);
+
+    if (occlusion_culled && occlusion_culler->UsesQueries()) {
+        occlusion_culler->RecordQueryCopy(command_buffer, current_frame);
+    }
+
+    // The stages run on the scene image and write the swap chain image
+    if (post_chain != nullptr) {
+        DebugLabel label(debug_utils, command_buffer, "Post-processing",
+                         DEBUG_LABEL_COMPUTE);
+
+        PostTargets targets;
+        targets.scene_image = post_images[0].image;
+        targets.scene_view = post_images[0].view;
+        targets.scratch_image = post_images[1].image;
+        targets.scratch_view = post_images[1].view;
+        targets.output_image = swap_chain_images[image_index];
+        if (post_storage_output) {
+            targets.output_view = swap_chain_image_views[image_index];
+        }
+        targets.extent = swap_chain_extent;
+
+        post_chain->Record(command_buffer, current_frame, targets,
+                           *frame_descriptors);
+    }
+
+    if (timestamp_query_pool != VK_NULL_HANDLE) {
+        vkCmdWriteTimestamp(command_buffer,
+                            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                            timestamp_query_pool, 2 * current_frame + 1);
+    }
+
+    // Finish recording the command buffer
+    if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkEndCommandBuffer Error: failed to record command buffer!");
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::RecordDraws(VkCommandBuffer command_buffer) {
+    /* The vkCmdDraw function has the following parameters aside from the
+     * command buffer:
+     - vertexCount: Number of vertices to draw
+     - instanceCount: Used for instanced rendering, set 1 if you're not doing
+     that.
+     - firstVertex: Used as offset into the vertex buffer, defines the lowest
+     value of gl_VertexIndex.
+     - firstInstance: Used as an offset for instanced rendering, defines the
+     lowest value of gl_InstanceIndex.
+     */
+
+    // Issue the draw commands for the triangle, more than one draw is only
+    // recorded to measure the recording cost of larger scenes. With a scene
+    // only the objects that passed the frustum culling are drawn. The first
+    // instance places a triangle in depth, a higher index is nearer, so the
+    // draws of the configured count overlap back to front.
+    if (culling_set.Size() > 0) {
+        for (uint32_t i = 0; i < visible_object_count; i++) {
+            vkCmdDraw(command_buffer, 3, 1, 0, visible_objects[i]);
+        }
+    } else {
+        for (uint32_t i = 0; i < DrawCount(); i++) {
+            vkCmdDraw(command_buffer, 3, 1, 0, i);
+        }
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::RecordParticleSimulation(
+    VkCommandBuffer command_buffer) {
+    // The fence of the frame slot was signaled, the count its last
+    // simulation read back is final
+    uint32_t alive_count = particle_system->GetAliveCount(current_frame);
+    if (alive_count > 0) {
+        particle_frame_count++;
+        particle_alive_sum += alive_count;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<float> delta_time = now - particle_time;
+    particle_time = now;
+
+    // A stall, e.g. a resize, does not make the particles jump
+    delta_time = std::min(delta_time, std::chrono::duration<float>(0.1F));
+
+    particle_system->RecordSimulation(command_buffer, current_frame,
+                                      delta_time.count());
+}
+
+template <typename Config>
+void Renderer<Config>::CullObjects() {
+    // The list only grows, the SIMD paths store whole vectors into it
+    if (visible_objects.size() < culling_set.GetPaddedSize()) {
+        visible_objects.resize(culling_set.GetPaddedSize());
+    }
+
+    visible_object_count =
+        culling_set.Size() > 0
+            ? culling_set.Cull(culling_frustum, visible_objects.data())
+            : 0;
+
+    /* Levels of detail of the visible objects, objects added without a mesh
+    are skipped */
+    if (visible_object_count > 0) {
+        lod_selector.Select(lod_view, culling_set, visible_objects.data(),
+                            visible_object_count);
+
+        if (lod_selector.GetFullTriangles() > 0) {
+            lod_frame_count++;
+            lod_selected_triangles += lod_selector.GetSelectedTriangles();
+            lod_full_triangles += lod_selector.GetFullTriangles();
+        }
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::RecordTextureUploads() {
+    /* Record the texture copies of the frame into their own command buffer
+    of the frame slot */
+    upload_command_buffer = VK_NULL_HANDLE;
+    upload_timeline_value = 0;
+
+    if (texture_streamer == nullptr) {
+        return;
+    }
+
+    texture_streamer->Update();
+
+    if (!texture_streamer->HasPendingUploads()) {
+        return;
+    }
+
+    VkCommandBuffer command_buffer = AcquireCommandBuffer(current_frame);
+
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    if (vkBeginCommandBuffer(command_buffer, &begin_info) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkBeginCommandBuffer Error: failed to begin recording upload "
+            "command buffer!");
+    }
+
+    {
+        DebugLabel label(debug_utils, command_buffer, "Texture uploads",
+                         DEBUG_LABEL_TRANSFER);
+        upload_timeline_value =
+            texture_streamer->RecordUploads(command_buffer, current_frame);
+    }
+
+    if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkEndCommandBuffer Error: failed to record upload command "
+            "buffer!");
+    }
+
+    // Nothing fit into the budget, the empty command buffer is not submitted
+    if (upload_timeline_value != 0) {
+        upload_command_buffer = command_buffer;
+    }
+}
+
+template <typename Config>
+bool Renderer<Config>::BeginFrame() {
+    /* Outline of a frame
+    At a high level, rendering a frame in Vulkan consists of a common set of
+    steps:
+    - Wait for the previous frame to finish
+    - Acquire an image from the swap chain
+    - Record a command buffer which draws the scene onto that image
+    - Submit the recorded command buffer
+    - Present the swap chain image
+
+    BeginFrame takes the first three steps, Submit and EndFrame the last two.
+    */
+
+    // The vkWaitForFences function takes an array of fences and waits on the
+    // host for any or all of the fences to be signaled before returning.
+    // VK_TRUE indicates that we want to wait for all fences,
+    // but in the case of a single one it doesn't matter.
+    // This function has a timeout parameter that we set to the maximum
+    // value of a 64 bit unsigned integer.
+    // UINT64_MAX disables the timeout.
+
+    // Wait until the previous frame has finished, so that the command buffer
+    // and semaphores are available to use.
+    vkWaitForFences(device, 1, &in_flight_fences[current_frame], VK_TRUE,
+                    UINT64_MAX);
+
+    if (MeasuringFrameTimings()) {
+        timing_cpu_start = std::chrono::steady_clock::now();
+    }
+
+    // The frame that last used these objects has finished, record its
+    // completion before the fence is reset
+    if (MeasuringLatency()) {
+        CollectPresentCompletions(false);
+    }
+
+    /* Coalescing resizes
+    Resize events, an out of date acquire and an out of date or suboptimal
+    present only mark the swap chain for recreation. It is recreated once
+    here, at the start of the next frame after the events were read, so a
+    burst of resize events causes at most one recreation per frame. */
+    if (framebuffer_resized) {
+        framebuffer_resized = false;
+        RecreateSwapChain();
+
+        // The surface is minimized, nothing can be rendered
+        if (framebuffer_resized) {
+            if (metrics != nullptr) {
+                RendererMetrics::Increment(metrics->dropped_frames);
+            }
+            return false;
+        }
+    }
+
+    /* Suboptimal or out-of-date swap chain
+    The vkAcquireNextImageKHR and vkQueuePresentKHR functions can return the
+    following special values to indicate this:
+    - VK_ERROR_OUT_OF_DATE_KHR: The swap chain has become incompatible with the
+    surface and can no longer be used for rendering. Usually happens after a
+    window resize.
+    - VK_SUBOPTIMAL_KHR: The swap chain can still be used to
+    successfully present to the surface, but the surface properties are no
+    longer matched exactly.
+    */
+
+    VkResult result =
+        vkAcquireNextImageKHR(device, swap_chain, UINT64_MAX,
+                              image_available_semaphores[current_frame],
+                              VK_NULL_HANDLE, &image_index);
+
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        // Nothing can be rendered this frame, the fence is not reset since no
+        // work is submitted
+        framebuffer_resized = true;
+        if (RunningResizeStorm()) {
+            resize_storm.OnFrameDropped();
+        }
+        if (metrics != nullptr) {
+            RendererMetrics::Increment(metrics->dropped_frames);
+        }
+        return false;
+    } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+        throw std::runtime_error(
+            "vkAcquireNextImageKHR Error: failed to acquire swap chain image!");
+    }
+
+    // Every frame that reaches the presentation is identified by a present id.
+    // The ids have to increase with each present to the swap chain.
+    present_id++;
+
+    if (MeasuringLatency()) {
+        latency_tracker.BeginFrame(present_id);
+    }
+
+    // The slot's previous frame is complete, its GPU time can be read
+    if (MeasuringFrameTimings()) {
+        MeasureFrameTimings();
+    }
+
+    UpdateMemoryBudget();
+    PublishPipelines();
+
+    /* Fixing a deadlock */
+    // Only reset the fence if we are submitting work
+    vkResetFences(device, 1, &in_flight_fences[current_frame]);
+
+    /* Reecording the command buffer */
+    // The frame slot is done with its command buffers, reset them all at once
+    ResetFrameCommandPool(current_frame);
+    frame_command_buffer = AcquireCommandBuffer(current_frame);
+    frame_descriptors->ResetFrame(current_frame);
+
+    // The texture copies of the frame use the staging buffer of the frame
+    // slot, which is free again after the fence wait
+    RecordTextureUploads();
+
+    // record the commands of the objects in the view
+    CullObjects();
+    if (hud != nullptr) {
+        UpdateHud();
+    }
+    RecordCommandBuffer(frame_command_buffer, image_index);
+
+    if (MeasuringLatency()) {
+        latency_tracker.MarkRecorded(present_id);
+    }
+
+    return true;
+}
+
+template <typename Config>
+void Renderer<Config>::Submit() {
+    /* Submitting the command buffer */
+    // Configure queue submission and synchronization
+    VkSubmitInfo submit_info{};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+
+    std::array<VkSemaphore, 1> wait_semaphores = {
+        image_available_semaphores[current_frame]};
+    std::array<VkPipelineStageFlags, 1> wait_stages = {
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+
+    // The first three parameters specify which semaphores to wait on before
+    // the execution begins and in which stage(s) of the pipeline to wait.
+    submit_info.waitSemaphoreCount = 1;
+    submit_info.pWaitSemaphores = wait_semaphores.data();
+    submit_info.pWaitDstStageMask = wait_stages.data();
+
+    // The two parameters specify which command buffers to actually submit for
+    // execution.
+    // The texture copies are submitted ahead of the draws of the frame
+    std::array<VkCommandBuffer, 2> command_buffers = {upload_command_buffer,
+                                                      frame_command_buffer};
+    uint32_t first_command_buffer =
+        upload_command_buffer == VK_NULL_HANDLE ? 1 : 0;
+    submit_info.commandBufferCount = 2 - first_command_buffer;
+    submit_info.pCommandBuffers = command_buffers.data() + first_command_buffer;
+
+    // The signalSemaphoreCount and pSignalSemaphores parameters specify which
+    // semaphores to signal once the command buffer(s) have finished execution.
+    std::array<VkSemaphore, 2> signal_semaphores = {
+        render_finished_semaphores[current_frame], VK_NULL_HANDLE};
+    submit_info.signalSemaphoreCount = 1;
+    submit_info.pSignalSemaphores = signal_semaphores.data();
+
+    // A frame with texture copies also signals their value on the timeline
+    // semaphore, the value of the binary semaphore is ignored
+    std::array<uint64_t, 2> signal_values = {0, upload_timeline_value};
+    VkTimelineSemaphoreSubmitInfoKHR timeline_info{};
+    if (upload_command_buffer != VK_NULL_HANDLE) {
+        signal_semaphores[1] = texture_streamer->GetTimelineSemaphore();
+        submit_info.signalSemaphoreCount = 2;
+
+        timeline_info.sType =
+            VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+        timeline_info.signalSemaphoreValueCount = 2;
+        timeline_info.pSignalSemaphoreValues = signal_values.data();
+        submit_info.pNext = &timeline_info;
+    }
+
+    // On the next frame, the CPU will wait for this command buffer to finish
+    // executing before it records new commands into it.
+
+    // Submit the command buffer to the graphics queue
+    if (vkQueueSubmit(graphics_queue, 1, &submit_info,
+                      in_flight_fences[current_frame]) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkQueueSubmit Error: failed to submit draw command buffer!");
+    }
+
+    if (MeasuringFrameTimings()) {
+        frame_timings.cpu_ms =
+            std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - timing_cpu_start)
+                .count();
+    }
+
+    if (metrics != nullptr) {
+        RendererMetrics::Increment(metrics->frames);
+    }
+
+    if (MeasuringLatency()) {
+        latency_tracker.MarkSubmitted(present_id);
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::EndFrame() {
+    /* Presentation */
+    VkPresentInfoKHR present_info{};
+    present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+
+    // Two paramets specify which semaphores to wait on before presentation can
+    // happen.
+    std::array<VkSemaphore, 1> wait_semaphores = {
+        render_finished_semaphores[current_frame]};
+    present_info.waitSemaphoreCount = 1;
+    present_info.pWaitSemaphores = wait_semaphores.data();
+
+    // Two parameters specify the swap chains to present images to and the index
+    // of the image for each swap chain. This will almost always be a single
+    // one.
+    std::array<VkSwapchainKHR, 1> swap_chains = {swap_chain};
+    present_info.swapchainCount = 1;
+    present_info.pSwapchains = swap_chains.data();
+    present_info.pImageIndices = &image_index;
+
+    // pResults allows you to specify an array of VkResult values to check every
+    // individual swap chain if presentation was successful.
+    // It is not required if you're only using a single swap chain, because you
+    // can simply use the return value of the present function.
+    present_info.pResults = nullptr;  // Optional
+
+    // Attach the present id so vkWaitForPresentKHR can wait for this present
+    VkPresentIdKHR present_id_info{};
+    present_id_info.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+    present_id_info.swapchainCount = 1;
+    present_id_info.pPresentIds = &present_id;
+
+    if (present_wait_supported) {
+        present_info.pNext = &present_id_info;
+    }
+
+    // Submit the request to present an image to the swap chain.
+    VkResult result = vkQueuePresentKHR(present_queue, &present_info);
+
+    if (MeasuringLatency()) {
+        if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR) {
+            latency_tracker.MarkPresented(present_id);
+            pending_presents.push_back({present_id, current_frame});
+        } else {
+            latency_tracker.DiscardFrame(present_id);
+        }
+
+        // Block on the oldest frame only if more frames are pending than
+        // the swap chain has images, they must have been presented by then
+        CollectPresentCompletions(pending_presents.size() >
+                                  swap_chain_images.size());
+    }
+
+    // Handling resizes explicitly, the swap chain is recreated at the start
+    // of the next frame
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+        framebuffer_resized = true;
+        if (result == VK_ERROR_OUT_OF_DATE_KHR && RunningResizeStorm()) {
+            resize_storm.OnFrameDropped();
+        }
+    } else if (result != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkQueuePresentKHR Error: failed to present swap chain image!");
+    }
+
+    // Advance to the next frame every time
+    current_frame = (current_frame + 1) % FramesInFlight();
+
+    frame_pacer.OnFrameSubmitted(FramePacer::Clock::now());
+
+    if (MeasuringLatency()) {
+        AdvanceLatencyMeasurement();
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CreateSyncObjects() {
+    /* Synchronization
+    The number of events that are required to order explicitly because they
+    happen on the GPU, such as:
+    - Acquire an image from the swap chain
+    - Execute commands that draw onto the acquired image
+    - Present that image to the screen for presentation, returning it to the
+    swapchain
+    */
+
+    // Describe semaphore information
+    VkSemaphoreCreateInfo semaphore_info{};
+    semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+    // The problem is the vkWaitForFences function blocks indefinitely, waiting
+    // on something which will never happen. There is a clever workaround built
+    // into the API. Create the fence in the signaled state, so that the first
+    // call to vkWaitForFences() returns immediately since the fence is already
+    // signaled.
+    // To achieve this, we add the VK_FENCE_CREATE_SIGNALED_BIT flag to the
+    // VkFenceCreateInfo
+
+    // Describe the fence information
+    VkFenceCreateInfo fence_info{};
+    fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+    for (size_t i = 0; i < Config::MAX_FRAMES_IN_FLIGHT; i++) {
+        // Create semaphores and the fence
+        if (vkCreateSemaphore(device, &semaphore_info, nullptr,
+                              &image_available_semaphores[i]) != VK_SUCCESS ||
+            vkCreateSemaphore(device, &semaphore_info, nullptr,
+                              &render_finished_semaphores[i]) != VK_SUCCESS ||
+            vkCreateFence(device, &fence_info, nullptr, &in_flight_fences[i]) !=
+                VK_SUCCESS) {
+            throw std::runtime_error(
+                "vkCreateSemaphore and vkCreateFence Error: failed to create "
+                "synchronization objects for a frame!");
+        }
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::RecreateSwapChain() {
+    /* Recreating the swap chain */
+    /* Handling minimization
+    A minimized window has a size of 0, no swap chain can be created for it.
+    The recreation is retried on the next frame, the host waits for events
+    in the meantime. */
+    VkExtent2D extent = surface_source.get_extent();
+    if (extent.width == 0 || extent.height == 0) {
+        framebuffer_resized = true;
+        return;
+    }
+
+    auto recreation_start = ResizeStorm::Clock::now();
+
+    vkDeviceWaitIdle(device);
+
+    // Presents to the old swap chain can not be waited on once it is destroyed
+    DiscardPendingPresents();
+
+    CleanupSwapChain();
+
+    CreateSwapChain();
+    CreateImageViews();
+    CreateColorResources();
+    CreatePostResources();
+    CreateGBuffer();
+    CreateDepthResources();
+    CreateFramebuffers();
+
+    if (RunningResizeStorm()) {
+        resize_storm.OnRecreated(ResizeStorm::Clock::now() - recreation_start);
+    }
+
+    if (metrics != nullptr) {
+        RendererMetrics::Increment(metrics->swap_chain_recreations);
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::CleanupSwapChain() {
+    if (color_image_view != VK_NULL_HANDLE) {
+        vkDestroyImageView(device, color_image_view, nullptr);
+        vkDestroyImage(device, color_image, nullptr);
+        memory_allocator->Free(color_image_memory);
+        color_image_view = VK_NULL_HANDLE;
+    }
+
+    if (depth_image_view != VK_NULL_HANDLE) {
+        vkDestroyImageView(device, depth_image_view, nullptr);
+        vkDestroyImage(device, depth_image, nullptr);
+        memory_allocator->Free(depth_image_memory);
+        depth_image_view = VK_NULL_HANDLE;
+    }
+
+    if (occlusion_culler != nullptr) {
+        occlusion_culler->DestroyPyramid();
+    }
+
+    for (auto* images : {&post_images, &gbuffer_images}) {
+        for (AttachmentImage& attachment_image : *images) {
+            if (attachment_image.view != VK_NULL_HANDLE) {
+                vkDestroyImageView(device, attachment_image.view, nullptr);
+                vkDestroyImage(device, attachment_image.image, nullptr);
+                memory_allocator->Free(attachment_image.memory);
+                attachment_image = {};
+            }
+        }
+    }
+
+    for (size_t i = 0; i < swap_chain_framebuffers.size(); i++) {
+        vkDestroyFramebuffer(device, swap_chain_framebuffers[i], nullptr);
+    }
+
+    for (size_t i = 0; i < swap_chain_image_views.size(); i++) {
+        vkDestroyImageView(device, swap_chain_image_views[i], nullptr);
+    }
+
+    vkDestroySwapchainKHR(device, swap_chain, nullptr);
+}
+
+template <typename Config>
+void Renderer<Config>::CollectPresentCompletions(bool wait_for_oldest) {
+    /* Frames complete in the order they were presented. Record completions
+    from the oldest pending frame on until a frame has not completed yet. */
+    while (!pending_presents.empty()) {
+        PendingPresent pending = pending_presents.front();
+        uint64_t timeout = wait_for_oldest ? PRESENT_COMPLETION_TIMEOUT : 0;
+
+        VkResult result = VK_SUCCESS;
+        if (present_wait_supported) {
+            // Completes once the presentation engine displayed the image
+            result = wait_for_present(device, swap_chain, pending.present_id,
+                                      timeout);
+        } else {
+            // Fall back to the fence of the frame, which is signaled once the
+            // GPU finished rendering the frame
+            result =
+                vkWaitForFences(device, 1, &in_flight_fences[pending.frame],
+                                VK_TRUE, timeout);
+        }
+
+        if (result == VK_TIMEOUT) {
+            break;
+        }
+
+        if (result == VK_SUCCESS) {
+            latency_tracker.MarkCompleted(pending.present_id,
+                                          LatencyTracker::Clock::now());
+        } else {
+            // VK_ERROR_OUT_OF_DATE_KHR: the present will never complete
+            latency_tracker.DiscardFrame(pending.present_id);
+        }
+
+        pending_presents.pop_front();
+        wait_for_oldest = false;
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::DiscardPendingPresents() {
+    /* Record the frames that already completed, the remaining frames can not
+    be observed anymore */
+    CollectPresentCompletions(false);
+
+    for (const auto& pending : pending_presents) {
+        latency_tracker.DiscardFrame(pending.present_id);
+    }
+
+    pending_presents.clear();
+}
+
+template <typename Config>
+void Renderer<Config>::StartLatencyMeasurement() {
+    /* Measure every supported present mode with every number of frames in
+    flight. A configured present mode or number of frames in flight limits the
+    measurement to that setting. */
+    std::vector<VkPresentModeKHR> present_modes =
+        QuerySwapChainSupport(physical_device).present_modes;
+
+    if (options.present_mode.has_value()) {
+        present_modes = {options.present_mode.value()};
+    }
+
+    latency_configurations.clear();
+
+    for (VkPresentModeKHR mode : present_modes) {
+        if (options.frames_in_flight.has_value()) {
+            latency_configurations.push_back({mode, frames_in_flight});
+            continue;
+        }
+
+        for (uint32_t count = 1; count <= Config::MAX_FRAMES_IN_FLIGHT;
+             count++) {
+            latency_configurations.push_back({mode, count});
+        }
+    }
+
+    latency_configuration_index = 0;
+    ApplyLatencyConfiguration();
+}
+
+template <typename Config>
+void Renderer<Config>::ApplyLatencyConfiguration() {
+    const LatencyConfiguration& configuration =
+        latency_configurations[latency_configuration_index];
+
+    // Recreating the swap chain waits until the device is idle, so the number
+    // of frames in flight can be changed afterwards
+    preferred_present_mode = configuration.present_mode;
+    RecreateSwapChain();
+
+    frames_in_flight = configuration.frames_in_flight;
+    current_frame = 0;
+
+    std::string completion =
+        present_wait_supported ? "vkWaitForPresentKHR" : "in flight fence";
+    latency_tracker.SetConfiguration(
+        PresentModeName(present_mode) + ", " +
+        std::to_string(frames_in_flight) + " frame(s) in flight, completion " +
+        "by " + completion);
+}
+
+template <typename Config>
+void Renderer<Config>::AdvanceLatencyMeasurement() {
+    /* Move on to the next configuration once enough frames were measured */
+    if (latency_tracker.CompletedFrameCount() < options.latency_frames) {
+        return;
+    }
+
+    latency_configuration_index++;
+
+    if (latency_configuration_index < latency_configurations.size()) {
+        ApplyLatencyConfiguration();
+    } else {
+        close_requested = true;
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::ConfigureFramePacing() {
+    /* The refresh rate of the display drives the display frame rate cap and
+    the low latency start prediction */
+    int refresh_rate = surface_source.refresh_rate > 0
+                           ? surface_source.refresh_rate
+                           : FALLBACK_REFRESH_RATE;
+
+    auto refresh_interval =
+        std::chrono::duration_cast<FramePacer::Clock::duration>(
+            std::chrono::duration<double>(1.0 / refresh_rate));
+    frame_pacer.SetRefreshInterval(refresh_interval);
+
+    if (options.fps_cap_display) {
+        frame_pacer.SetTargetInterval(refresh_interval);
+    } else if (options.fps_cap.has_value()) {
+        frame_pacer.SetTargetInterval(
+            std::chrono::duration_cast<FramePacer::Clock::duration>(
+                std::chrono::duration<double>(1.0 / options.fps_cap.value())));
+    }
+
+    low_latency_pacing = options.low_latency && present_wait_supported;
+
+    if (options.low_latency && !present_wait_supported) {
+        std::cerr << "low latency pacing requires VK_KHR_present_wait, only "
+                     "the frame rate cap is applied"
+                  << std::endl;
+    }
+}
+
+template <typename Config>
+void Renderer<Config>::PaceFrame() {
+    /* Wait for the present of frame N - k to complete, then sleep until the
+    predicted start time of frame N */
+    if (low_latency_pacing && present_id >= options.pacing_depth) {
+        // present_id is the id of the previous frame, N - 1
+        uint64_t wait_id = present_id + 1 - options.pacing_depth;
+
+        if (wait_id >= swap_chain_first_present_id) {
+            VkResult result = wait_for_present(device, swap_chain, wait_id,
+                                               PRESENT_COMPLETION_TIMEOUT);
+            if (result == VK_SUCCESS) {
+                frame_pacer.OnPresentCompleted(FramePacer::Clock::now());
+            }
+        }
+    }
+
+    frame_pacer.WaitForFrameStart();
+}
+
+// The renderer is compiled for the production and the diagnostic configuration
+template class Renderer<ProductionConfig>;
+template class Renderer<DiagnosticConfig>;
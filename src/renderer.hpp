@@ -0,0 +1,726 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+#define GLM_FORCE_RADIUS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+/* Local header files */
+#include "application_options.hpp"
+#include "debug_utils.hpp"
+#include "deferred_lighting.hpp"
+#include "descriptor_allocator.hpp"
+#include "frame_pacer.hpp"
+#include "frustum_culling.hpp"
+#include "latency_tracker.hpp"
+#include "lod_selection.hpp"
+#include "memory_allocator.hpp"
+#include "memory_budget.hpp"
+#include "metrics_server.hpp"
+#include "mesh_file.hpp"
+#include "occlusion_culling.hpp"
+#include "particle_system.hpp"
+#include "pipeline_compiler.hpp"
+#include "performance_hud.hpp"
+#include "post_process.hpp"
+#include "renderer_config.hpp"
+#include "renderer_metrics.hpp"
+#include "renderer_surface.hpp"
+#include "resize_storm.hpp"
+#include "scene_lights.hpp"
+#include "shader_manifest.hpp"
+#include "texture_streamer.hpp"
+
+/* Standard libraries */
+#include <algorithm>  // Required for std::clamp
+#include <array>
+#include <chrono>
+#include <cstdint>  // Required for uint32_t
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>  // Required for std::istreambuf_iterator
+#include <limits>  // Required for std::numeric_limits
+#include <map>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+// Enable the standard diagnostic layers provided by the Vulkan SDK
+const std::array<const char*, 1> VALIDATION_LAYERS = {
+    "VK_LAYER_KHRONOS_validation"};
+
+// Declare a list of required device extensions
+const std::array<const char*, 3> DEVICE_EXTENSIONS = {
+    VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+    VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
+    VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
+};
+
+// Optional device extensions to find out when a present has completed
+const std::array<const char*, 2> PRESENT_WAIT_EXTENSIONS = {
+    VK_KHR_PRESENT_ID_EXTENSION_NAME,
+    VK_KHR_PRESENT_WAIT_EXTENSION_NAME,
+};
+
+// Optional device extension to track the completion of texture uploads
+const std::array<const char*, 1> TIMELINE_SEMAPHORE_EXTENSIONS = {
+    VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME,
+};
+
+// Optional device extension to query the memory budget of the process
+const std::array<const char*, 1> MEMORY_BUDGET_EXTENSIONS = {
+    VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+};
+
+// Optional device extension to gate draws on the results of occlusion
+// queries
+const std::array<const char*, 1> CONDITIONAL_RENDERING_EXTENSIONS = {
+    VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME,
+};
+
+// Longest time to block on the completion of a single present (1 second)
+const uint64_t PRESENT_COMPLETION_TIMEOUT = 1000000000;
+
+// Refresh rate to assume if the display does not report one
+const int FALLBACK_REFRESH_RATE = 60;
+
+// Pipeline cache of the previous run, loaded when the shaders and the driver
+// are unchanged
+const char* const PIPELINE_CACHE_FILE = "pipeline_cache.bin";
+const uint32_t PIPELINE_CACHE_FILE_MAGIC = 0x48435056;  // "VPCH"
+
+/* Mesh loaded from a .vmesh file. The payload of the file is copied as it
+is into a single device local buffer, a stream is bound at its offset within
+the payload. */
+struct GpuMesh {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    MeshFileHeader header{};
+    VkDeviceSize payload_offset = 0;  // Offset of the payload in the file
+    std::vector<MeshLod> lods;        // Ranges of the index stream
+
+    VkDeviceSize GetStreamOffset(MeshStream stream) const {
+        return header.streams[static_cast<size_t>(stream)].offset -
+               payload_offset;
+    }
+};
+
+// How a pipeline uses the depth attachment
+enum class DepthPass {
+    SINGLE,    // Test and write, the scene is drawn once
+    PRE_PASS,  // Depth only, writes the nearest depth of every pixel
+    SHADING,   // After the pre-pass, shades only the fragments of that depth
+    PROXY,     // Depth only without writes, for the occlusion queries
+};
+
+/* Reusable Vulkan renderer
+
+The renderer does not own a window and does not read events, the host
+supplies the surface (see renderer_surface.hpp) and drives every frame
+explicitly:
+
+    renderer.Initialize(surface);
+    ...
+    renderer.PaceFrame();
+    // read the events of the host, e.g. glfwPollEvents
+    if (renderer.BeginFrame()) {
+        renderer.Submit();
+        renderer.EndFrame();
+    }
+
+The renderer settings (frames in flight, present mode, validation and sample
+count) are given by the Config policy, see renderer_config.hpp
+*/
+template <typename Config>
+class Renderer {
+   private:
+    ApplicationOptions options;
+    RendererSurface surface_source;
+    bool close_requested = false;
+    VkInstance instance{};
+    VkDebugUtilsMessengerEXT debug_messenger{};
+
+    // Object names and command buffer labels, only with Config::DEBUG_LABELS
+    // and an instance that has VK_EXT_debug_utils
+    bool debug_utils_enabled = false;
+    DebugUtils debug_utils;
+    using DebugLabel = DebugLabelScope<Config::DEBUG_LABELS>;
+    VkPhysicalDevice physical_device = VK_NULL_HANDLE;
+    VkDevice device{};
+    VkQueue graphics_queue{};
+    VkSurfaceKHR surface{};
+    VkQueue present_queue{};
+    VkSwapchainKHR swap_chain{};
+    std::vector<VkImage> swap_chain_images;
+    std::vector<VkImageView> swap_chain_image_views;
+    VkFormat swap_chain_image_format{};
+    VkExtent2D swap_chain_extent{};
+    VkRenderPass render_pass{};
+    VkPipelineLayout pipeline_layout{};
+    VkPipeline graphics_pipeline{};
+    VkPipelineCache pipeline_cache = VK_NULL_HANDLE;
+
+    // Manifest of the Shaders target, if the shaders were built by CMake. The
+    // listed shaders are read once at startup and checked against it.
+    std::optional<ShaderManifest> shader_manifest;
+    std::map<std::string, std::vector<char>> shader_code;
+
+    // Key of the pipeline cache file, derived from the shader hashes and the
+    // device and driver
+    uint64_t pipeline_cache_key = 0;
+    size_t pipeline_cache_loaded_size = 0;
+    std::vector<VkFramebuffer> swap_chain_framebuffers;
+
+    // Multisampled color attachment, resolved into the swap chain image. Only
+    // created with more than one sample per pixel.
+    VkSampleCountFlagBits msaa_samples = VK_SAMPLE_COUNT_1_BIT;
+    VkImage color_image = VK_NULL_HANDLE;
+    VkDeviceMemory color_image_memory = VK_NULL_HANDLE;
+    VkImageView color_image_view = VK_NULL_HANDLE;
+
+    // Attachment or storage image recreated with the swap chain
+    struct AttachmentImage {
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+    };
+
+    // With post-processing the scene is rendered to the first of two HDR
+    // images instead of the swap chain image, the second one is the target of
+    // the stages that read neighbors.
+    std::array<AttachmentImage, 2> post_images{};
+
+    // Albedo and normal of the deferred path. They only live within the
+    // render pass, so they are transient and lazily allocated where the
+    // device has such memory.
+    std::array<AttachmentImage, 2> gbuffer_images{};
+    bool gbuffer_lazily_allocated = false;
+
+    // Depth attachment, recreated with the swap chain. The format is the
+    // most precise one the device supports, see FindDepthFormat.
+    VkFormat depth_format = VK_FORMAT_UNDEFINED;
+    VkImage depth_image = VK_NULL_HANDLE;
+    VkDeviceMemory depth_image_memory = VK_NULL_HANDLE;
+    VkImageView depth_image_view = VK_NULL_HANDLE;
+
+    // With a depth pre-pass the draws are recorded twice: depth only, then
+    // shaded with an equal depth test, so every pixel is shaded once. Both
+    // pipelines are compiled on the workers of the pipeline compiler and
+    // published together, until then the scene is drawn once with the
+    // graphics pipeline.
+    VkPipeline depth_prepass_pipeline = VK_NULL_HANDLE;
+    VkPipeline depth_shading_pipeline = VK_NULL_HANDLE;
+    std::optional<PipelineCompiler::Handle> prepass_pipeline_request;
+    std::optional<PipelineCompiler::Handle> shading_pipeline_request;
+
+    // Compiles pipelines off the render thread, the finished ones are
+    // published at the start of a frame
+    std::unique_ptr<PipelineCompiler> pipeline_compiler;
+
+    // Set layouts shared by all modules, and the descriptor sets of a frame,
+    // released together when the fence of the frame slot is signaled
+    std::unique_ptr<DescriptorLayoutCache> descriptor_layout_cache;
+    std::unique_ptr<DescriptorAllocator> frame_descriptors;
+
+    /* Command buffers of a frame slot. The pool is transient and reset as a
+    whole once the fence of the slot is signaled, its command buffers are
+    then handed out again in allocation order. Recording on several threads
+    requires one pool per thread, command pools are externally synchronized. */
+    struct FrameCommandPool {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> command_buffers;
+        size_t used_count = 0;
+    };
+    std::array<FrameCommandPool, Config::MAX_FRAMES_IN_FLIGHT>
+        frame_command_pools{};
+    VkCommandBuffer frame_command_buffer = VK_NULL_HANDLE;
+    std::array<VkSemaphore, Config::MAX_FRAMES_IN_FLIGHT>
+        image_available_semaphores{};
+    std::array<VkSemaphore, Config::MAX_FRAMES_IN_FLIGHT>
+        render_finished_semaphores{};
+    std::array<VkFence, Config::MAX_FRAMES_IN_FLIGHT> in_flight_fences{};
+    uint32_t current_frame = 0;
+    uint32_t image_index = 0;
+    VkPresentModeKHR present_mode = VK_PRESENT_MODE_FIFO_KHR;
+
+    // Settings of a runtime configuration, a compile time configuration uses
+    // its constants instead
+    uint32_t frames_in_flight = Config::FRAMES_IN_FLIGHT;
+    std::optional<VkPresentModeKHR> preferred_present_mode;
+    bool enable_validation = Config::ENABLE_VALIDATION;
+    VkSampleCountFlagBits sample_count = Config::SAMPLE_COUNT;
+    uint32_t draw_count = 1;
+
+    bool framebuffer_resized = false;
+
+    // VK_KHR_present_id and VK_KHR_present_wait
+    bool present_wait_supported = false;
+    PFN_vkWaitForPresentKHR wait_for_present = nullptr;
+    uint64_t present_id = 0;
+    uint64_t swap_chain_first_present_id = 1;
+
+    // Frame rate cap and low latency pacing
+    FramePacer frame_pacer;
+    bool low_latency_pacing = false;
+
+    // Presented frames whose completion has not been observed yet
+    struct PendingPresent {
+        uint64_t present_id;
+        uint32_t frame;
+    };
+    std::deque<PendingPresent> pending_presents;
+
+    // Input-to-present latency measurement
+    struct LatencyConfiguration {
+        VkPresentModeKHR present_mode;
+        uint32_t frames_in_flight;
+    };
+    LatencyTracker latency_tracker;
+    std::vector<LatencyConfiguration> latency_configurations;
+    size_t latency_configuration_index = 0;
+
+    // Resize storm stress test
+    ResizeStorm resize_storm;
+
+    // Bounds of the objects of the scene, culled against the frustum of the
+    // view projection before the frame is recorded. The visible list holds
+    // the indices of the objects that are drawn.
+    CullingSet culling_set;
+    Frustum culling_frustum = ExtractFrustum(glm::mat4(1.0F));
+    std::vector<uint32_t> visible_objects;
+    uint32_t visible_object_count = 0;
+
+    // Level of detail of the visible objects, selected after the culling.
+    // The triangle sums compare the selected levels with the finest levels,
+    // the draws do not use the index ranges of the levels yet.
+    LodSelector lod_selector;
+    LodView lod_view;
+    uint64_t lod_frame_count = 0;
+    uint64_t lod_selected_triangles = 0;
+    uint64_t lod_full_triangles = 0;
+
+    // Texture uploads, created by the first LoadTexture. The copies of a
+    // frame are recorded into their own command buffer, submitted before the
+    // frame command buffer.
+    bool timeline_semaphore_supported = false;
+    std::unique_ptr<TextureStreamer> texture_streamer;
+    VkCommandBuffer upload_command_buffer = VK_NULL_HANDLE;
+    uint64_t upload_timeline_value = 0;
+
+    // GPU particles, simulated at the start of the frame command buffer and
+    // drawn over the scene. The alive counts of the frames are summed for the
+    // report once their fences were signaled.
+    std::unique_ptr<ParticleSystem> particle_system;
+    std::chrono::steady_clock::time_point particle_time;
+    uint64_t particle_frame_count = 0;
+    uint64_t particle_alive_sum = 0;
+
+    // Device memory of the renderer and its modules, counted in the metrics
+    std::unique_ptr<MemoryAllocator> memory_allocator;
+
+    // Budget and usage of the memory heaps, polled every
+    // MEMORY_BUDGET_POLL_FRAMES frames. The renderer shrinks the textures it
+    // loads while the pressure is raised.
+    bool memory_budget_supported = false;
+    std::unique_ptr<MemoryBudget> memory_budget;
+
+    // Performance overlay, drawn at the end of the render pass
+    std::unique_ptr<PerformanceHud> hud;
+
+    // Point lights of the scene, with --lights. The forward pipelines bind
+    // their set, the deferred path binds it in the lighting subpass.
+    std::unique_ptr<SceneLights> scene_lights;
+    std::unique_ptr<DeferredLighting> deferred_lighting;
+
+    // Compute post-processing after the render pass. The last stage writes
+    // the swap chain image if it supports storage, otherwise the result is
+    // blitted to it.
+    std::unique_ptr<PostProcessChain> post_chain;
+    bool storage_write_without_format = false;
+    bool post_storage_output = false;
+
+    // Two-phase occlusion culling of the scene draws, with
+    // --occlusion-culling. The frame is recorded in the two halves of the
+    // split render pass, the depth pyramid is built between them. The proxy
+    // pipeline draws the occlusion queries with conditional rendering.
+    std::unique_ptr<OcclusionCuller> occlusion_culler;
+    std::array<VkRenderPass, 2> occlusion_render_passes{};
+    VkPipeline occlusion_proxy_pipeline = VK_NULL_HANDLE;
+    bool conditional_rendering_supported = false;
+    bool multi_draw_indirect_supported = false;
+
+    // Metrics and their loopback HTTP endpoint, both only exist with a
+    // metrics port. The render thread only updates atomics.
+    std::unique_ptr<RendererMetrics> metrics;
+    std::unique_ptr<MetricsServer> metrics_server;
+
+    // Frame timings of the overlay and the metrics. The GPU time of a frame
+    // is measured with a timestamp at the start and the end of its command
+    // buffer, two queries per frame slot. The CPU time is the time from the
+    // fence wait to the submission of the previous frame.
+    VkQueryPool timestamp_query_pool = VK_NULL_HANDLE;
+    double timestamp_period = 0.0;  // Nanoseconds per tick
+    uint64_t timestamp_mask = 0;
+    std::chrono::steady_clock::time_point timing_frame_start;
+    std::chrono::steady_clock::time_point timing_cpu_start;
+    HudFrameStats frame_timings;
+
+    // Meshes and the pool of the one time command buffers that upload them
+    std::vector<GpuMesh> meshes;
+    VkCommandPool load_command_pool = VK_NULL_HANDLE;
+
+    struct QueueFamilyIndices {
+        std::optional<uint32_t> graphics_family;
+        std::optional<uint32_t> present_family;
+
+        bool IsComplete();
+    };
+
+    struct SwapChainSupportDetails {
+        VkSurfaceCapabilitiesKHR capabilities{};
+        std::vector<VkSurfaceFormatKHR> formats;
+        std::vector<VkPresentModeKHR> present_modes;
+    };
+
+    /* Settings of the configuration. With a compile time configuration they
+    are constants, so the branches on them and the code of the diagnostic
+    modes are removed from the hot path. */
+    uint32_t FramesInFlight() const {
+        if constexpr (Config::RUNTIME_CONFIGURED) {
+            return frames_in_flight;
+        } else {
+            return Config::FRAMES_IN_FLIGHT;
+        }
+    }
+
+    std::optional<VkPresentModeKHR> PreferredPresentMode() const {
+        if constexpr (Config::RUNTIME_CONFIGURED) {
+            return preferred_present_mode;
+        } else {
+            return Config::PRESENT_MODE;
+        }
+    }
+
+    bool ValidationEnabled() const {
+        if constexpr (Config::RUNTIME_CONFIGURED) {
+            return enable_validation;
+        } else {
+            return Config::ENABLE_VALIDATION;
+        }
+    }
+
+    VkSampleCountFlagBits SampleCount() const {
+        if constexpr (Config::RUNTIME_CONFIGURED) {
+            return sample_count;
+        } else {
+            return Config::SAMPLE_COUNT;
+        }
+    }
+
+    bool PostProcessing() const { return !options.post_stages.empty(); }
+
+    bool DeferredShading() const { return options.deferred; }
+
+    bool OcclusionCulling() const { return options.occlusion_culling; }
+
+    // Subpass the particles and the overlay are drawn in, the one that
+    // writes the color attachment
+    uint32_t ColorSubpass() const {
+        return DeferredShading() ? DEFERRED_LIGHTING_SUBPASS : 0;
+    }
+
+    // Format of the color attachments of the render pass
+    VkFormat SceneFormat() const {
+        return PostProcessing() ? POST_IMAGE_FORMAT : swap_chain_image_format;
+    }
+
+    uint32_t DrawCount() const {
+        if constexpr (Config::RUNTIME_CONFIGURED) {
+            return draw_count;
+        } else {
+            return 1;
+        }
+    }
+
+    static void CheckExtensionSupport();
+    void CreateInstance();
+    static bool CheckValidationLayerSupport();
+    std::vector<const char*> GetRequiredExtensions() const;
+    static VKAPI_ATTR VkBool32 VKAPI_CALL
+    DebugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT message_severity,
+                  VkDebugUtilsMessageTypeFlagsEXT message_type,
+                  const VkDebugUtilsMessengerCallbackDataEXT* p_callback_data,
+                  void* p_user_data);
+    void SetupDebugMessenger();
+    static VkResult CreateDebugUtilsMessengerEXT(
+        VkInstance instance,
+        const VkDebugUtilsMessengerCreateInfoEXT* p_create_info,
+        const VkAllocationCallbacks* p_allocator,
+        VkDebugUtilsMessengerEXT* p_debug_messenger);
+    static void DestroyDebugUtilsMessengerEXT(
+        VkInstance instance, VkDebugUtilsMessengerEXT debug_messenger,
+        const VkAllocationCallbacks* p_allocator);
+    static void PopulateDebugMessengerCreateInfo(
+        VkDebugUtilsMessengerCreateInfoEXT& create_info);
+    void PickPhysicalDevice();
+    bool IsDeviceSuitable(VkPhysicalDevice device);
+    QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device);
+    void CreateLogicalDevice();
+    void CreateSurface();
+    static std::set<std::string> GetAvailableDeviceExtensions(
+        VkPhysicalDevice device);
+    static bool CheckDeviceExtensionSupport(VkPhysicalDevice device);
+    bool CheckPresentWaitSupport(VkPhysicalDevice device);
+    bool CheckTimelineSemaphoreSupport(VkPhysicalDevice device);
+    bool CheckConditionalRenderingSupport(VkPhysicalDevice device);
+    SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice device);
+    static VkSurfaceFormatKHR ChooseSwapSurfaceFormat(
+        const std::vector<VkSurfaceFormatKHR>& available_formats);
+    VkPresentModeKHR ChooseSwapPresentMode(
+        const std::vector<VkPresentModeKHR>& available_present_modes) const;
+    VkExtent2D ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities);
+    void CreateSwapChain();
+    void CreateImageViews();
+    VkImageView CreateImageView(VkImage image, VkFormat format,
+                                VkImageAspectFlags aspect_flags);
+    void UploadToBuffer(const void* data, VkDeviceSize size, VkBuffer buffer,
+                        VkDeviceSize buffer_offset);
+    // fill_staging writes the size bytes into the mapped staging buffer
+    void UploadToBuffer(VkDeviceSize size, VkBuffer buffer,
+                        VkDeviceSize buffer_offset,
+                        const std::function<void(uint8_t*)>& fill_staging);
+    void DestroyMeshes();
+    TextureStreamer& GetTextureStreamer();
+    void CreateImage(uint32_t width, uint32_t height,
+                     VkSampleCountFlagBits samples, VkFormat format,
+                     VkImageTiling tiling, VkImageUsageFlags usage,
+                     VkMemoryPropertyFlags properties, VkImage& image,
+                     VkDeviceMemory& image_memory);
+    VkSampleCountFlagBits GetMaxUsableSampleCount();
+    VkSampleCountFlagBits ChooseSampleCount();
+    void CreateColorResources();
+    void CreatePostResources();
+    void CreateGBuffer();
+    VkFormat FindDepthFormat();
+    void CreateDepthResources();
+    void CreateGraphicsPipeline();
+    PipelineCompiler::Handle RequestPipeline(const std::string& name,
+                                             std::vector<char> vert_code,
+                                             std::vector<char> frag_code,
+                                             DepthPass depth_pass,
+                                             VkPipeline fallback);
+    void PublishPipelines();
+    // Destroy the pre-pass pipelines and drop their requests, the scene is
+    // drawn with the graphics pipeline until they are requested again
+    void DiscardPrepassPipelines();
+    static bool InstanceExtensionSupported(const char* extension_name);
+
+    // Name an object for capture tools, compiled out without
+    // Config::DEBUG_LABELS
+    template <typename Handle>
+    void NameObject(Handle handle, VkObjectType type, const char* name) const {
+        if constexpr (Config::DEBUG_LABELS) {
+            debug_utils.SetObjectName(handle, type, name);
+        }
+    }
+    void CreateParticleSystem(uint32_t capacity);
+    void DestroyParticleSystem();
+    void CreateHud();
+    void DestroyHud();
+    void CreatePostChain();
+    void DestroyPostChain();
+    void CreateLighting();
+    void DestroyLighting();
+    void CreateOcclusionCuller();
+    void DestroyOcclusionCuller();
+    // Recreate the render pass and everything drawn in it after the shading
+    // options changed, the device must be idle
+    void RebuildRenderPass();
+    void CreateTimestampQueries();
+    // GPU time of the last submission of the frame slot in milliseconds,
+    // negative if it is not known
+    double ReadGpuFrameTime(uint32_t frame);
+    // Timings of the frame slot after its fence wait, for the overlay and
+    // the metrics
+    void MeasureFrameTimings();
+    void UpdateHud();
+    void UpdateMemoryBudget();
+    void RespondToMemoryPressure(MemoryPressure pressure);
+    bool MeasuringFrameTimings() const {
+        return hud != nullptr || metrics != nullptr;
+    }
+    // The fragment shader module is not used by a PRE_PASS pipeline
+    VkPipeline CreatePipeline(VkShaderModule vert_shader_module,
+                              VkShaderModule frag_shader_module,
+                              VkPipelineCache cache, DepthPass depth_pass);
+    void CreatePipelineCache();
+    void SavePipelineCache();
+    void LoadShaders();
+    const std::vector<char>& GetShaderCode(const std::string& filename);
+    static std::vector<char> ReadFile(const std::string& filename);
+    VkShaderModule CreateShaderModule(const std::vector<char>& code);
+    void CreateRenderPass();
+    void CreateDeferredRenderPass();
+    void DestroyRenderPasses();
+    void CreateFramebuffers();
+    void CreateCommandPools();
+    void CreateCommandBuffers();
+    void ResetFrameCommandPool(uint32_t frame);
+    VkCommandBuffer AcquireCommandBuffer(uint32_t frame);
+    void RecordCommandBuffer(VkCommandBuffer command_buffer,
+                             uint32_t image_index);
+    void RecordDraws(VkCommandBuffer command_buffer);
+    void RecordParticleSimulation(VkCommandBuffer command_buffer);
+    void RecordTextureUploads();
+    void CullObjects();
+    void CreateSyncObjects();
+    void RecreateSwapChain();
+    void CleanupSwapChain();
+    void ConfigureFramePacing();
+    void CollectPresentCompletions(bool wait_for_oldest);
+    void DiscardPendingPresents();
+    void StartLatencyMeasurement();
+    void ApplyLatencyConfiguration();
+    void AdvanceLatencyMeasurement();
+
+    // The benchmarks drive the individual steps of a frame directly
+    template <typename>
+    friend class BenchmarkSuite;
+
+   public:
+    explicit Renderer(ApplicationOptions options = {});
+
+    // Create the Vulkan objects for the surface of the host
+    void Initialize(RendererSurface surface);
+
+    // Destroy the Vulkan objects and the surface
+    void Shutdown();
+
+    // Delay the start of the next frame for the frame rate cap and low
+    // latency pacing, called before the host reads its events
+    void PaceFrame();
+
+    // Wait for the frame slot, acquire a swap chain image and record the
+    // command buffer. Returns false if no frame can be rendered, e.g. while
+    // the surface is minimized, Submit and EndFrame are skipped then.
+    bool BeginFrame();
+
+    // Submit the recorded command buffer to the graphics queue
+    void Submit();
+
+    // Present the image and advance to the next frame slot
+    void EndFrame();
+
+    // Recreate the swap chain at the start of the next frame
+    void NotifySurfaceResized();
+
+    // Timestamp an input event for the input-to-present latency measurement
+    void StampInput();
+
+    void WaitIdle();
+
+    // Load a KTX2 texture and stream it to the GPU over the next frames.
+    // Requires VK_KHR_timeline_semaphore, throws std::runtime_error if the
+    // device does not support it or the texture can not be loaded.
+    TextureStreamer::TextureHandle LoadTexture(const std::string& filename);
+
+    // Stream a KTX2 texture that is already in memory, e.g. an image of a
+    // glTF file
+    TextureStreamer::TextureHandle LoadTexture(const std::string& name,
+                                               Ktx2File texture);
+
+    // Image view of a texture once its upload completed, VK_NULL_HANDLE
+    // before
+    VkImageView GetTextureView(TextureStreamer::TextureHandle texture) const;
+
+    // Map a .vmesh file and copy its payload to a device local buffer
+    // through a staging buffer. Blocks until the copy is done, so it is meant
+    // for loading and not for the frame loop.
+    using MeshHandle = uint32_t;
+    MeshHandle LoadMesh(const std::string& filename);
+
+    // Copy the streams of a mesh in memory, e.g. from a glTF file, to a
+    // device local buffer in the layout of a .vmesh file. Blocks like
+    // LoadMesh.
+    MeshHandle UploadMesh(const MeshData& data);
+
+    const GpuMesh& GetMesh(MeshHandle mesh) const { return meshes.at(mesh); }
+    size_t GetMeshCount() const { return meshes.size(); }
+
+    // Objects of the scene. While the set is empty the configured number of
+    // draws is recorded, otherwise one draw per visible object with the
+    // index of the object as first instance.
+    CullingSet& GetCullingSet() { return culling_set; }
+    void SetViewProjection(const glm::mat4& view_projection) {
+        culling_frustum = ExtractFrustum(view_projection);
+    }
+    uint32_t GetVisibleObjectCount() const { return visible_object_count; }
+    VkExtent2D GetExtent() const { return swap_chain_extent; }
+
+    // Add an object that draws a mesh, its level of detail is selected every
+    // frame from the levels of the mesh. Returns the object of the culling
+    // set.
+    uint32_t AddObject(MeshHandle mesh, const glm::vec3& center, float radius);
+    void SetLodView(const LodView& view) { lod_view = view; }
+    const LodSelector& GetLodSelector() const { return lod_selector; }
+
+    // Budget and usage of the memory heaps, and the pressure callbacks of
+    // subsystems that can shrink their allocations. The callbacks are called
+    // on the render thread at the start of a frame.
+    const MemoryBudget& GetMemoryBudget() const { return *memory_budget; }
+    void AddMemoryPressureCallback(MemoryBudget::PressureCallback callback) {
+        memory_budget->AddPressureCallback(std::move(callback));
+    }
+
+    // Compiler for the pipelines of new materials or state combinations.
+    // Its pipelines are published at the start of a frame, before that the
+    // fallback of the request is drawn.
+    PipelineCompiler& GetPipelineCompiler() { return *pipeline_compiler; }
+
+    // Set layouts deduplicated by their bindings, and the allocator of the
+    // descriptor sets of the frame being recorded. A set of the allocator is
+    // valid until its frame slot is recorded again.
+    DescriptorLayoutCache& GetDescriptorLayoutCache() {
+        return *descriptor_layout_cache;
+    }
+    DescriptorAllocator& GetFrameDescriptors() { return *frame_descriptors; }
+
+    // Parameters of the post-processing stages, ignored without them
+    void SetPostParameters(const PostParameters& parameters) {
+        if (post_chain != nullptr) {
+            post_chain->SetParameters(parameters);
+        }
+    }
+
+    // Print the results of the diagnostic modes, after WaitIdle
+    void ReportDiagnostics(std::ostream& out);
+
+    // A diagnostic mode has finished, e.g. the latency measurement
+    bool CloseRequested() const { return close_requested; }
+
+    bool MeasuringLatency() const {
+        return Config::RUNTIME_CONFIGURED && options.measure_latency;
+    }
+
+    bool RunningResizeStorm() const {
+        return Config::RUNTIME_CONFIGURED && options.resize_storm;
+    }
+
+    // The host issues the resizes of a storm, the renderer records the
+    // recreations and dropped frames
+    ResizeStorm& GetResizeStorm() { return resize_storm; }
+};
+
+#endif  // RENDERER_H
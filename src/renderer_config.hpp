@@ -0,0 +1,67 @@
+#ifndef RENDERER_CONFIG_H
+#define RENDERER_CONFIG_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Standard libraries */
+#include <cstdint>  // Required for uint32_t
+
+/* Renderer configuration policies
+
+Renderer is parameterized with one of the two policies:
+- StaticRendererConfig fixes the settings at compile time. The renderer reads
+them as constants, so the branches on them and on the diagnostic modes are
+removed from the hot path.
+- RuntimeRendererConfig reads the settings from the application options and
+enables the diagnostic modes, e.g. the latency measurement and the resize
+storm.
+*/
+
+template <uint32_t FramesInFlight, VkPresentModeKHR PresentMode,
+          bool EnableValidation, VkSampleCountFlagBits SampleCount>
+struct StaticRendererConfig {
+    static_assert(FramesInFlight > 0, "at least one frame must be in flight");
+
+    static constexpr bool RUNTIME_CONFIGURED = false;
+
+    // The synchronization objects are created for this many frames
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = FramesInFlight;
+
+    static constexpr uint32_t FRAMES_IN_FLIGHT = FramesInFlight;
+    static constexpr VkPresentModeKHR PRESENT_MODE = PresentMode;
+    static constexpr bool ENABLE_VALIDATION = EnableValidation;
+    static constexpr VkSampleCountFlagBits SAMPLE_COUNT = SampleCount;
+
+    // Object names and command buffer labels for capture tools, compiled in
+    // with the validation layers only
+    static constexpr bool DEBUG_LABELS = EnableValidation;
+};
+
+struct RuntimeRendererConfig {
+    static constexpr bool RUNTIME_CONFIGURED = true;
+
+    // The synchronization objects are created for this many frames, up to
+    // this many can be in flight at runtime
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
+    // Defaults of the settings without a command line option
+    static constexpr uint32_t FRAMES_IN_FLIGHT = 2;
+    static constexpr bool ENABLE_VALIDATION = true;
+    static constexpr VkSampleCountFlagBits SAMPLE_COUNT = VK_SAMPLE_COUNT_1_BIT;
+
+    // Object names and command buffer labels for capture tools, used when
+    // VK_EXT_debug_utils is available
+    static constexpr bool DEBUG_LABELS = true;
+};
+
+// Release configuration: double buffering, MAILBOX with a FIFO fallback, no
+// validation layers and no multisampling
+using ProductionConfig =
+    StaticRendererConfig<2, VK_PRESENT_MODE_MAILBOX_KHR, false,
+                         VK_SAMPLE_COUNT_1_BIT>;
+
+// Configured by the command line options, with the diagnostic modes
+using DiagnosticConfig = RuntimeRendererConfig;
+
+#endif  // RENDERER_CONFIG_H
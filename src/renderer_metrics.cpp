@@ -0,0 +1,133 @@
+/* Local header files */
+#include "renderer_metrics.hpp"
+
+/* Standard libraries */
+#include <cstdio>
+
+namespace {
+
+void FormatCounter(const std::string& name, const std::string& help,
+                   const std::atomic<uint64_t>& counter, std::string& out) {
+    out += "# HELP " + name + " " + help + "\n";
+    out += "# TYPE " + name + " counter\n";
+    out += name + " " +
+           std::to_string(counter.load(std::memory_order_relaxed)) + "\n";
+}
+
+void FormatGauge(const std::string& name, const std::string& help,
+                 const std::atomic<uint64_t>& gauge, std::string& out) {
+    out += "# HELP " + name + " " + help + "\n";
+    out += "# TYPE " + name + " gauge\n";
+    out += name + " " + std::to_string(gauge.load(std::memory_order_relaxed)) +
+           "\n";
+}
+
+void FormatHeapGauge(const std::string& name, const std::string& help,
+                     const std::array<std::atomic<uint64_t>,
+                                      METRICS_MAX_HEAPS>& heaps,
+                     size_t heap_count, std::string& out) {
+    out += "# HELP " + name + " " + help + "\n";
+    out += "# TYPE " + name + " gauge\n";
+    for (size_t i = 0; i < heap_count; i++) {
+        out += name + "{heap=\"" + std::to_string(i) + "\"} " +
+               std::to_string(heaps[i].load(std::memory_order_relaxed)) +
+               "\n";
+    }
+}
+
+}  // namespace
+
+void AtomicHistogram::Observe(double seconds) {
+    size_t bucket = 0;
+    while (bucket < METRICS_TIME_BUCKETS.size() &&
+           seconds > METRICS_TIME_BUCKETS[bucket]) {
+        bucket++;
+    }
+
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum_nanoseconds.fetch_add(static_cast<uint64_t>(seconds * 1e9),
+                              std::memory_order_relaxed);
+}
+
+void AtomicHistogram::Format(const std::string& name, const std::string& help,
+                             std::string& out) const {
+    out += "# HELP " + name + " " + help + "\n";
+    out += "# TYPE " + name + " histogram\n";
+
+    // The buckets of the format count every observation up to their bound
+    uint64_t cumulative = 0;
+    std::array<char, 32> bound{};
+    for (size_t i = 0; i < buckets.size(); i++) {
+        cumulative += buckets[i].load(std::memory_order_relaxed);
+
+        if (i < METRICS_TIME_BUCKETS.size()) {
+            std::snprintf(bound.data(), bound.size(), "%g",
+                          METRICS_TIME_BUCKETS[i]);
+        } else {
+            std::snprintf(bound.data(), bound.size(), "+Inf");
+        }
+
+        out += name + "_bucket{le=\"" + bound.data() + "\"} " +
+               std::to_string(cumulative) + "\n";
+    }
+
+    std::array<char, 32> sum{};
+    std::snprintf(sum.data(), sum.size(), "%.9f",
+                  static_cast<double>(
+                      sum_nanoseconds.load(std::memory_order_relaxed)) /
+                      1e9);
+    out += name + "_sum " + sum.data() + "\n";
+
+    // The +Inf bucket and the count are the same number
+    out += name + "_count " + std::to_string(cumulative) + "\n";
+}
+
+std::string RendererMetrics::Format() const {
+    std::string out;
+
+    frame_time.Format("renderer_frame_time_seconds",
+                      "Time between the starts of consecutive frames.", out);
+    gpu_time.Format("renderer_gpu_time_seconds",
+                    "GPU time of the frame command buffer.", out);
+    FormatCounter("renderer_frames_total", "Frames submitted.", frames, out);
+    FormatCounter("renderer_dropped_frames_total",
+                  "Frames not rendered because the swap chain was out of "
+                  "date or the surface minimized.",
+                  dropped_frames, out);
+    FormatCounter("renderer_swapchain_recreations_total",
+                  "Swap chain recreations.", swap_chain_recreations, out);
+    FormatCounter("renderer_device_memory_allocations_total",
+                  "Device memory allocations of the renderer buffers and "
+                  "images.",
+                  device_allocations, out);
+    FormatCounter("renderer_device_memory_allocated_bytes_total",
+                  "Bytes of device memory allocated for the renderer buffers "
+                  "and images.",
+                  device_allocated_bytes, out);
+    FormatGauge("renderer_device_memory_live_allocations",
+                "Device memory allocations of the renderer buffers and images "
+                "that are not freed.",
+                device_live_allocations, out);
+    FormatGauge("renderer_device_memory_live_bytes",
+                "Bytes of device memory of the renderer buffers and images "
+                "that are not freed.",
+                device_live_bytes, out);
+
+    size_t heaps = heap_count.load(std::memory_order_relaxed);
+    if (heaps > 0) {
+        FormatHeapGauge("renderer_memory_heap_budget_bytes",
+                        "Device memory the process can use from the heap.",
+                        heap_budget_bytes, heaps, out);
+        FormatHeapGauge("renderer_memory_heap_usage_bytes",
+                        "Device memory the process uses from the heap.",
+                        heap_usage_bytes, heaps, out);
+        out += "# HELP renderer_memory_pressure Memory pressure: 0 none, 1 "
+               "high, 2 critical.\n";
+        out += "# TYPE renderer_memory_pressure gauge\n";
+        out += "renderer_memory_pressure " +
+               std::to_string(memory_pressure.load(std::memory_order_relaxed)) +
+               "\n";
+    }
+
+    return out;
+}
@@ -0,0 +1,82 @@
+#ifndef RENDERER_METRICS_H
+#define RENDERER_METRICS_H
+
+/* Standard libraries */
+#include <array>
+#include <atomic>
+#include <cstddef>  // Required for size_t
+#include <cstdint>  // Required for uint64_t
+#include <string>
+
+// Upper bounds of the buckets of the time histograms in seconds, the last
+// bucket (+Inf) takes the rest. The bounds around 16.7 and 33.3 ms separate
+// the frames of 60 and 30 Hz.
+const std::array<double, 9> METRICS_TIME_BUCKETS = {
+    0.001, 0.002, 0.004, 0.008, 0.0167, 0.0333, 0.05, 0.1, 0.25};
+
+// Memory heaps with a budget gauge, the limit of Vulkan (VK_MAX_MEMORY_HEAPS)
+const size_t METRICS_MAX_HEAPS = 16;
+
+/* Histogram that one thread observes into while others read it
+
+The buckets and the sum are separate atomics, so a reader never blocks the
+writer. A reader may see an observation in a bucket before it sees it in the
+sum, the next read is consistent again. The count is the sum of the buckets.
+*/
+class AtomicHistogram {
+   public:
+    void Observe(double seconds);
+
+    // Prometheus text format of the histogram, with cumulative buckets
+    void Format(const std::string& name, const std::string& help,
+                std::string& out) const;
+
+   private:
+    std::array<std::atomic<uint64_t>, METRICS_TIME_BUCKETS.size() + 1>
+        buckets{};
+    std::atomic<uint64_t> sum_nanoseconds{0};
+};
+
+/* Counters of the renderer for the metrics endpoint
+
+The render thread updates them with relaxed atomics and the endpoint thread
+reads them the same way, so scraping never contends with a frame.
+*/
+struct RendererMetrics {
+    AtomicHistogram frame_time;
+    AtomicHistogram gpu_time;
+
+    std::atomic<uint64_t> frames{0};
+
+    // Frames that could not be rendered: the swap chain was out of date or
+    // the surface minimized
+    std::atomic<uint64_t> dropped_frames{0};
+    std::atomic<uint64_t> swap_chain_recreations{0};
+
+    // Device memory allocated for the buffers and images of the renderer and
+    // its modules
+    std::atomic<uint64_t> device_allocations{0};
+    std::atomic<uint64_t> device_allocated_bytes{0};
+
+    // Device memory allocated and not freed yet
+    std::atomic<uint64_t> device_live_allocations{0};
+    std::atomic<uint64_t> device_live_bytes{0};
+
+    // Budget and usage of the memory heaps in bytes, and the memory pressure
+    // (0 none, 1 high, 2 critical), set while VK_EXT_memory_budget is
+    // supported
+    std::array<std::atomic<uint64_t>, METRICS_MAX_HEAPS> heap_budget_bytes{};
+    std::array<std::atomic<uint64_t>, METRICS_MAX_HEAPS> heap_usage_bytes{};
+    std::atomic<size_t> heap_count{0};
+    std::atomic<uint64_t> memory_pressure{0};
+
+    static void Increment(std::atomic<uint64_t>& counter,
+                          uint64_t value = 1) {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    // All metrics in the Prometheus text exposition format
+    std::string Format() const;
+};
+
+#endif  // RENDERER_METRICS_H
@@ -0,0 +1,48 @@
+/* Local header files */
+#include "renderer_surface.hpp"
+
+/* Standard libraries */
+#include <stdexcept>
+
+RendererSurface MakeHeadlessSurface(const VkExtent2D& extent) {
+    RendererSurface surface;
+
+    // A headless surface only requires the surface extension and
+    // VK_EXT_headless_surface
+    surface.instance_extensions = {VK_KHR_SURFACE_EXTENSION_NAME,
+                                   VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME};
+
+    surface.create_surface = [](VkInstance instance) {
+        /* VK_EXT_headless_surface creates a surface that is not backed by a
+        window, presenting to it does not show anything. The swap chain,
+        acquire and present paths still run like with a window. */
+        auto func = reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(
+            vkGetInstanceProcAddr(instance, "vkCreateHeadlessSurfaceEXT"));
+
+        if (func == nullptr) {
+            throw std::runtime_error(
+                "vkCreateHeadlessSurfaceEXT Error: VK_EXT_headless_surface is "
+                "not available!");
+        }
+
+        VkHeadlessSurfaceCreateInfoEXT create_info{};
+        create_info.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+
+        VkSurfaceKHR headless_surface = VK_NULL_HANDLE;
+        if (func(instance, &create_info, nullptr, &headless_surface) !=
+            VK_SUCCESS) {
+            throw std::runtime_error(
+                "vkCreateHeadlessSurfaceEXT Error: failed to create headless "
+                "surface!");
+        }
+
+        return headless_surface;
+    };
+
+    // The size of a headless surface is defined by the host, it is the
+    // simulated window size
+    const VkExtent2D* surface_extent = &extent;
+    surface.get_extent = [surface_extent]() { return *surface_extent; };
+
+    return surface;
+}
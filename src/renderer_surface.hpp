@@ -0,0 +1,39 @@
+#ifndef RENDERER_SURFACE_H
+#define RENDERER_SURFACE_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Standard libraries */
+#include <functional>
+#include <vector>
+
+/* Surface supplied to the renderer by its host
+
+The renderer does not create windows or read events, the host describes its
+surface with the instance extensions it requires and a function that creates
+it once the renderer created the instance. The host passes it to
+Renderer::Initialize, after it created its window. The renderer owns the
+created VkSurfaceKHR and destroys it together with the instance.
+*/
+struct RendererSurface {
+    // Instance extensions required to create the surface
+    std::vector<const char*> instance_extensions;
+
+    // Create the surface for the instance of the renderer
+    std::function<VkSurfaceKHR(VkInstance instance)> create_surface;
+
+    // Current size of the surface in pixels, e.g. the framebuffer size of a
+    // window. A width or height of 0 (a minimized window) pauses rendering.
+    std::function<VkExtent2D()> get_extent;
+
+    // Refresh rate of the display in Hz for frame pacing, 0 if unknown
+    int refresh_rate = 0;
+};
+
+// Surface backed by VK_EXT_headless_surface, presenting to it does not show
+// anything. The extent is read from the given variable, so the host resizes
+// the surface by changing it.
+RendererSurface MakeHeadlessSurface(const VkExtent2D& extent);
+
+#endif  // RENDERER_SURFACE_H
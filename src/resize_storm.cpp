@@ -0,0 +1,66 @@
+/* Local header files */
+#include "resize_storm.hpp"
+
+#include "frame_statistics.hpp"
+
+/* Standard libraries */
+#include <sys/resource.h>  // Required for getrusage
+
+namespace {
+
+// Range of the sizes a resize storm cycles through
+constexpr uint32_t MIN_STORM_WIDTH = 320;
+constexpr uint32_t MAX_STORM_WIDTH = 1920;
+constexpr uint32_t MIN_STORM_HEIGHT = 240;
+constexpr uint32_t MAX_STORM_HEIGHT = 1080;
+
+uint32_t InRange(uint32_t random_value, uint32_t min, uint32_t max) {
+    return min + random_value % (max - min + 1);
+}
+
+}  // namespace
+
+VkExtent2D ResizeStorm::NextExtent() {
+    // The engine is used directly instead of a distribution, so the sequence
+    // is the same with every standard library
+    VkExtent2D extent{};
+    extent.width = InRange(static_cast<uint32_t>(random_engine()),
+                           MIN_STORM_WIDTH, MAX_STORM_WIDTH);
+    extent.height = InRange(static_cast<uint32_t>(random_engine()),
+                            MIN_STORM_HEIGHT, MAX_STORM_HEIGHT);
+    return extent;
+}
+
+void ResizeStorm::OnResizeRequested() { resize_count++; }
+
+void ResizeStorm::OnRecreated(Clock::duration duration) {
+    recreation_times.push_back(
+        std::chrono::duration<double, std::milli>(duration).count());
+}
+
+void ResizeStorm::OnFrameDropped() { dropped_frame_count++; }
+
+void ResizeStorm::OnFrame() { frame_count++; }
+
+void ResizeStorm::Report(std::ostream& out) const {
+    /* Peak memory is the peak resident set size of the process. It includes
+    the memory of CPU side drivers such as lavapipe, but not device memory of
+    a discrete GPU. */
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+
+    out << "Resize storm: " << frame_count << " frames, " << resize_count
+        << " resizes, " << recreation_times.size() << " recreations, "
+        << dropped_frame_count << " dropped frames" << std::endl;
+
+    if (!recreation_times.empty()) {
+        SampleSummary summary = Summarize(recreation_times);
+        out << "  recreation time: mean " << summary.mean << " ms, p50 "
+            << summary.p50 << " ms, p99 " << summary.p99 << " ms, max "
+            << summary.max << " ms" << std::endl;
+    }
+
+    // ru_maxrss is in kilobytes on Linux
+    out << "  peak resident memory: " << usage.ru_maxrss / 1024 << " MiB"
+        << std::endl;
+}
@@ -0,0 +1,52 @@
+#ifndef RESIZE_STORM_H
+#define RESIZE_STORM_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Standard libraries */
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <vector>
+
+/* Stress test of the swap chain recreation
+
+Every frame a burst of resizes is issued, the way a window manager delivers
+resize events while a window is dragged. The sizes come from a fixed seed, so
+runs are repeatable. Recreations are coalesced by the renderer, the report
+shows how many of the requested resizes caused a recreation, how long each
+recreation took, how many frames were dropped and the peak memory usage.
+*/
+class ResizeStorm {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    // Size of the next resize in the sequence
+    VkExtent2D NextExtent();
+
+    // A resize was issued
+    void OnResizeRequested();
+
+    // The swap chain was recreated, which took the given time
+    void OnRecreated(Clock::duration duration);
+
+    // A frame was not presented because the swap chain was out of date
+    void OnFrameDropped();
+
+    // A frame finished, presented or not
+    void OnFrame();
+
+    void Report(std::ostream& out) const;
+
+   private:
+    std::minstd_rand random_engine{0x5eed};
+
+    uint64_t resize_count = 0;
+    uint64_t dropped_frame_count = 0;
+    uint64_t frame_count = 0;
+    std::vector<double> recreation_times;  // milliseconds
+};
+
+#endif  // RESIZE_STORM_H
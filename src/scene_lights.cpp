@@ -0,0 +1,190 @@
+/* Local header files */
+#include "scene_lights.hpp"
+
+/* Standard libraries */
+#include <algorithm>  // Required for std::max
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Depth of the lights, in front of the nearest triangle of a few hundred
+// layers
+const float LIGHT_DEPTH = 0.02F;
+
+// Radius of a light in grid spacings
+const float LIGHT_RADIUS_SPACINGS = 2.0F;
+
+const float LIGHT_INTENSITY = 0.25F;
+
+// Color of a hue in [0, 1), lightened towards white
+std::array<float, 3> HueColor(float hue) {
+    std::array<float, 3> color{};
+    for (uint32_t channel = 0; channel < 3; channel++) {
+        // Distance to the hue of the channel on the circle: red 0, green
+        // 1/3, blue 2/3
+        float distance = std::fabs(hue - static_cast<float>(channel) / 3.0F);
+        distance = std::min(distance, 1.0F - distance);
+        float value = std::clamp(2.0F - 6.0F * distance, 0.0F, 1.0F);
+        color[channel] = 0.4F + 0.6F * value;
+    }
+    return color;
+}
+
+}  // namespace
+
+std::vector<PointLight> MakeLightGrid(uint32_t count) {
+    auto columns = static_cast<uint32_t>(
+        std::ceil(std::sqrt(static_cast<double>(count))));
+    uint32_t rows = columns > 0 ? (count + columns - 1) / columns : 0;
+
+    std::vector<PointLight> lights;
+    lights.reserve(count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t column = i % columns;
+        uint32_t row = i / columns;
+        float spacing_x = 2.0F / static_cast<float>(columns);
+        float spacing_y = 2.0F / static_cast<float>(rows);
+
+        float x = -1.0F + (static_cast<float>(column) + 0.5F) * spacing_x;
+        float y = -1.0F + (static_cast<float>(row) + 0.5F) * spacing_y;
+
+        PointLight light{};
+        light.position = {x, y, LIGHT_DEPTH};
+        light.radius = LIGHT_RADIUS_SPACINGS * std::max(spacing_x, spacing_y);
+
+        // Neighbors differ in color, the golden ratio spreads the hues
+        float hue = static_cast<float>(i) * 0.618034F;
+        light.color = HueColor(hue - std::floor(hue));
+        light.intensity = LIGHT_INTENSITY;
+        lights.push_back(light);
+    }
+
+    return lights;
+}
+
+SceneLights::SceneLights(VkDevice device, MemoryAllocator& memory_allocator,
+                         DescriptorLayoutCache& layout_cache,
+                         const std::vector<PointLight>& lights)
+    : device(device),
+      memory_allocator(memory_allocator),
+      count(static_cast<uint32_t>(lights.size())) {
+    if (lights.empty() || lights.size() > SCENE_MAX_LIGHTS) {
+        throw std::invalid_argument(
+            "the light count must be between 1 and " +
+            std::to_string(SCENE_MAX_LIGHTS) + "!");
+    }
+
+    CreateBuffer(lights);
+    CreateDescriptorSet(layout_cache);
+}
+
+void SceneLights::Destroy() {
+    // Destroying the pool frees the set, the layout belongs to the cache
+    vkDestroyDescriptorPool(device, descriptor_pool, nullptr);
+    descriptor_pool = VK_NULL_HANDLE;
+    set = VK_NULL_HANDLE;
+
+    vkDestroyBuffer(device, buffer, nullptr);
+    memory_allocator.Free(buffer_memory);
+    buffer = VK_NULL_HANDLE;
+    buffer_memory = VK_NULL_HANDLE;
+}
+
+void SceneLights::SetDebugNames(const DebugUtils& debug_utils) const {
+    debug_utils.SetObjectName(buffer, VK_OBJECT_TYPE_BUFFER, "Scene lights");
+}
+
+void SceneLights::CreateBuffer(const std::vector<PointLight>& lights) {
+    VkDeviceSize size = lights.size() * sizeof(PointLight);
+
+    VkBufferCreateInfo buffer_info{};
+    buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_info.size = size;
+    buffer_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(device, &buffer_info, nullptr, &buffer) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateBuffer Error: failed to create light buffer!");
+    }
+
+    VkMemoryRequirements mem_requirements{};
+    vkGetBufferMemoryRequirements(device, buffer, &mem_requirements);
+
+    /* Every lit fragment reads all lights, so the buffer should be in video
+    memory. It is written once, host visible video memory saves the staging
+    copy where the device has it. */
+    VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                       VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    if (memory_allocator.HasMemoryType(
+            mem_requirements.memoryTypeBits,
+            properties | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+        properties |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    }
+
+    buffer_memory =
+        memory_allocator.Allocate(mem_requirements, properties, "light");
+    vkBindBufferMemory(device, buffer, buffer_memory, 0);
+
+    void* data = nullptr;
+    if (vkMapMemory(device, buffer_memory, 0, size, 0, &data) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkMapMemory Error: failed to map light memory!");
+    }
+    std::memcpy(data, lights.data(), size);
+    vkUnmapMemory(device, buffer_memory);
+}
+
+void SceneLights::CreateDescriptorSet(DescriptorLayoutCache& layout_cache) {
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    set_layout = layout_cache.Get({binding});
+
+    VkDescriptorPoolSize pool_size{};
+    pool_size.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pool_size.descriptorCount = 1;
+
+    VkDescriptorPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.maxSets = 1;
+    pool_info.poolSizeCount = 1;
+    pool_info.pPoolSizes = &pool_size;
+
+    if (vkCreateDescriptorPool(device, &pool_info, nullptr,
+                               &descriptor_pool) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateDescriptorPool Error: failed to create light descriptor "
+            "pool!");
+    }
+
+    VkDescriptorSetAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.descriptorPool = descriptor_pool;
+    alloc_info.descriptorSetCount = 1;
+    alloc_info.pSetLayouts = &set_layout;
+
+    if (vkAllocateDescriptorSets(device, &alloc_info, &set) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkAllocateDescriptorSets Error: failed to allocate light "
+            "descriptor set!");
+    }
+
+    VkDescriptorBufferInfo buffer_info{buffer, 0, VK_WHOLE_SIZE};
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = set;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &buffer_info;
+
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
@@ -0,0 +1,77 @@
+#ifndef SCENE_LIGHTS_H
+#define SCENE_LIGHTS_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Local header files */
+#include "debug_utils.hpp"
+#include "descriptor_allocator.hpp"
+#include "memory_allocator.hpp"
+
+/* Standard libraries */
+#include <array>
+#include <cstdint>  // Required for uint32_t
+#include <vector>
+
+// Most lights of a scene
+const uint32_t SCENE_MAX_LIGHTS = 65536;
+
+// Point light in the clip space of the scene, there is no camera. The layout
+// matches the light buffer of shaders/lit.frag and shaders/lighting.frag.
+struct PointLight {
+    std::array<float, 3> position;
+    float radius;  // Distance at which the light fades out
+    std::array<float, 3> color;
+    float intensity;
+};
+static_assert(sizeof(PointLight) == 32, "PointLight must be 32 bytes");
+
+// Lights on a grid over the view, in front of the triangles. The radius
+// shrinks with the grid spacing, so about the same number of lights reach a
+// pixel for any count.
+std::vector<PointLight> MakeLightGrid(uint32_t count);
+
+/* Point lights of the scene in a storage buffer
+
+The lights are written once into host visible memory, device local if the
+device has such memory, and read by every fragment that is lit. The buffer
+has one descriptor set of its own that lives as long as the lights, the
+forward pipelines and the lighting subpass of the deferred path bind the
+same set. Its layout comes from the layout cache.
+*/
+class SceneLights {
+   public:
+    // Throws std::invalid_argument without lights or with more than
+    // SCENE_MAX_LIGHTS
+    SceneLights(VkDevice device, MemoryAllocator& memory_allocator,
+                DescriptorLayoutCache& layout_cache,
+                const std::vector<PointLight>& lights);
+
+    // Destroy the buffer and the set, the device must be idle
+    void Destroy();
+
+    VkDescriptorSetLayout GetSetLayout() const { return set_layout; }
+    VkDescriptorSet GetSet() const { return set; }
+    uint32_t GetCount() const { return count; }
+
+    // Name the buffer for capture tools
+    void SetDebugNames(const DebugUtils& debug_utils) const;
+
+   private:
+    VkDevice device;
+    MemoryAllocator& memory_allocator;
+    uint32_t count;
+
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory buffer_memory = VK_NULL_HANDLE;
+
+    VkDescriptorSetLayout set_layout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
+    VkDescriptorSet set = VK_NULL_HANDLE;
+
+    void CreateBuffer(const std::vector<PointLight>& lights);
+    void CreateDescriptorSet(DescriptorLayoutCache& layout_cache);
+};
+
+#endif  // SCENE_LIGHTS_H
@@ -0,0 +1,201 @@
+/* Local header files */
+#include "shader_manifest.hpp"
+
+#include "json_value.hpp"
+
+/* Standard libraries */
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// First 32 bits of the fractional parts of the cube roots of the first 64
+// primes (FIPS 180-4)
+const std::array<uint32_t, 64> SHA256_ROUND_CONSTANTS = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+uint32_t RotateRight(uint32_t value, uint32_t bits) {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+void Sha256Block(const uint8_t* block, std::array<uint32_t, 8>& state) {
+    std::array<uint32_t, 64> schedule{};
+    for (size_t i = 0; i < 16; i++) {
+        schedule[i] = (static_cast<uint32_t>(block[i * 4]) << 24) |
+                      (static_cast<uint32_t>(block[i * 4 + 1]) << 16) |
+                      (static_cast<uint32_t>(block[i * 4 + 2]) << 8) |
+                      static_cast<uint32_t>(block[i * 4 + 3]);
+    }
+    for (size_t i = 16; i < 64; i++) {
+        uint32_t s0 = RotateRight(schedule[i - 15], 7) ^
+                      RotateRight(schedule[i - 15], 18) ^
+                      (schedule[i - 15] >> 3);
+        uint32_t s1 = RotateRight(schedule[i - 2], 17) ^
+                      RotateRight(schedule[i - 2], 19) ^
+                      (schedule[i - 2] >> 10);
+        schedule[i] = schedule[i - 16] + s0 + schedule[i - 7] + s1;
+    }
+
+    std::array<uint32_t, 8> h = state;
+    for (size_t i = 0; i < 64; i++) {
+        uint32_t s1 = RotateRight(h[4], 6) ^ RotateRight(h[4], 11) ^
+                      RotateRight(h[4], 25);
+        uint32_t choice = (h[4] & h[5]) ^ (~h[4] & h[6]);
+        uint32_t t1 =
+            h[7] + s1 + choice + SHA256_ROUND_CONSTANTS[i] + schedule[i];
+        uint32_t s0 = RotateRight(h[0], 2) ^ RotateRight(h[0], 13) ^
+                      RotateRight(h[0], 22);
+        uint32_t majority = (h[0] & h[1]) ^ (h[0] & h[2]) ^ (h[1] & h[2]);
+        uint32_t t2 = s0 + majority;
+
+        h[7] = h[6];
+        h[6] = h[5];
+        h[5] = h[4];
+        h[4] = h[3] + t1;
+        h[3] = h[2];
+        h[2] = h[1];
+        h[1] = h[0];
+        h[0] = t1 + t2;
+    }
+
+    for (size_t i = 0; i < state.size(); i++) {
+        state[i] += h[i];
+    }
+}
+
+}  // namespace
+
+uint64_t ShaderManifest::GetCacheKey() const {
+    uint64_t hash = HashBytes(build.data(), build.size());
+    for (const auto& variant : variants) {
+        hash = HashBytes(variant.file.data(), variant.file.size(), hash);
+        hash = HashBytes(variant.sha256.data(), variant.sha256.size(), hash);
+    }
+    return hash;
+}
+
+void ShaderManifest::Report(std::ostream& out) const {
+    uint64_t size = 0;
+    uint64_t unoptimized_size = 0;
+    for (const auto& variant : variants) {
+        size += variant.size;
+        unoptimized_size += variant.unoptimized_size;
+    }
+
+    out << "Shaders: " << build << " build, " << variants.size()
+        << " variants, " << size << " bytes";
+    if (optimized) {
+        out << " (" << unoptimized_size << " before spirv-opt)";
+    }
+    out << std::endl;
+
+    for (const auto& variant : variants) {
+        out << "  " << variant.file << " (" << variant.source
+            << "): " << variant.size << " bytes";
+        if (optimized) {
+            out << ", " << variant.unoptimized_size << " before spirv-opt";
+        }
+        out << std::endl;
+    }
+}
+
+ShaderManifest LoadShaderManifest(const std::string& filename) {
+    std::ifstream file(filename);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("failed to open file: " + filename + "!");
+    }
+
+    std::stringstream text;
+    text << file.rdbuf();
+    std::string json_text = text.str();
+    JsonValue json = ParseJson(json_text.data(), json_text.size());
+
+    if (!json["shaders"].IsArray()) {
+        throw std::runtime_error(filename + ": the shader list is missing!");
+    }
+
+    ShaderManifest manifest;
+    manifest.build = json["build"].IsString() ? json["build"].AsString() : "";
+    manifest.optimized = json["optimized"].AsBool(false);
+
+    for (const auto& entry : json["shaders"].AsArray()) {
+        if (!entry["file"].IsString() || !entry["sha256"].IsString()) {
+            throw std::runtime_error(filename +
+                                     ": a shader has no file or hash!");
+        }
+
+        ShaderVariant variant;
+        variant.name = entry["name"].IsString() ? entry["name"].AsString() : "";
+        variant.source =
+            entry["source"].IsString() ? entry["source"].AsString() : "";
+        variant.stage =
+            entry["stage"].IsString() ? entry["stage"].AsString() : "";
+        variant.file = entry["file"].AsString();
+        variant.size = entry["size"].AsUnsigned(0);
+        variant.unoptimized_size = entry["unoptimized_size"].AsUnsigned(0);
+        variant.sha256 = entry["sha256"].AsString();
+        manifest.variants.push_back(std::move(variant));
+    }
+
+    return manifest;
+}
+
+uint64_t HashBytes(const void* data, size_t size, uint64_t hash) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+std::string Sha256Hex(const void* data, size_t size) {
+    std::array<uint32_t, 8> state = {0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+                                     0xa54ff53a, 0x510e527f, 0x9b05688c,
+                                     0x1f83d9ab, 0x5be0cd19};
+
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    size_t full_blocks = size / 64;
+    for (size_t i = 0; i < full_blocks; i++) {
+        Sha256Block(bytes + i * 64, state);
+    }
+
+    /* The message is padded with a 1 bit, zeros and its length in bits as a
+    big endian 64 bit number, which takes one or two more blocks */
+    std::array<uint8_t, 128> tail{};
+    size_t remainder = size - full_blocks * 64;
+    std::copy(bytes + full_blocks * 64, bytes + size, tail.begin());
+    tail[remainder] = 0x80;
+
+    size_t tail_size = remainder < 56 ? 64 : 128;
+    uint64_t bit_count = static_cast<uint64_t>(size) * 8;
+    for (size_t i = 0; i < 8; i++) {
+        tail[tail_size - 1 - i] = static_cast<uint8_t>(bit_count >> (i * 8));
+    }
+    for (size_t offset = 0; offset < tail_size; offset += 64) {
+        Sha256Block(tail.data() + offset, state);
+    }
+
+    const char* digits = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(64);
+    for (uint32_t word : state) {
+        for (int shift = 28; shift >= 0; shift -= 4) {
+            hex += digits[(word >> shift) & 0xF];
+        }
+    }
+    return hex;
+}
@@ -0,0 +1,55 @@
+#ifndef SHADER_MANIFEST_H
+#define SHADER_MANIFEST_H
+
+/* Standard libraries */
+#include <cstdint>  // Required for uint64_t
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Written next to the compiled shaders by the Shaders target of CMake
+const char* const SHADER_MANIFEST_FILE = "shaders/shader_manifest.json";
+
+// A compiled shader of the build, see cmake/ShaderManifest.cmake
+struct ShaderVariant {
+    std::string name;
+    std::string source;  // GLSL source in src/shaders
+    std::string stage;   // vert, frag or comp
+    std::string file;    // SPIR-V file in the shaders directory
+    uint64_t size = 0;
+    uint64_t unoptimized_size = 0;  // Before spirv-opt
+    std::string sha256;
+};
+
+/* Manifest of the shaders of the build
+
+Lists every compiled variant with its size and hash. The renderer checks the
+shaders it loads against it, so a stale shader fails at startup, and keys its
+pipeline cache with the hashes, so a changed shader does not load the cache
+of the previous build.
+*/
+struct ShaderManifest {
+    std::string build;  // release or debug
+    bool optimized = false;
+    std::vector<ShaderVariant> variants;
+
+    // FNV-1a of the hashes of all variants
+    uint64_t GetCacheKey() const;
+
+    // Print the size of every variant before and after optimization
+    void Report(std::ostream& out) const;
+};
+
+// Read the manifest. Throws std::runtime_error if the file can not be read or
+// is malformed.
+ShaderManifest LoadShaderManifest(const std::string& filename);
+
+// FNV-1a over the bytes, continuing from a previous hash
+uint64_t HashBytes(const void* data, size_t size,
+                   uint64_t hash = 0xcbf29ce484222325ULL);
+
+// SHA-256 of the bytes as lowercase hex digits, as CMake writes it into the
+// manifest
+std::string Sha256Hex(const void* data, size_t size);
+
+#endif  // SHADER_MANIFEST_H
@@ -1,2 +1,19 @@
 glslc.exe shader.vert -o vert.spv
-glslc.exe shader.frag -o frag.spv
\ No newline at end of file
+glslc.exe shader.frag -o frag.spv
+glslc.exe particles.comp -o particles_comp.spv
+glslc.exe particle.vert -o particle_vert.spv
+glslc.exe hud.vert -o hud_vert.spv
+glslc.exe hud.frag -o hud_frag.spv
+glslc.exe post_tonemap.comp -o post_tonemap_comp.spv
+glslc.exe post_fxaa.comp -o post_fxaa_comp.spv
+glslc.exe post_grade.comp -o post_grade_comp.spv
+glslc.exe -DSWAP_CHAIN_OUTPUT post_tonemap.comp -o post_tonemap_output_comp.spv
+glslc.exe -DSWAP_CHAIN_OUTPUT post_fxaa.comp -o post_fxaa_output_comp.spv
+glslc.exe -DSWAP_CHAIN_OUTPUT post_grade.comp -o post_grade_output_comp.spv
+glslc.exe lit.frag -o lit_frag.spv
+glslc.exe gbuffer.frag -o gbuffer_frag.spv
+glslc.exe lighting.vert -o lighting_vert.spv
+glslc.exe lighting.frag -o lighting_frag.spv
+glslc.exe depth_pyramid.comp -o depth_pyramid_comp.spv
+glslc.exe occlusion_cull.comp -o occlusion_cull_comp.spv
+glslc.exe occlusion_test.vert -o occlusion_test_vert.spv
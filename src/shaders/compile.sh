@@ -1,3 +1,20 @@
 #!/bin/sh
 glslc shader.vert -o vert.spv
 glslc shader.frag -o frag.spv
+glslc particles.comp -o particles_comp.spv
+glslc particle.vert -o particle_vert.spv
+glslc hud.vert -o hud_vert.spv
+glslc hud.frag -o hud_frag.spv
+glslc post_tonemap.comp -o post_tonemap_comp.spv
+glslc post_fxaa.comp -o post_fxaa_comp.spv
+glslc post_grade.comp -o post_grade_comp.spv
+glslc -DSWAP_CHAIN_OUTPUT post_tonemap.comp -o post_tonemap_output_comp.spv
+glslc -DSWAP_CHAIN_OUTPUT post_fxaa.comp -o post_fxaa_output_comp.spv
+glslc -DSWAP_CHAIN_OUTPUT post_grade.comp -o post_grade_output_comp.spv
+glslc lit.frag -o lit_frag.spv
+glslc gbuffer.frag -o gbuffer_frag.spv
+glslc lighting.vert -o lighting_vert.spv
+glslc lighting.frag -o lighting_frag.spv
+glslc depth_pyramid.comp -o depth_pyramid_comp.spv
+glslc occlusion_cull.comp -o occlusion_cull_comp.spv
+glslc occlusion_test.vert -o occlusion_test_vert.spv
@@ -0,0 +1,15 @@
+#version 450
+
+// G-buffer subpass of the deferred path, the lighting subpass reads the
+// attachments of the pixel
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec3 fragNormal;
+
+layout(location = 0) out vec4 outAlbedo;
+layout(location = 1) out vec4 outNormal;
+
+void main() {
+    outAlbedo = vec4(fragColor, 1.0);
+    outNormal = vec4(normalize(fragNormal) * 0.5 + 0.5, 1.0);
+}
@@ -0,0 +1,31 @@
+#version 450
+
+// Performance overlay, glyphs are cut out of the 1 bit font atlas
+
+const uint SOLID_GLYPH = 0xFFFFFFFFu;
+
+// The 35 pixels of a glyph, bit row * 5 + column
+layout(std430, set = 0, binding = 0) readonly buffer Font {
+    uvec2 glyphs[];
+};
+
+layout(location = 0) in vec2 fragCell;
+layout(location = 1) flat in uint fragGlyph;
+layout(location = 2) in vec4 fragColor;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    if (fragGlyph != SOLID_GLYPH) {
+        uvec2 cell = min(uvec2(fragCell), uvec2(4u, 6u));
+        uint bit = cell.y * 5u + cell.x;
+        uvec2 glyph = glyphs[fragGlyph];
+        uint word = bit < 32u ? glyph.x : glyph.y;
+
+        if (((word >> (bit & 31u)) & 1u) == 0u) {
+            discard;
+        }
+    }
+
+    outColor = fragColor;
+}
@@ -0,0 +1,37 @@
+#version 450
+
+// Quad of the performance overlay, one instance per glyph, bar or panel
+
+layout(location = 0) in vec2 inPosition;  // Top left corner in pixels
+layout(location = 1) in vec2 inSize;
+layout(location = 2) in uint inGlyph;
+layout(location = 3) in vec4 inColor;
+
+layout(push_constant) uniform Parameters {
+    vec2 scale;  // Pixels to clip space, 2 / extent
+} parameters;
+
+layout(location = 0) out vec2 fragCell;
+layout(location = 1) flat out uint fragGlyph;
+layout(location = 2) out vec4 fragColor;
+
+vec2 corners[6] = vec2[](
+    vec2(0.0, 0.0),
+    vec2(1.0, 0.0),
+    vec2(1.0, 1.0),
+    vec2(0.0, 0.0),
+    vec2(1.0, 1.0),
+    vec2(0.0, 1.0)
+);
+
+void main() {
+    vec2 corner = corners[gl_VertexIndex];
+    vec2 position = inPosition + corner * inSize;
+
+    gl_Position = vec4(position * parameters.scale - 1.0, 0.0, 1.0);
+
+    // Pixel of the 5x7 glyph
+    fragCell = corner * vec2(5.0, 7.0);
+    fragGlyph = inGlyph;
+    fragColor = inColor;
+}
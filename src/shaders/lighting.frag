@@ -0,0 +1,54 @@
+#version 450
+
+// Lighting subpass of the deferred path: the G-buffer of the pixel is read
+// through input attachments, every pixel adds up the lights once
+
+layout(input_attachment_index = 0, set = 0, binding = 0)
+    uniform subpassInput gbufferAlbedo;
+layout(input_attachment_index = 1, set = 0, binding = 1)
+    uniform subpassInput gbufferNormal;
+layout(input_attachment_index = 2, set = 0, binding = 2)
+    uniform subpassInput gbufferDepth;
+
+// Same layout as PointLight in scene_lights.hpp
+struct PointLight {
+    vec3 position;
+    float radius;
+    vec3 color;
+    float intensity;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer Lights {
+    PointLight lights[];
+};
+
+layout(push_constant) uniform Parameters {
+    vec2 inverse_extent;  // 1 / extent
+} parameters;
+
+layout(location = 0) out vec4 outColor;
+
+// Same shading as shaders/lit.frag
+const float ambient = 0.05;
+
+void main() {
+    vec3 albedo = subpassLoad(gbufferAlbedo).rgb;
+    vec3 normal = normalize(subpassLoad(gbufferNormal).xyz * 2.0 - 1.0);
+    float depth = subpassLoad(gbufferDepth).r;
+
+    // The clip space position the forward path interpolates
+    vec3 position = vec3(
+        gl_FragCoord.xy * parameters.inverse_extent * 2.0 - 1.0, depth);
+    vec3 light = vec3(ambient);
+
+    for (int i = 0; i < lights.length(); i++) {
+        vec3 to_light = lights[i].position - position;
+        float distance = length(to_light);
+        float attenuation = clamp(1.0 - distance / lights[i].radius, 0.0, 1.0);
+        float diffuse = max(dot(normal, to_light / max(distance, 1e-4)), 0.0);
+        light += lights[i].color * lights[i].intensity * diffuse *
+                 attenuation * attenuation;
+    }
+
+    outColor = vec4(albedo * light, 1.0);
+}
@@ -0,0 +1,9 @@
+#version 450
+
+// Fullscreen triangle of the lighting subpass, it covers the viewport with
+// the vertices (-1, -1), (3, -1) and (-1, 3)
+
+void main() {
+    vec2 corner = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,40 @@
+#version 450
+
+// Forward shading: every fragment adds up all lights, including the
+// fragments that are drawn over later
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec3 fragNormal;
+layout(location = 2) in vec3 fragPosition;
+
+layout(location = 0) out vec4 outColor;
+
+// Same layout as PointLight in scene_lights.hpp
+struct PointLight {
+    vec3 position;
+    float radius;
+    vec3 color;
+    float intensity;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Lights {
+    PointLight lights[];
+};
+
+const float ambient = 0.05;
+
+void main() {
+    vec3 normal = normalize(fragNormal);
+    vec3 light = vec3(ambient);
+
+    for (int i = 0; i < lights.length(); i++) {
+        vec3 to_light = lights[i].position - fragPosition;
+        float distance = length(to_light);
+        float attenuation = clamp(1.0 - distance / lights[i].radius, 0.0, 1.0);
+        float diffuse = max(dot(normal, to_light / max(distance, 1e-4)), 0.0);
+        light += lights[i].color * lights[i].intensity * diffuse *
+                 attenuation * attenuation;
+    }
+
+    outColor = vec4(fragColor * light, 1.0);
+}
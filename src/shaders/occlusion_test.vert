@@ -0,0 +1,35 @@
+#version 450
+
+// Dense occlusion test scene of the benchmark, see MakeOcclusionTestScene.
+// Every instance is a right triangle with legs of three cells whose corner
+// is at its cell of a 16x16 grid over the view. Each layer covers the whole
+// view in front of the previous layer.
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec3 fragPosition;
+
+invariant gl_Position;
+
+const uint GRID = 16;
+const float CELL_SIZE = 2.0 / float(GRID);
+
+vec2 offsets[3] = vec2[](
+    vec2(0.0, 0.0),
+    vec2(3.0, 0.0),
+    vec2(0.0, 3.0)
+);
+
+void main() {
+    uint cell = uint(gl_InstanceIndex) % (GRID * GRID);
+    uint layer = uint(gl_InstanceIndex) / (GRID * GRID);
+
+    vec2 corner = vec2(-1.0) + vec2(cell % GRID, cell / GRID) * CELL_SIZE;
+    vec2 position = corner + offsets[gl_VertexIndex] * CELL_SIZE;
+    float depth = 1.0 / (2.0 + float(layer));
+    gl_Position = vec4(position, depth, 1.0);
+
+    // The layers alternate in color so a missing draw stands out
+    fragColor = (layer % 2u == 0u) ? vec3(0.2, 0.6, 1.0) : vec3(1.0, 0.6, 0.2);
+    fragNormal = vec3(0.0, 0.0, -1.0);
+    fragPosition = gl_Position.xyz;
+}
@@ -0,0 +1,39 @@
+#version 450
+
+// Camera facing quad per particle, one instance per particle of the
+// compacted buffer
+
+struct Particle {
+    vec4 position_age;
+    vec4 velocity_lifetime;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Particles {
+    Particle particles[];
+};
+
+layout(push_constant) uniform Parameters {
+    vec2 half_size;  // Half the size of a particle in clip space
+} parameters;
+
+layout(location = 0) out vec3 fragColor;
+
+vec2 corners[6] = vec2[](
+    vec2(-1.0, -1.0),
+    vec2(1.0, -1.0),
+    vec2(1.0, 1.0),
+    vec2(-1.0, -1.0),
+    vec2(1.0, 1.0),
+    vec2(-1.0, 1.0)
+);
+
+void main() {
+    Particle particle = particles[gl_InstanceIndex];
+    float life = clamp(
+        particle.position_age.w / particle.velocity_lifetime.w, 0.0, 1.0);
+
+    gl_Position = vec4(particle.position_age.xy +
+                           corners[gl_VertexIndex] * parameters.half_size,
+                       0.0, 1.0);
+    fragColor = mix(vec3(1.0, 0.8, 0.3), vec3(0.6, 0.1, 0.05), life) * 0.25;
+}
@@ -1,20 +1,35 @@
-#version 450
-
-layout(location = 0) out vec3 fragColor;
-
-vec2 positions[3] = vec2[](
-    vec2(0.0, -0.5),
-    vec2(0.5, 0.5),
-    vec2(-0.5, 0.5)
-);
-
-vec3 colors[3] = vec3[](
-    vec3(1.0, 0.0, 0.0),
-    vec3(0.0, 1.0, 0.0),
-    vec3(0.0, 0.0, 1.0)
-);
-
-void main() {
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-    fragColor = colors[gl_VertexIndex];
+#version 450
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec3 fragPosition;
+
+// The depth pre-pass and the shading pass must compute the same depth
+invariant gl_Position;
+
+vec2 positions[3] = vec2[](
+    vec2(0.0, -0.5),
+    vec2(0.5, 0.5),
+    vec2(-0.5, 0.5)
+);
+
+// Center of the triangle
+const vec2 center = vec2(0.0, 1.0 / 6.0);
+
+vec3 colors[3] = vec3[](
+    vec3(1.0, 0.0, 0.0),
+    vec3(0.0, 1.0, 0.0),
+    vec3(0.0, 0.0, 1.0)
+);
+
+void main() {
+    // Every instance index is a layer in front of the previous one
+    float depth = 1.0 / (2.0 + float(gl_InstanceIndex));
+    gl_Position = vec4(positions[gl_VertexIndex], depth, 1.0);
+    fragColor = colors[gl_VertexIndex];
+
+    // The normals lean away from the center, so the lit triangle looks
+    // curved. The viewer looks along +z.
+    fragNormal = normalize(vec3(positions[gl_VertexIndex] - center, -1.0));
+    fragPosition = gl_Position.xyz;
 }
\ No newline at end of file
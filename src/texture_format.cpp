@@ -0,0 +1,299 @@
+/* Local header files */
+#include "texture_format.hpp"
+
+/* Standard libraries */
+#include <algorithm>  // Required for std::copy
+#include <array>
+#include <stdexcept>
+
+namespace {
+
+// Texel block of the BCn formats
+constexpr uint32_t BC_BLOCK_DIMENSION = 4;
+constexpr uint32_t BC_TEXELS_PER_BLOCK = 16;
+
+struct AstcFormat {
+    VkFormat unorm;
+    VkFormat srgb;
+    uint32_t width;
+    uint32_t height;
+};
+
+// Every ASTC block is 16 bytes, the block dimensions vary
+const std::array<AstcFormat, 14> ASTC_FORMATS = {{
+    {VK_FORMAT_ASTC_4x4_UNORM_BLOCK, VK_FORMAT_ASTC_4x4_SRGB_BLOCK, 4, 4},
+    {VK_FORMAT_ASTC_5x4_UNORM_BLOCK, VK_FORMAT_ASTC_5x4_SRGB_BLOCK, 5, 4},
+    {VK_FORMAT_ASTC_5x5_UNORM_BLOCK, VK_FORMAT_ASTC_5x5_SRGB_BLOCK, 5, 5},
+    {VK_FORMAT_ASTC_6x5_UNORM_BLOCK, VK_FORMAT_ASTC_6x5_SRGB_BLOCK, 6, 5},
+    {VK_FORMAT_ASTC_6x6_UNORM_BLOCK, VK_FORMAT_ASTC_6x6_SRGB_BLOCK, 6, 6},
+    {VK_FORMAT_ASTC_8x5_UNORM_BLOCK, VK_FORMAT_ASTC_8x5_SRGB_BLOCK, 8, 5},
+    {VK_FORMAT_ASTC_8x6_UNORM_BLOCK, VK_FORMAT_ASTC_8x6_SRGB_BLOCK, 8, 6},
+    {VK_FORMAT_ASTC_8x8_UNORM_BLOCK, VK_FORMAT_ASTC_8x8_SRGB_BLOCK, 8, 8},
+    {VK_FORMAT_ASTC_10x5_UNORM_BLOCK, VK_FORMAT_ASTC_10x5_SRGB_BLOCK, 10, 5},
+    {VK_FORMAT_ASTC_10x6_UNORM_BLOCK, VK_FORMAT_ASTC_10x6_SRGB_BLOCK, 10, 6},
+    {VK_FORMAT_ASTC_10x8_UNORM_BLOCK, VK_FORMAT_ASTC_10x8_SRGB_BLOCK, 10, 8},
+    {VK_FORMAT_ASTC_10x10_UNORM_BLOCK, VK_FORMAT_ASTC_10x10_SRGB_BLOCK, 10,
+     10},
+    {VK_FORMAT_ASTC_12x10_UNORM_BLOCK, VK_FORMAT_ASTC_12x10_SRGB_BLOCK, 12,
+     10},
+    {VK_FORMAT_ASTC_12x12_UNORM_BLOCK, VK_FORMAT_ASTC_12x12_SRGB_BLOCK, 12,
+     12},
+}};
+
+using Rgba8 = std::array<uint8_t, 4>;
+
+uint16_t ReadU16(const uint8_t* data) {
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+uint32_t ReadU32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) |
+           (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) |
+           (static_cast<uint32_t>(data[3]) << 24);
+}
+
+Rgba8 Expand565(uint16_t color) {
+    /* Expand a 5:6:5 color to 8 bits per channel by replicating the high
+    bits into the low bits */
+    auto red = static_cast<uint8_t>((color >> 11) & 0x1F);
+    auto green = static_cast<uint8_t>((color >> 5) & 0x3F);
+    auto blue = static_cast<uint8_t>(color & 0x1F);
+
+    return {static_cast<uint8_t>((red << 3) | (red >> 2)),
+            static_cast<uint8_t>((green << 2) | (green >> 4)),
+            static_cast<uint8_t>((blue << 3) | (blue >> 2)), 255};
+}
+
+Rgba8 Mix(const Rgba8& a, const Rgba8& b, uint32_t weight_a,
+          uint32_t weight_b) {
+    Rgba8 mixed{};
+    for (size_t i = 0; i < mixed.size(); i++) {
+        mixed[i] = static_cast<uint8_t>((a[i] * weight_a + b[i] * weight_b) /
+                                        (weight_a + weight_b));
+    }
+    return mixed;
+}
+
+void DecodeColorBlock(const uint8_t* block, bool punch_through_alpha,
+                      std::array<Rgba8, BC_TEXELS_PER_BLOCK>& texels) {
+    /* BC1 color block: two 5:6:5 endpoints and 2 bit indices into a palette
+    of the endpoints and two interpolated colors. With color0 <= color1 the
+    BC1 block has one interpolated color and transparent black instead. */
+    uint16_t color0 = ReadU16(block);
+    uint16_t color1 = ReadU16(block + 2);
+    uint32_t indices = ReadU32(block + 4);
+
+    std::array<Rgba8, 4> palette{};
+    palette[0] = Expand565(color0);
+    palette[1] = Expand565(color1);
+
+    if (color0 > color1 || !punch_through_alpha) {
+        palette[2] = Mix(palette[0], palette[1], 2, 1);
+        palette[3] = Mix(palette[0], palette[1], 1, 2);
+    } else {
+        palette[2] = Mix(palette[0], palette[1], 1, 1);
+        palette[3] = {0, 0, 0, 0};
+    }
+
+    for (uint32_t i = 0; i < BC_TEXELS_PER_BLOCK; i++) {
+        texels[i] = palette[(indices >> (2 * i)) & 0x3];
+    }
+}
+
+void DecodeAlphaBlock(const uint8_t* block,
+                      std::array<Rgba8, BC_TEXELS_PER_BLOCK>& texels,
+                      size_t channel) {
+    /* BC3 alpha and BC4 block: two 8 bit endpoints and 3 bit indices into a
+    palette of the endpoints and six interpolated values, or four
+    interpolated values, 0 and 255 */
+    std::array<uint8_t, 8> palette{};
+    palette[0] = block[0];
+    palette[1] = block[1];
+
+    if (palette[0] > palette[1]) {
+        for (uint32_t i = 1; i < 7; i++) {
+            palette[i + 1] = static_cast<uint8_t>(
+                ((7 - i) * palette[0] + i * palette[1]) / 7);
+        }
+    } else {
+        for (uint32_t i = 1; i < 5; i++) {
+            palette[i + 1] = static_cast<uint8_t>(
+                ((5 - i) * palette[0] + i * palette[1]) / 5);
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    // 48 bits of indices, little endian
+    uint64_t indices = 0;
+    for (int i = 5; i >= 0; i--) {
+        indices = (indices << 8) | block[2 + i];
+    }
+
+    for (uint32_t i = 0; i < BC_TEXELS_PER_BLOCK; i++) {
+        texels[i][channel] = palette[(indices >> (3 * i)) & 0x7];
+    }
+}
+
+void DecodeBlock(VkFormat format, const uint8_t* block,
+                 std::array<Rgba8, BC_TEXELS_PER_BLOCK>& texels) {
+    switch (format) {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            DecodeColorBlock(block, true, texels);
+            // The RGB variant has no transparency, the fourth color is black
+            for (auto& texel : texels) {
+                texel[3] = 255;
+            }
+            break;
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            DecodeColorBlock(block, true, texels);
+            break;
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+            // Explicit 4 bit alpha followed by a color block
+            DecodeColorBlock(block + 8, false, texels);
+            for (uint32_t i = 0; i < BC_TEXELS_PER_BLOCK; i++) {
+                auto alpha =
+                    static_cast<uint8_t>((block[i / 2] >> (4 * (i % 2))) & 0xF);
+                texels[i][3] = static_cast<uint8_t>(alpha * 17);
+            }
+            break;
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+            DecodeColorBlock(block + 8, false, texels);
+            DecodeAlphaBlock(block, texels, 3);
+            break;
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+            texels.fill({0, 0, 0, 255});
+            DecodeAlphaBlock(block, texels, 0);
+            break;
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+            texels.fill({0, 0, 0, 255});
+            DecodeAlphaBlock(block, texels, 0);
+            DecodeAlphaBlock(block + 8, texels, 1);
+            break;
+        default:
+            throw std::invalid_argument(
+                "TranscodeToRgba8 Error: the format can not be transcoded!");
+    }
+}
+
+}  // namespace
+
+std::optional<FormatBlock> GetFormatBlock(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_R8_UNORM:
+            return FormatBlock{1, 1, 1};
+        case VK_FORMAT_R8G8_UNORM:
+            return FormatBlock{1, 1, 2};
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+            return FormatBlock{1, 1, 4};
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+            return FormatBlock{1, 1, 8};
+        case VK_FORMAT_R32G32B32A32_SFLOAT:
+            return FormatBlock{1, 1, 16};
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC4_SNORM_BLOCK:
+            return FormatBlock{BC_BLOCK_DIMENSION, BC_BLOCK_DIMENSION, 8};
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC5_SNORM_BLOCK:
+        case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+        case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            return FormatBlock{BC_BLOCK_DIMENSION, BC_BLOCK_DIMENSION, 16};
+        default:
+            break;
+    }
+
+    for (const auto& astc : ASTC_FORMATS) {
+        if (format == astc.unorm || format == astc.srgb) {
+            return FormatBlock{astc.width, astc.height, 16};
+        }
+    }
+
+    return std::nullopt;
+}
+
+bool IsBlockCompressed(VkFormat format) {
+    std::optional<FormatBlock> block = GetFormatBlock(format);
+    return block.has_value() && (block->width > 1 || block->height > 1);
+}
+
+size_t GetLevelSize(const FormatBlock& block, uint32_t width,
+                    uint32_t height) {
+    size_t blocks_x = (width + block.width - 1) / block.width;
+    size_t blocks_y = (height + block.height - 1) / block.height;
+    return blocks_x * blocks_y * block.size;
+}
+
+std::optional<VkFormat> GetTranscodedFormat(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+            return VK_FORMAT_R8G8B8A8_UNORM;
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+            return VK_FORMAT_R8G8B8A8_SRGB;
+        default:
+            return std::nullopt;
+    }
+}
+
+std::vector<uint8_t> TranscodeToRgba8(VkFormat format, const uint8_t* data,
+                                      uint32_t width, uint32_t height) {
+    std::optional<FormatBlock> block = GetFormatBlock(format);
+    if (!block.has_value() || !GetTranscodedFormat(format).has_value()) {
+        throw std::invalid_argument(
+            "TranscodeToRgba8 Error: the format can not be transcoded!");
+    }
+
+    std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+    std::array<Rgba8, BC_TEXELS_PER_BLOCK> texels{};
+
+    uint32_t blocks_x = (width + BC_BLOCK_DIMENSION - 1) / BC_BLOCK_DIMENSION;
+    uint32_t blocks_y = (height + BC_BLOCK_DIMENSION - 1) / BC_BLOCK_DIMENSION;
+
+    for (uint32_t block_y = 0; block_y < blocks_y; block_y++) {
+        for (uint32_t block_x = 0; block_x < blocks_x; block_x++) {
+            DecodeBlock(format, data, texels);
+            data += block->size;
+
+            // Blocks at the right and bottom edge may be partially outside
+            // of the image
+            for (uint32_t i = 0; i < BC_TEXELS_PER_BLOCK; i++) {
+                uint32_t x = block_x * BC_BLOCK_DIMENSION +
+                             i % BC_BLOCK_DIMENSION;
+                uint32_t y = block_y * BC_BLOCK_DIMENSION +
+                             i / BC_BLOCK_DIMENSION;
+                if (x < width && y < height) {
+                    size_t offset = (static_cast<size_t>(y) * width + x) * 4;
+                    std::copy(texels[i].begin(), texels[i].end(),
+                              rgba.begin() + offset);
+                }
+            }
+        }
+    }
+
+    return rgba;
+}
@@ -0,0 +1,42 @@
+#ifndef TEXTURE_FORMAT_H
+#define TEXTURE_FORMAT_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Standard libraries */
+#include <cstdint>  // Required for uint32_t
+#include <optional>
+#include <vector>
+
+// Texel block of a format: uncompressed formats have 1x1 blocks, BCn formats
+// 4x4 blocks and ASTC formats a block size given by the format
+struct FormatBlock {
+    uint32_t width = 1;
+    uint32_t height = 1;
+    uint32_t size = 0;  // Bytes per block
+};
+
+// Block of a texture format, no value for formats textures can not use
+std::optional<FormatBlock> GetFormatBlock(VkFormat format);
+
+bool IsBlockCompressed(VkFormat format);
+
+// Size in bytes of an image level with the given size in texels
+size_t GetLevelSize(const FormatBlock& block, uint32_t width, uint32_t height);
+
+/* CPU transcoder
+
+Devices without support for a compressed format, e.g. BCn on most mobile
+GPUs, sample a decoded copy of the texture instead. BC1 to BC5 are decoded to
+RGBA8 on the CPU, the other compressed formats require device support. */
+
+// Format a compressed format is transcoded to, no value if the transcoder
+// does not decode the format
+std::optional<VkFormat> GetTranscodedFormat(VkFormat format);
+
+// Decode one image level to tightly packed RGBA8 texels
+std::vector<uint8_t> TranscodeToRgba8(VkFormat format, const uint8_t* data,
+                                      uint32_t width, uint32_t height);
+
+#endif  // TEXTURE_FORMAT_H
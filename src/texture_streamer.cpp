@@ -0,0 +1,553 @@
+/* Local header files */
+#include "texture_streamer.hpp"
+
+#include "texture_format.hpp"
+
+/* Standard libraries */
+#include <algorithm>  // Required for std::max
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Copies out of a buffer must start at a multiple of 4 bytes and of the
+// texel block size
+VkDeviceSize AlignCopyOffset(VkDeviceSize offset, uint32_t block_size) {
+    VkDeviceSize alignment = std::max<VkDeviceSize>(block_size, 4);
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+uint32_t FullMipLevelCount(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    for (uint32_t size = std::max(width, height); size > 1; size /= 2) {
+        levels++;
+    }
+    return levels;
+}
+
+}  // namespace
+
+TextureStreamer::TextureStreamer(VkPhysicalDevice physical_device,
+                                 VkDevice device,
+                                 MemoryAllocator& memory_allocator,
+                                 uint32_t frame_slot_count,
+                                 VkDeviceSize frame_budget)
+    : physical_device(physical_device),
+      device(device),
+      memory_allocator(memory_allocator),
+      frame_budget(frame_budget),
+      staging_buffers(frame_slot_count) {
+    for (auto& staging : staging_buffers) {
+        CreateStagingBuffer(staging);
+    }
+
+    CreateTimelineSemaphore();
+    CreateSampler();
+}
+
+void TextureStreamer::Destroy() {
+    for (auto& texture : textures) {
+        vkDestroyImageView(device, texture.view, nullptr);
+        vkDestroyImage(device, texture.image, nullptr);
+        memory_allocator.Free(texture.memory);
+    }
+    textures.clear();
+    upload_queue.clear();
+
+    // Unmapping is implicit when the memory is freed
+    for (auto& staging : staging_buffers) {
+        vkDestroyBuffer(device, staging.buffer, nullptr);
+        memory_allocator.Free(staging.memory);
+    }
+    staging_buffers.clear();
+
+    vkDestroySampler(device, sampler, nullptr);
+    vkDestroySemaphore(device, timeline_semaphore, nullptr);
+}
+
+TextureStreamer::TextureHandle TextureStreamer::LoadTexture(
+    const std::string& filename) {
+    return AddTexture(filename, LoadKtx2File(filename));
+}
+
+TextureStreamer::TextureHandle TextureStreamer::AddTexture(
+    const std::string& name, Ktx2File source) {
+    Texture texture;
+    texture.name = name;
+    texture.load_time = Clock::now();
+    texture.load_frame = frame_count;
+    texture.source = std::move(source);
+    texture.format = texture.source.format;
+
+    // Drop the largest levels under memory pressure, before they are
+    // transcoded. The image is created with the size of the first kept level.
+    auto stored_level_count =
+        static_cast<uint32_t>(texture.source.levels.size());
+    if (stored_level_count > 1) {
+        texture.skipped_levels =
+            std::min(skipped_mip_levels, stored_level_count - 1);
+    }
+    if (texture.skipped_levels > 0) {
+        auto& levels = texture.source.levels;
+        levels.erase(levels.begin(), levels.begin() + texture.skipped_levels);
+        texture.source.width = levels[0].width;
+        texture.source.height = levels[0].height;
+    }
+
+    // Use the format of the file if the device can sample it, otherwise
+    // decode it on the CPU
+    VkFormatProperties properties{};
+    vkGetPhysicalDeviceFormatProperties(physical_device, texture.format,
+                                        &properties);
+
+    if ((properties.optimalTilingFeatures &
+         VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) == 0) {
+        std::optional<VkFormat> transcoded_format =
+            GetTranscodedFormat(texture.format);
+
+        if (!transcoded_format.has_value()) {
+            throw std::runtime_error(
+                name +
+                ": the device does not support the texture format and it can "
+                "not be transcoded!");
+        }
+
+        Ktx2File transcoded;
+        transcoded.format = transcoded_format.value();
+        transcoded.width = texture.source.width;
+        transcoded.height = texture.source.height;
+
+        for (const auto& level : texture.source.levels) {
+            std::vector<uint8_t> rgba = TranscodeToRgba8(
+                texture.format, texture.source.data.data() + level.offset,
+                level.width, level.height);
+
+            Ktx2Level transcoded_level = level;
+            transcoded_level.offset = transcoded.data.size();
+            transcoded_level.size = rgba.size();
+            transcoded.levels.push_back(transcoded_level);
+            transcoded.data.insert(transcoded.data.end(), rgba.begin(),
+                                   rgba.end());
+        }
+
+        texture.source = std::move(transcoded);
+        texture.format = texture.source.format;
+        texture.transcoded = true;
+
+        vkGetPhysicalDeviceFormatProperties(physical_device, texture.format,
+                                            &properties);
+    }
+
+    // The frame budget must hold at least one row of blocks of every level
+    FormatBlock block = GetFormatBlock(texture.format).value();
+    VkDeviceSize row_size =
+        GetLevelSize(block, texture.source.width, block.height);
+    if (AlignCopyOffset(0, block.size) + row_size > frame_budget) {
+        throw std::runtime_error(
+            name + ": a row of the texture exceeds the upload budget!");
+    }
+
+    /* Missing levels of the mip chain are generated by blitting each level
+    from the previous one. Compressed formats can not be blit destinations,
+    such textures only have the levels stored in the file. */
+    auto stored_levels = static_cast<uint32_t>(texture.source.levels.size());
+    uint32_t full_levels =
+        FullMipLevelCount(texture.source.width, texture.source.height);
+    VkFormatFeatureFlags blit_features =
+        VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+        VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+    texture.generate_mips =
+        stored_levels < full_levels && !IsBlockCompressed(texture.format) &&
+        (properties.optimalTilingFeatures & blit_features) == blit_features;
+    texture.mip_levels = texture.generate_mips ? full_levels : stored_levels;
+
+    CreateTextureImage(texture);
+
+    auto handle = static_cast<TextureHandle>(textures.size());
+    textures.push_back(std::move(texture));
+    upload_queue.push_back(handle);
+
+    return handle;
+}
+
+void TextureStreamer::Update() {
+    /* Textures become visible in the order their uploads complete */
+    frame_count++;
+
+    uint64_t completed_value = 0;
+    get_counter_value(device, timeline_semaphore, &completed_value);
+
+    for (auto& texture : textures) {
+        if (texture.state == TextureState::COMPLETING &&
+            texture.ready_value <= completed_value) {
+            texture.state = TextureState::VISIBLE;
+            texture.visible_ms = std::chrono::duration<double, std::milli>(
+                                     Clock::now() - texture.load_time)
+                                     .count();
+            texture.visible_frames = frame_count - texture.load_frame;
+        }
+    }
+}
+
+uint64_t TextureStreamer::RecordUploads(VkCommandBuffer command_buffer,
+                                        uint32_t frame_slot) {
+    /* Copy rows of texel blocks into the staging buffer of the frame slot
+    until the frame budget is used up. A level is split between frames at a
+    row boundary. */
+    const StagingBuffer& staging = staging_buffers[frame_slot];
+    uint64_t signal_value = last_signal_value + 1;
+    VkDeviceSize staging_offset = 0;
+    bool recorded = false;
+
+    while (!upload_queue.empty()) {
+        Texture& texture = textures[upload_queue.front()];
+
+        if (texture.next_level == 0 && texture.next_block_row == 0) {
+            TransitionLevels(command_buffer, texture, 0, texture.mip_levels,
+                             VK_IMAGE_LAYOUT_UNDEFINED,
+                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        }
+
+        const Ktx2Level& level = texture.source.levels[texture.next_level];
+        FormatBlock block = GetFormatBlock(texture.format).value();
+        uint32_t block_rows = (level.height + block.height - 1) / block.height;
+        VkDeviceSize row_size = GetLevelSize(block, level.width, block.height);
+
+        VkDeviceSize copy_offset = AlignCopyOffset(staging_offset, block.size);
+        if (copy_offset + row_size > frame_budget) {
+            break;
+        }
+
+        auto row_count = static_cast<uint32_t>(std::min<VkDeviceSize>(
+            (frame_budget - copy_offset) / row_size,
+            block_rows - texture.next_block_row));
+
+        std::memcpy(staging.mapped + copy_offset,
+                    texture.source.data.data() + level.offset +
+                        texture.next_block_row * row_size,
+                    row_count * row_size);
+
+        // The rows are tightly packed in the staging buffer
+        uint32_t first_row = texture.next_block_row * block.height;
+        VkBufferImageCopy region{};
+        region.bufferOffset = copy_offset;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = texture.next_level;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {0, static_cast<int32_t>(first_row), 0};
+        region.imageExtent = {
+            level.width,
+            std::min(row_count * block.height, level.height - first_row), 1};
+
+        vkCmdCopyBufferToImage(command_buffer, staging.buffer, texture.image,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                               &region);
+
+        staging_offset = copy_offset + row_count * row_size;
+        recorded = true;
+
+        texture.next_block_row += row_count;
+        if (texture.next_block_row == block_rows) {
+            texture.next_block_row = 0;
+            texture.next_level++;
+        }
+
+        if (texture.next_level == texture.source.levels.size()) {
+            FinishTexture(command_buffer, texture);
+            texture.ready_value = signal_value;
+            upload_queue.pop_front();
+        }
+    }
+
+    if (!recorded) {
+        return 0;
+    }
+
+    uploaded_bytes += staging_offset;
+    max_frame_bytes = std::max(max_frame_bytes, staging_offset);
+    last_signal_value = signal_value;
+
+    return signal_value;
+}
+
+VkImageView TextureStreamer::GetImageView(TextureHandle texture) const {
+    if (texture >= textures.size() ||
+        textures[texture].state != TextureState::VISIBLE) {
+        return VK_NULL_HANDLE;
+    }
+
+    return textures[texture].view;
+}
+
+void TextureStreamer::Report(std::ostream& out) const {
+    out << "Texture streaming: " << textures.size() << " textures, "
+        << uploaded_bytes / 1024 << " KiB uploaded, at most "
+        << max_frame_bytes / 1024 << " KiB of " << frame_budget / 1024
+        << " KiB per frame" << std::endl;
+
+    for (const auto& texture : textures) {
+        out << "  " << texture.name << ": " << texture.source.width << "x"
+            << texture.source.height << ", " << texture.mip_levels
+            << " levels";
+
+        if (texture.generate_mips) {
+            out << " (" << texture.mip_levels - texture.source.levels.size()
+                << " generated)";
+        }
+
+        if (texture.transcoded) {
+            out << ", transcoded on the CPU";
+        }
+
+        if (texture.skipped_levels > 0) {
+            out << ", " << texture.skipped_levels
+                << " levels left out under memory pressure";
+        }
+
+        if (texture.state == TextureState::VISIBLE) {
+            out << ", visible after " << texture.visible_frames
+                << " frames, " << texture.visible_ms << " ms";
+        } else {
+            out << ", not visible yet";
+        }
+
+        out << std::endl;
+    }
+}
+
+void TextureStreamer::CreateStagingBuffer(StagingBuffer& staging) {
+    /* Host visible and coherent memory that stays mapped, the copies of a
+    frame are visible to the device without a flush */
+    memory_allocator.CreateBuffer(frame_budget,
+                                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                  staging.buffer, staging.memory, "staging");
+
+    void* mapped = nullptr;
+    if (vkMapMemory(device, staging.memory, 0, frame_budget, 0, &mapped) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkMapMemory Error: failed to map staging memory!");
+    }
+    staging.mapped = static_cast<uint8_t*>(mapped);
+}
+
+void TextureStreamer::CreateTimelineSemaphore() {
+    VkSemaphoreTypeCreateInfoKHR type_info{};
+    type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+    type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+    type_info.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphore_info{};
+    semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphore_info.pNext = &type_info;
+
+    if (vkCreateSemaphore(device, &semaphore_info, nullptr,
+                          &timeline_semaphore) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateSemaphore Error: failed to create timeline semaphore!");
+    }
+
+    // vkGetSemaphoreCounterValueKHR is an extension function and has to be
+    // looked up from the device
+    get_counter_value = reinterpret_cast<PFN_vkGetSemaphoreCounterValueKHR>(
+        vkGetDeviceProcAddr(device, "vkGetSemaphoreCounterValueKHR"));
+
+    if (get_counter_value == nullptr) {
+        throw std::runtime_error(
+            "vkGetSemaphoreCounterValueKHR Error: VK_KHR_timeline_semaphore "
+            "is not enabled!");
+    }
+}
+
+void TextureStreamer::CreateSampler() {
+    // Trilinear filtering over all levels of the texture
+    VkSamplerCreateInfo sampler_info{};
+    sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    sampler_info.magFilter = VK_FILTER_LINEAR;
+    sampler_info.minFilter = VK_FILTER_LINEAR;
+    sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    sampler_info.minLod = 0.0F;
+    sampler_info.maxLod = VK_LOD_CLAMP_NONE;
+    sampler_info.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+
+    if (vkCreateSampler(device, &sampler_info, nullptr, &sampler) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateSampler Error: failed to create texture sampler!");
+    }
+}
+
+void TextureStreamer::CreateTextureImage(Texture& texture) {
+    VkImageCreateInfo image_info{};
+    image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.extent.width = texture.source.width;
+    image_info.extent.height = texture.source.height;
+    image_info.extent.depth = 1;
+    image_info.mipLevels = texture.mip_levels;
+    image_info.arrayLayers = 1;
+    image_info.format = texture.format;
+    image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image_info.usage =
+        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // The generated levels are blitted from the previous level
+    if (texture.generate_mips) {
+        image_info.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
+
+    if (vkCreateImage(device, &image_info, nullptr, &texture.image) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateImage Error: failed to create texture image!");
+    }
+
+    if (debug_utils != nullptr) {
+        debug_utils->SetObjectName(texture.image, VK_OBJECT_TYPE_IMAGE,
+                                   texture.name.c_str());
+    }
+
+    VkMemoryRequirements mem_requirements{};
+    vkGetImageMemoryRequirements(device, texture.image, &mem_requirements);
+    texture.size = mem_requirements.size;
+    texture.memory = memory_allocator.Allocate(
+        mem_requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, "texture");
+    vkBindImageMemory(device, texture.image, texture.memory, 0);
+
+    VkImageViewCreateInfo view_info{};
+    view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    view_info.image = texture.image;
+    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_info.format = texture.format;
+    view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    view_info.subresourceRange.baseMipLevel = 0;
+    view_info.subresourceRange.levelCount = texture.mip_levels;
+    view_info.subresourceRange.baseArrayLayer = 0;
+    view_info.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(device, &view_info, nullptr, &texture.view) !=
+        VK_SUCCESS) {
+        throw std::runtime_error(
+            "vkCreateImageView Error: failed to create texture image view!");
+    }
+}
+
+void TextureStreamer::TransitionLevels(VkCommandBuffer command_buffer,
+                                       const Texture& texture,
+                                       uint32_t base_level,
+                                       uint32_t level_count,
+                                       VkImageLayout old_layout,
+                                       VkImageLayout new_layout) {
+    /* Layout transitions of the upload:
+    - UNDEFINED to TRANSFER_DST before the first copy
+    - TRANSFER_DST to TRANSFER_SRC for the source level of a blit
+    - TRANSFER_DST or TRANSFER_SRC to SHADER_READ_ONLY once a level is done
+    */
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = old_layout;
+    barrier.newLayout = new_layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = texture.image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = base_level;
+    barrier.subresourceRange.levelCount = level_count;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    VkPipelineStageFlags src_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    VkPipelineStageFlags dst_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+    if (old_layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+        src_stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    } else if (new_layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    } else {
+        dst_stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        barrier.srcAccessMask =
+            old_layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+                ? VK_ACCESS_TRANSFER_READ_BIT
+                : VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    }
+
+    vkCmdPipelineBarrier(command_buffer, src_stage, dst_stage, 0, 0, nullptr,
+                         0, nullptr, 1, &barrier);
+}
+
+void TextureStreamer::FinishTexture(VkCommandBuffer command_buffer,
+                                    Texture& texture) {
+    /* All stored levels were copied. Generate the missing levels, each from
+    the previous one, and make every level readable by the shaders. */
+    auto stored_levels = static_cast<uint32_t>(texture.source.levels.size());
+
+    // Levels that are not the source of a blit are done
+    uint32_t blit_source_level =
+        texture.generate_mips ? stored_levels - 1 : stored_levels;
+    if (blit_source_level > 0) {
+        TransitionLevels(command_buffer, texture, 0, blit_source_level,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    for (uint32_t level = blit_source_level + 1; level < texture.mip_levels;
+         level++) {
+        TransitionLevels(command_buffer, texture, level - 1, 1,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+        auto source_width =
+            static_cast<int32_t>(std::max(texture.source.width >> (level - 1),
+                                          1U));
+        auto source_height =
+            static_cast<int32_t>(std::max(texture.source.height >> (level - 1),
+                                          1U));
+
+        VkImageBlit blit{};
+        blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1};
+        blit.srcOffsets[0] = {0, 0, 0};
+        blit.srcOffsets[1] = {source_width, source_height, 1};
+        blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+        blit.dstOffsets[0] = {0, 0, 0};
+        blit.dstOffsets[1] = {std::max(source_width / 2, 1),
+                              std::max(source_height / 2, 1), 1};
+
+        vkCmdBlitImage(command_buffer, texture.image,
+                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, texture.image,
+                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit,
+                       VK_FILTER_LINEAR);
+
+        TransitionLevels(command_buffer, texture, level - 1, 1,
+                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    // The last level is only a blit destination
+    if (texture.generate_mips) {
+        TransitionLevels(command_buffer, texture, texture.mip_levels - 1, 1,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    // The source levels are in the staging buffer, the file data is no
+    // longer needed
+    texture.source.data.clear();
+    texture.source.data.shrink_to_fit();
+    texture.state = TextureState::COMPLETING;
+}
@@ -0,0 +1,155 @@
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+/* Third party libraries */
+#include <vulkan/vulkan.h>
+
+/* Local header files */
+#include "debug_utils.hpp"
+#include "ktx2_file.hpp"
+#include "memory_allocator.hpp"
+
+/* Standard libraries */
+#include <chrono>
+#include <cstdint>  // Required for uint32_t
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* Streams KTX2 textures to the GPU without stalling frames
+
+Loading a texture reads the file, transcodes it on the CPU if the device can
+not sample its format and creates the image. The image levels are then copied
+through a persistently mapped staging buffer per frame slot, at most
+frame_budget bytes per frame, so a large texture is spread over several
+frames. Missing mip levels are generated on the GPU with a chain of blits.
+
+The copies of a frame are submitted together with the frame and signal a
+value of a timeline semaphore. A texture only becomes visible, its image view
+is returned, once the value of its last copy has been reached.
+*/
+class TextureStreamer {
+   public:
+    using Clock = std::chrono::steady_clock;
+    using TextureHandle = uint32_t;
+
+    TextureStreamer(VkPhysicalDevice physical_device, VkDevice device,
+                    MemoryAllocator& memory_allocator,
+                    uint32_t frame_slot_count, VkDeviceSize frame_budget);
+
+    // Destroy the textures and the staging buffers, the device must be idle
+    void Destroy();
+
+    // Load a texture and queue its upload. Throws std::runtime_error if the
+    // file can not be read or its format can not be used.
+    TextureHandle LoadTexture(const std::string& filename);
+
+    // Queue the upload of a texture that is already in memory, e.g. an image
+    // of a glTF file. The name is used in errors and reports.
+    TextureHandle AddTexture(const std::string& name, Ktx2File source);
+
+    // Make the textures whose upload completed visible, called once per frame
+    void Update();
+
+    bool HasPendingUploads() const { return !upload_queue.empty(); }
+
+    // Record the copies of one frame, up to the frame budget, into the
+    // command buffer. The staging buffer of the frame slot must not be in use
+    // anymore. Returns the value the submission of the command buffer has to
+    // signal on the timeline semaphore, or 0 if nothing was recorded.
+    uint64_t RecordUploads(VkCommandBuffer command_buffer,
+                           uint32_t frame_slot);
+
+    VkSemaphore GetTimelineSemaphore() const { return timeline_semaphore; }
+
+    // Image view of a visible texture, VK_NULL_HANDLE while it is uploading
+    VkImageView GetImageView(TextureHandle texture) const;
+
+    VkSampler GetSampler() const { return sampler; }
+
+    // Print the size and time to visibility of every texture
+    void Report(std::ostream& out) const;
+
+    // Name the staging buffers and, from now on, the texture images after
+    // their files for capture tools. The debug utils must outlive the
+    // streamer.
+    void SetDebugUtils(const DebugUtils* debug_utils);
+
+    // Leave out the largest stored levels of the textures loaded from now
+    // on, to save memory under memory pressure. Every level left out saves
+    // three quarters of the memory of a texture. Textures keep at least
+    // their smallest stored level.
+    void SetSkippedMipLevels(uint32_t levels) { skipped_mip_levels = levels; }
+
+   private:
+    enum class TextureState { UPLOADING, COMPLETING, VISIBLE };
+
+    struct Texture {
+        std::string name;
+        TextureState state = TextureState::UPLOADING;
+
+        // Source levels, released once they were copied to staging memory
+        Ktx2File source;
+        bool transcoded = false;
+        uint32_t skipped_levels = 0;
+
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32_t mip_levels = 0;
+        bool generate_mips = false;
+        VkDeviceSize size = 0;
+
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+
+        // Upload progress, in rows of texel blocks of the current level
+        uint32_t next_level = 0;
+        uint32_t next_block_row = 0;
+
+        uint64_t ready_value = 0;
+        Clock::time_point load_time;
+        uint64_t load_frame = 0;
+        double visible_ms = 0.0;
+        uint64_t visible_frames = 0;
+    };
+
+    struct StagingBuffer {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        uint8_t* mapped = nullptr;
+    };
+
+    VkPhysicalDevice physical_device;
+    VkDevice device;
+    MemoryAllocator& memory_allocator;
+    VkDeviceSize frame_budget;
+
+    std::vector<StagingBuffer> staging_buffers;
+    std::vector<Texture> textures;
+    std::deque<TextureHandle> upload_queue;
+    VkSampler sampler = VK_NULL_HANDLE;
+    const DebugUtils* debug_utils = nullptr;
+    uint32_t skipped_mip_levels = 0;
+
+    // Timeline semaphore signaled by the frames that carry copies
+    VkSemaphore timeline_semaphore = VK_NULL_HANDLE;
+    PFN_vkGetSemaphoreCounterValueKHR get_counter_value = nullptr;
+    uint64_t last_signal_value = 0;
+
+    uint64_t frame_count = 0;
+    VkDeviceSize uploaded_bytes = 0;
+    VkDeviceSize max_frame_bytes = 0;
+
+    void CreateStagingBuffer(StagingBuffer& staging);
+    void CreateTimelineSemaphore();
+    void CreateSampler();
+    void CreateTextureImage(Texture& texture);
+    static void TransitionLevels(VkCommandBuffer command_buffer,
+                                 const Texture& texture, uint32_t base_level,
+                                 uint32_t level_count, VkImageLayout old_layout,
+                                 VkImageLayout new_layout);
+    void FinishTexture(VkCommandBuffer command_buffer, Texture& texture);
+};
+
+#endif  // TEXTURE_STREAMER_H
@@ -0,0 +1,50 @@
+/* Local header files */
+#include "thread_pool.hpp"
+
+/* Standard libraries */
+#include <algorithm>  // Required for std::max
+
+ThreadPool::ThreadPool(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    workers.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; i++) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    task_available.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::WorkerLoop() {
+    while (true) {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            task_available.wait(
+                lock, [this]() { return stopping || !tasks.empty(); });
+
+            // The queued tasks still run when the pool is destroyed
+            if (tasks.empty()) {
+                return;
+            }
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        task();
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+/* Standard libraries */
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Fixed set of worker threads that run submitted tasks in FIFO order
+
+Submit returns a std::future for the result of the task, an exception thrown
+by the task is rethrown by the get of the future. Tasks must not wait for
+other tasks of the same pool, the caller waits for the futures instead.
+Destroying the pool runs the queued tasks and joins the workers.
+*/
+class ThreadPool {
+   public:
+    // A thread count of 0 uses one thread per hardware thread
+    explicit ThreadPool(size_t thread_count = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename Function>
+    auto Submit(Function function) -> std::future<decltype(function())> {
+        using Result = decltype(function());
+
+        // std::function requires a copyable callable, the task is shared
+        auto task =
+            std::make_shared<std::packaged_task<Result()>>(std::move(function));
+        std::future<Result> result = task->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace_back([task]() { (*task)(); });
+        }
+        task_available.notify_one();
+
+        return result;
+    }
+
+    size_t GetThreadCount() const { return workers.size(); }
+
+   private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable task_available;
+    bool stopping = false;
+
+    void WorkerLoop();
+};
+
+#endif  // THREAD_POOL_H
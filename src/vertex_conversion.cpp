@@ -0,0 +1,351 @@
+/* Local header files */
+#include "vertex_conversion.hpp"
+
+#include "mesh_builder.hpp"
+
+/* Standard libraries */
+#include <algorithm>  // Required for std::max
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VERTEX_CONVERSION_X86
+#endif
+
+namespace {
+
+float ReadComponent(const uint8_t* data, ComponentType type, bool normalized) {
+    /* Read a component as float, normalized integers are mapped to [0, 1]
+    or [-1, 1] like the glTF specification defines */
+    switch (type) {
+        case ComponentType::BYTE: {
+            int8_t value = 0;
+            std::memcpy(&value, data, sizeof(value));
+            return normalized ? std::max(value / 127.0F, -1.0F) : value;
+        }
+        case ComponentType::UNSIGNED_BYTE: {
+            uint8_t value = *data;
+            return normalized ? value / 255.0F : value;
+        }
+        case ComponentType::SHORT: {
+            int16_t value = 0;
+            std::memcpy(&value, data, sizeof(value));
+            return normalized ? std::max(value / 32767.0F, -1.0F) : value;
+        }
+        case ComponentType::UNSIGNED_SHORT: {
+            uint16_t value = 0;
+            std::memcpy(&value, data, sizeof(value));
+            return normalized ? value / 65535.0F : value;
+        }
+        case ComponentType::UNSIGNED_INT: {
+            uint32_t value = 0;
+            std::memcpy(&value, data, sizeof(value));
+            return static_cast<float>(value);
+        }
+        case ComponentType::FLOAT: {
+            float value = 0.0F;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+    }
+
+    return 0.0F;
+}
+
+// Component of an element, 0 for components the element does not have
+float ReadElement(const AccessorView& view, size_t element,
+                  uint32_t component) {
+    if (component >= view.component_count) {
+        return 0.0F;
+    }
+
+    const uint8_t* data = view.data + element * view.stride +
+                          component * GetComponentSize(view.component_type);
+    return ReadComponent(data, view.component_type, view.normalized);
+}
+
+uint32_t ReadIndex(const AccessorView& view, size_t element) {
+    const uint8_t* data = view.data + element * view.stride;
+
+    switch (view.component_type) {
+        case ComponentType::UNSIGNED_BYTE:
+            return *data;
+        case ComponentType::UNSIGNED_SHORT: {
+            uint16_t index = 0;
+            std::memcpy(&index, data, sizeof(index));
+            return index;
+        }
+        default: {
+            uint32_t index = 0;
+            std::memcpy(&index, data, sizeof(index));
+            return index;
+        }
+    }
+}
+
+bool IsFloatVector(const AccessorView& view, uint32_t component_count) {
+    return view.component_type == ComponentType::FLOAT &&
+           view.component_count >= component_count;
+}
+
+#ifdef VERTEX_CONVERSION_X86
+
+bool SupportsSse41() {
+    static const bool supported = __builtin_cpu_supports("sse4.1") != 0;
+    return supported;
+}
+
+bool SupportsF16c() {
+    static const bool supported = __builtin_cpu_supports("f16c") != 0 &&
+                                  __builtin_cpu_supports("sse4.1") != 0;
+    return supported;
+}
+
+/* A float3 is loaded with a single unaligned 16 byte load when the memory
+after it is readable, the fourth lane is ignored */
+__attribute__((target("sse4.1"))) __m128 LoadFloat3(const AccessorView& view,
+                                                     size_t element) {
+    const uint8_t* data = view.data + element * view.stride;
+
+    if (static_cast<size_t>(view.buffer_end - data) >= sizeof(__m128)) {
+        return _mm_loadu_ps(reinterpret_cast<const float*>(data));
+    }
+
+    std::array<float, 4> values{};
+    std::memcpy(values.data(), data, 3 * sizeof(float));
+    return _mm_loadu_ps(values.data());
+}
+
+__attribute__((target("sse4.1"))) void ConvertPositionsSse41(
+    const AccessorView& view, size_t first, size_t count,
+    const PositionQuantization& quantization, MeshVertex* vertices) {
+    const auto& center = quantization.center;
+    const auto& inverse_extent = quantization.inverse_extent;
+
+    // w is 0 after the scale and replaced with 1.0 (32767)
+    const __m128 offset = _mm_setr_ps(center[0], center[1], center[2], 0.0F);
+    const __m128 scale =
+        _mm_setr_ps(inverse_extent[0] * 32767.0F, inverse_extent[1] * 32767.0F,
+                    inverse_extent[2] * 32767.0F, 0.0F);
+    const __m128 one = _mm_set1_ps(32767.0F);
+    const __m128 minus_one = _mm_set1_ps(-32767.0F);
+
+    for (size_t i = 0; i < count; i++) {
+        __m128 position = LoadFloat3(view, first + i);
+        __m128 quantized = _mm_mul_ps(_mm_sub_ps(position, offset), scale);
+        quantized = _mm_min_ps(_mm_max_ps(quantized, minus_one), one);
+        quantized = _mm_blend_ps(quantized, one, 0x8);
+
+        __m128i integers = _mm_cvtps_epi32(quantized);
+        __m128i packed = _mm_packs_epi32(integers, integers);
+        _mm_storel_epi64(
+            reinterpret_cast<__m128i*>(vertices[i].position.data()), packed);
+    }
+}
+
+__attribute__((target("sse4.1"))) void ConvertNormalsSse41(
+    const AccessorView& view, size_t first, size_t count,
+    MeshVertex* vertices) {
+    // w is 0 after the scale
+    const __m128 scale = _mm_setr_ps(127.0F, 127.0F, 127.0F, 0.0F);
+    const __m128 one = _mm_set1_ps(127.0F);
+    const __m128 minus_one = _mm_set1_ps(-127.0F);
+
+    for (size_t i = 0; i < count; i++) {
+        __m128 normal = _mm_mul_ps(LoadFloat3(view, first + i), scale);
+        normal = _mm_min_ps(_mm_max_ps(normal, minus_one), one);
+
+        __m128i integers = _mm_cvtps_epi32(normal);
+        __m128i shorts = _mm_packs_epi32(integers, integers);
+        __m128i bytes = _mm_packs_epi16(shorts, shorts);
+
+        auto packed = static_cast<uint32_t>(_mm_cvtsi128_si32(bytes));
+        std::memcpy(vertices[i].normal.data(), &packed, sizeof(packed));
+    }
+}
+
+__attribute__((target("sse4.1,f16c"))) void ConvertUvsF16c(
+    const AccessorView& view, size_t first, size_t count,
+    MeshVertex* vertices) {
+    for (size_t i = 0; i < count; i++) {
+        // A float2 is loaded into the lower half of the register
+        const uint8_t* data = view.data + (first + i) * view.stride;
+        __m128 uv = _mm_castpd_ps(
+            _mm_load_sd(reinterpret_cast<const double*>(data)));
+
+        __m128i halves = _mm_cvtps_ph(uv, _MM_FROUND_TO_NEAREST_INT);
+
+        auto packed = static_cast<uint32_t>(_mm_cvtsi128_si32(halves));
+        std::memcpy(vertices[i].uv.data(), &packed, sizeof(packed));
+    }
+}
+
+__attribute__((target("sse4.1"))) uint32_t NarrowIndicesSse41(
+    const uint8_t* input, size_t count, uint8_t* output) {
+    // Tightly packed 32 bit indices, 8 at a time. The pack saturates, the
+    // maximum of the source tells the caller whether it did.
+    __m128i max = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i low = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(input + i * 4));
+        __m128i high = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(input + i * 4 + 16));
+        max = _mm_max_epu32(max, _mm_max_epu32(low, high));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * 2),
+                         _mm_packus_epi32(low, high));
+    }
+
+    std::array<uint32_t, 4> lanes{};
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.data()), max);
+    uint32_t max_index = *std::max_element(lanes.begin(), lanes.end());
+
+    for (; i < count; i++) {
+        uint32_t index = 0;
+        std::memcpy(&index, input + i * 4, sizeof(index));
+        max_index = std::max(max_index, index);
+        auto narrow = static_cast<uint16_t>(index);
+        std::memcpy(output + i * 2, &narrow, sizeof(narrow));
+    }
+
+    return max_index;
+}
+
+#endif  // VERTEX_CONVERSION_X86
+
+}  // namespace
+
+size_t GetComponentSize(ComponentType type) {
+    switch (type) {
+        case ComponentType::BYTE:
+        case ComponentType::UNSIGNED_BYTE:
+            return 1;
+        case ComponentType::SHORT:
+        case ComponentType::UNSIGNED_SHORT:
+            return 2;
+        case ComponentType::UNSIGNED_INT:
+        case ComponentType::FLOAT:
+            return 4;
+    }
+
+    return 0;
+}
+
+PositionQuantization GetPositionQuantization(
+    const std::array<float, 3>& bounds_min,
+    const std::array<float, 3>& bounds_max) {
+    PositionQuantization quantization;
+
+    for (size_t axis = 0; axis < 3; axis++) {
+        float extent =
+            std::max((bounds_max[axis] - bounds_min[axis]) / 2, 1e-20F);
+        quantization.center[axis] = (bounds_min[axis] + bounds_max[axis]) / 2;
+        quantization.inverse_extent[axis] = 1.0F / extent;
+    }
+
+    return quantization;
+}
+
+void ConvertPositions(const AccessorView& positions, size_t first,
+                      size_t count, const PositionQuantization& quantization,
+                      MeshVertex* vertices) {
+#ifdef VERTEX_CONVERSION_X86
+    if (IsFloatVector(positions, 3) && SupportsSse41()) {
+        ConvertPositionsSse41(positions, first, count, quantization, vertices);
+        return;
+    }
+#endif
+
+    const auto& center = quantization.center;
+    const auto& inverse_extent = quantization.inverse_extent;
+
+    for (size_t i = 0; i < count; i++) {
+        for (uint32_t axis = 0; axis < 3; axis++) {
+            float value = ReadElement(positions, first + i, axis);
+            vertices[i].position[axis] =
+                QuantizeSnorm16((value - center[axis]) * inverse_extent[axis]);
+        }
+        vertices[i].position[3] = 32767;
+    }
+}
+
+void ConvertNormals(const AccessorView& normals, size_t first, size_t count,
+                    MeshVertex* vertices) {
+#ifdef VERTEX_CONVERSION_X86
+    if (IsFloatVector(normals, 3) && SupportsSse41()) {
+        ConvertNormalsSse41(normals, first, count, vertices);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < count; i++) {
+        for (uint32_t axis = 0; axis < 3; axis++) {
+            vertices[i].normal[axis] =
+                QuantizeSnorm8(ReadElement(normals, first + i, axis));
+        }
+        vertices[i].normal[3] = 0;
+    }
+}
+
+void ConvertUvs(const AccessorView& uvs, size_t first, size_t count,
+                MeshVertex* vertices) {
+#ifdef VERTEX_CONVERSION_X86
+    if (IsFloatVector(uvs, 2) && SupportsF16c()) {
+        ConvertUvsF16c(uvs, first, count, vertices);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < count; i++) {
+        vertices[i].uv = {FloatToHalf(ReadElement(uvs, first + i, 0)),
+                          FloatToHalf(ReadElement(uvs, first + i, 1))};
+    }
+}
+
+uint32_t ConvertIndices(const AccessorView& indices, size_t first,
+                        size_t count, uint32_t index_size, uint8_t* output) {
+    const uint8_t* input = indices.data + first * indices.stride;
+    size_t input_size = GetComponentSize(indices.component_type);
+
+    // Same size and tightly packed, the indices are copied as they are
+    if (input_size == index_size && indices.stride == index_size) {
+        std::memcpy(output, input, count * index_size);
+        return GetMaxIndex(output, count, index_size);
+    }
+
+#ifdef VERTEX_CONVERSION_X86
+    if (input_size == 4 && indices.stride == 4 && index_size == 2 &&
+        SupportsSse41()) {
+        return NarrowIndicesSse41(input, count, output);
+    }
+#endif
+
+    uint32_t max_index = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t index = ReadIndex(indices, first + i);
+        max_index = std::max(max_index, index);
+
+        if (index_size == 2) {
+            auto narrow = static_cast<uint16_t>(index);
+            std::memcpy(output + i * 2, &narrow, sizeof(narrow));
+        } else {
+            std::memcpy(output + i * 4, &index, sizeof(index));
+        }
+    }
+
+    return max_index;
+}
+
+const char* GetVertexConversionPath() {
+#ifdef VERTEX_CONVERSION_X86
+    if (SupportsF16c()) {
+        return "sse4.1+f16c";
+    }
+    if (SupportsSse41()) {
+        return "sse4.1";
+    }
+#endif
+
+    return "scalar";
+}
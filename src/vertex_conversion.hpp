@@ -0,0 +1,69 @@
+#ifndef VERTEX_CONVERSION_H
+#define VERTEX_CONVERSION_H
+
+/* Local header files */
+#include "mesh_file.hpp"
+
+/* Standard libraries */
+#include <array>
+#include <cstddef>
+#include <cstdint>  // Required for uint32_t
+
+// Component types of vertex attributes, with the values glTF uses
+enum class ComponentType : uint32_t {
+    BYTE = 5120,
+    UNSIGNED_BYTE = 5121,
+    SHORT = 5122,
+    UNSIGNED_SHORT = 5123,
+    UNSIGNED_INT = 5125,
+    FLOAT = 5126,
+};
+
+// Size of a component type in bytes, 0 for unknown types
+size_t GetComponentSize(ComponentType type);
+
+// Strided view of an attribute or index array in memory
+struct AccessorView {
+    const uint8_t* data = nullptr;        // First element
+    const uint8_t* buffer_end = nullptr;  // End of the readable memory
+    size_t count = 0;
+    size_t stride = 0;  // Bytes from one element to the next
+    ComponentType component_type = ComponentType::FLOAT;
+    uint32_t component_count = 1;
+    bool normalized = false;
+};
+
+// Positions are stored as center + position * extent, see MeshVertex
+struct PositionQuantization {
+    std::array<float, 3> center{};
+    std::array<float, 3> inverse_extent{};
+};
+
+PositionQuantization GetPositionQuantization(
+    const std::array<float, 3>& bounds_min,
+    const std::array<float, 3>& bounds_max);
+
+/* Conversion of vertex attributes into MeshVertex
+
+Each function converts the elements [first, first + count) of the view into
+the vertices [0, count), so ranges of a large accessor are converted in
+parallel. Float attributes, the common case, are converted with SSE4.1 and
+F16C when the CPU supports them, other component types with scalar code.
+*/
+void ConvertPositions(const AccessorView& positions, size_t first,
+                      size_t count, const PositionQuantization& quantization,
+                      MeshVertex* vertices);
+void ConvertNormals(const AccessorView& normals, size_t first, size_t count,
+                    MeshVertex* vertices);
+void ConvertUvs(const AccessorView& uvs, size_t first, size_t count,
+                MeshVertex* vertices);
+
+// Convert indices to index_size (2 or 4) bytes each. Returns the largest
+// source index, read before the narrowing to 16 bits wraps or saturates it.
+uint32_t ConvertIndices(const AccessorView& indices, size_t first,
+                        size_t count, uint32_t index_size, uint8_t* output);
+
+// Instruction sets of the float conversions on this CPU, for reports
+const char* GetVertexConversionPath();
+
+#endif  // VERTEX_CONVERSION_H